@@ -62,6 +62,11 @@ RunContext run_cook_once(const Options &options) {
             << " asset(s), " << output.cooked_artifact_count
             << " cooked artifact(s), manifest "
             << output.manifest_path.generic_string() << '\n';
+  std::cout << "axgen cook-assets: cache " << output.cache_hits << " hit(s), "
+            << output.cache_misses << " miss(es), "
+            << output.deduplicated_artifact_count << " deduplicated, "
+            << output.removed_artifact_count << " stale artifact(s) removed"
+            << '\n';
 
   context.ok = true;
   return context;
@@ -44,6 +44,8 @@ std::string format_name(SerializationFormat format) {
       return "toml";
     case SerializationFormat::Xml:
       return "xml";
+    case SerializationFormat::Binary:
+      return "binary";
   }
 
   return "unknown";
@@ -64,6 +66,9 @@ std::vector<SerializationFormat> enabled_formats() {
 #if defined(ASTRALIX_SERIALIZATION_ENABLE_XML)
   formats.push_back(SerializationFormat::Xml);
 #endif
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_BINARY)
+  formats.push_back(SerializationFormat::Binary);
+#endif
 
   return formats;
 }
@@ -84,6 +89,9 @@ serialization_format_from_string(std::string value) {
   if (value == "xml") {
     return SerializationFormat::Xml;
   }
+  if (value == "binary") {
+    return SerializationFormat::Binary;
+  }
 
   return std::nullopt;
 }
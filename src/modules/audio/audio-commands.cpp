@@ -10,23 +10,25 @@ std::vector<OneShotRequest> &get_one_shot_queue() {
 }
 
 void queue_audio_one_shot(const std::string &clip_id, const glm::vec3 &position,
-                          float gain, float pitch) {
+                          float gain, float pitch, uint8_t priority) {
   g_one_shot_queue.push_back({
       .clip_id = clip_id,
       .position = position,
       .gain = gain,
       .pitch = pitch,
       .spatial = true,
+      .priority = priority,
   });
 }
 
 void queue_audio_one_shot_2d(const std::string &clip_id,
-                             float gain, float pitch) {
+                             float gain, float pitch, uint8_t priority) {
   g_one_shot_queue.push_back({
       .clip_id = clip_id,
       .gain = gain,
       .pitch = pitch,
       .spatial = false,
+      .priority = priority,
   });
 }
 
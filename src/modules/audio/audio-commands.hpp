@@ -1,14 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <string>
 
 namespace astralix::audio {
 
+// `priority` decides which one-shot keeps its voice when the pool is full;
+// higher wins, and among equals the voice closer to the listener wins.
 void queue_audio_one_shot(const std::string &clip_id, const glm::vec3 &position,
-                          float gain = 1.0f, float pitch = 1.0f);
+                          float gain = 1.0f, float pitch = 1.0f,
+                          uint8_t priority = 128);
 
 void queue_audio_one_shot_2d(const std::string &clip_id,
-                             float gain = 1.0f, float pitch = 1.0f);
+                             float gain = 1.0f, float pitch = 1.0f,
+                             uint8_t priority = 128);
 
 } // namespace astralix::audio
@@ -3,16 +3,35 @@
 
 namespace astralix::audio {
 
-  bool AudioBackend::initialize(uint32_t listener_count) {
+  bool AudioBackend::initialize(uint32_t listener_count, bool headless) {
     ma_engine_config config = ma_engine_config_init();
     config.listenerCount = listener_count;
 
+    if (headless) {
+      const ma_backend backends[] = {ma_backend_null};
+      ma_result result = ma_context_init(backends, 1, nullptr, &m_context);
+      if (result != MA_SUCCESS) {
+        LOG_ERROR("[AUDIO BACKEND] failed to initialize null device (error ", result, ")");
+        return false;
+      }
+
+      m_context_initialized = true;
+      config.pContext = &m_context;
+    }
+
     ma_result result = ma_engine_init(&config, &m_engine);
     if (result != MA_SUCCESS) {
       LOG_ERROR("[AUDIO BACKEND] failed to initialize miniaudio engine (error ", result, ")");
+      if (m_context_initialized) {
+        ma_context_uninit(&m_context);
+        m_context_initialized = false;
+      }
       return false;
     }
 
+    m_clip_cache.initialize(ma_engine_get_channels(&m_engine),
+      ma_engine_get_sample_rate(&m_engine));
+
     m_initialized = true;
     return true;
   }
@@ -20,8 +39,14 @@ namespace astralix::audio {
   void AudioBackend::shutdown() {
     if (m_initialized) {
       ma_engine_uninit(&m_engine);
+      m_clip_cache.clear();
       m_initialized = false;
     }
+
+    if (m_context_initialized) {
+      ma_context_uninit(&m_context);
+      m_context_initialized = false;
+    }
   }
 
   bool AudioBackend::is_initialized() const { return m_initialized; }
@@ -40,20 +65,41 @@ namespace astralix::audio {
     ma_engine_listener_set_world_up(&m_engine, index, up.x, up.y, up.z);
   }
 
-  Scope<VoiceHandle> AudioBackend::create_voice(const std::string& file_path, bool spatial) {
+  Scope<VoiceHandle> AudioBackend::create_voice(const DecodedClip& clip, bool spatial) {
     auto handle = std::make_unique<VoiceHandle>();
 
-    ma_result result = ma_sound_init_from_file(
-      &m_engine, file_path.c_str(), MA_SOUND_FLAG_DECODE,
-      nullptr, nullptr, &handle->sound);
+    if (!init_buffer_voice(*handle)) {
+      return nullptr;
+    }
+
+    voice_bind_clip(*handle, clip);
+    voice_set_spatial(*handle, spatial);
+    return handle;
+  }
+
+  Scope<VoiceHandle> AudioBackend::create_stream_voice(const std::string& file_path,
+    uint32_t chunk_frames, uint32_t chunk_count, uint32_t prefetch_frames,
+    bool spatial) {
+    auto handle = std::make_unique<VoiceHandle>();
+    handle->stream = create_ref<AudioStream>(
+      file_path, ma_engine_get_channels(&m_engine), ma_engine_get_sample_rate(&m_engine),
+      chunk_frames, chunk_count, prefetch_frames);
+
+    if (!handle->stream->initialize()) {
+      return nullptr;
+    }
+
+    ma_result result = ma_sound_init_from_data_source(
+      &m_engine, handle->stream->data_source(), 0, nullptr, &handle->sound);
 
     if (result != MA_SUCCESS) {
-      LOG_ERROR("[AUDIO BACKEND] failed to load '", file_path, "' (error ", result, ")");
+      LOG_ERROR("[AUDIO BACKEND] failed to stream '", file_path, "' (error ", result, ")");
       return nullptr;
     }
 
     handle->initialized = true;
-    ma_sound_set_spatialization_enabled(&handle->sound, spatial ? MA_TRUE : MA_FALSE);
+    voice_set_spatial(*handle, spatial);
+    AudioStream::request_refill(handle->stream);
     return handle;
   }
 
@@ -62,6 +108,52 @@ namespace astralix::audio {
       ma_sound_uninit(&handle.sound);
       handle.initialized = false;
     }
+
+    // A refill job may still hold the stream; it is freed when that job ends.
+    handle.stream.reset();
+
+    if (handle.buffer_initialized) {
+      ma_audio_buffer_ref_uninit(&handle.buffer);
+      handle.buffer_initialized = false;
+    }
+  }
+
+  bool AudioBackend::init_buffer_voice(VoiceHandle& handle) {
+    ma_result result = ma_audio_buffer_ref_init(
+      ma_format_f32, ma_engine_get_channels(&m_engine), nullptr, 0, &handle.buffer);
+
+    if (result != MA_SUCCESS) {
+      LOG_ERROR("[AUDIO BACKEND] failed to initialize voice buffer (error ", result, ")");
+      return false;
+    }
+
+    // Cached clips are decoded at the engine rate, so the sound's resampler
+    // stays a passthrough.
+    handle.buffer.sampleRate = ma_engine_get_sample_rate(&m_engine);
+    handle.buffer_initialized = true;
+
+    result = ma_sound_init_from_data_source(
+      &m_engine, &handle.buffer, 0, nullptr, &handle.sound);
+
+    if (result != MA_SUCCESS) {
+      LOG_ERROR("[AUDIO BACKEND] failed to initialize voice (error ", result, ")");
+      destroy_voice(handle);
+      return false;
+    }
+
+    handle.initialized = true;
+    return true;
+  }
+
+  // Only call on a voice that finished or was halted: the audio thread reads
+  // the buffer cursor while the sound is playing.
+  void AudioBackend::voice_bind_clip(VoiceHandle& handle, const DecodedClip& clip) {
+    ma_audio_buffer_ref_set_data(&handle.buffer, clip.frames, clip.frame_count);
+    ma_sound_seek_to_pcm_frame(&handle.sound, 0);
+  }
+
+  void AudioBackend::voice_set_spatial(VoiceHandle& handle, bool spatial) {
+    ma_sound_set_spatialization_enabled(&handle.sound, spatial ? MA_TRUE : MA_FALSE);
   }
 
   void AudioBackend::voice_set_position(VoiceHandle& handle, const glm::vec3& position) {
@@ -100,6 +192,14 @@ namespace astralix::audio {
     ma_sound_stop(&handle.sound);
   }
 
+  void AudioBackend::voice_halt(VoiceHandle& handle) {
+    ma_sound_stop(&handle.sound);
+
+    // Detaching blocks until the mixer has finished any read of this node.
+    ma_node_detach_output_bus(&handle.sound, 0);
+    ma_node_attach_output_bus(&handle.sound, 0, ma_engine_get_endpoint(&m_engine), 0);
+  }
+
   bool AudioBackend::voice_is_playing(const VoiceHandle& handle) const {
     return ma_sound_is_playing(&handle.sound);
   }
@@ -108,4 +208,33 @@ namespace astralix::audio {
     return ma_sound_at_end(&handle.sound);
   }
 
+  double AudioBackend::voice_cursor_seconds(VoiceHandle& handle) const {
+    if (handle.stream != nullptr) {
+      return 0.0;
+    }
+
+    float cursor = 0.0f;
+    ma_sound_get_cursor_in_seconds(&handle.sound, &cursor);
+    return cursor;
+  }
+
+  double AudioBackend::voice_length_seconds(VoiceHandle& handle) const {
+    if (handle.stream != nullptr) {
+      return 0.0;
+    }
+
+    float length = 0.0f;
+    ma_sound_get_length_in_seconds(&handle.sound, &length);
+    return length;
+  }
+
+  void AudioBackend::voice_seek_seconds(VoiceHandle& handle, double seconds) {
+    if (handle.stream != nullptr) {
+      return;
+    }
+
+    ma_sound_seek_to_pcm_frame(&handle.sound, static_cast<ma_uint64>(
+      seconds * ma_engine_get_sample_rate(&m_engine)));
+  }
+
 } // namespace astralix::audio
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "audio-clip-cache.hpp"
+#include "audio-stream.hpp"
 #include "base.hpp"
 #include "miniaudio.h"
 #include <glm/glm.hpp>
@@ -8,14 +10,22 @@
 
 namespace astralix::audio {
 
+  // A voice plays either a cached clip through `buffer`, which only points at
+  // the clip's PCM and can be rebound in place, or a streamed file through
+  // `stream`.
   struct VoiceHandle {
     ma_sound sound;
+    ma_audio_buffer_ref buffer;
+    Ref<AudioStream> stream;
     bool initialized = false;
+    bool buffer_initialized = false;
   };
 
   class AudioBackend {
   public:
-    bool initialize(uint32_t listener_count = 1);
+    // `headless` runs the engine on miniaudio's null device: mixing happens on
+    // a timer thread at the usual rate, but no sound card is opened.
+    bool initialize(uint32_t listener_count = 1, bool headless = false);
     void shutdown();
     bool is_initialized() const;
 
@@ -24,9 +34,20 @@ namespace astralix::audio {
     void set_listener_position(uint32_t index, const glm::vec3& position);
     void set_listener_direction(uint32_t index, const glm::vec3& forward, const glm::vec3& up);
 
-    Scope<VoiceHandle> create_voice(const std::string& file_path, bool spatial);
+    Scope<VoiceHandle> create_voice(const DecodedClip& clip, bool spatial);
+    // Returns immediately; the file is opened and decoded by Background jobs
+    // scheduled through AudioStream::request_refill.
+    Scope<VoiceHandle> create_stream_voice(const std::string& file_path,
+      uint32_t chunk_frames, uint32_t chunk_count, uint32_t prefetch_frames,
+      bool spatial);
     void destroy_voice(VoiceHandle& handle);
 
+    // Initializes a clip-backed voice with no data bound; used to fill voice
+    // pools up front so starting a one-shot never allocates.
+    bool init_buffer_voice(VoiceHandle& handle);
+    void voice_bind_clip(VoiceHandle& handle, const DecodedClip& clip);
+    void voice_set_spatial(VoiceHandle& handle, bool spatial);
+
     void voice_set_position(VoiceHandle& handle, const glm::vec3& position);
     void voice_set_volume(VoiceHandle& handle, float gain);
     void voice_set_pitch(VoiceHandle& handle, float pitch);
@@ -37,11 +58,25 @@ namespace astralix::audio {
 
     void voice_start(VoiceHandle& handle);
     void voice_stop(VoiceHandle& handle);
+    // Stops the voice and waits until the audio thread no longer reads it, so
+    // a playing voice can be rebound to another clip right away.
+    void voice_halt(VoiceHandle& handle);
     bool voice_is_playing(const VoiceHandle& handle) const;
     bool voice_at_end(const VoiceHandle& handle) const;
 
+    // Playback position and length for clip-backed voices; streamed voices
+    // report 0 and can only be rewound.
+    double voice_cursor_seconds(VoiceHandle& handle) const;
+    double voice_length_seconds(VoiceHandle& handle) const;
+    void voice_seek_seconds(VoiceHandle& handle, double seconds);
+
+    AudioClipCache& clip_cache() { return m_clip_cache; }
+
   private:
+    ma_context m_context{};
     ma_engine m_engine{};
+    AudioClipCache m_clip_cache;
+    bool m_context_initialized = false;
     bool m_initialized = false;
   };
 
@@ -0,0 +1,63 @@
+#include "audio-clip-cache.hpp"
+#include "log.hpp"
+
+namespace astralix::audio {
+
+  AudioClipCache::~AudioClipCache() { clear(); }
+
+  void AudioClipCache::initialize(uint32_t channels, uint32_t sample_rate) {
+    m_channels = channels;
+    m_sample_rate = sample_rate;
+  }
+
+  void AudioClipCache::clear() {
+    for (auto& [clip_id, clip] : m_clips) {
+      ma_free(clip.frames, nullptr);
+    }
+    m_clips.clear();
+    m_stats.clip_count = 0;
+    m_stats.resident_bytes = 0;
+  }
+
+  const DecodedClip* AudioClipCache::find(const std::string& clip_id) {
+    auto iterator = m_clips.find(clip_id);
+    if (iterator == m_clips.end()) {
+      ++m_stats.misses;
+      return nullptr;
+    }
+
+    ++m_stats.hits;
+    return &iterator->second;
+  }
+
+  const DecodedClip* AudioClipCache::load(const std::string& clip_id,
+    const std::string& file_path) {
+    auto [iterator, inserted] = m_clips.try_emplace(clip_id);
+    auto& clip = iterator->second;
+    if (!inserted) {
+      return clip.valid() ? &clip : nullptr;
+    }
+
+    ma_decoder_config config =
+      ma_decoder_config_init(ma_format_f32, m_channels, m_sample_rate);
+
+    void* frames = nullptr;
+    ma_uint64 frame_count = 0;
+    ma_result result = ma_decode_file(file_path.c_str(), &config, &frame_count, &frames);
+
+    if (result != MA_SUCCESS) {
+      LOG_ERROR("[AUDIO CLIP CACHE] failed to decode '", file_path, "' (error ", result, ")");
+      return nullptr;
+    }
+
+    clip.frames = static_cast<float*>(frames);
+    clip.frame_count = frame_count;
+    clip.channels = m_channels;
+    clip.sample_rate = m_sample_rate;
+
+    ++m_stats.clip_count;
+    m_stats.resident_bytes += clip.size_bytes();
+    return clip.valid() ? &clip : nullptr;
+  }
+
+} // namespace astralix::audio
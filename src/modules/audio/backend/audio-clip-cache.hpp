@@ -0,0 +1,63 @@
+#pragma once
+
+#include "miniaudio.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace astralix::audio {
+
+  // PCM for one clip, decoded once to the engine's f32 layout so every voice
+  // can play it through an `ma_audio_buffer_ref` without resampling or
+  // copying. `frames` is null when decoding failed.
+  struct DecodedClip {
+    float* frames = nullptr;
+    ma_uint64 frame_count = 0;
+    uint32_t channels = 0;
+    uint32_t sample_rate = 0;
+
+    bool valid() const { return frames != nullptr && frame_count > 0; }
+    size_t size_bytes() const {
+      return static_cast<size_t>(frame_count) * channels * sizeof(float);
+    }
+  };
+
+  // Decoded clips keyed by AudioClipDescriptor id. Entries are never evicted
+  // while the backend is alive, so a `DecodedClip*` stays valid for any voice
+  // still reading it on the audio thread. Failed decodes are remembered as
+  // invalid entries so a missing file is only reported once.
+  class AudioClipCache {
+  public:
+    struct Stats {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint32_t clip_count = 0;
+      size_t resident_bytes = 0;
+    };
+
+    AudioClipCache() = default;
+    AudioClipCache(const AudioClipCache&) = delete;
+    AudioClipCache& operator=(const AudioClipCache&) = delete;
+    ~AudioClipCache();
+
+    void initialize(uint32_t channels, uint32_t sample_rate);
+    void clear();
+
+    // Returns the cached entry, valid or not, or null when the clip was never
+    // loaded. Counts a hit or a miss.
+    const DecodedClip* find(const std::string& clip_id);
+
+    // Decodes `file_path` and caches it under `clip_id`. Returns null when the
+    // file could not be decoded.
+    const DecodedClip* load(const std::string& clip_id, const std::string& file_path);
+
+    const Stats& stats() const { return m_stats; }
+
+  private:
+    std::unordered_map<std::string, DecodedClip> m_clips;
+    uint32_t m_channels = 0;
+    uint32_t m_sample_rate = 0;
+    Stats m_stats;
+  };
+
+} // namespace astralix::audio
@@ -0,0 +1,74 @@
+#include "audio-clip-cache.hpp"
+#include "helpers/audio-clips.hpp"
+
+#include <gtest/gtest.h>
+
+namespace astralix::audio {
+namespace {
+
+class AudioClipCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    m_cache.initialize(1u, 48000u);
+    m_tone_path = testing::write_test_wav("cache-tone.wav", testing::ramp_samples(4800u));
+    ASSERT_FALSE(m_tone_path.empty());
+  }
+
+  AudioClipCache m_cache;
+  std::string m_tone_path;
+};
+
+TEST_F(AudioClipCacheTest, DecodesOnceAndServesHitsFromMemory) {
+  EXPECT_EQ(m_cache.find("tone"), nullptr);
+  EXPECT_EQ(m_cache.stats().misses, 1u);
+
+  const DecodedClip *clip = m_cache.load("tone", m_tone_path);
+  ASSERT_NE(clip, nullptr);
+  ASSERT_TRUE(clip->valid());
+  EXPECT_EQ(clip->frame_count, 4800u);
+  EXPECT_EQ(clip->channels, 1u);
+  EXPECT_EQ(clip->frames[1234], 1234.0f);
+  EXPECT_EQ(m_cache.stats().clip_count, 1u);
+  EXPECT_EQ(m_cache.stats().resident_bytes, 4800u * sizeof(float));
+
+  // Later lookups and loads return the same PCM without decoding again.
+  EXPECT_EQ(m_cache.find("tone"), clip);
+  EXPECT_EQ(m_cache.find("tone"), clip);
+  EXPECT_EQ(m_cache.load("tone", m_tone_path), clip);
+  EXPECT_EQ(m_cache.stats().hits, 2u);
+  EXPECT_EQ(m_cache.stats().clip_count, 1u);
+  EXPECT_EQ(m_cache.stats().resident_bytes, 4800u * sizeof(float));
+}
+
+TEST_F(AudioClipCacheTest, RemembersFailedDecodes) {
+  const auto missing = (testing::audio_test_dir() / "missing.wav").string();
+  EXPECT_EQ(m_cache.load("missing", missing), nullptr);
+
+  // The failure is cached, so the file is not opened again on every request.
+  const DecodedClip *entry = m_cache.find("missing");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_FALSE(entry->valid());
+  EXPECT_EQ(m_cache.load("missing", missing), nullptr);
+  EXPECT_EQ(m_cache.stats().clip_count, 0u);
+  EXPECT_EQ(m_cache.stats().resident_bytes, 0u);
+}
+
+TEST_F(AudioClipCacheTest, ClearEvictsEveryClip) {
+  ASSERT_NE(m_cache.load("tone", m_tone_path), nullptr);
+  ASSERT_NE(m_cache.load("tone-copy", m_tone_path), nullptr);
+  EXPECT_EQ(m_cache.stats().clip_count, 2u);
+
+  m_cache.clear();
+  EXPECT_EQ(m_cache.stats().clip_count, 0u);
+  EXPECT_EQ(m_cache.stats().resident_bytes, 0u);
+  EXPECT_EQ(m_cache.find("tone"), nullptr);
+
+  // An evicted clip decodes again on its next load.
+  const DecodedClip *reloaded = m_cache.load("tone", m_tone_path);
+  ASSERT_NE(reloaded, nullptr);
+  EXPECT_EQ(reloaded->frame_count, 4800u);
+  EXPECT_EQ(m_cache.stats().clip_count, 1u);
+}
+
+} // namespace
+} // namespace astralix::audio
@@ -0,0 +1,238 @@
+#include "audio-stream.hpp"
+#include "log.hpp"
+#include "systems/job-system/job-system.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace astralix::audio {
+
+  ma_data_source_vtable AudioStream::s_vtable = {
+    AudioStream::on_read,
+    AudioStream::on_seek,
+    AudioStream::on_get_data_format,
+    nullptr,
+    nullptr,
+    nullptr,
+    0,
+  };
+
+  AudioStream::AudioStream(std::string file_path, uint32_t channels, uint32_t sample_rate,
+    uint32_t chunk_frames, uint32_t chunk_count, uint32_t prefetch_frames)
+    : m_file_path(std::move(file_path)), m_channels(channels), m_sample_rate(sample_rate),
+    m_chunk_frames(std::max(chunk_frames, 256u)), m_chunk_count(std::max(chunk_count, 2u)),
+    m_prefetch_frames(std::min(prefetch_frames, m_chunk_frames * (m_chunk_count - 1))) {
+  }
+
+  AudioStream::~AudioStream() {
+    if (m_decoder_opened) {
+      ma_decoder_uninit(&m_decoder);
+    }
+
+    if (m_ring_initialized) {
+      ma_pcm_rb_uninit(&m_ring);
+    }
+
+    if (m_source_initialized) {
+      ma_data_source_uninit(&m_source.base);
+    }
+  }
+
+  bool AudioStream::initialize() {
+    ma_data_source_config config = ma_data_source_config_init();
+    config.vtable = &s_vtable;
+
+    ma_result result = ma_data_source_init(&config, &m_source.base);
+    if (result != MA_SUCCESS) {
+      LOG_ERROR("[AUDIO STREAM] failed to initialize data source (error ", result, ")");
+      return false;
+    }
+    m_source.owner = this;
+    m_source_initialized = true;
+
+    result = ma_pcm_rb_init(ma_format_f32, m_channels, m_chunk_frames * m_chunk_count,
+      nullptr, nullptr, &m_ring);
+    if (result != MA_SUCCESS) {
+      LOG_ERROR("[AUDIO STREAM] failed to allocate ring buffer (error ", result, ")");
+      return false;
+    }
+    m_ring_initialized = true;
+    return true;
+  }
+
+  void AudioStream::request_refill(const Ref<AudioStream>& stream) {
+    if (stream->m_failed.load(std::memory_order_acquire)) {
+      return;
+    }
+
+    if (stream->m_end_of_file.load(std::memory_order_acquire) &&
+      !stream->m_rewind.load(std::memory_order_acquire)) {
+      return;
+    }
+
+    if (ma_pcm_rb_available_read(&stream->m_ring) >= stream->m_prefetch_frames) {
+      return;
+    }
+
+    if (stream->m_refill_pending.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+
+    auto* jobs = JobSystem::get();
+    if (jobs == nullptr) {
+      stream->refill();
+      return;
+    }
+
+    jobs->submit([stream]() { stream->refill(); }, JobQueue::Background);
+  }
+
+  size_t AudioStream::buffer_bytes() const {
+    return static_cast<size_t>(m_chunk_frames) * m_chunk_count * m_channels * sizeof(float);
+  }
+
+  AudioStream::Stats AudioStream::stats() const {
+    return Stats{
+      .decoded_frames = m_decoded_frames.load(std::memory_order_relaxed),
+      .underrun_frames = m_underrun_frames.load(std::memory_order_relaxed),
+    };
+  }
+
+  bool AudioStream::open_decoder() {
+    ma_decoder_config config =
+      ma_decoder_config_init(ma_format_f32, m_channels, m_sample_rate);
+
+    ma_result result = ma_decoder_init_file(m_file_path.c_str(), &config, &m_decoder);
+    if (result != MA_SUCCESS) {
+      LOG_ERROR("[AUDIO STREAM] failed to open '", m_file_path, "' (error ", result, ")");
+      return false;
+    }
+
+    m_decoder_opened = true;
+    return true;
+  }
+
+  // Producer side: runs on a Background job, never concurrently with itself.
+  void AudioStream::refill() {
+    ASTRA_PROFILE_N("AudioStream::refill");
+
+    if (!m_decoder_opened && !open_decoder()) {
+      m_failed.store(true, std::memory_order_release);
+      m_refill_pending.store(false, std::memory_order_release);
+      return;
+    }
+
+    if (m_rewind.exchange(false, std::memory_order_acq_rel)) {
+      ma_decoder_seek_to_pcm_frame(&m_decoder, 0);
+      m_end_of_file.store(false, std::memory_order_release);
+    }
+
+    const bool looping = ma_data_source_is_looping(data_source());
+    bool wrapped = false;
+
+    while (!m_end_of_file.load(std::memory_order_relaxed)) {
+      ma_uint32 frames = m_chunk_frames;
+      void* buffer = nullptr;
+      if (ma_pcm_rb_acquire_write(&m_ring, &frames, &buffer) != MA_SUCCESS || frames == 0) {
+        break;
+      }
+
+      ma_uint64 decoded = 0;
+      ma_result result = ma_decoder_read_pcm_frames(&m_decoder, buffer, frames, &decoded);
+      ma_pcm_rb_commit_write(&m_ring, static_cast<ma_uint32>(decoded));
+      m_decoded_frames.fetch_add(decoded, std::memory_order_relaxed);
+
+      if (decoded == frames && result == MA_SUCCESS) {
+        wrapped = false;
+        continue;
+      }
+
+      // Wrap once per short read; a second short read in a row means the
+      // file has no frames left to loop.
+      if (looping && !wrapped && (result == MA_SUCCESS || result == MA_AT_END)) {
+        ma_decoder_seek_to_pcm_frame(&m_decoder, 0);
+        wrapped = decoded == 0;
+        continue;
+      }
+
+      m_end_of_file.store(true, std::memory_order_release);
+    }
+
+    m_refill_pending.store(false, std::memory_order_release);
+  }
+
+  // Consumer side: runs on the audio thread.
+  ma_uint64 AudioStream::read(float* frames_out, ma_uint64 frame_count) {
+    ma_uint64 total = 0;
+
+    while (total < frame_count) {
+      ma_uint32 frames = static_cast<ma_uint32>(
+        std::min<ma_uint64>(frame_count - total, m_chunk_frames));
+      void* buffer = nullptr;
+      if (ma_pcm_rb_acquire_read(&m_ring, &frames, &buffer) != MA_SUCCESS || frames == 0) {
+        break;
+      }
+
+      std::memcpy(frames_out + total * m_channels, buffer,
+        static_cast<size_t>(frames) * m_channels * sizeof(float));
+      ma_pcm_rb_commit_read(&m_ring, frames);
+      total += frames;
+    }
+
+    return total;
+  }
+
+  ma_result AudioStream::on_read(ma_data_source* source, void* frames_out,
+    ma_uint64 frame_count, ma_uint64* frames_read) {
+    auto* stream = static_cast<Source*>(source)->owner;
+
+    // Sample the end flag before draining so frames committed ahead of it are
+    // never mistaken for the end of the stream.
+    const bool finished =
+      stream->m_failed.load(std::memory_order_acquire) ||
+      (stream->m_end_of_file.load(std::memory_order_acquire) &&
+        !stream->m_rewind.load(std::memory_order_acquire));
+
+    auto* output = static_cast<float*>(frames_out);
+    const ma_uint64 read = stream->read(output, frame_count);
+
+    if (read < frame_count && finished) {
+      *frames_read = read;
+      return read == 0 ? MA_AT_END : MA_SUCCESS;
+    }
+
+    if (read < frame_count) {
+      std::memset(output + read * stream->m_channels, 0,
+        static_cast<size_t>(frame_count - read) * stream->m_channels * sizeof(float));
+      stream->m_underrun_frames.fetch_add(frame_count - read, std::memory_order_relaxed);
+    }
+
+    *frames_read = frame_count;
+    return MA_SUCCESS;
+  }
+
+  // Only rewinding is supported, which is what restarting a finished sound
+  // asks for. Frames already in the ring still play before the rewound data.
+  ma_result AudioStream::on_seek(ma_data_source* source, ma_uint64 frame_index) {
+    if (frame_index != 0) {
+      return MA_NOT_IMPLEMENTED;
+    }
+
+    static_cast<Source*>(source)->owner->m_rewind.store(true, std::memory_order_release);
+    return MA_SUCCESS;
+  }
+
+  ma_result AudioStream::on_get_data_format(ma_data_source* source, ma_format* format,
+    ma_uint32* channels, ma_uint32* sample_rate, ma_channel* channel_map,
+    size_t channel_map_capacity) {
+    auto* stream = static_cast<Source*>(source)->owner;
+
+    *format = ma_format_f32;
+    *channels = stream->m_channels;
+    *sample_rate = stream->m_sample_rate;
+    ma_channel_map_init_standard(ma_standard_channel_map_default, channel_map,
+      channel_map_capacity, stream->m_channels);
+    return MA_SUCCESS;
+  }
+
+} // namespace astralix::audio
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "base.hpp"
+#include "miniaudio.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace astralix::audio {
+
+  // Data source that plays a file through a small ring buffer instead of
+  // decoding it up front. The file is opened and decoded in `chunk_frames`
+  // pieces by jobs on JobQueue::Background; the audio thread only consumes the
+  // ring, and plays silence rather than blocking when a refill is late.
+  //
+  // The ring is single-producer/single-consumer: at most one refill job runs
+  // at a time, and jobs hold a Ref so a voice can be destroyed while its last
+  // refill is still decoding.
+  class AudioStream {
+  public:
+    struct Stats {
+      uint64_t decoded_frames = 0;
+      uint64_t underrun_frames = 0;
+    };
+
+    AudioStream(std::string file_path, uint32_t channels, uint32_t sample_rate,
+      uint32_t chunk_frames, uint32_t chunk_count, uint32_t prefetch_frames);
+    ~AudioStream();
+
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+
+    bool initialize();
+    ma_data_source* data_source() { return &m_source.base; }
+
+    // Schedules a refill when the ring holds fewer than `prefetch_frames` and
+    // no refill is already running. Called once per audio frame.
+    static void request_refill(const Ref<AudioStream>& stream);
+
+    size_t buffer_bytes() const;
+    Stats stats() const;
+
+  private:
+    struct Source {
+      ma_data_source_base base;
+      AudioStream* owner;
+    };
+
+    void refill();
+    bool open_decoder();
+
+    ma_uint64 read(float* frames_out, ma_uint64 frame_count);
+
+    static ma_result on_read(ma_data_source* source, void* frames_out,
+      ma_uint64 frame_count, ma_uint64* frames_read);
+    static ma_result on_seek(ma_data_source* source, ma_uint64 frame_index);
+    static ma_result on_get_data_format(ma_data_source* source, ma_format* format,
+      ma_uint32* channels, ma_uint32* sample_rate, ma_channel* channel_map,
+      size_t channel_map_capacity);
+
+    static ma_data_source_vtable s_vtable;
+
+    std::string m_file_path;
+    uint32_t m_channels;
+    uint32_t m_sample_rate;
+    uint32_t m_chunk_frames;
+    uint32_t m_chunk_count;
+    uint32_t m_prefetch_frames;
+
+    Source m_source{};
+    ma_pcm_rb m_ring{};
+    ma_decoder m_decoder{};
+    bool m_source_initialized = false;
+    bool m_ring_initialized = false;
+    bool m_decoder_opened = false;
+
+    std::atomic<bool> m_refill_pending{false};
+    std::atomic<bool> m_rewind{false};
+    std::atomic<bool> m_end_of_file{false};
+    std::atomic<bool> m_failed{false};
+    std::atomic<uint64_t> m_decoded_frames{0};
+    std::atomic<uint64_t> m_underrun_frames{0};
+  };
+
+} // namespace astralix::audio
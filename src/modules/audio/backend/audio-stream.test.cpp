@@ -0,0 +1,151 @@
+#include "audio-stream.hpp"
+#include "helpers/audio-clips.hpp"
+#include "systems/job-system/job-system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace astralix::audio {
+namespace {
+
+// 256-frame chunks, 4 of them: a 1024-frame ring refilled below 512 frames.
+constexpr uint32_t k_chunk_frames = 256u;
+constexpr uint32_t k_chunk_count = 4u;
+constexpr uint32_t k_ring_frames = k_chunk_frames * k_chunk_count;
+constexpr uint32_t k_prefetch_frames = 512u;
+
+// Without a JobSystem, request_refill decodes inline, so every refill below
+// has landed by the time it returns.
+class AudioStreamTest : public ::testing::Test {
+protected:
+  void SetUp() override { ASSERT_EQ(JobSystem::get(), nullptr); }
+
+  Ref<AudioStream> open(const std::string &path) {
+    auto stream = create_ref<AudioStream>(path, 1u, 48000u, k_chunk_frames,
+                                          k_chunk_count, k_prefetch_frames);
+    EXPECT_TRUE(stream->initialize());
+    return stream;
+  }
+
+  static ma_result read(const Ref<AudioStream> &stream, std::vector<float> &out,
+                        ma_uint64 frame_count, ma_uint64 &frames_read) {
+    out.assign(frame_count, -1.0f);
+    return ma_data_source_read_pcm_frames(stream->data_source(), out.data(),
+                                          frame_count, &frames_read);
+  }
+};
+
+TEST_F(AudioStreamTest, HoldsOnlyTheRingInMemory) {
+  const auto path = testing::write_test_wav("stream-ramp.wav", testing::ramp_samples(10000u));
+  auto stream = open(path);
+
+  EXPECT_EQ(stream->buffer_bytes(), k_ring_frames * sizeof(float));
+  EXPECT_EQ(stream->stats().decoded_frames, 0u);
+
+  AudioStream::request_refill(stream);
+  EXPECT_EQ(stream->stats().decoded_frames, k_ring_frames);
+}
+
+TEST_F(AudioStreamTest, RefillsOnlyBelowThePrefetchThreshold) {
+  const auto path = testing::write_test_wav("stream-ramp.wav", testing::ramp_samples(10000u));
+  auto stream = open(path);
+  AudioStream::request_refill(stream);
+
+  std::vector<float> out;
+  ma_uint64 frames_read = 0;
+  ASSERT_EQ(read(stream, out, 300u, frames_read), MA_SUCCESS);
+
+  // 724 frames still buffered: above the threshold, nothing is decoded.
+  AudioStream::request_refill(stream);
+  EXPECT_EQ(stream->stats().decoded_frames, k_ring_frames);
+
+  ASSERT_EQ(read(stream, out, 300u, frames_read), MA_SUCCESS);
+
+  // 424 frames left: the refill tops the ring back up.
+  AudioStream::request_refill(stream);
+  EXPECT_EQ(stream->stats().decoded_frames, k_ring_frames + 600u);
+}
+
+TEST_F(AudioStreamTest, StreamsTheWholeFileInOrderAcrossRingWraps) {
+  constexpr uint32_t k_frames = 10000u;
+  const auto path = testing::write_test_wav("stream-ramp.wav", testing::ramp_samples(k_frames));
+  auto stream = open(path);
+
+  std::vector<float> out;
+  uint32_t expected = 0u;
+  ma_result result = MA_SUCCESS;
+  while (result == MA_SUCCESS && expected < k_frames + 1u) {
+    AudioStream::request_refill(stream);
+    ma_uint64 frames_read = 0;
+    result = read(stream, out, 300u, frames_read);
+    for (ma_uint64 frame = 0; frame < frames_read; ++frame) {
+      ASSERT_EQ(out[frame], static_cast<float>(expected)) << "frame " << expected;
+      ++expected;
+    }
+
+    // Decoding never runs more than one ring ahead of playback.
+    EXPECT_LE(stream->stats().decoded_frames, expected + k_ring_frames);
+  }
+
+  EXPECT_EQ(result, MA_AT_END);
+  EXPECT_EQ(expected, k_frames);
+  EXPECT_EQ(stream->stats().decoded_frames, k_frames);
+  EXPECT_EQ(stream->stats().underrun_frames, 0u);
+}
+
+TEST_F(AudioStreamTest, PlaysSilenceWhenARefillIsLate) {
+  const auto path = testing::write_test_wav("stream-ramp.wav", testing::ramp_samples(10000u));
+  auto stream = open(path);
+  AudioStream::request_refill(stream);
+
+  std::vector<float> out;
+  ma_uint64 frames_read = 0;
+  ASSERT_EQ(read(stream, out, k_ring_frames, frames_read), MA_SUCCESS);
+  EXPECT_EQ(out.back(), static_cast<float>(k_ring_frames - 1u));
+
+  // The ring is empty and no refill ran: the voice keeps playing silence
+  // instead of ending or blocking.
+  ASSERT_EQ(read(stream, out, 100u, frames_read), MA_SUCCESS);
+  EXPECT_EQ(frames_read, 100u);
+  EXPECT_EQ(out.front(), 0.0f);
+  EXPECT_EQ(out.back(), 0.0f);
+  EXPECT_EQ(stream->stats().underrun_frames, 100u);
+
+  // Playback resumes where decoding left off.
+  AudioStream::request_refill(stream);
+  ASSERT_EQ(read(stream, out, 1u, frames_read), MA_SUCCESS);
+  EXPECT_EQ(out.front(), static_cast<float>(k_ring_frames));
+}
+
+TEST_F(AudioStreamTest, LoopingWrapsTheDecoderToTheStart) {
+  constexpr uint32_t k_frames = 700u;
+  const auto path = testing::write_test_wav("stream-short.wav", testing::ramp_samples(k_frames));
+  auto stream = open(path);
+  ma_data_source_set_looping(stream->data_source(), MA_TRUE);
+
+  std::vector<float> out;
+  for (uint32_t played = 0u; played < 3u * k_frames;) {
+    AudioStream::request_refill(stream);
+    ma_uint64 frames_read = 0;
+    ASSERT_EQ(read(stream, out, 256u, frames_read), MA_SUCCESS);
+    for (ma_uint64 frame = 0; frame < frames_read; ++frame, ++played) {
+      ASSERT_EQ(out[frame], static_cast<float>(played % k_frames)) << "frame " << played;
+    }
+  }
+  EXPECT_EQ(stream->stats().underrun_frames, 0u);
+}
+
+TEST_F(AudioStreamTest, MissingFileEndsTheStream) {
+  auto stream = open((testing::audio_test_dir() / "missing.wav").string());
+  AudioStream::request_refill(stream);
+
+  std::vector<float> out;
+  ma_uint64 frames_read = 0;
+  EXPECT_EQ(read(stream, out, 64u, frames_read), MA_AT_END);
+  EXPECT_EQ(frames_read, 0u);
+  EXPECT_EQ(stream->stats().decoded_frames, 0u);
+}
+
+} // namespace
+} // namespace astralix::audio
@@ -0,0 +1,109 @@
+#include "voice-pool.hpp"
+#include "log.hpp"
+#include <algorithm>
+
+namespace astralix::audio {
+
+  bool VoicePool::initialize(AudioBackend& backend, uint32_t capacity) {
+    // Slots hold ma_sound nodes wired into the engine graph, so they are
+    // allocated once and never move.
+    m_slots = std::make_unique<Slot[]>(capacity);
+    m_free.clear();
+    m_active.clear();
+    m_free.reserve(capacity);
+    m_active.reserve(capacity);
+    m_stats = {};
+
+    for (uint32_t index = 0; index < capacity; ++index) {
+      if (!backend.init_buffer_voice(m_slots[index].handle)) {
+        LOG_ERROR("[VOICE POOL] only ", index, " of ", capacity, " voices initialized");
+        break;
+      }
+      m_free.push_back(index);
+    }
+
+    // Hand out low indices first.
+    std::reverse(m_free.begin(), m_free.end());
+    m_stats.capacity = static_cast<uint32_t>(m_free.size());
+    return m_stats.capacity > 0;
+  }
+
+  void VoicePool::shutdown(AudioBackend& backend) {
+    if (m_slots == nullptr) {
+      return;
+    }
+
+    const uint32_t capacity = m_stats.capacity;
+    for (uint32_t index = 0; index < capacity; ++index) {
+      backend.destroy_voice(m_slots[index].handle);
+    }
+
+    m_slots.reset();
+    m_free.clear();
+    m_active.clear();
+    m_stats.capacity = 0;
+    m_stats.active = 0;
+  }
+
+  void VoicePool::reclaim_finished(AudioBackend& backend) {
+    std::erase_if(m_active, [&](uint32_t index) {
+      if (!backend.voice_at_end(m_slots[index].handle)) {
+        return false;
+      }
+
+      m_free.push_back(index);
+      return true;
+      });
+
+    m_stats.active = static_cast<uint32_t>(m_active.size());
+  }
+
+  VoiceHandle* VoicePool::acquire(AudioBackend& backend, const DecodedClip& clip,
+    uint8_t priority, float distance) {
+    uint32_t index = 0;
+
+    if (!m_free.empty()) {
+      index = m_free.back();
+      m_free.pop_back();
+      m_active.push_back(index);
+    } else {
+      if (m_active.empty()) {
+        ++m_stats.dropped;
+        return nullptr;
+      }
+
+      size_t victim = 0;
+      for (size_t candidate = 1; candidate < m_active.size(); ++candidate) {
+        const auto& current = m_slots[m_active[victim]];
+        const auto& other = m_slots[m_active[candidate]];
+
+        if (other.priority < current.priority ||
+          (other.priority == current.priority && other.distance > current.distance)) {
+          victim = candidate;
+        }
+      }
+
+      const auto& weakest = m_slots[m_active[victim]];
+      if (weakest.priority > priority ||
+        (weakest.priority == priority && weakest.distance <= distance)) {
+        ++m_stats.dropped;
+        return nullptr;
+      }
+
+      index = m_active[victim];
+      backend.voice_halt(m_slots[index].handle);
+      ++m_stats.stolen;
+    }
+
+    auto& slot = m_slots[index];
+    slot.priority = priority;
+    slot.distance = distance;
+    backend.voice_bind_clip(slot.handle, clip);
+
+    ++m_stats.started;
+    m_stats.active = static_cast<uint32_t>(m_active.size());
+    m_stats.peak_active = std::max(m_stats.peak_active, m_stats.active);
+    return &slot.handle;
+  }
+
+} // namespace astralix::audio
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "audio-backend.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace astralix::audio {
+
+  // Fixed set of clip-backed voices created once at setup. Starting a sound
+  // rebinds an idle voice to a cached clip instead of opening a file, so the
+  // hot path never decodes or allocates. When every voice is busy the request
+  // steals the voice with the lowest priority, preferring the farthest one
+  // among equals, or is dropped if every playing voice outranks it.
+  class VoicePool {
+  public:
+    struct Stats {
+      uint32_t capacity = 0;
+      uint32_t active = 0;
+      uint32_t peak_active = 0;
+      uint64_t started = 0;
+      uint64_t stolen = 0;
+      uint64_t dropped = 0;
+    };
+
+    bool initialize(AudioBackend& backend, uint32_t capacity);
+    void shutdown(AudioBackend& backend);
+
+    // Returns voices that finished playing to the free list.
+    void reclaim_finished(AudioBackend& backend);
+
+    // Binds `clip` to a stopped voice and returns it, or null when the request
+    // lost to every playing voice. The caller configures and starts it.
+    VoiceHandle* acquire(AudioBackend& backend, const DecodedClip& clip,
+      uint8_t priority, float distance);
+
+    const Stats& stats() const { return m_stats; }
+
+  private:
+    struct Slot {
+      VoiceHandle handle;
+      uint8_t priority = 0;
+      float distance = 0.0f;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::vector<uint32_t> m_free;
+    std::vector<uint32_t> m_active;
+    Stats m_stats;
+  };
+
+} // namespace astralix::audio
@@ -0,0 +1,88 @@
+#include "voice-pool.hpp"
+#include "helpers/audio-clips.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+namespace astralix::audio {
+namespace {
+
+class VoicePoolTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(m_backend.initialize(1u, true));
+    // Ten seconds of silence, so no voice finishes while a test runs.
+    const auto path = testing::write_test_wav(
+        "pool-long.wav", std::vector<float>(480000u, 0.0f), 1u, 48000u);
+    m_clip = m_backend.clip_cache().load("long", path);
+    ASSERT_NE(m_clip, nullptr);
+    ASSERT_TRUE(m_pool.initialize(m_backend, 4u));
+  }
+
+  void TearDown() override {
+    m_pool.shutdown(m_backend);
+    m_backend.shutdown();
+  }
+
+  AudioBackend m_backend;
+  VoicePool m_pool;
+  const DecodedClip *m_clip = nullptr;
+};
+
+TEST_F(VoicePoolTest, StealsTheLowestPriorityThenFarthestVoice) {
+  VoiceHandle *voices[4] = {};
+  for (int index = 0; index < 4; ++index) {
+    voices[index] = m_pool.acquire(m_backend, *m_clip, 100u, static_cast<float>(index));
+    ASSERT_NE(voices[index], nullptr);
+  }
+  EXPECT_EQ(m_pool.stats().active, 4u);
+
+  // Outranked by every playing voice: dropped.
+  EXPECT_EQ(m_pool.acquire(m_backend, *m_clip, 50u, 0.0f), nullptr);
+  // Same priority but farther than the farthest voice: dropped.
+  EXPECT_EQ(m_pool.acquire(m_backend, *m_clip, 100u, 10.0f), nullptr);
+  EXPECT_EQ(m_pool.stats().dropped, 2u);
+
+  // Same priority and closer: takes the farthest voice.
+  EXPECT_EQ(m_pool.acquire(m_backend, *m_clip, 100u, 1.5f), voices[3]);
+  // Higher priority: takes the farthest of the lowest-priority voices, which
+  // is now the one at distance 2.
+  EXPECT_EQ(m_pool.acquire(m_backend, *m_clip, 200u, 99.0f), voices[2]);
+
+  const auto &stats = m_pool.stats();
+  EXPECT_EQ(stats.stolen, 2u);
+  EXPECT_EQ(stats.started, 6u);
+  EXPECT_EQ(stats.active, 4u);
+  EXPECT_EQ(stats.peak_active, 4u);
+  EXPECT_EQ(stats.capacity, 4u);
+}
+
+TEST_F(VoicePoolTest, ReclaimsFinishedVoices) {
+  const auto path = testing::write_test_wav(
+      "pool-blip.wav", std::vector<float>(480u, 0.0f), 1u, 48000u);
+  const DecodedClip *blip = m_backend.clip_cache().load("blip", path);
+  ASSERT_NE(blip, nullptr);
+
+  VoiceHandle *voice = m_pool.acquire(m_backend, *blip, 100u, 0.0f);
+  ASSERT_NE(voice, nullptr);
+  m_backend.voice_start(*voice);
+  EXPECT_EQ(m_pool.stats().active, 1u);
+
+  // The null device mixes in real time; ten milliseconds of audio ends well
+  // within the deadline.
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (m_pool.stats().active != 0u && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    m_pool.reclaim_finished(m_backend);
+  }
+  EXPECT_EQ(m_pool.stats().active, 0u);
+
+  // The reclaimed voice is handed out again instead of stealing.
+  EXPECT_EQ(m_pool.acquire(m_backend, *m_clip, 1u, 0.0f), voice);
+  EXPECT_EQ(m_pool.stats().stolen, 0u);
+}
+
+} // namespace
+} // namespace astralix::audio
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "backend/audio-backend.hpp"
+#include "backend/voice-pool.hpp"
 #include "base.hpp"
 #include "components/audio-emitter.hpp"
 #include "components/audio-listener.hpp"
@@ -51,6 +52,22 @@ namespace astralix::audio {
     float gain = 1.0f;
     float pitch = 1.0f;
     bool spatial = true;
+    uint8_t priority = 128;
+  };
+
+  // Voice state kept per emitter. While the emitter is outside the audibility
+  // budget `handle` is null and only `cursor_seconds` advances, so a virtual
+  // voice costs no miniaudio work until it is heard again.
+  struct EmitterVoice {
+    Scope<VoiceHandle> handle;
+    std::string clip_id;
+    double cursor_seconds = 0.0;
+    double length_seconds = 0.0;
+    float audibility = 0.0f;
+    bool audible = false;
+    uint64_t seen_epoch = 0;
+
+    bool is_virtual() const { return handle == nullptr; }
   };
 
   struct SceneStateData {
@@ -63,10 +80,11 @@ namespace astralix::audio {
   struct AudioFrame {
     ListenerData listener;
     std::vector<EmitterData> emitters;
-    std::unordered_map<EntityID, Scope<VoiceHandle>> voices;
-    std::vector<Scope<VoiceHandle>> one_shots;
+    std::unordered_map<EntityID, EmitterVoice> voices;
+    VoicePool one_shots;
     std::vector<OneShotRequest> one_shot_queue;
     SceneStateData scene_state;
+    double delta_time = 0.0;
 
     void clear_transient() {
       listener = {};
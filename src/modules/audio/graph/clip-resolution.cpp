@@ -0,0 +1,52 @@
+#include "clip-resolution.hpp"
+#include "log.hpp"
+#include "managers/path-manager.hpp"
+#include "managers/resource-manager.hpp"
+#include "resources/descriptors/audio-clip-descriptor.hpp"
+#include <algorithm>
+
+namespace astralix::audio {
+
+const DecodedClip *resolve_clip(AudioBackend &backend, const std::string &clip_id) {
+  auto &cache = backend.clip_cache();
+  if (const auto *clip = cache.find(clip_id); clip != nullptr) {
+    return clip->valid() ? clip : nullptr;
+  }
+
+  auto descriptor =
+      resource_manager()->get_descriptor_by_id<AudioClipDescriptor>(clip_id);
+
+  if (descriptor == nullptr) {
+    LOG_ERROR("[AUDIO] unknown clip_id '", clip_id, "'");
+    return nullptr;
+  }
+
+  return cache.load(clip_id, path_manager()->resolve(descriptor->path).string());
+}
+
+Scope<VoiceHandle> create_clip_voice(AudioBackend &backend,
+                                     const std::string &clip_id, bool spatial) {
+  auto descriptor =
+      resource_manager()->get_descriptor_by_id<AudioClipDescriptor>(clip_id);
+
+  if (descriptor != nullptr && descriptor->streaming.enabled) {
+    const auto &streaming = descriptor->streaming;
+    const float threshold = std::clamp(streaming.prefetch_threshold, 0.0f, 1.0f);
+    const auto prefetch_frames = static_cast<uint32_t>(
+        threshold * static_cast<float>(streaming.chunk_frames) *
+        static_cast<float>(streaming.chunk_count));
+
+    return backend.create_stream_voice(
+        path_manager()->resolve(descriptor->path).string(),
+        streaming.chunk_frames, streaming.chunk_count, prefetch_frames, spatial);
+  }
+
+  const auto *clip = resolve_clip(backend, clip_id);
+  if (clip == nullptr) {
+    return nullptr;
+  }
+
+  return backend.create_voice(*clip, spatial);
+}
+
+} // namespace astralix::audio
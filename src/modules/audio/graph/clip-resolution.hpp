@@ -0,0 +1,17 @@
+#pragma once
+
+#include "backend/audio-backend.hpp"
+#include <string>
+
+namespace astralix::audio {
+
+// Looks `clip_id` up in the backend's clip cache, decoding the descriptor's
+// file on first use. Returns null for unknown or undecodable clips.
+const DecodedClip *resolve_clip(AudioBackend &backend, const std::string &clip_id);
+
+// Creates a voice for an emitter: streamed descriptors get a ring-buffered
+// stream voice that never blocks, the rest play from the clip cache.
+Scope<VoiceHandle> create_clip_voice(AudioBackend &backend,
+                                     const std::string &clip_id, bool spatial);
+
+} // namespace astralix::audio
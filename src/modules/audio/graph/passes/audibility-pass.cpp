@@ -0,0 +1,145 @@
+#include "audibility-pass.hpp"
+#include "graph/clip-resolution.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace astralix::audio {
+
+namespace {
+
+// Roughly -60 dB; quieter emitters are never worth a voice.
+constexpr float k_audibility_floor = 0.001f;
+
+// Ranking bonus for emitters that already own a voice, so two emitters of
+// nearly equal loudness do not swap voices every frame.
+constexpr float k_real_voice_bias = 1.1f;
+
+// Mirrors miniaudio's default inverse-distance attenuation, except that
+// anything past max_distance counts as silent.
+float estimate_audibility(const EmitterData &emitter, const ListenerData &listener) {
+  float gain = emitter.gain * listener.gain;
+  if (!emitter.spatial || !listener.valid) {
+    return gain;
+  }
+
+  const float distance = glm::distance(emitter.position, listener.position);
+  if (distance >= emitter.max_distance) {
+    return 0.0f;
+  }
+
+  const float min_distance = std::max(emitter.min_distance, 0.0001f);
+  if (distance <= min_distance) {
+    return gain;
+  }
+
+  return gain * min_distance /
+         (min_distance + emitter.rolloff * (distance - min_distance));
+}
+
+void virtualize(AudioBackend &backend, EmitterVoice &voice) {
+  voice.cursor_seconds = backend.voice_cursor_seconds(*voice.handle);
+  backend.destroy_voice(*voice.handle);
+  voice.handle.reset();
+}
+
+bool realize(AudioBackend &backend, EmitterVoice &voice, bool spatial) {
+  voice.handle = create_clip_voice(backend, voice.clip_id, spatial);
+  if (voice.handle == nullptr) {
+    return false;
+  }
+
+  if (voice.length_seconds <= 0.0) {
+    voice.length_seconds = backend.voice_length_seconds(*voice.handle);
+  }
+
+  if (voice.cursor_seconds > 0.0) {
+    backend.voice_seek_seconds(*voice.handle, voice.cursor_seconds);
+  }
+  return true;
+}
+
+} // namespace
+
+void AudibilityPass::process(AudioFrame &frame, AudioBackend &backend) {
+  ASTRA_PROFILE_N("AudibilityPass::process");
+
+  if (!frame.scene_state.active) {
+    return;
+  }
+
+  m_candidates.clear();
+  for (const auto &emitter : frame.emitters) {
+    auto iterator = frame.voices.find(emitter.entity_id);
+    if (iterator == frame.voices.end()) {
+      continue;
+    }
+
+    auto &voice = iterator->second;
+    voice.audibility = estimate_audibility(emitter, frame.listener);
+    voice.audible = false;
+
+    if (voice.audibility < k_audibility_floor) {
+      continue;
+    }
+
+    const float rank =
+        voice.is_virtual() ? voice.audibility : voice.audibility * k_real_voice_bias;
+    m_candidates.emplace_back(rank, &voice);
+  }
+
+  if (m_candidates.size() > m_voice_budget) {
+    std::nth_element(m_candidates.begin(), m_candidates.begin() + m_voice_budget,
+                     m_candidates.end(), [](const auto &lhs, const auto &rhs) {
+                       return lhs.first > rhs.first;
+                     });
+    m_candidates.resize(m_voice_budget);
+  }
+
+  for (auto &[rank, voice] : m_candidates) {
+    voice->audible = true;
+  }
+
+  // Release voices first so the budget is never exceeded mid-frame.
+  uint32_t virtualized = 0;
+  for (auto &[entity_id, voice] : frame.voices) {
+    if (!voice.audible && !voice.is_virtual()) {
+      virtualize(backend, voice);
+      ++virtualized;
+    }
+  }
+
+  uint32_t realized = 0;
+  uint32_t real_count = 0;
+  for (const auto &emitter : frame.emitters) {
+    auto iterator = frame.voices.find(emitter.entity_id);
+    if (iterator == frame.voices.end()) {
+      continue;
+    }
+
+    auto &voice = iterator->second;
+    if (voice.audible) {
+      if (voice.is_virtual() && realize(backend, voice, emitter.spatial)) {
+        ++realized;
+      }
+      real_count += voice.is_virtual() ? 0u : 1u;
+      continue;
+    }
+
+    // Virtual voices keep time the way PlayStatePass would have played them.
+    if (frame.scene_state.playing && emitter.play_on_awake) {
+      voice.cursor_seconds += frame.delta_time * emitter.pitch;
+      if (voice.length_seconds > 0.0) {
+        voice.cursor_seconds = std::fmod(voice.cursor_seconds, voice.length_seconds);
+      }
+    }
+  }
+
+  ASTRA_PROFILE_PLOT("Audio real voices", static_cast<int64_t>(real_count));
+  ASTRA_PROFILE_PLOT("Audio virtual voices",
+                     static_cast<int64_t>(frame.voices.size() - real_count));
+  ASTRA_PROFILE_PLOT("Audio voices realized", static_cast<int64_t>(realized));
+  ASTRA_PROFILE_PLOT("Audio voices virtualized", static_cast<int64_t>(virtualized));
+}
+
+} // namespace astralix::audio
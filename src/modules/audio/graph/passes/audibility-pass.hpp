@@ -0,0 +1,32 @@
+#pragma once
+
+#include "graph/audio-pass.hpp"
+#include <utility>
+#include <vector>
+
+namespace astralix::audio {
+
+// Ranks emitters by estimated loudness at the listener and keeps a real voice
+// only for the loudest `voice_budget` of them. Emitters past `max_distance`
+// or below the audibility floor become virtual: their voice is released and
+// only a playback cursor advances, so realizing them later resumes in place.
+class AudibilityPass : public AudioPass {
+public:
+  explicit AudibilityPass(uint32_t voice_budget) : m_voice_budget(voice_budget) {}
+
+  void process(AudioFrame &frame, AudioBackend &backend) override;
+  std::string_view name() const override { return "Audibility"; }
+  std::span<const FrameField> reads() const override { return s_reads; }
+  std::span<const FrameField> writes() const override { return s_writes; }
+
+private:
+  static constexpr FrameField s_reads[] = {
+      FrameField::Listener, FrameField::Emitters, FrameField::Voices,
+      FrameField::SceneState};
+  static constexpr FrameField s_writes[] = {FrameField::Voices};
+
+  uint32_t m_voice_budget;
+  std::vector<std::pair<float, EmitterVoice *>> m_candidates;
+};
+
+} // namespace astralix::audio
@@ -0,0 +1,249 @@
+#include "audibility-pass.hpp"
+#include "emitter-sync-pass.hpp"
+#include "play-state-pass.hpp"
+#include "spatial-update-pass.hpp"
+#include "graph/audio-graph.hpp"
+#include "helpers/audio-clips.hpp"
+#include "helpers/benchmark.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+namespace astralix::audio {
+namespace {
+
+// With min_distance 1 and rolloff 1, an emitter `d` units from the listener
+// is heard at gain 1 / d.
+class AudibilityPassTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(m_backend.initialize(1u, true));
+    // Ten seconds of silence, so cursors have room to move.
+    const auto path = testing::write_test_wav(
+        "audibility-long.wav", std::vector<float>(480000u, 0.0f), 1u, 48000u);
+    ASSERT_NE(m_backend.clip_cache().load("long", path), nullptr);
+
+    m_frame.scene_state = {.active = true, .playing = true};
+    m_frame.listener.valid = true;
+  }
+
+  void TearDown() override {
+    for (auto &[entity_id, voice] : m_frame.voices) {
+      if (!voice.is_virtual()) {
+        m_backend.destroy_voice(*voice.handle);
+      }
+    }
+    m_frame.voices.clear();
+    m_backend.shutdown();
+  }
+
+  // Emitters keep their voice entry across frames, the way EmitterSyncPass
+  // leaves it.
+  EmitterData &add_emitter(EntityID id, float distance) {
+    m_frame.voices.try_emplace(id, EmitterVoice{.clip_id = "long"});
+    return m_frame.emitters.emplace_back(EmitterData{
+        .entity_id = id,
+        .position = glm::vec3(distance, 0.0f, 0.0f),
+        .clip_id = "long",
+    });
+  }
+
+  EmitterVoice &voice(EntityID id) { return m_frame.voices.at(id); }
+
+  uint32_t real_voice_count() const {
+    uint32_t count = 0u;
+    for (const auto &[entity_id, voice] : m_frame.voices) {
+      count += voice.is_virtual() ? 0u : 1u;
+    }
+    return count;
+  }
+
+  AudioBackend m_backend;
+  AudioFrame m_frame;
+};
+
+TEST_F(AudibilityPassTest, KeepsRealVoicesForTheLoudestEmittersOnly) {
+  AudibilityPass pass(2u);
+  add_emitter(1u, 8.0f);
+  add_emitter(2u, 2.0f);
+  add_emitter(3u, 16.0f);
+  add_emitter(4u, 4.0f);
+
+  pass.process(m_frame, m_backend);
+
+  EXPECT_EQ(real_voice_count(), 2u);
+  EXPECT_FALSE(voice(2u).is_virtual());
+  EXPECT_FALSE(voice(4u).is_virtual());
+  EXPECT_TRUE(voice(1u).is_virtual());
+  EXPECT_TRUE(voice(3u).is_virtual());
+  EXPECT_TRUE(voice(2u).audible);
+  EXPECT_FALSE(voice(1u).audible);
+  EXPECT_FLOAT_EQ(voice(4u).audibility, 0.25f);
+}
+
+TEST_F(AudibilityPassTest, NeverRealizesEmittersPastMaxDistance) {
+  AudibilityPass pass(8u);
+  add_emitter(1u, 2.0f);
+  add_emitter(2u, 150.0f);
+  // Inside max_distance but below the audibility floor.
+  add_emitter(3u, 2000.0f).max_distance = 5000.0f;
+
+  pass.process(m_frame, m_backend);
+
+  EXPECT_FALSE(voice(1u).is_virtual());
+  EXPECT_TRUE(voice(2u).is_virtual());
+  EXPECT_EQ(voice(2u).audibility, 0.0f);
+  EXPECT_TRUE(voice(3u).is_virtual());
+}
+
+TEST_F(AudibilityPassTest, DemotesAndPromotesVoicesInPlace) {
+  AudibilityPass pass(1u);
+  add_emitter(1u, 2.0f);
+  pass.process(m_frame, m_backend);
+  ASSERT_FALSE(voice(1u).is_virtual());
+  m_backend.voice_seek_seconds(*voice(1u).handle, 3.0);
+
+  // A louder emitter takes the only voice; the demoted one keeps its place.
+  add_emitter(2u, 1.5f);
+  pass.process(m_frame, m_backend);
+  ASSERT_TRUE(voice(1u).is_virtual());
+  EXPECT_FALSE(voice(2u).is_virtual());
+  EXPECT_NEAR(voice(1u).cursor_seconds, 3.0, 1e-3);
+  EXPECT_NEAR(voice(1u).length_seconds, 10.0, 1e-3);
+
+  // While virtual, the cursor advances by delta_time * pitch.
+  m_frame.delta_time = 0.5;
+  m_frame.emitters[0].pitch = 2.0f;
+  pass.process(m_frame, m_backend);
+  EXPECT_NEAR(voice(1u).cursor_seconds, 4.0, 1e-3);
+
+  // The louder emitter walks out of range: the voice is realized again and
+  // resumes where the cursor got to.
+  m_frame.emitters[1].position.x = 200.0f;
+  pass.process(m_frame, m_backend);
+  ASSERT_FALSE(voice(1u).is_virtual());
+  EXPECT_TRUE(voice(2u).is_virtual());
+  EXPECT_NEAR(m_backend.voice_cursor_seconds(*voice(1u).handle), 4.0, 1e-3);
+}
+
+TEST_F(AudibilityPassTest, VirtualCursorsWrapAtTheClipLength) {
+  AudibilityPass pass(1u);
+  add_emitter(1u, 2.0f);
+  add_emitter(2u, 4.0f);
+  pass.process(m_frame, m_backend);
+  ASSERT_TRUE(voice(2u).is_virtual());
+
+  voice(2u).length_seconds = 10.0;
+  voice(2u).cursor_seconds = 9.5;
+  m_frame.delta_time = 1.0;
+  pass.process(m_frame, m_backend);
+  EXPECT_NEAR(voice(2u).cursor_seconds, 0.5, 1e-9);
+
+  // Emitters that do not play on awake stay where they are.
+  m_frame.emitters[1].play_on_awake = false;
+  pass.process(m_frame, m_backend);
+  EXPECT_NEAR(voice(2u).cursor_seconds, 0.5, 1e-9);
+}
+
+TEST_F(AudibilityPassTest, RealVoicesHoldOffNearlyEqualChallengers) {
+  AudibilityPass pass(1u);
+  add_emitter(1u, 2.0f);
+  pass.process(m_frame, m_backend);
+  const VoiceHandle *held = voice(1u).handle.get();
+  ASSERT_NE(held, nullptr);
+
+  // 1 / 1.9 is louder than 1 / 2, but not by the real-voice bias.
+  add_emitter(2u, 1.9f);
+  pass.process(m_frame, m_backend);
+  EXPECT_EQ(voice(1u).handle.get(), held);
+  EXPECT_TRUE(voice(2u).is_virtual());
+
+  // Clearly louder: the voice moves.
+  m_frame.emitters[1].position.x = 1.2f;
+  pass.process(m_frame, m_backend);
+  EXPECT_TRUE(voice(1u).is_virtual());
+  EXPECT_FALSE(voice(2u).is_virtual());
+}
+
+TEST_F(AudibilityPassTest, InactiveScenesLeaveVoicesAlone) {
+  AudibilityPass pass(1u);
+  add_emitter(1u, 2.0f);
+  pass.process(m_frame, m_backend);
+  ASSERT_FALSE(voice(1u).is_virtual());
+
+  m_frame.scene_state.active = false;
+  m_frame.emitters[0].position.x = 500.0f;
+  pass.process(m_frame, m_backend);
+  EXPECT_FALSE(voice(1u).is_virtual());
+}
+
+// 10k looping emitters on a 100 x 100 grid, 3 units apart, heard by a
+// listener sweeping across it. Only the budget's worth of them ever hold a
+// miniaudio voice.
+TEST(AudioBudgetBenchmark, DISABLED_TenThousandEmitters) {
+  constexpr uint32_t k_emitter_count = 10000u;
+  constexpr uint32_t k_voice_budget = 32u;
+  constexpr int k_frames = 120;
+
+  AudioBackend backend;
+  ASSERT_TRUE(backend.initialize(1u, true));
+  const auto path = testing::write_test_wav(
+      "budget-tone.wav", std::vector<float>(48000u, 0.0f), 1u, 48000u);
+  ASSERT_NE(backend.clip_cache().load("tone", path), nullptr);
+
+  AudioGraph graph;
+  graph.add_pass(create_scope<EmitterSyncPass>());
+  graph.add_pass(create_scope<AudibilityPass>(k_voice_budget));
+  graph.add_pass(create_scope<SpatialUpdatePass>());
+  graph.add_pass(create_scope<PlayStatePass>());
+  graph.compile();
+
+  AudioFrame frame;
+  graph.setup(frame, backend);
+
+  double total_ms = 0.0;
+  double worst_ms = 0.0;
+  for (int index = 0; index < k_frames; ++index) {
+    frame.clear_transient();
+    frame.delta_time = 1.0 / 60.0;
+    frame.scene_state = {.active = true, .playing = true, .scene_changed = index == 0};
+    frame.listener.valid = true;
+    frame.listener.position = glm::vec3(static_cast<float>(index), 0.0f, 0.0f);
+    for (uint32_t emitter = 0u; emitter < k_emitter_count; ++emitter) {
+      frame.emitters.push_back(EmitterData{
+          .entity_id = emitter + 1u,
+          .position = glm::vec3(static_cast<float>(emitter % 100u) * 3.0f, 0.0f,
+                                static_cast<float>(emitter / 100u) * 3.0f),
+          .clip_id = "tone",
+          .looping = true,
+          .max_distance = 50.0f,
+      });
+    }
+
+    const double ms = testing::elapsed_ms([&] { graph.process(frame, backend); });
+    // The first frame creates every entry; the rest are steady state.
+    if (index > 0) {
+      total_ms += ms;
+      worst_ms = std::max(worst_ms, ms);
+    }
+
+    uint32_t real = 0u;
+    for (const auto &[entity_id, voice] : frame.voices) {
+      real += voice.is_virtual() ? 0u : 1u;
+    }
+    ASSERT_LE(real, k_voice_budget);
+  }
+
+  graph.teardown(frame, backend);
+  backend.shutdown();
+
+  const double average_ms = total_ms / static_cast<double>(k_frames - 1);
+  std::printf("[AudioBudgetBenchmark] %u emitters, %u voices: %.3f ms/frame, worst %.3f ms\n",
+              k_emitter_count, k_voice_budget, average_ms, worst_ms);
+  testing::record_ms("frame", average_ms);
+  testing::record_ms("worst_frame", worst_ms);
+}
+
+} // namespace
+} // namespace astralix::audio
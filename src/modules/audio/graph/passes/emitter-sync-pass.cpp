@@ -1,75 +1,62 @@
 #include "emitter-sync-pass.hpp"
-#include "managers/path-manager.hpp"
-#include "managers/resource-manager.hpp"
-#include "resources/descriptors/audio-clip-descriptor.hpp"
-#include <unordered_set>
 
 namespace astralix::audio {
 
+namespace {
+
+void release_voice(AudioBackend &backend, EmitterVoice &voice) {
+  if (voice.handle != nullptr) {
+    backend.destroy_voice(*voice.handle);
+    voice.handle.reset();
+  }
+}
+
+} // namespace
+
 void EmitterSyncPass::process(AudioFrame &frame, AudioBackend &backend) {
   if (!frame.scene_state.active) {
-    for (auto &[entity_id, handle] : frame.voices) {
-      backend.destroy_voice(*handle);
+    for (auto &[entity_id, voice] : frame.voices) {
+      release_voice(backend, voice);
     }
     frame.voices.clear();
     return;
   }
 
   if (frame.scene_state.scene_changed) {
-    for (auto &[entity_id, handle] : frame.voices) {
-      backend.destroy_voice(*handle);
+    for (auto &[entity_id, voice] : frame.voices) {
+      release_voice(backend, voice);
     }
     frame.voices.clear();
   }
 
-  std::unordered_set<EntityID> active_entities;
-  active_entities.reserve(frame.emitters.size());
-  for (const auto &emitter : frame.emitters) {
-    active_entities.insert(emitter.entity_id);
-  }
-
-  std::vector<EntityID> stale_entities;
-  for (const auto &[entity_id, handle] : frame.voices) {
-    if (!active_entities.contains(entity_id)) {
-      backend.destroy_voice(*handle);
-      stale_entities.push_back(entity_id);
-    }
-  }
-  for (EntityID entity_id : stale_entities) {
-    frame.voices.erase(entity_id);
-  }
-
+  // Mark every emitter seen this frame, creating entries for new ones, then
+  // sweep the entries that were not marked.
+  ++m_epoch;
   for (const auto &emitter : frame.emitters) {
-    if (frame.voices.contains(emitter.entity_id)) {
-      continue;
-    }
-
     if (emitter.clip_id.empty()) {
       continue;
     }
 
-    auto descriptor =
-        resource_manager()->get_descriptor_by_id<AudioClipDescriptor>(emitter.clip_id);
-
-    if (descriptor == nullptr) {
-      LOG_ERROR("[EMITTER SYNC] unknown clip_id '", emitter.clip_id, "'");
-      continue;
-    }
-
-    std::string resolved_path = path_manager()->resolve(descriptor->path).string();
-    auto handle = backend.create_voice(resolved_path, emitter.spatial);
+    // Entries start virtual; AudibilityPass decides which ones get a voice.
+    auto [iterator, inserted] = frame.voices.try_emplace(
+        emitter.entity_id, EmitterVoice{.clip_id = emitter.clip_id});
+    iterator->second.seen_epoch = m_epoch;
+  }
 
-    if (handle == nullptr) {
+  for (auto iterator = frame.voices.begin(); iterator != frame.voices.end();) {
+    if (iterator->second.seen_epoch == m_epoch) {
+      ++iterator;
       continue;
     }
 
-    frame.voices.emplace(emitter.entity_id, std::move(handle));
+    release_voice(backend, iterator->second);
+    iterator = frame.voices.erase(iterator);
   }
 }
 
 void EmitterSyncPass::teardown(AudioFrame &frame, AudioBackend &backend) {
-  for (auto &[entity_id, handle] : frame.voices) {
-    backend.destroy_voice(*handle);
+  for (auto &[entity_id, voice] : frame.voices) {
+    release_voice(backend, voice);
   }
   frame.voices.clear();
 }
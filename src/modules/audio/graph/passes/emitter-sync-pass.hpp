@@ -15,6 +15,8 @@ public:
 private:
   static constexpr FrameField s_reads[] = {FrameField::Emitters, FrameField::SceneState};
   static constexpr FrameField s_writes[] = {FrameField::Voices};
+
+  uint64_t m_epoch = 0;
 };
 
 } // namespace astralix::audio
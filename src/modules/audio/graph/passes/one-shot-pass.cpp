@@ -1,35 +1,35 @@
 #include "one-shot-pass.hpp"
-#include "managers/path-manager.hpp"
-#include "managers/resource-manager.hpp"
-#include "resources/descriptors/audio-clip-descriptor.hpp"
+#include "graph/clip-resolution.hpp"
+#include "trace.hpp"
 
 namespace astralix::audio {
 
+  void OneShotPass::setup(AudioFrame& frame, AudioBackend& backend) {
+    frame.one_shots.initialize(backend, m_voice_capacity);
+  }
+
   void OneShotPass::process(AudioFrame& frame, AudioBackend& backend) {
-    std::erase_if(frame.one_shots, [&](const Scope<VoiceHandle>& handle) {
-      if (backend.voice_at_end(*handle)) {
-        backend.destroy_voice(*handle);
-        return true;
-      }
-      return false;
-      });
+    ASTRA_PROFILE_N("OneShotPass::process");
 
-    for (auto& request : frame.one_shot_queue) {
-      auto descriptor =
-        resource_manager()->get_descriptor_by_id<AudioClipDescriptor>(request.clip_id);
+    frame.one_shots.reclaim_finished(backend);
 
-      if (descriptor == nullptr) {
-        LOG_ERROR("[ONE SHOT] unknown clip_id '", request.clip_id, "'");
+    for (auto& request : frame.one_shot_queue) {
+      const auto* clip = resolve_clip(backend, request.clip_id);
+      if (clip == nullptr) {
         continue;
       }
 
-      std::string resolved_path = path_manager()->resolve(descriptor->path).string();
-      auto handle = backend.create_voice(resolved_path, request.spatial);
+      const float distance =
+        request.spatial && frame.listener.valid
+        ? glm::distance(request.position, frame.listener.position)
+        : 0.0f;
 
+      auto* handle = frame.one_shots.acquire(backend, *clip, request.priority, distance);
       if (handle == nullptr) {
         continue;
       }
 
+      backend.voice_set_spatial(*handle, request.spatial);
       if (request.spatial) {
         backend.voice_set_position(*handle, request.position);
       }
@@ -37,18 +37,20 @@ namespace astralix::audio {
       backend.voice_set_volume(*handle, request.gain);
       backend.voice_set_pitch(*handle, request.pitch);
       backend.voice_start(*handle);
-
-      frame.one_shots.push_back(std::move(handle));
     }
 
     frame.one_shot_queue.clear();
+
+    const auto& cache_stats = backend.clip_cache().stats();
+    const auto& voice_stats = frame.one_shots.stats();
+    ASTRA_PROFILE_PLOT("Audio clip cache hits", static_cast<int64_t>(cache_stats.hits));
+    ASTRA_PROFILE_PLOT("Audio clip cache misses", static_cast<int64_t>(cache_stats.misses));
+    ASTRA_PROFILE_PLOT("Audio one-shot voices", static_cast<int64_t>(voice_stats.active));
+    ASTRA_PROFILE_PLOT("Audio one-shot steals", static_cast<int64_t>(voice_stats.stolen));
   }
 
   void OneShotPass::teardown(AudioFrame& frame, AudioBackend& backend) {
-    for (auto& handle : frame.one_shots) {
-      backend.destroy_voice(*handle);
-    }
-    frame.one_shots.clear();
+    frame.one_shots.shutdown(backend);
   }
 
 } // namespace astralix::audio
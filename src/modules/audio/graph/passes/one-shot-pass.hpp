@@ -6,6 +6,10 @@ namespace astralix::audio {
 
 class OneShotPass : public AudioPass {
 public:
+  explicit OneShotPass(uint32_t voice_capacity)
+      : m_voice_capacity(voice_capacity) {}
+
+  void setup(AudioFrame &frame, AudioBackend &backend) override;
   void process(AudioFrame &frame, AudioBackend &backend) override;
   void teardown(AudioFrame &frame, AudioBackend &backend) override;
   std::string_view name() const override { return "OneShot"; }
@@ -13,7 +17,9 @@ public:
   std::span<const FrameField> writes() const override { return {}; }
 
 private:
-  static constexpr FrameField s_reads[] = {FrameField::OneShotQueue};
+  uint32_t m_voice_capacity;
+  static constexpr FrameField s_reads[] = {FrameField::OneShotQueue,
+                                          FrameField::Listener};
 };
 
 } // namespace astralix::audio
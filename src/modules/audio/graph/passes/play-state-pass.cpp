@@ -9,11 +9,11 @@ void PlayStatePass::process(AudioFrame &frame, AudioBackend &backend) {
 
   for (const auto &emitter : frame.emitters) {
     auto iterator = frame.voices.find(emitter.entity_id);
-    if (iterator == frame.voices.end()) {
+    if (iterator == frame.voices.end() || iterator->second.is_virtual()) {
       continue;
     }
 
-    auto &handle = *iterator->second;
+    auto &handle = *iterator->second.handle;
 
     if (frame.scene_state.playing) {
       if (!backend.voice_is_playing(handle) && emitter.play_on_awake) {
@@ -67,8 +67,8 @@ void SceneExtractionPass::process(AudioFrame &frame, AudioBackend &backend) {
   auto &world = active_scene->world();
 
   bool listener_found = false;
-  world.each<scene::Transform, AudioListener>(
-      [&](EntityID entity_id, scene::Transform &transform, AudioListener &listener) {
+  world.each<const scene::Transform, const AudioListener>(
+      [&](EntityID entity_id, const scene::Transform &transform, const AudioListener &listener) {
         if (!listener.enabled || !world.active(entity_id)) {
           return;
         }
@@ -97,8 +97,8 @@ void SceneExtractionPass::process(AudioFrame &frame, AudioBackend &backend) {
         }
       });
 
-  world.each<scene::Transform, AudioEmitter>(
-      [&](EntityID entity_id, scene::Transform &transform, AudioEmitter &emitter) {
+  world.each<const scene::Transform, const AudioEmitter>(
+      [&](EntityID entity_id, const scene::Transform &transform, const AudioEmitter &emitter) {
         if (!emitter.enabled || !world.active(entity_id)) {
           return;
         }
@@ -10,11 +10,11 @@ void SpatialUpdatePass::process(AudioFrame &frame, AudioBackend &backend) {
 
   for (const auto &emitter : frame.emitters) {
     auto iterator = frame.voices.find(emitter.entity_id);
-    if (iterator == frame.voices.end()) {
+    if (iterator == frame.voices.end() || iterator->second.is_virtual()) {
       continue;
     }
 
-    auto &handle = *iterator->second;
+    auto &handle = *iterator->second.handle;
     backend.voice_set_position(handle, emitter.position);
     backend.voice_set_volume(handle, emitter.gain);
     backend.voice_set_pitch(handle, emitter.pitch);
@@ -0,0 +1,24 @@
+#include "stream-refill-pass.hpp"
+#include "trace.hpp"
+
+namespace astralix::audio {
+
+void StreamRefillPass::process(AudioFrame &frame, AudioBackend &backend) {
+  (void)backend;
+  ASTRA_PROFILE_N("StreamRefillPass::process");
+
+  uint64_t underrun_frames = 0;
+  for (auto &[entity_id, voice] : frame.voices) {
+    if (voice.is_virtual() || voice.handle->stream == nullptr) {
+      continue;
+    }
+
+    AudioStream::request_refill(voice.handle->stream);
+    underrun_frames += voice.handle->stream->stats().underrun_frames;
+  }
+
+  ASTRA_PROFILE_PLOT("Audio stream underrun frames",
+                     static_cast<int64_t>(underrun_frames));
+}
+
+} // namespace astralix::audio
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "graph/audio-pass.hpp"
+
+namespace astralix::audio {
+
+// Tops up the ring buffers of streamed voices by scheduling Background decode
+// jobs; the audio thread itself never decodes or waits on a file.
+class StreamRefillPass : public AudioPass {
+public:
+  void process(AudioFrame &frame, AudioBackend &backend) override;
+  std::string_view name() const override { return "StreamRefill"; }
+  std::span<const FrameField> reads() const override { return s_reads; }
+  std::span<const FrameField> writes() const override { return {}; }
+
+private:
+  static constexpr FrameField s_reads[] = {FrameField::Voices};
+};
+
+} // namespace astralix::audio
@@ -10,9 +10,10 @@ namespace astralix {
 
 struct AudioClip {
   static Ref<AudioClipDescriptor> create(const ResourceDescriptorID &id,
-                                         Ref<Path> path) {
+                                         Ref<Path> path,
+                                         AudioClipStreaming streaming = {}) {
     return resource_manager()->register_audio_clip(
-        AudioClipDescriptor::create(id, path));
+        AudioClipDescriptor::create(id, path, streaming));
   }
 };
 
@@ -4,8 +4,9 @@
 namespace astralix {
 
 Ref<AudioClipDescriptor> AudioClipDescriptor::create(const ResourceDescriptorID &id,
-                                                     Ref<Path> path) {
-  return create_ref<AudioClipDescriptor>(id, path);
+                                                     Ref<Path> path,
+                                                     AudioClipStreaming streaming) {
+  return create_ref<AudioClipDescriptor>(id, path, streaming);
 }
 
 } // namespace astralix
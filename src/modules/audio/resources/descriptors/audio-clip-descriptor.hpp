@@ -7,16 +7,29 @@
 
 namespace astralix {
 
+// Streamed clips are decoded on Background jobs into a ring of `chunk_count`
+// chunks of `chunk_frames` frames; a refill is scheduled once fewer than
+// `prefetch_threshold` of the ring remains buffered.
+struct AudioClipStreaming {
+  bool enabled = false;
+  uint32_t chunk_frames = 16384;
+  uint32_t chunk_count = 4;
+  float prefetch_threshold = 0.5f;
+};
+
 struct AudioClipDescriptor {
   static Ref<AudioClipDescriptor> create(const ResourceDescriptorID &id,
-                                         Ref<Path> path);
+                                         Ref<Path> path,
+                                         AudioClipStreaming streaming = {});
 
-  AudioClipDescriptor(const ResourceDescriptorID &id, Ref<Path> path)
-      : RESOURCE_DESCRIPTOR_INIT(), path(path) {}
+  AudioClipDescriptor(const ResourceDescriptorID &id, Ref<Path> path,
+                      AudioClipStreaming streaming = {})
+      : RESOURCE_DESCRIPTOR_INIT(), path(path), streaming(streaming) {}
 
   RESOURCE_DESCRIPTOR_PARAMS;
 
   Ref<Path> path;
+  AudioClipStreaming streaming;
 };
 
 } // namespace astralix
@@ -1,10 +1,12 @@
 #include "audio-system.hpp"
 #include "audio-commands.hpp"
+#include "graph/passes/audibility-pass.hpp"
 #include "graph/passes/emitter-sync-pass.hpp"
 #include "graph/passes/one-shot-pass.hpp"
 #include "graph/passes/play-state-pass.hpp"
 #include "graph/passes/scene-extraction-pass.hpp"
 #include "graph/passes/spatial-update-pass.hpp"
+#include "graph/passes/stream-refill-pass.hpp"
 #include "trace.hpp"
 
 namespace astralix {
@@ -14,12 +16,15 @@ std::vector<OneShotRequest> &get_one_shot_queue();
 } // namespace audio
 
 AudioSystem::AudioSystem(AudioSystemConfig &config)
-    : m_master_gain(config.master_gain) {}
+    : m_master_gain(config.master_gain),
+      m_one_shot_voices(config.one_shot_voices),
+      m_voice_budget(config.voice_budget),
+      m_headless(config.backend == "null") {}
 
 void AudioSystem::start() {
   ASTRA_PROFILE_N("AudioSystem::start");
 
-  if (!m_backend.initialize()) {
+  if (!m_backend.initialize(1, m_headless)) {
     return;
   }
 
@@ -27,15 +32,16 @@ void AudioSystem::start() {
 
   m_graph.add_pass(create_scope<audio::SceneExtractionPass>());
   m_graph.add_pass(create_scope<audio::EmitterSyncPass>());
+  m_graph.add_pass(create_scope<audio::AudibilityPass>(m_voice_budget));
   m_graph.add_pass(create_scope<audio::SpatialUpdatePass>());
   m_graph.add_pass(create_scope<audio::PlayStatePass>());
-  m_graph.add_pass(create_scope<audio::OneShotPass>());
+  m_graph.add_pass(create_scope<audio::StreamRefillPass>());
+  m_graph.add_pass(create_scope<audio::OneShotPass>(m_one_shot_voices));
   m_graph.compile();
   m_graph.setup(m_frame, m_backend);
 }
 
 void AudioSystem::update(double dt) {
-  (void)dt;
   ASTRA_PROFILE_N("AudioSystem::update");
 
   if (!m_backend.is_initialized()) {
@@ -43,6 +49,7 @@ void AudioSystem::update(double dt) {
   }
 
   m_frame.clear_transient();
+  m_frame.delta_time = dt;
   m_frame.one_shot_queue = std::move(audio::get_one_shot_queue());
   audio::get_one_shot_queue().clear();
 
@@ -22,6 +22,9 @@ public:
 
 private:
   float m_master_gain;
+  uint32_t m_one_shot_voices;
+  uint32_t m_voice_budget;
+  bool m_headless;
   audio::AudioBackend m_backend;
   audio::AudioGraph m_graph;
   audio::AudioFrame m_frame;
@@ -272,6 +272,7 @@ void InspectorPanelController::commit_numeric_field(
       return;
     }
 
+    resource_manager()->touch();
     field->value = *parsed;
     refresh(true);
     return;
@@ -342,6 +343,7 @@ void InspectorPanelController::commit_numeric_group(
       }
     }
 
+    resource_manager()->touch();
     refresh(true);
     return;
   }
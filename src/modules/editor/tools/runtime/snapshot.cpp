@@ -32,7 +32,7 @@ RuntimePanelController::collect_snapshot() const {
   snapshot.ui_root_count = scene_world.count<rendering::UIRoot>();
   snapshot.shadow_caster_count = scene_world.count<rendering::ShadowCaster>();
 
-  scene_world.each<physics::RigidBody>(
+  scene_world.each<const physics::RigidBody>(
       [&](EntityID, const physics::RigidBody &body) {
         snapshot.rigid_body_count++;
         if (body.mode == physics::RigidBodyMode::Static) {
@@ -43,7 +43,7 @@ RuntimePanelController::collect_snapshot() const {
       }
   );
 
-  scene_world.each<rendering::MeshSet>(
+  scene_world.each<const rendering::MeshSet>(
       [&](EntityID, const rendering::MeshSet &mesh_set) {
         for (const auto &mesh : mesh_set.meshes) {
           snapshot.vertex_count += mesh.vertices.size();
@@ -98,6 +98,8 @@ std::string serialization_format_label(SerializationFormat format) {
       return "YAML";
     case SerializationFormat::Xml:
       return "XML";
+    case SerializationFormat::Binary:
+      return "Binary";
   }
 
   return "JSON";
@@ -543,6 +543,7 @@ void ShadingPanelController::apply_material_change(
   }
 
   mutator(*descriptor);
+  manager->touch();
 
   active_slot.base_color_factor = descriptor->base_color_factor;
   active_slot.emissive_factor = descriptor->emissive_factor;
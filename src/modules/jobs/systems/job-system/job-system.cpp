@@ -1,15 +1,19 @@
 #include "job-system.hpp"
 
 #include "assert.hpp"
+#include "base.hpp"
 #include "log.hpp"
+#include "slab-pool.hpp"
+#include "work-stealing-deque.hpp"
+#include "world.hpp"
 
 #include <algorithm>
 #include <array>
-#include <chrono>
-#include <condition_variable>
+#include <atomic>
 #include <deque>
 #include <exception>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <unordered_map>
 #include <utility>
@@ -69,6 +73,139 @@ size_t priority_index(JobPriority priority) {
   return 1u;
 }
 
+void dispatch_parallel_tasks(
+    size_t task_count,
+    void *context,
+    void (*task)(void *context, size_t index)
+) {
+  auto *jobs = JobSystem::get();
+  if (jobs == nullptr || task_count <= 1u) {
+    for (size_t index = 0u; index < task_count; ++index) {
+      task(context, index);
+    }
+    return;
+  }
+
+  jobs->run_tasks(task_count, context, task);
+}
+
+// Shared by every runner of one run_tasks() call. Lives on the caller's stack,
+// so helper jobs capture a single pointer and stay in JobCallable's inline
+// storage.
+struct TaskRange {
+  void *context = nullptr;
+  void (*task)(void *context, size_t index) = nullptr;
+  size_t task_count = 0u;
+  std::atomic<size_t> next_index{0u};
+  std::atomic<uint32_t> pending_helpers{0u};
+  std::atomic<bool> failed{false};
+  std::exception_ptr exception;
+
+  void run() {
+    for (;;) {
+      const size_t index = next_index.fetch_add(1u, std::memory_order_relaxed);
+      if (index >= task_count) {
+        return;
+      }
+
+      try {
+        task(context, index);
+      } catch (...) {
+        if (!failed.exchange(true, std::memory_order_acq_rel)) {
+          exception = std::current_exception();
+        }
+        // Stop handing out further indices once a task failed.
+        next_index.store(task_count, std::memory_order_relaxed);
+        return;
+      }
+    }
+  }
+};
+
+uint64_t encode_id(uint32_t index, uint32_t generation) {
+  return (static_cast<uint64_t>(generation) << 32u) |
+         (static_cast<uint64_t>(index) + 1u);
+}
+
+uint32_t id_index(uint64_t id) {
+  return static_cast<uint32_t>(id & 0xffffffffu) - 1u;
+}
+
+uint32_t id_generation(uint64_t id) {
+  return static_cast<uint32_t>(id >> 32u);
+}
+
+class SpinLock {
+public:
+  void lock() noexcept {
+    while (m_flag.test_and_set(std::memory_order_acquire)) {
+      while (m_flag.test(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  void unlock() noexcept { m_flag.clear(std::memory_order_release); }
+
+private:
+  std::atomic_flag m_flag;
+};
+
+// Ready queues shared by threads that do not own a deque: the main queue, the
+// background queue, and submissions from threads outside the pool. These are
+// off the hot path, so a plain mutex is enough; `size` lets pollers skip the
+// lock when the queue is empty.
+struct LockedQueue {
+  mutable std::mutex mutex;
+  std::array<std::deque<uint32_t>, k_priority_order.size()> by_priority;
+  std::atomic<size_t> size{0u};
+
+  void push(uint32_t job_index, JobPriority priority) {
+    std::lock_guard lock(mutex);
+    by_priority[priority_index(priority)].push_back(job_index);
+    size.fetch_add(1u, std::memory_order_seq_cst);
+  }
+
+  std::optional<uint32_t> pop(JobPriority priority) {
+    if (size.load(std::memory_order_acquire) == 0u) {
+      return std::nullopt;
+    }
+
+    std::lock_guard lock(mutex);
+    auto &bucket = by_priority[priority_index(priority)];
+    if (bucket.empty()) {
+      return std::nullopt;
+    }
+
+    const uint32_t job_index = bucket.front();
+    bucket.pop_front();
+    size.fetch_sub(1u, std::memory_order_relaxed);
+    return job_index;
+  }
+
+  std::optional<uint32_t> pop_any() {
+    for (JobPriority priority : k_priority_order) {
+      if (auto job_index = pop(priority)) {
+        return job_index;
+      }
+    }
+
+    return std::nullopt;
+  }
+};
+
+class JobSystemImpl;
+
+struct WorkerContext {
+  std::array<WorkStealingDeque<uint32_t>, k_priority_order.size()> ready;
+  uint32_t steal_seed = 1u;
+};
+
+// Set on the main thread and every worker; threads outside the pool submit
+// through the injection queue instead of a deque.
+thread_local JobSystemImpl *t_owner = nullptr;
+thread_local WorkerContext *t_context = nullptr;
+
 class JobSystemImpl {
 public:
   explicit JobSystemImpl(JobSystem::Config config)
@@ -79,22 +216,38 @@ public:
       worker_count = hardware_threads > 1u ? hardware_threads - 1u : 1u;
     }
 
+    // Context 0 belongs to the main thread; its deques are stolen from like
+    // any worker's, so main-thread submissions never touch a shared lock.
+    m_contexts.reserve(worker_count + 1u);
+    for (uint32_t index = 0; index <= worker_count; ++index) {
+      m_contexts.push_back(create_scope<WorkerContext>());
+      m_contexts.back()->steal_seed = index * 2654435761u + 1u;
+    }
+
+    t_owner = this;
+    t_context = m_contexts.front().get();
+
     m_worker_threads.reserve(worker_count);
-    for (uint32_t index = 0; index < worker_count; ++index) {
-      m_worker_threads.emplace_back([this]() { worker_loop(); });
+    for (uint32_t index = 1; index <= worker_count; ++index) {
+      m_worker_threads.emplace_back([this, index]() { worker_loop(index); });
     }
 
     LOG_INFO("[JobSystem] initialized", "workers=", worker_count);
   }
 
-  ~JobSystemImpl() = default;
+  ~JobSystemImpl() {
+    if (t_owner == this) {
+      t_owner = nullptr;
+      t_context = nullptr;
+    }
+  }
 
   JobHandle submit(
       JobCallable work,
       JobQueue queue,
       JobPriority priority
   ) {
-    return submit_locked({}, JobBarrier{}, std::move(work), queue, priority);
+    return submit_job({}, JobBarrier{}, std::move(work), queue, priority);
   }
 
   JobHandle submit_after(
@@ -103,7 +256,7 @@ public:
       JobQueue queue,
       JobPriority priority
   ) {
-    return submit_locked(
+    return submit_job(
         dependencies, JobBarrier{}, std::move(work), queue, priority
     );
   }
@@ -114,16 +267,30 @@ public:
       JobQueue queue,
       JobPriority priority
   ) {
-    return submit_locked({}, barrier, std::move(work), queue, priority);
+    return submit_job({}, barrier, std::move(work), queue, priority);
   }
 
   JobBarrier create_barrier(uint32_t expected_count) {
-    std::lock_guard lock(m_mutex);
+    const uint32_t barrier_index = m_barriers.acquire();
+    auto &record = m_barriers.at(barrier_index);
+
+    JobBarrier barrier;
+    {
+      std::lock_guard lock(record.lock);
+      barrier.id = encode_id(
+          barrier_index, record.generation.load(std::memory_order_relaxed)
+      );
+      record.remaining = expected_count;
+      record.waiting_jobs.clear();
+      if (expected_count == 0u) {
+        fire_barrier_locked(record);
+      }
+    }
+
+    if (expected_count == 0u) {
+      m_barriers.release(barrier_index);
+    }
 
-    JobBarrier barrier{.id = m_next_barrier_id++};
-    auto &record = m_barriers[barrier.id];
-    record.remaining = expected_count;
-    record.fired = expected_count == 0u;
     LOG_DEBUG(
         "[JobSystem] created barrier",
         "barrier_id=", barrier.id,
@@ -137,50 +304,46 @@ public:
       return;
     }
 
-    std::lock_guard lock(m_mutex);
-
-    auto job_it = m_jobs.find(handle.id);
-    ASTRA_ENSURE(job_it == m_jobs.end(), "Unknown job handle");
-
-    auto barrier_it = m_barriers.find(barrier.id);
-    ASTRA_ENSURE(barrier_it == m_barriers.end(), "Unknown job barrier");
-
-    if (barrier_it->second.fired) {
-      return;
-    }
-
-    auto &job = job_it->second;
-    if (job.complete) {
-      complete_barrier_attachment_locked(barrier.id);
-      return;
-    }
+    ASTRA_ENSURE(!m_jobs.contains(id_index(handle.id)), "Unknown job handle");
+    ASTRA_ENSURE(
+        !m_barriers.contains(id_index(barrier.id)), "Unknown job barrier"
+    );
 
-    if (std::find(
-            job.attached_barriers.begin(),
-            job.attached_barriers.end(),
-            barrier.id
-        ) != job.attached_barriers.end()) {
-      return;
+    auto &job = m_jobs.at(id_index(handle.id));
+    {
+      std::lock_guard lock(job.lock);
+      const bool pending =
+          job.generation.load(std::memory_order_relaxed) ==
+              id_generation(handle.id) &&
+          !job.complete.load(std::memory_order_relaxed);
+
+      if (pending) {
+        if (std::find(
+                job.attached_barriers.begin(),
+                job.attached_barriers.end(),
+                barrier.id
+            ) == job.attached_barriers.end()) {
+          job.attached_barriers.push_back(barrier.id);
+          LOG_DEBUG(
+              "[JobSystem] attached job to barrier",
+              "job_id=", handle.id,
+              "barrier_id=", barrier.id
+          );
+        }
+        return;
+      }
     }
 
-    job.attached_barriers.push_back(barrier.id);
-    LOG_DEBUG(
-        "[JobSystem] attached job to barrier",
-        "job_id=", handle.id,
-        "barrier_id=", barrier.id
-    );
+    complete_barrier_attachment(barrier.id);
   }
 
-  bool is_complete(JobHandle handle) const {
+  bool is_complete(JobHandle handle) {
     if (!handle.is_valid()) {
       return true;
     }
 
-    std::lock_guard lock(m_mutex);
-
-    auto it = m_jobs.find(handle.id);
-    ASTRA_ENSURE(it == m_jobs.end(), "Unknown job handle");
-    return it->second.complete;
+    ASTRA_ENSURE(!m_jobs.contains(id_index(handle.id)), "Unknown job handle");
+    return job_complete(handle);
   }
 
   void wait(JobHandle handle) {
@@ -188,25 +351,18 @@ public:
       return;
     }
 
-    for (;;) {
-      {
-        std::lock_guard lock(m_mutex);
-        auto it = m_jobs.find(handle.id);
-        ASTRA_ENSURE(it == m_jobs.end(), "Unknown job handle");
-        if (it->second.complete) {
-          if (it->second.exception != nullptr) {
-            std::rethrow_exception(it->second.exception);
-          }
-          return;
-        }
-      }
+    ASTRA_ENSURE(!m_jobs.contains(id_index(handle.id)), "Unknown job handle");
 
-      if (is_main_thread() && drain_main_queue(1u) > 0u) {
+    while (!job_complete(handle)) {
+      if (help_one()) {
         continue;
       }
 
-      std::unique_lock lock(m_mutex);
-      m_completion_cv.wait_for(lock, std::chrono::milliseconds(1));
+      sleep_until_progress([&]() { return job_complete(handle); });
+    }
+
+    if (auto exception = take_failure(handle.id)) {
+      std::rethrow_exception(exception);
     }
   }
 
@@ -221,22 +377,16 @@ public:
       return;
     }
 
-    for (;;) {
-      {
-        std::lock_guard lock(m_mutex);
-        auto it = m_barriers.find(barrier.id);
-        ASTRA_ENSURE(it == m_barriers.end(), "Unknown job barrier");
-        if (it->second.fired) {
-          return;
-        }
-      }
+    ASTRA_ENSURE(
+        !m_barriers.contains(id_index(barrier.id)), "Unknown job barrier"
+    );
 
-      if (is_main_thread() && drain_main_queue(1u) > 0u) {
+    while (!barrier_fired(barrier)) {
+      if (help_one()) {
         continue;
       }
 
-      std::unique_lock lock(m_mutex);
-      m_completion_cv.wait_for(lock, std::chrono::milliseconds(1));
+      sleep_until_progress([&]() { return barrier_fired(barrier); });
     }
   }
 
@@ -249,24 +399,12 @@ public:
     size_t drained = 0u;
 
     while (drained < max_jobs) {
-      JobCallable work;
-      uint64_t job_id = 0u;
-
-      {
-        std::lock_guard lock(m_mutex);
-        job_id = pop_ready_job_locked(m_main_ready);
-        if (job_id == 0u) {
-          break;
-        }
-
-        auto &job = m_jobs.at(job_id);
-        job.queued = false;
-        job.running = true;
-        ++m_running_jobs;
-        work = std::move(job.work);
+      auto job_index = m_main_ready.pop_any();
+      if (!job_index) {
+        break;
       }
 
-      execute_job(job_id, std::move(work));
+      execute_job(*job_index);
       ++drained;
     }
 
@@ -278,19 +416,33 @@ public:
   }
 
   bool has_pending_main_work() const {
-    std::lock_guard lock(m_mutex);
-    return !m_main_ready.empty();
+    return m_main_ready.size.load(std::memory_order_acquire) > 0u;
   }
 
-  void shutdown() {
-    wait_for_quiescence();
+  void wait_until_zero(const std::atomic<uint32_t> &counter) {
+    const auto done = [&counter]() {
+      return counter.load(std::memory_order_acquire) == 0u;
+    };
 
-    {
-      std::lock_guard lock(m_mutex);
-      m_stopping = true;
+    while (!done()) {
+      if (help_one()) {
+        continue;
+      }
+
+      sleep_until_progress(done);
     }
+  }
+
+  uint32_t worker_count() const {
+    return static_cast<uint32_t>(m_worker_threads.size());
+  }
 
-    m_ready_cv.notify_all();
+  void shutdown() {
+    wait_for_quiescence();
+
+    m_stopping.store(true, std::memory_order_seq_cst);
+    m_work_epoch.fetch_add(1u, std::memory_order_seq_cst);
+    m_work_epoch.notify_all();
 
     for (auto &worker : m_worker_threads) {
       if (worker.joinable()) {
@@ -302,40 +454,43 @@ public:
   }
 
 private:
-  struct ReadyQueues {
-    std::array<std::deque<uint64_t>, 4> by_priority;
-
-    bool empty() const {
-      for (const auto &queue : by_priority) {
-        if (!queue.empty()) {
-          return false;
-        }
-      }
-      return true;
-    }
-  };
+  static constexpr uint32_t k_spin_attempts = 64u;
 
   struct JobRecord {
+    std::atomic<uint32_t> next_free{0u};
+    std::atomic<uint32_t> generation{1u};
+    // Unfinished dependencies plus one guard held while the job is being
+    // submitted; the thread that drops it to zero enqueues the job.
+    std::atomic<uint32_t> pending{0u};
+    std::atomic<bool> complete{false};
+    SpinLock lock;
     JobQueue queue = JobQueue::Worker;
     JobPriority priority = JobPriority::Normal;
     JobCallable work;
-    std::vector<uint64_t> dependents;
+    std::vector<uint32_t> dependents;
     std::vector<uint64_t> attached_barriers;
-    uint32_t remaining_job_dependencies = 0u;
-    uint32_t remaining_barrier_dependencies = 0u;
-    bool queued = false;
-    bool running = false;
-    bool complete = false;
-    std::exception_ptr exception;
   };
 
   struct BarrierRecord {
+    std::atomic<uint32_t> next_free{0u};
+    std::atomic<uint32_t> generation{1u};
+    SpinLock lock;
     uint32_t remaining = 0u;
-    bool fired = false;
-    std::vector<uint64_t> waiting_jobs;
+    std::vector<uint32_t> waiting_jobs;
+  };
+
+  // Failed jobs give their slot back like any other job; the exception waits
+  // here, keyed by job id, until a wait() on that handle takes it. Failures
+  // nobody waits for are dropped oldest first.
+  struct FailureTable {
+    static constexpr size_t k_max_unclaimed = 256u;
+
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::exception_ptr> by_job;
+    std::deque<uint64_t> order;
   };
 
-  JobHandle submit_locked(
+  JobHandle submit_job(
       std::span<const JobHandle> dependencies,
       JobBarrier barrier,
       JobCallable work,
@@ -343,289 +498,443 @@ private:
       JobPriority priority
   ) {
     ASTRA_ENSURE(!work, "Cannot submit an empty job");
-
-    std::lock_guard lock(m_mutex);
-    ASTRA_ENSURE(m_stopping, "JobSystem is shutting down");
-
-    JobHandle handle{.id = m_next_job_id++};
-    auto &job = m_jobs[handle.id];
-    job.queue = queue;
-    job.priority = priority;
-    job.work = std::move(work);
+    ASTRA_ENSURE(
+        m_stopping.load(std::memory_order_acquire),
+        "JobSystem is shutting down"
+    );
 
     for (const auto &dependency : dependencies) {
-      if (!dependency.is_valid()) {
-        continue;
-      }
-
-      auto dep_it = m_jobs.find(dependency.id);
-      ASTRA_ENSURE(dep_it == m_jobs.end(), "Unknown dependency job handle");
+      ASTRA_ENSURE(
+          dependency.is_valid() && !m_jobs.contains(id_index(dependency.id)),
+          "Unknown dependency job handle"
+      );
+    }
+    ASTRA_ENSURE(
+        barrier.is_valid() && !m_barriers.contains(id_index(barrier.id)),
+        "Unknown job barrier"
+    );
 
-      if (dep_it->second.complete) {
-        continue;
-      }
+    const uint32_t job_index = m_jobs.acquire();
+    auto &job = m_jobs.at(job_index);
 
-      dep_it->second.dependents.push_back(handle.id);
-      ++job.remaining_job_dependencies;
+    JobHandle handle;
+    {
+      std::lock_guard lock(job.lock);
+      handle.id = encode_id(
+          job_index, job.generation.load(std::memory_order_relaxed)
+      );
+      job.queue = queue;
+      job.priority = priority;
+      job.work = std::move(work);
+      job.pending.store(1u, std::memory_order_relaxed);
+      job.complete.store(false, std::memory_order_release);
     }
 
-    if (barrier.is_valid()) {
-      auto barrier_it = m_barriers.find(barrier.id);
-      ASTRA_ENSURE(barrier_it == m_barriers.end(), "Unknown job barrier");
+    m_incomplete_jobs.fetch_add(1u, std::memory_order_relaxed);
 
-      if (!barrier_it->second.fired) {
-        barrier_it->second.waiting_jobs.push_back(handle.id);
-        ++job.remaining_barrier_dependencies;
+    uint32_t job_dependencies = 0u;
+    for (const auto &dependency : dependencies) {
+      if (dependency.is_valid() && add_dependent(dependency, job, job_index)) {
+        ++job_dependencies;
       }
     }
 
-    ++m_incomplete_jobs;
+    uint32_t barrier_dependencies = 0u;
+    if (barrier.is_valid() && add_barrier_waiter(barrier, job, job_index)) {
+      ++barrier_dependencies;
+    }
 
     LOG_DEBUG(
         "[JobSystem] submitted job",
         "job_id=", handle.id,
         "queue=", queue_name(queue),
         "priority=", priority_name(priority),
-        "job_dependencies=", job.remaining_job_dependencies,
-        "barrier_dependencies=", job.remaining_barrier_dependencies
+        "job_dependencies=", job_dependencies,
+        "barrier_dependencies=", barrier_dependencies
     );
 
-    if (job.remaining_job_dependencies == 0u &&
-        job.remaining_barrier_dependencies == 0u) {
-      enqueue_ready_locked(handle.id, job.queue, job.priority);
-      m_ready_cv.notify_one();
+    release_pending(job_index);
+    return handle;
+  }
+
+  bool add_dependent(JobHandle dependency, JobRecord &job, uint32_t job_index) {
+    auto &record = m_jobs.at(id_index(dependency.id));
+    std::lock_guard lock(record.lock);
+
+    if (record.generation.load(std::memory_order_relaxed) !=
+            id_generation(dependency.id) ||
+        record.complete.load(std::memory_order_relaxed)) {
+      return false;
     }
 
-    return handle;
+    job.pending.fetch_add(1u, std::memory_order_relaxed);
+    record.dependents.push_back(job_index);
+    return true;
   }
 
-  void worker_loop() {
-    for (;;) {
-      JobCallable work;
-      uint64_t job_id = 0u;
+  bool add_barrier_waiter(
+      JobBarrier barrier,
+      JobRecord &job,
+      uint32_t job_index
+  ) {
+    auto &record = m_barriers.at(id_index(barrier.id));
+    std::lock_guard lock(record.lock);
 
-      {
-        std::unique_lock lock(m_mutex);
-        m_ready_cv.wait(lock, [this]() {
-          return m_stopping || has_worker_ready_jobs_locked();
-        });
+    if (record.generation.load(std::memory_order_relaxed) !=
+        id_generation(barrier.id)) {
+      return false;
+    }
 
-        if (m_stopping && !has_worker_ready_jobs_locked()) {
-          return;
-        }
+    job.pending.fetch_add(1u, std::memory_order_relaxed);
+    record.waiting_jobs.push_back(job_index);
+    return true;
+  }
 
-        job_id = pop_ready_job_locked(m_worker_ready);
-        if (job_id == 0u) {
-          job_id = pop_ready_job_locked(m_background_ready);
+  void release_pending(uint32_t job_index) {
+    auto &job = m_jobs.at(job_index);
+    if (job.pending.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+      enqueue_ready(job_index, job.queue, job.priority);
+    }
+  }
+
+  void enqueue_ready(uint32_t job_index, JobQueue queue, JobPriority priority) {
+    switch (queue) {
+      case JobQueue::Main:
+        m_main_ready.push(job_index, priority);
+        wake_waiters();
+        return;
+      case JobQueue::Background:
+        m_background_ready.push(job_index, priority);
+        break;
+      case JobQueue::Worker:
+        if (WorkerContext *context = current_context()) {
+          context->ready[priority_index(priority)].push(job_index);
+        } else {
+          m_injected.push(job_index, priority);
         }
+        break;
+    }
+
+    wake_workers();
+  }
+
+  void worker_loop(uint32_t context_index) {
+    t_owner = this;
+    t_context = m_contexts[context_index].get();
+
+    uint32_t idle_attempts = 0u;
+    for (;;) {
+      if (auto job_index = find_job(*t_context, true)) {
+        execute_job(*job_index);
+        idle_attempts = 0u;
+        continue;
+      }
+
+      if (m_stopping.load(std::memory_order_acquire)) {
+        return;
+      }
+
+      if (++idle_attempts < k_spin_attempts) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // Publish that we are about to sleep before re-checking for work;
+      // wake_workers() reads the counter after its own push, so one side
+      // always observes the other.
+      m_sleeping_workers.fetch_add(1u, std::memory_order_seq_cst);
+      const uint32_t epoch = m_work_epoch.load(std::memory_order_seq_cst);
+      if (!m_stopping.load(std::memory_order_seq_cst) && !has_worker_work()) {
+        m_work_epoch.wait(epoch, std::memory_order_seq_cst);
+      }
+      m_sleeping_workers.fetch_sub(1u, std::memory_order_relaxed);
+      idle_attempts = 0u;
+    }
+  }
+
+  std::optional<uint32_t>
+  find_job(WorkerContext &context, bool include_background) {
+    const size_t context_count = m_contexts.size();
+
+    for (JobPriority priority : k_priority_order) {
+      const size_t bucket = priority_index(priority);
+
+      if (auto job_index = context.ready[bucket].pop()) {
+        return job_index;
+      }
+
+      if (auto job_index = m_injected.pop(priority)) {
+        return job_index;
+      }
+
+      context.steal_seed ^= context.steal_seed << 13u;
+      context.steal_seed ^= context.steal_seed >> 17u;
+      context.steal_seed ^= context.steal_seed << 5u;
+      const size_t start = context.steal_seed % context_count;
 
-        if (job_id == 0u) {
+      for (size_t offset = 0u; offset < context_count; ++offset) {
+        auto &victim = *m_contexts[(start + offset) % context_count];
+        if (&victim == &context) {
           continue;
         }
 
-        auto &job = m_jobs.at(job_id);
-        job.queued = false;
-        job.running = true;
-        ++m_running_jobs;
-        work = std::move(job.work);
+        if (auto job_index = victim.ready[bucket].steal()) {
+          return job_index;
+        }
       }
+    }
 
-      execute_job(job_id, std::move(work));
+    if (include_background) {
+      return m_background_ready.pop_any();
     }
+
+    return std::nullopt;
   }
 
-  void execute_job(uint64_t job_id, JobCallable work) {
-    std::exception_ptr exception;
+  bool has_worker_work() const {
+    if (m_injected.size.load(std::memory_order_seq_cst) > 0u ||
+        m_background_ready.size.load(std::memory_order_seq_cst) > 0u) {
+      return true;
+    }
 
-    try {
-      if (work) {
-        work();
+    for (const auto &context : m_contexts) {
+      for (const auto &deque : context->ready) {
+        if (!deque.empty()) {
+          return true;
+        }
       }
-    } catch (...) {
-      exception = std::current_exception();
     }
 
-    std::lock_guard lock(m_mutex);
-    complete_job_locked(job_id, exception);
+    return false;
   }
 
-  void complete_job_locked(uint64_t job_id, std::exception_ptr exception) {
-    auto job_it = m_jobs.find(job_id);
-    if (job_it == m_jobs.end() || job_it->second.complete) {
-      return;
+  // Runs one ready job on the waiting thread instead of blocking. Background
+  // jobs are left alone since they may run for a long time.
+  bool help_one() {
+    if (is_main_thread() && drain_main_queue(1u) > 0u) {
+      return true;
     }
 
-    auto &job = job_it->second;
-    job.complete = true;
-    job.running = false;
-    job.exception = exception;
+    WorkerContext *context = current_context();
+    if (context == nullptr) {
+      return false;
+    }
 
-    if (exception != nullptr) {
-      LOG_ERROR(
-          "[JobSystem] job failed",
-          "job_id=", job_id,
-          "queue=", queue_name(job.queue),
-          "priority=", priority_name(job.priority)
-      );
+    if (auto job_index = find_job(*context, false)) {
+      execute_job(*job_index);
+      return true;
     }
 
-    if (m_running_jobs > 0u) {
-      --m_running_jobs;
+    return false;
+  }
+
+  template <typename Done>
+  void sleep_until_progress(Done &&done) {
+    m_waiters.fetch_add(1u, std::memory_order_seq_cst);
+    const uint32_t epoch = m_completion_epoch.load(std::memory_order_seq_cst);
+
+    const bool main_work = is_main_thread() && has_pending_main_work();
+    if (!done() && !main_work) {
+      m_completion_epoch.wait(epoch, std::memory_order_seq_cst);
     }
-    if (m_incomplete_jobs > 0u) {
-      --m_incomplete_jobs;
+
+    m_waiters.fetch_sub(1u, std::memory_order_relaxed);
+  }
+
+  void wake_workers() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping_workers.load(std::memory_order_seq_cst) > 0u) {
+      m_work_epoch.fetch_add(1u, std::memory_order_seq_cst);
+      m_work_epoch.notify_one();
     }
 
-    auto dependents = std::move(job.dependents);
-    auto barriers = std::move(job.attached_barriers);
-    job.dependents.clear();
-    job.attached_barriers.clear();
+    // Waiting threads help with ready work, so new work counts as progress.
+    wake_waiters();
+  }
 
-    for (uint64_t barrier_id : barriers) {
-      complete_barrier_attachment_locked(barrier_id);
+  void wake_waiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_seq_cst) > 0u) {
+      m_completion_epoch.fetch_add(1u, std::memory_order_seq_cst);
+      m_completion_epoch.notify_all();
     }
+  }
 
-    for (uint64_t dependent_id : dependents) {
-      auto dependent_it = m_jobs.find(dependent_id);
-      if (dependent_it == m_jobs.end() || dependent_it->second.complete) {
-        continue;
+  void execute_job(uint32_t job_index) {
+    auto &job = m_jobs.at(job_index);
+    JobCallable work = std::move(job.work);
+    std::exception_ptr exception;
+
+    try {
+      if (work) {
+        work();
       }
+    } catch (...) {
+      exception = std::current_exception();
+    }
 
-      auto &dependent = dependent_it->second;
-      if (dependent.remaining_job_dependencies > 0u) {
-        --dependent.remaining_job_dependencies;
+    // Release captured state before dependents or waiters can observe the
+    // completion.
+    work = JobCallable{};
+    complete_job(job_index, exception);
+  }
+
+  void complete_job(uint32_t job_index, std::exception_ptr exception) {
+    auto &job = m_jobs.at(job_index);
+
+    {
+      std::lock_guard lock(job.lock);
+      const uint32_t generation = job.generation.load(std::memory_order_relaxed);
+      if (exception != nullptr) {
+        record_failure(encode_id(job_index, generation), exception);
       }
+      job.complete.store(true, std::memory_order_seq_cst);
 
-      if (dependent.remaining_job_dependencies == 0u &&
-          dependent.remaining_barrier_dependencies == 0u &&
-          !dependent.queued && !dependent.running) {
-        enqueue_ready_locked(
-            dependent_id, dependent.queue, dependent.priority
-        );
+      for (uint64_t barrier_id : job.attached_barriers) {
+        complete_barrier_attachment(barrier_id);
       }
-    }
+      job.attached_barriers.clear();
 
-    m_completion_cv.notify_all();
-    m_ready_cv.notify_all();
-  }
+      for (uint32_t dependent_index : job.dependents) {
+        release_pending(dependent_index);
+      }
+      job.dependents.clear();
 
-  void complete_barrier_attachment_locked(uint64_t barrier_id) {
-    auto barrier_it = m_barriers.find(barrier_id);
-    if (barrier_it == m_barriers.end() || barrier_it->second.fired) {
-      return;
+      // Stale handles read as complete, so the slot can be recycled.
+      job.generation.store(generation + 1u, std::memory_order_release);
     }
 
-    auto &barrier = barrier_it->second;
-    if (barrier.remaining > 0u) {
-      --barrier.remaining;
+    if (exception != nullptr) {
+      LOG_ERROR(
+          "[JobSystem] job failed",
+          "job_index=", job_index,
+          "queue=", queue_name(job.queue),
+          "priority=", priority_name(job.priority)
+      );
     }
 
-    if (barrier.remaining != 0u) {
-      return;
-    }
+    m_jobs.release(job_index);
 
-    barrier.fired = true;
-    auto waiting_jobs = std::move(barrier.waiting_jobs);
-    barrier.waiting_jobs.clear();
+    m_incomplete_jobs.fetch_sub(1u, std::memory_order_seq_cst);
+    wake_waiters();
+  }
 
-    for (uint64_t waiting_job_id : waiting_jobs) {
-      auto job_it = m_jobs.find(waiting_job_id);
-      if (job_it == m_jobs.end() || job_it->second.complete) {
-        continue;
+  void complete_barrier_attachment(uint64_t barrier_id) {
+    const uint32_t barrier_index = id_index(barrier_id);
+    auto &record = m_barriers.at(barrier_index);
+
+    {
+      std::lock_guard lock(record.lock);
+      if (record.generation.load(std::memory_order_relaxed) !=
+          id_generation(barrier_id)) {
+        return;
       }
 
-      auto &job = job_it->second;
-      if (job.remaining_barrier_dependencies > 0u) {
-        --job.remaining_barrier_dependencies;
+      if (record.remaining > 0u) {
+        --record.remaining;
       }
 
-      if (job.remaining_job_dependencies == 0u &&
-          job.remaining_barrier_dependencies == 0u &&
-          !job.queued && !job.running) {
-        enqueue_ready_locked(waiting_job_id, job.queue, job.priority);
+      if (record.remaining != 0u) {
+        return;
       }
+
+      fire_barrier_locked(record);
     }
-  }
 
-  void enqueue_ready_locked(
-      uint64_t job_id,
-      JobQueue queue,
-      JobPriority priority
-  ) {
-    auto &ready = ready_queue_locked(queue);
-    ready.by_priority[priority_index(priority)].push_back(job_id);
-    m_jobs.at(job_id).queued = true;
+    m_barriers.release(barrier_index);
   }
 
-  ReadyQueues &ready_queue_locked(JobQueue queue) {
-    switch (queue) {
-      case JobQueue::Worker:
-        return m_worker_ready;
-      case JobQueue::Main:
-        return m_main_ready;
-      case JobQueue::Background:
-        return m_background_ready;
+  // A fired barrier bumps its generation, so stale ids read as fired and the
+  // slot can be recycled.
+  void fire_barrier_locked(BarrierRecord &record) {
+    record.generation.fetch_add(1u, std::memory_order_release);
+
+    for (uint32_t waiting_index : record.waiting_jobs) {
+      release_pending(waiting_index);
     }
+    record.waiting_jobs.clear();
+    wake_waiters();
+  }
 
-    return m_worker_ready;
+  // Completion bumps the generation, so a handle is complete exactly when its
+  // generation no longer matches the slot.
+  bool job_complete(JobHandle handle) const {
+    return m_jobs.at(id_index(handle.id))
+               .generation.load(std::memory_order_acquire) !=
+           id_generation(handle.id);
   }
 
-  uint64_t pop_ready_job_locked(ReadyQueues &ready) {
-    for (JobPriority priority : k_priority_order) {
-      auto &bucket = ready.by_priority[priority_index(priority)];
-      if (bucket.empty()) {
-        continue;
+  void record_failure(uint64_t job_id, std::exception_ptr exception) {
+    std::lock_guard lock(m_failures.mutex);
+    m_failures.by_job[job_id] = std::move(exception);
+    m_failures.order.push_back(job_id);
+
+    while (m_failures.order.size() > FailureTable::k_max_unclaimed) {
+      if (m_failures.by_job.erase(m_failures.order.front()) > 0u) {
+        LOG_WARN(
+            "[JobSystem] dropped unclaimed job failure",
+            "job_id=", m_failures.order.front()
+        );
       }
+      m_failures.order.pop_front();
+    }
+  }
 
-      uint64_t job_id = bucket.front();
-      bucket.pop_front();
-      return job_id;
+  std::exception_ptr take_failure(uint64_t job_id) {
+    std::lock_guard lock(m_failures.mutex);
+    auto it = m_failures.by_job.find(job_id);
+    if (it == m_failures.by_job.end()) {
+      return nullptr;
     }
 
-    return 0u;
+    std::exception_ptr exception = std::move(it->second);
+    m_failures.by_job.erase(it);
+    return exception;
   }
 
-  bool has_worker_ready_jobs_locked() const {
-    return !m_worker_ready.empty() || !m_background_ready.empty();
+  bool barrier_fired(JobBarrier barrier) const {
+    return m_barriers.at(id_index(barrier.id))
+               .generation.load(std::memory_order_acquire) !=
+           id_generation(barrier.id);
   }
 
   void wait_for_quiescence() {
-    for (;;) {
-      {
-        std::lock_guard lock(m_mutex);
-        if (m_incomplete_jobs == 0u) {
-          return;
-        }
-      }
+    const auto quiescent = [this]() {
+      return m_incomplete_jobs.load(std::memory_order_seq_cst) == 0u;
+    };
 
-      if (is_main_thread() && drain_main_queue(1u) > 0u) {
+    while (!quiescent()) {
+      if (help_one()) {
         continue;
       }
 
-      std::unique_lock lock(m_mutex);
-      m_completion_cv.wait_for(lock, std::chrono::milliseconds(1));
+      sleep_until_progress(quiescent);
     }
   }
 
+  WorkerContext *current_context() const noexcept {
+    return t_owner == this ? t_context : nullptr;
+  }
+
   bool is_main_thread() const noexcept {
     return std::this_thread::get_id() == m_main_thread_id;
   }
 
   std::thread::id m_main_thread_id;
-  mutable std::mutex m_mutex;
-  std::condition_variable m_ready_cv;
-  std::condition_variable m_completion_cv;
   std::vector<std::thread> m_worker_threads;
-  std::unordered_map<uint64_t, JobRecord> m_jobs;
-  std::unordered_map<uint64_t, BarrierRecord> m_barriers;
-  ReadyQueues m_worker_ready;
-  ReadyQueues m_main_ready;
-  ReadyQueues m_background_ready;
-  uint64_t m_next_job_id = 1u;
-  uint64_t m_next_barrier_id = 1u;
-  size_t m_incomplete_jobs = 0u;
-  size_t m_running_jobs = 0u;
-  bool m_stopping = false;
+  std::vector<Scope<WorkerContext>> m_contexts;
+  SlabPool<JobRecord> m_jobs;
+  SlabPool<BarrierRecord> m_barriers;
+  FailureTable m_failures;
+  LockedQueue m_injected;
+  LockedQueue m_main_ready;
+  LockedQueue m_background_ready;
+  std::atomic<size_t> m_incomplete_jobs{0u};
+  std::atomic<uint32_t> m_sleeping_workers{0u};
+  std::atomic<uint32_t> m_work_epoch{0u};
+  std::atomic<uint32_t> m_waiters{0u};
+  std::atomic<uint32_t> m_completion_epoch{0u};
+  std::atomic<bool> m_stopping{false};
 };
 
 } // namespace
@@ -649,9 +958,13 @@ void JobSystem::start() {
   if (g_job_system_impl == nullptr) {
     g_job_system_impl = new JobSystemImpl(m_config);
   }
+
+  ecs::set_parallel_dispatch(&dispatch_parallel_tasks);
 }
 
 void JobSystem::end() {
+  ecs::set_parallel_dispatch(nullptr);
+
   if (g_job_system_impl != nullptr) {
     g_job_system_impl->shutdown();
     delete g_job_system_impl;
@@ -729,4 +1042,52 @@ bool JobSystem::has_pending_main_work() const {
   return g_job_system_impl->has_pending_main_work();
 }
 
+void JobSystem::run_tasks(
+    size_t task_count,
+    void *context,
+    void (*task)(void *context, size_t index),
+    JobPriority priority
+) {
+  if (task_count == 0u) {
+    return;
+  }
+
+  TaskRange range;
+  range.context = context;
+  range.task = task;
+  range.task_count = task_count;
+
+  const size_t helper_count =
+      std::min<size_t>(task_count - 1u, g_job_system_impl->worker_count());
+  range.pending_helpers.store(
+      static_cast<uint32_t>(helper_count), std::memory_order_relaxed
+  );
+
+  for (size_t helper = 0u; helper < helper_count; ++helper) {
+    g_job_system_impl->submit(
+        [&range]() {
+          range.run();
+          range.pending_helpers.fetch_sub(1u, std::memory_order_acq_rel);
+        },
+        JobQueue::Worker,
+        priority
+    );
+  }
+
+  range.run();
+  g_job_system_impl->wait_until_zero(range.pending_helpers);
+
+  if (range.exception != nullptr) {
+    std::rethrow_exception(range.exception);
+  }
+}
+
+void JobSystem::wait_until_zero(const std::atomic<uint32_t> &counter) {
+  g_job_system_impl->wait_until_zero(counter);
+}
+
+uint32_t JobSystem::worker_count() const {
+  return g_job_system_impl->worker_count();
+}
+
 } // namespace astralix
@@ -3,6 +3,7 @@
 #include "job-callable.hpp"
 #include "systems/system.hpp"
 
+#include <atomic>
 #include <cstdint>
 #include <limits>
 #include <span>
@@ -76,6 +77,8 @@ public:
   );
 
   bool is_complete(JobHandle handle) const;
+  // Helps run ready jobs until `handle` finished. A job that threw hands its
+  // exception to the first wait() on its handle.
   void wait(JobHandle handle);
   void wait_all(std::span<const JobHandle> handles);
   void wait_barrier(JobBarrier barrier);
@@ -84,6 +87,22 @@ public:
   drain_main_queue(size_t max_jobs = std::numeric_limits<size_t>::max());
   bool has_pending_main_work() const;
 
+  // Runs task(context, index) for every index in [0, task_count). Indices are
+  // claimed dynamically by the calling thread and up to worker_count() helper
+  // jobs; the caller returns once all of them finished and rethrows the first
+  // exception a task raised.
+  void run_tasks(
+      size_t task_count,
+      void *context,
+      void (*task)(void *context, size_t index),
+      JobPriority priority = JobPriority::Normal
+  );
+
+  // Runs ready jobs on the calling thread until `counter` reaches zero.
+  void wait_until_zero(const std::atomic<uint32_t> &counter);
+
+  uint32_t worker_count() const;
+
 private:
   JobSystem(const JobSystem &) = delete;
   JobSystem &operator=(const JobSystem &) = delete;
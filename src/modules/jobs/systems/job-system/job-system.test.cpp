@@ -0,0 +1,245 @@
+#include "job-system.hpp"
+#include "work-stealing-deque.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace astralix {
+namespace {
+
+uint32_t slot_of(JobHandle handle) {
+  return static_cast<uint32_t>(handle.id & 0xffffffffu);
+}
+
+TEST(WorkStealingDequeTest, OwnerPopsInLifoOrderAndThievesStealFifo) {
+  WorkStealingDeque<uint32_t> deque(4u);
+  for (uint32_t value = 0u; value < 10u; ++value) {
+    deque.push(value);
+  }
+  EXPECT_EQ(deque.size(), 10u);
+
+  EXPECT_EQ(deque.steal(), 0u);
+  EXPECT_EQ(deque.steal(), 1u);
+  EXPECT_EQ(deque.pop(), 9u);
+  EXPECT_EQ(deque.pop(), 8u);
+  EXPECT_EQ(deque.size(), 6u);
+
+  while (deque.pop().has_value()) {
+  }
+  EXPECT_TRUE(deque.empty());
+  EXPECT_FALSE(deque.steal().has_value());
+}
+
+TEST(WorkStealingDequeTest, StealsAndPopsRaceWithoutLosingOrDuplicatingItems) {
+  constexpr uint32_t k_items = 200000u;
+  constexpr size_t k_thieves = 3u;
+
+  // Starts small so the owner grows the buffer while thieves read it.
+  WorkStealingDeque<uint32_t> deque(8u);
+  std::vector<std::atomic<uint8_t>> taken(k_items);
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> stolen{0u};
+
+  std::vector<std::thread> thieves;
+  for (size_t thief = 0u; thief < k_thieves; ++thief) {
+    thieves.emplace_back([&]() {
+      while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+        if (auto value = deque.steal()) {
+          taken[*value].fetch_add(1u, std::memory_order_relaxed);
+          stolen.fetch_add(1u, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+
+  uint32_t popped = 0u;
+  for (uint32_t value = 0u; value < k_items; ++value) {
+    deque.push(value);
+    // Pop every third push so the single-element CAS race is hit often.
+    if (value % 3u == 0u) {
+      if (auto item = deque.pop()) {
+        taken[*item].fetch_add(1u, std::memory_order_relaxed);
+        ++popped;
+      }
+    }
+  }
+  while (auto item = deque.pop()) {
+    taken[*item].fetch_add(1u, std::memory_order_relaxed);
+    ++popped;
+  }
+
+  done.store(true, std::memory_order_release);
+  for (auto &thief : thieves) {
+    thief.join();
+  }
+
+  EXPECT_EQ(popped + stolen.load(), k_items);
+  EXPECT_TRUE(std::all_of(taken.begin(), taken.end(), [](const auto &count) {
+    return count.load() == 1u;
+  }));
+}
+
+TEST(JobSystemTest, RunsEveryJobUnderStealing) {
+  JobSystem jobs(JobSystem::Config{.worker_count = 4});
+  jobs.start();
+
+  for (int round = 0; round < 10; ++round) {
+    std::atomic<int> ran{0};
+    std::vector<JobHandle> handles;
+    // Workers fan out more jobs onto their own deques so idle workers steal.
+    for (int outer = 0; outer < 32; ++outer) {
+      handles.push_back(jobs.submit([&ran]() {
+        std::vector<JobHandle> inner;
+        for (int index = 0; index < 64; ++index) {
+          inner.push_back(JobSystem::get()->submit(
+              [&ran]() { ran.fetch_add(1, std::memory_order_relaxed); },
+              JobQueue::Worker, static_cast<JobPriority>(index % 4)
+          ));
+        }
+        JobSystem::get()->wait_all(inner);
+      }));
+    }
+
+    jobs.wait_all(handles);
+    EXPECT_EQ(ran.load(), 32 * 64) << "round " << round;
+  }
+
+  jobs.end();
+}
+
+TEST(JobSystemTest, DependenciesRunInOrder) {
+  JobSystem jobs(JobSystem::Config{.worker_count = 3});
+  jobs.start();
+
+  std::vector<int> order;
+  JobHandle previous;
+  for (int index = 0; index < 200; ++index) {
+    const JobHandle dependencies[] = {previous};
+    previous = jobs.submit_after(
+        dependencies, [&order, index]() { order.push_back(index); }
+    );
+  }
+  jobs.wait(previous);
+
+  ASSERT_EQ(order.size(), 200u);
+  for (int index = 0; index < 200; ++index) {
+    EXPECT_EQ(order[index], index);
+  }
+
+  jobs.end();
+}
+
+TEST(JobSystemTest, FailedJobRethrowsToItsWaiterAndReleasesItsSlot) {
+  JobSystem jobs(JobSystem::Config{.worker_count = 1});
+  jobs.start();
+
+  auto failing = jobs.submit([]() { throw std::runtime_error("boom"); });
+  EXPECT_THROW(jobs.wait(failing), std::runtime_error);
+  EXPECT_TRUE(jobs.is_complete(failing));
+
+  // The slot went back to the pool, so the next job reuses it under a new
+  // generation and the stale handle stays complete.
+  auto next = jobs.submit([]() {});
+  EXPECT_EQ(slot_of(next), slot_of(failing));
+  EXPECT_NE(next.id, failing.id);
+  jobs.wait(next);
+  EXPECT_TRUE(jobs.is_complete(failing));
+  EXPECT_NO_THROW(jobs.wait(failing));
+
+  jobs.end();
+}
+
+TEST(JobSystemTest, FailuresDoNotLeakSlots) {
+  JobSystem jobs(JobSystem::Config{.worker_count = 3});
+  jobs.start();
+
+  uint32_t highest_slot = 0u;
+  for (int round = 0; round < 50; ++round) {
+    std::vector<JobHandle> handles;
+    for (int index = 0; index < 200; ++index) {
+      handles.push_back(jobs.submit([index]() {
+        if (index % 2 == 0) {
+          throw std::runtime_error("failed");
+        }
+      }));
+    }
+
+    size_t failures = 0u;
+    for (JobHandle handle : handles) {
+      highest_slot = std::max(highest_slot, slot_of(handle));
+      try {
+        jobs.wait(handle);
+      } catch (const std::runtime_error &) {
+        ++failures;
+      }
+    }
+    EXPECT_EQ(failures, 100u) << "round " << round;
+  }
+
+  // 10000 jobs went through; without recycling failed slots the pool would
+  // have grown past 5000.
+  EXPECT_LT(highest_slot, 2048u);
+
+  jobs.end();
+}
+
+TEST(JobSystemTest, FailedDependencyStillReleasesDependents) {
+  JobSystem jobs(JobSystem::Config{.worker_count = 2});
+  jobs.start();
+
+  std::atomic<bool> ran{false};
+  auto failing = jobs.submit([]() { throw std::runtime_error("boom"); });
+  const JobHandle dependencies[] = {failing};
+  auto dependent = jobs.submit_after(dependencies, [&ran]() { ran = true; });
+
+  jobs.wait(dependent);
+  EXPECT_TRUE(ran.load());
+  EXPECT_THROW(jobs.wait(failing), std::runtime_error);
+
+  jobs.end();
+}
+
+TEST(JobSystemTest, BarrierReleasesWaitingJobOnceAllAttachedJobsFinish) {
+  JobSystem jobs(JobSystem::Config{.worker_count = 2});
+  jobs.start();
+
+  auto barrier = jobs.create_barrier(10u);
+  std::atomic<int> finished{0};
+  std::atomic<int> seen{-1};
+  auto gated = jobs.submit_after_barrier(barrier, [&]() { seen = finished.load(); });
+  for (int index = 0; index < 10; ++index) {
+    jobs.attach_to_barrier(jobs.submit([&finished]() { finished++; }), barrier);
+  }
+
+  jobs.wait_barrier(barrier);
+  jobs.wait(gated);
+  EXPECT_EQ(seen.load(), 10);
+
+  jobs.end();
+}
+
+TEST(JobSystemTest, AcceptsSubmissionsFromOutsideThePool) {
+  JobSystem jobs(JobSystem::Config{.worker_count = 2});
+  jobs.start();
+
+  std::atomic<int> ran{0};
+  std::thread external([&ran]() {
+    std::vector<JobHandle> handles;
+    for (int index = 0; index < 1000; ++index) {
+      handles.push_back(JobSystem::get()->submit([&ran]() { ran++; }));
+    }
+    JobSystem::get()->wait_all(handles);
+  });
+  external.join();
+  EXPECT_EQ(ran.load(), 1000);
+
+  jobs.end();
+}
+
+} // namespace
+} // namespace astralix
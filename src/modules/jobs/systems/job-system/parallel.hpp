@@ -0,0 +1,157 @@
+#pragma once
+
+#include "job-system.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace astralix {
+
+// Calls fn(range_begin, range_end) over [begin, end) split into ranges of at
+// most `grain` elements. Falls back to a serial loop when no JobSystem is
+// running or the range fits in a single grain.
+template <typename Fn>
+void parallel_for(size_t begin, size_t end, size_t grain, Fn &&fn) {
+  if (end <= begin) {
+    return;
+  }
+
+  grain = std::max<size_t>(grain, 1u);
+  const size_t chunk_count = (end - begin + grain - 1u) / grain;
+  auto *jobs = JobSystem::get();
+
+  if (jobs == nullptr || chunk_count <= 1u) {
+    fn(begin, end);
+    return;
+  }
+
+  struct Context {
+    std::remove_reference_t<Fn> *fn;
+    size_t begin;
+    size_t end;
+    size_t grain;
+  } context{&fn, begin, end, grain};
+
+  jobs->run_tasks(chunk_count, &context, [](void *opaque, size_t chunk) {
+    auto &state = *static_cast<Context *>(opaque);
+    const size_t range_begin = state.begin + chunk * state.grain;
+    const size_t range_end = std::min(range_begin + state.grain, state.end);
+    (*state.fn)(range_begin, range_end);
+  });
+}
+
+// Maps every grain-sized range with map(range_begin, range_end) -> T and folds
+// the partial results with reduce(T, T) -> T in range order, so the result is
+// the same for any thread count as long as the grain does not change.
+template <typename T, typename Map, typename Reduce>
+T parallel_reduce(
+    size_t begin,
+    size_t end,
+    size_t grain,
+    T identity,
+    Map &&map,
+    Reduce &&reduce
+) {
+  if (end <= begin) {
+    return identity;
+  }
+
+  grain = std::max<size_t>(grain, 1u);
+  const size_t chunk_count = (end - begin + grain - 1u) / grain;
+
+  std::vector<T> partials(chunk_count, identity);
+  parallel_for(
+      0u, chunk_count, 1u,
+      [&](size_t chunk_begin, size_t chunk_end) {
+        for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+          const size_t range_begin = begin + chunk * grain;
+          partials[chunk] = map(range_begin, std::min(range_begin + grain, end));
+        }
+      }
+  );
+
+  T result = std::move(identity);
+  for (auto &partial : partials) {
+    result = reduce(std::move(result), std::move(partial));
+  }
+  return result;
+}
+
+// Fork/join scope: run() submits a task, wait() helps execute queued jobs
+// until every task of the group finished and rethrows the first failure.
+// Tasks whose captures fit in 48 bytes stay in JobCallable's inline storage.
+class TaskGroup {
+public:
+  explicit TaskGroup(JobPriority priority = JobPriority::Normal)
+      : m_jobs(JobSystem::get()), m_priority(priority) {}
+
+  ~TaskGroup() {
+    if (m_jobs != nullptr) {
+      m_jobs->wait_until_zero(m_pending);
+    }
+  }
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  template <typename F>
+  void run(F &&task) {
+    if (m_jobs == nullptr) {
+      invoke(task);
+      return;
+    }
+
+    m_pending.fetch_add(1u, std::memory_order_relaxed);
+    m_jobs->submit(
+        [this, task = std::forward<F>(task)]() mutable {
+          invoke(task);
+          m_pending.fetch_sub(1u, std::memory_order_acq_rel);
+        },
+        JobQueue::Worker,
+        m_priority
+    );
+  }
+
+  void wait() {
+    if (m_jobs != nullptr) {
+      m_jobs->wait_until_zero(m_pending);
+    }
+
+    std::exception_ptr exception;
+    {
+      std::lock_guard lock(m_exception_mutex);
+      exception = std::exchange(m_exception, nullptr);
+    }
+
+    if (exception != nullptr) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+private:
+  template <typename F>
+  void invoke(F &task) {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard lock(m_exception_mutex);
+      if (m_exception == nullptr) {
+        m_exception = std::current_exception();
+      }
+    }
+  }
+
+  JobSystem *m_jobs = nullptr;
+  JobPriority m_priority = JobPriority::Normal;
+  std::atomic<uint32_t> m_pending{0u};
+  std::mutex m_exception_mutex;
+  std::exception_ptr m_exception;
+};
+
+} // namespace astralix
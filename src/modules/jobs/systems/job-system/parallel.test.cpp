@@ -0,0 +1,220 @@
+#include "parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace astralix {
+namespace {
+
+class ParallelTest : public ::testing::Test {
+protected:
+  void SetUp() override { m_jobs.start(); }
+  void TearDown() override { m_jobs.end(); }
+
+private:
+  JobSystem m_jobs{JobSystem::Config{.worker_count = 3}};
+};
+
+// Every index in [begin, end) visited exactly once, and nothing outside it.
+void expect_covers(size_t begin, size_t end, size_t grain) {
+  std::vector<std::atomic<int>> visits(end + 8u);
+
+  parallel_for(begin, end, grain, [&](size_t range_begin, size_t range_end) {
+    EXPECT_LT(range_begin, range_end);
+    EXPECT_LE(range_end - range_begin, std::max<size_t>(grain, 1u));
+    for (size_t index = range_begin; index < range_end; ++index) {
+      visits[index].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  for (size_t index = 0u; index < visits.size(); ++index) {
+    const int expected = index >= begin && index < end ? 1 : 0;
+    EXPECT_EQ(visits[index].load(), expected)
+        << "index " << index << " of [" << begin << ", " << end << ") grain "
+        << grain;
+  }
+}
+
+TEST_F(ParallelTest, ForSkipsEmptyAndInvertedRanges) {
+  int calls = 0;
+  parallel_for(0u, 0u, 16u, [&](size_t, size_t) { calls++; });
+  parallel_for(10u, 10u, 16u, [&](size_t, size_t) { calls++; });
+  parallel_for(10u, 4u, 16u, [&](size_t, size_t) { calls++; });
+  EXPECT_EQ(calls, 0);
+}
+
+TEST_F(ParallelTest, ForCoversUnevenRanges) {
+  expect_covers(0u, 1000u, 7u);
+  expect_covers(13u, 1013u, 64u);
+  expect_covers(5u, 6u, 1u);
+  expect_covers(0u, 257u, 256u);
+  // A zero grain is treated as one element per range.
+  expect_covers(3u, 40u, 0u);
+}
+
+TEST_F(ParallelTest, ForRunsInlineWhenGrainExceedsRange) {
+  std::vector<std::pair<size_t, size_t>> ranges;
+  parallel_for(4u, 20u, 100u, [&](size_t range_begin, size_t range_end) {
+    ranges.emplace_back(range_begin, range_end);
+  });
+
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges.front(), (std::pair<size_t, size_t>{4u, 20u}));
+}
+
+TEST_F(ParallelTest, ReduceMatchesSerialResult) {
+  std::vector<uint64_t> values(100003u);
+  std::iota(values.begin(), values.end(), 1u);
+  const uint64_t serial = std::accumulate(values.begin(), values.end(), uint64_t{0});
+
+  for (size_t grain : {1u, 7u, 1000u, 200000u}) {
+    const uint64_t parallel = parallel_reduce(
+        size_t{0}, values.size(), grain, uint64_t{0},
+        [&](size_t range_begin, size_t range_end) {
+          uint64_t sum = 0u;
+          for (size_t index = range_begin; index < range_end; ++index) {
+            sum += values[index];
+          }
+          return sum;
+        },
+        [](uint64_t lhs, uint64_t rhs) { return lhs + rhs; }
+    );
+    EXPECT_EQ(parallel, serial) << "grain " << grain;
+  }
+}
+
+TEST_F(ParallelTest, ReduceFoldsInRangeOrder) {
+  // Concatenation is not commutative, so any reordering shows up.
+  const std::vector<int> folded = parallel_reduce(
+      size_t{0}, size_t{100}, size_t{9}, std::vector<int>{},
+      [](size_t range_begin, size_t range_end) {
+        std::vector<int> part;
+        for (size_t index = range_begin; index < range_end; ++index) {
+          part.push_back(static_cast<int>(index));
+        }
+        return part;
+      },
+      [](std::vector<int> lhs, std::vector<int> rhs) {
+        lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+        return lhs;
+      }
+  );
+
+  std::vector<int> expected(100);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(folded, expected);
+}
+
+TEST_F(ParallelTest, ReduceOfEmptyRangeReturnsIdentity) {
+  const int result = parallel_reduce(
+      size_t{5}, size_t{5}, size_t{4}, 42,
+      [](size_t, size_t) { return 1; }, [](int lhs, int rhs) { return lhs + rhs; }
+  );
+  EXPECT_EQ(result, 42);
+}
+
+TEST_F(ParallelTest, NestedTaskGroupsWaitForTheirOwnTasks) {
+  std::atomic<int> leaves{0};
+  TaskGroup outer;
+  for (int branch = 0; branch < 32; ++branch) {
+    outer.run([&leaves]() {
+      TaskGroup inner;
+      for (int leaf = 0; leaf < 16; ++leaf) {
+        inner.run([&leaves]() { leaves.fetch_add(1, std::memory_order_relaxed); });
+      }
+      inner.wait();
+    });
+  }
+  outer.wait();
+  EXPECT_EQ(leaves.load(), 32 * 16);
+
+  // Groups are reusable once waited on.
+  outer.run([&leaves]() { leaves.fetch_add(1); });
+  outer.wait();
+  EXPECT_EQ(leaves.load(), 32 * 16 + 1);
+}
+
+TEST_F(ParallelTest, NestedParallelForInsideTasks) {
+  std::atomic<size_t> visited{0u};
+  parallel_for(0u, 16u, 1u, [&](size_t, size_t) {
+    parallel_for(0u, 1000u, 10u, [&](size_t range_begin, size_t range_end) {
+      visited.fetch_add(range_end - range_begin, std::memory_order_relaxed);
+    });
+  });
+  EXPECT_EQ(visited.load(), 16u * 1000u);
+}
+
+TEST_F(ParallelTest, RethrowsExceptionsFromBodies) {
+  EXPECT_THROW(
+      parallel_for(0u, 100u, 1u, [](size_t range_begin, size_t) {
+        if (range_begin == 50u) {
+          throw std::runtime_error("parallel_for");
+        }
+      }),
+      std::runtime_error
+  );
+
+  EXPECT_THROW(
+      parallel_reduce(
+          size_t{0}, size_t{100}, size_t{10}, 0,
+          [](size_t range_begin, size_t) -> int {
+            if (range_begin == 30u) {
+              throw std::runtime_error("parallel_reduce");
+            }
+            return 1;
+          },
+          [](int lhs, int rhs) { return lhs + rhs; }
+      ),
+      std::runtime_error
+  );
+
+  TaskGroup group;
+  std::atomic<int> completed{0};
+  for (int index = 0; index < 8; ++index) {
+    group.run([&completed, index]() {
+      if (index == 3) {
+        throw std::runtime_error("task group");
+      }
+      completed++;
+    });
+  }
+  EXPECT_THROW(group.wait(), std::runtime_error);
+  EXPECT_EQ(completed.load(), 7);
+  // The failure was handed out once; the group is clean afterwards.
+  EXPECT_NO_THROW(group.wait());
+}
+
+TEST(ParallelWithoutJobSystemTest, RunsSerially) {
+  ASSERT_EQ(JobSystem::get(), nullptr);
+
+  std::vector<std::pair<size_t, size_t>> ranges;
+  parallel_for(0u, 10u, 3u, [&](size_t range_begin, size_t range_end) {
+    ranges.emplace_back(range_begin, range_end);
+  });
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges.front(), (std::pair<size_t, size_t>{0u, 10u}));
+
+  const long sum = parallel_reduce(
+      size_t{0}, size_t{10}, size_t{3}, 0L,
+      [](size_t range_begin, size_t range_end) {
+        return static_cast<long>(range_end - range_begin);
+      },
+      [](long lhs, long rhs) { return lhs + rhs; }
+  );
+  EXPECT_EQ(sum, 10);
+
+  int ran = 0;
+  TaskGroup group;
+  group.run([&ran]() { ran++; });
+  group.wait();
+  EXPECT_EQ(ran, 1);
+}
+
+} // namespace
+} // namespace astralix
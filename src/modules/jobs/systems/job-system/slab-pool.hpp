@@ -0,0 +1,117 @@
+#pragma once
+
+#include "assert.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace astralix {
+
+// Fixed-page pool addressed by a stable 32-bit index. Pages are never moved or
+// freed while the pool lives, so any thread may resolve an index without a
+// lock; only growing the pool takes the mutex. Free slots form a Treiber stack
+// whose head carries a tag to defeat ABA. T must expose an
+// `std::atomic<uint32_t> next_free` member.
+template <typename T>
+class SlabPool {
+public:
+  static constexpr uint32_t PAGE_SIZE = 1024u;
+  static constexpr uint32_t MAX_PAGES = 4096u;
+
+  SlabPool() = default;
+  SlabPool(const SlabPool &) = delete;
+  SlabPool &operator=(const SlabPool &) = delete;
+
+  ~SlabPool() {
+    const uint32_t page_count = m_page_count.load(std::memory_order_acquire);
+    for (uint32_t page = 0u; page < page_count; ++page) {
+      delete[] m_pages[page].load(std::memory_order_relaxed);
+    }
+  }
+
+  uint32_t acquire() {
+    for (;;) {
+      uint64_t head = m_free_head.load(std::memory_order_acquire);
+      const uint32_t encoded = static_cast<uint32_t>(head);
+      if (encoded == 0u) {
+        return grow();
+      }
+
+      const uint32_t index = encoded - 1u;
+      const uint32_t next =
+          at(index).next_free.load(std::memory_order_relaxed);
+      const uint64_t next_head = ((head >> 32u) + 1u) << 32u | next;
+      if (m_free_head.compare_exchange_weak(
+              head, next_head, std::memory_order_acq_rel,
+              std::memory_order_acquire
+          )) {
+        return index;
+      }
+    }
+  }
+
+  void release(uint32_t index) { push_free(index, index); }
+
+  T &at(uint32_t index) {
+    return m_pages[index / PAGE_SIZE].load(std::memory_order_acquire)
+        [index % PAGE_SIZE];
+  }
+
+  const T &at(uint32_t index) const {
+    return m_pages[index / PAGE_SIZE].load(std::memory_order_acquire)
+        [index % PAGE_SIZE];
+  }
+
+  bool contains(uint32_t index) const {
+    return index / PAGE_SIZE < m_page_count.load(std::memory_order_acquire);
+  }
+
+private:
+  uint32_t grow() {
+    std::lock_guard lock(m_grow_mutex);
+
+    const uint32_t page = m_page_count.load(std::memory_order_relaxed);
+    ASTRA_ENSURE(page >= MAX_PAGES, "SlabPool exhausted");
+
+    m_pages[page].store(new T[PAGE_SIZE], std::memory_order_release);
+    m_page_count.store(page + 1u, std::memory_order_release);
+
+    // Hand out the first slot and chain the rest onto the free stack.
+    const uint32_t first = page * PAGE_SIZE;
+    for (uint32_t offset = 1u; offset + 1u < PAGE_SIZE; ++offset) {
+      at(first + offset).next_free.store(
+          first + offset + 2u, std::memory_order_relaxed
+      );
+    }
+    push_free(first + 1u, first + PAGE_SIZE - 1u);
+    return first;
+  }
+
+  // Pushes the pre-linked chain [first..last] whose interior `next_free`
+  // values are already set; only `last` is linked to the current head.
+  void push_free(uint32_t first, uint32_t last) {
+    uint64_t head = m_free_head.load(std::memory_order_relaxed);
+    for (;;) {
+      at(last).next_free.store(
+          static_cast<uint32_t>(head), std::memory_order_relaxed
+      );
+      const uint64_t next_head = ((head >> 32u) + 1u) << 32u | (first + 1u);
+      if (m_free_head.compare_exchange_weak(
+              head, next_head, std::memory_order_release,
+              std::memory_order_relaxed
+          )) {
+        return;
+      }
+    }
+  }
+
+  std::array<std::atomic<T *>, MAX_PAGES> m_pages{};
+  std::atomic<uint32_t> m_page_count{0u};
+  std::atomic<uint64_t> m_free_head{0u};
+  std::mutex m_grow_mutex;
+};
+
+} // namespace astralix
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace astralix {
+
+// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). The owning thread pushes and pops at
+// the bottom; any other thread may steal from the top. Grown buffers are kept
+// until destruction because a concurrent thief may still be reading them.
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "deque elements are copied without synchronization");
+
+public:
+  explicit WorkStealingDeque(size_t capacity = 256u) {
+    size_t rounded = 1u;
+    while (rounded < capacity) {
+      rounded <<= 1u;
+    }
+
+    m_buffers.push_back(std::make_unique<Buffer>(rounded));
+    m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque &) = delete;
+  WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+  void push(T value) {
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_acquire);
+    Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+
+    if (bottom - top > static_cast<int64_t>(buffer->mask)) {
+      buffer = grow(buffer, top, bottom);
+    }
+
+    buffer->store(bottom, value);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+  }
+
+  std::optional<T> pop() {
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    std::optional<T> value = buffer->load(bottom);
+    if (top == bottom) {
+      // Last element: race any thief for it through top.
+      if (!m_top.compare_exchange_strong(
+              top, top + 1, std::memory_order_seq_cst,
+              std::memory_order_relaxed
+          )) {
+        value.reset();
+      }
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return value;
+  }
+
+  std::optional<T> steal() {
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+      return std::nullopt;
+    }
+
+    Buffer *buffer = m_buffer.load(std::memory_order_acquire);
+    T value = buffer->load(top);
+    if (!m_top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+        )) {
+      return std::nullopt;
+    }
+
+    return value;
+  }
+
+  bool empty() const {
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_relaxed);
+    return bottom <= top;
+  }
+
+  size_t size() const {
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0u;
+  }
+
+private:
+  struct Buffer {
+    explicit Buffer(size_t capacity)
+        : mask(capacity - 1u), slots(new std::atomic<T>[capacity]) {}
+
+    T load(int64_t index) const {
+      return slots[static_cast<size_t>(index) & mask].load(
+          std::memory_order_relaxed
+      );
+    }
+
+    void store(int64_t index, T value) {
+      slots[static_cast<size_t>(index) & mask].store(
+          value, std::memory_order_relaxed
+      );
+    }
+
+    size_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+  Buffer *grow(Buffer *buffer, int64_t top, int64_t bottom) {
+    auto grown = std::make_unique<Buffer>((buffer->mask + 1u) * 2u);
+    for (int64_t index = top; index < bottom; ++index) {
+      grown->store(index, buffer->load(index));
+    }
+
+    Buffer *next = grown.get();
+    m_buffers.push_back(std::move(grown));
+    m_buffer.store(next, std::memory_order_release);
+    return next;
+  }
+
+  alignas(64) std::atomic<int64_t> m_top{0};
+  alignas(64) std::atomic<int64_t> m_bottom{0};
+  std::atomic<Buffer *> m_buffer{nullptr};
+  std::vector<std::unique_ptr<Buffer>> m_buffers;
+};
+
+} // namespace astralix
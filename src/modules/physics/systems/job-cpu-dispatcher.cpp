@@ -0,0 +1,80 @@
+#include "job-cpu-dispatcher.hpp"
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace astralix {
+
+JobCpuDispatcher::JobCpuDispatcher(uint32_t worker_budget)
+    : m_worker_budget(std::max(worker_budget, 1u)) {}
+
+void JobCpuDispatcher::submitTask(physx::PxBaseTask &task) {
+  auto *jobs = JobSystem::get();
+  if (jobs == nullptr) {
+    run_task(task);
+    return;
+  }
+
+  {
+    std::lock_guard lock(m_mutex);
+    if (m_in_flight >= m_worker_budget) {
+      m_overflow.push_back(&task);
+      return;
+    }
+    ++m_in_flight;
+  }
+
+  jobs->submit(
+      [this, task_pointer = &task]() { run_slot(task_pointer); },
+      JobQueue::Worker,
+      JobPriority::High
+  );
+}
+
+uint32_t JobCpuDispatcher::getWorkerCount() const { return m_worker_budget; }
+
+JobCpuDispatcher::StepStats JobCpuDispatcher::consume_step_stats() {
+  return StepStats{
+      .task_count = m_task_count.exchange(0u, std::memory_order_relaxed),
+      .task_time_ns = m_task_time_ns.exchange(0u, std::memory_order_relaxed),
+  };
+}
+
+// Keeps the slot busy with overflowed tasks and only gives it back once the
+// overflow queue is empty, so a queued task always has a running job.
+void JobCpuDispatcher::run_slot(physx::PxBaseTask *task) {
+  for (;;) {
+    run_task(*task);
+
+    std::lock_guard lock(m_mutex);
+    if (m_overflow.empty()) {
+      --m_in_flight;
+      return;
+    }
+
+    task = m_overflow.front();
+    m_overflow.pop_front();
+  }
+}
+
+void JobCpuDispatcher::run_task(physx::PxBaseTask &task) {
+  ASTRA_PROFILE_DYN(task.getName(), std::strlen(task.getName()));
+
+  const auto begin = std::chrono::steady_clock::now();
+  task.run();
+  const auto elapsed = std::chrono::steady_clock::now() - begin;
+  task.release();
+
+  m_task_count.fetch_add(1u, std::memory_order_relaxed);
+  m_task_time_ns.fetch_add(
+      static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+      ),
+      std::memory_order_relaxed
+  );
+}
+
+} // namespace astralix
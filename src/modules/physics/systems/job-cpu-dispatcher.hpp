@@ -0,0 +1,45 @@
+#pragma once
+
+#include "systems/job-system/job-system.hpp"
+#include "task/PxCpuDispatcher.h"
+#include "task/PxTask.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace astralix {
+
+// PhysX CPU dispatcher backed by the engine JobSystem. Tasks run as High
+// priority worker jobs, with at most `worker_budget` of them in flight; extra
+// submissions wait in an overflow queue drained by the running jobs. When no
+// JobSystem is available tasks run inline on the submitting thread.
+class JobCpuDispatcher final : public physx::PxCpuDispatcher {
+public:
+  struct StepStats {
+    uint32_t task_count = 0u;
+    uint64_t task_time_ns = 0u;
+  };
+
+  explicit JobCpuDispatcher(uint32_t worker_budget);
+
+  void submitTask(physx::PxBaseTask &task) override;
+  uint32_t getWorkerCount() const override;
+
+  // Task timing accumulated since the last call; read once per simulate step.
+  StepStats consume_step_stats();
+
+private:
+  void run_slot(physx::PxBaseTask *task);
+  void run_task(physx::PxBaseTask &task);
+
+  uint32_t m_worker_budget = 1u;
+  std::mutex m_mutex;
+  uint32_t m_in_flight = 0u;
+  std::deque<physx::PxBaseTask *> m_overflow;
+  std::atomic<uint32_t> m_task_count{0u};
+  std::atomic<uint64_t> m_task_time_ns{0u};
+};
+
+} // namespace astralix
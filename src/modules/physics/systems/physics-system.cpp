@@ -12,12 +12,14 @@
 #include "events/key-codes.hpp"
 #include "events/keyboard.hpp"
 #include "extensions/PxRigidBodyExt.h"
+#include "job-cpu-dispatcher.hpp"
 #include "foundation/PxFoundation.h"
 #include "foundation/PxQuat.h"
 #include "foundation/PxSimpleTypes.h"
 #include "foundation/PxVec3.h"
 #include "managers/scene-manager.hpp"
 #include "managers/window-manager.hpp"
+#include "systems/job-system/job-system.hpp"
 #include "utils/math.hpp"
 #include <algorithm>
 #include <vector>
@@ -28,7 +30,7 @@ static PxDefaultAllocator g_allocator;
 static PxDefaultErrorCallback g_error_callback;
 static PxFoundation *g_foundation = nullptr;
 static PxPhysics *g_physics = nullptr;
-static PxDefaultCpuDispatcher *g_dispatcher = nullptr;
+static astralix::JobCpuDispatcher *g_dispatcher = nullptr;
 static PxScene *g_scene = nullptr;
 static PxMaterial *g_material = nullptr;
 static PxPvd *g_pvd = nullptr;
@@ -44,24 +46,6 @@ void toggle_physics_simulation() { g_simulate = !g_simulate; }
 
 namespace {
 
-void clear_registered_actors(
-    std::unordered_map<EntityID, PxRigidActor *> &actors
-) {
-  if (g_scene == nullptr) {
-    actors.clear();
-    return;
-  }
-
-  for (auto &[_, actor] : actors) {
-    if (actor != nullptr) {
-      g_scene->removeActor(*actor);
-      actor->release();
-    }
-  }
-
-  actors.clear();
-}
-
 PxTransform to_px_transform(const scene::Transform &transform) {
   return PxTransform(GlmVec3ToPxVec3(transform.position),
                      GlmQuatToPxQuat(transform.rotation));
@@ -133,13 +117,9 @@ void set_actor_pose(PxRigidActor *actor, const PxTransform &pose) {
   }
 }
 
-PxTransform actor_pose(PxRigidActor *actor) {
-  if (auto *dynamic_actor = actor->is<PxRigidDynamic>();
-      dynamic_actor != nullptr) {
-    return dynamic_actor->getGlobalPose();
-  }
-
-  return static_cast<PxRigidStatic *>(actor)->getGlobalPose();
+bool same_pose(const PxTransform &lhs, const PxTransform &rhs) {
+  return lhs.p == rhs.p && lhs.q.x == rhs.q.x && lhs.q.y == rhs.q.y &&
+         lhs.q.z == rhs.q.z && lhs.q.w == rhs.q.w;
 }
 
 } // namespace
@@ -148,7 +128,8 @@ PhysicsSystem::PhysicsSystem(PhysicsSystemConfig &config)
     : m_backend(config.backend), m_gravity(config.gravity),
       m_pvd({.host = config.pvd_host,
              .port = config.pvd_port,
-             .timeout = config.pvd_timeout}) {}
+             .timeout = config.pvd_timeout}),
+      m_worker_budget(config.worker_budget) {}
 
 void PhysicsSystem::start() {
   ASTRA_PROFILE_N("PhysicsSystem::start");
@@ -170,9 +151,16 @@ void PhysicsSystem::start() {
 
   PxSceneDesc scene_desc(g_physics->getTolerancesScale());
   scene_desc.gravity = PxVec3(m_gravity.x, m_gravity.y, m_gravity.z);
-  g_dispatcher = PxDefaultCpuDispatcherCreate(2);
+  uint32_t worker_budget = m_worker_budget;
+  if (worker_budget == 0u) {
+    auto *jobs = JobSystem::get();
+    worker_budget = jobs != nullptr ? jobs->worker_count() : 1u;
+  }
+  g_dispatcher = new JobCpuDispatcher(worker_budget);
   scene_desc.cpuDispatcher = g_dispatcher;
   scene_desc.filterShader = PxDefaultSimulationFilterShader;
+  // Only bodies that moved during a step are reported back for pose sync.
+  scene_desc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
 
   g_scene = g_physics->createScene(scene_desc);
   ASTRA_ENSURE(g_scene == nullptr, "[PHYSICS SYSTEM] scene init failed")
@@ -194,7 +182,7 @@ void PhysicsSystem::fixed_update(double fixed_dt) {
 
   auto scene_manager = SceneManager::get();
   if (scene_manager == nullptr) {
-    clear_registered_actors(m_actors);
+    clear_actors();
     m_registered_scene = nullptr;
     m_registered_scene_revision = 0u;
     m_registered_scene_generation = 0u;
@@ -206,7 +194,7 @@ void PhysicsSystem::fixed_update(double fixed_dt) {
   const uint64_t scene_generation =
       scene_manager->scene_instance_generation();
   if (m_registered_scene_generation != scene_generation) {
-    clear_registered_actors(m_actors);
+    clear_actors();
     m_registered_scene = nullptr;
     m_registered_scene_revision = 0u;
     m_registered_scene_generation = scene_generation;
@@ -214,7 +202,7 @@ void PhysicsSystem::fixed_update(double fixed_dt) {
 
   auto active_scene = scene_manager->get_active_scene();
   if (active_scene == nullptr) {
-    clear_registered_actors(m_actors);
+    clear_actors();
     m_registered_scene = nullptr;
     m_registered_scene_revision = 0u;
     m_registered_scene_generation = scene_generation;
@@ -223,91 +211,241 @@ void PhysicsSystem::fixed_update(double fixed_dt) {
 
   if (active_scene->get_session_kind() != SceneSessionKind::Preview &&
       active_scene->get_session_kind() != SceneSessionKind::Runtime) {
-    clear_registered_actors(m_actors);
+    clear_actors();
     m_registered_scene = nullptr;
     m_registered_scene_revision = 0u;
     m_registered_scene_generation = scene_generation;
     return;
   }
 
-  if (m_registered_scene != active_scene ||
-      m_registered_scene_revision != active_scene->get_session_revision()) {
-    // Preview and runtime worlds can reuse the same entity ids, so actors
-    // must be rebuilt whenever the active scene instance changes or is reset.
-    clear_registered_actors(m_actors);
+  if (m_registered_scene != active_scene) {
+    // Entity handles are only meaningful inside one world, so a different
+    // scene instance still starts from an empty actor table.
+    clear_actors();
     m_registered_scene = active_scene;
+  }
+
+  if (m_registered_scene_revision != active_scene->get_session_revision()) {
+    // A session reset respawns entities under new handles; reconciling drops
+    // the stale ones and picks up the new ones without a full rebuild.
     m_registered_scene_revision = active_scene->get_session_revision();
+    m_actors_synced = false;
   }
 
   auto &world = active_scene->world();
   resolve_box_colliders_from_render_mesh(world);
-  std::vector<EntityID> stale_entities;
-  stale_entities.reserve(m_actors.size());
-
-  for (const auto &[entity_id, actor] : m_actors) {
-    if (!world.contains(entity_id) || !world.active(entity_id) ||
-        !world.has<scene::Transform>(entity_id) ||
-        !world.has<physics::RigidBody>(entity_id)) {
-      if (actor != nullptr) {
-        g_scene->removeActor(*actor);
-        actor->release();
-      }
-      stale_entities.push_back(entity_id);
-    }
+
+  if (!m_actors_synced || m_synced_world_revision != world.revision()) {
+    reconcile_actors(world);
   }
 
-  for (EntityID entity_id : stale_entities) {
-    m_actors.erase(entity_id);
+  push_dirty_poses(world);
+
+  if (!g_simulate || !active_scene->is_playing() || m_actors.empty()) {
+    return;
   }
 
-  world.each<scene::Transform, physics::RigidBody>(
-      [&](EntityID entity_id, scene::Transform &transform,
-          physics::RigidBody &rigid_body) {
-        if (!world.active(entity_id) || m_actors.contains(entity_id)) {
-          return;
-        }
+  {
+    ASTRA_PROFILE_N("PhysX::simulate");
+    g_scene->simulate(fixed_dt);
+    g_scene->fetchResults(true);
 
-        auto entity = world.entity(entity_id);
-        auto *actor = create_actor(entity, transform, rigid_body);
-        if (actor == nullptr) {
-          return;
-        }
+    const auto stats = g_dispatcher->consume_step_stats();
+    ASTRA_PROFILE_PLOT("PhysX tasks", static_cast<int64_t>(stats.task_count));
+    ASTRA_PROFILE_PLOT(
+        "PhysX task time (ms)",
+        static_cast<double>(stats.task_time_ns) / 1.0e6
+    );
+  }
 
-        g_scene->addActor(*actor);
-        m_actors.emplace(entity_id, actor);
-      });
+  pull_active_poses(world);
+}
 
-  for (auto &[entity_id, actor] : m_actors) {
-    auto entity = world.entity(entity_id);
-    auto *transform = entity.get<scene::Transform>();
-    if (actor == nullptr || transform == nullptr || !transform->dirty) {
+void PhysicsSystem::clear_actors() {
+  for (auto &entry : m_actors) {
+    if (entry.actor == nullptr) {
       continue;
     }
 
-    set_actor_pose(actor, to_px_transform(*transform));
+    if (g_scene != nullptr) {
+      g_scene->removeActor(*entry.actor);
+    }
+    entry.actor->release();
   }
 
-  if (!g_simulate || !active_scene->is_playing() || m_actors.empty()) {
+  m_actors.clear();
+  m_actor_by_slot.clear();
+  m_pose_query.reset();
+  m_pending_poses.clear();
+  m_actors_synced = false;
+  m_synced_world_revision = 0u;
+  m_reconcile_tick = 0u;
+}
+
+// Runs only when the world's structure changed. Actors whose entity is gone,
+// deactivated, stripped of a required component, or whose body or collider
+// was rewritten since the last pass are dropped; matching entities without an
+// actor get one.
+void PhysicsSystem::reconcile_actors(ecs::World &world) {
+  ASTRA_PROFILE_N("PhysicsSystem::reconcile_actors");
+
+  for (size_t index = 0u; index < m_actors.size();) {
+    const auto &entry = m_actors[index];
+    const auto *rigid_body = world.get<physics::RigidBody>(entry.handle);
+
+    const bool keep =
+        rigid_body != nullptr && rigid_body->mode == entry.mode &&
+        world.active(entry.handle) &&
+        world.has<scene::Transform>(entry.handle) &&
+        !world.changed_since<physics::RigidBody>(
+            entry.handle, m_reconcile_tick
+        ) &&
+        !world.changed_since<physics::BoxCollider>(
+            entry.handle, m_reconcile_tick
+        );
+
+    if (keep) {
+      ++index;
+      continue;
+    }
+
+    remove_actor(index);
+  }
+
+  world.each<const scene::Transform, const physics::RigidBody>(
+      [&](ecs::EntityHandle handle, const scene::Transform &transform,
+          const physics::RigidBody &rigid_body) {
+        if (find_actor(handle) != nullptr || !world.active(handle)) {
+          return;
+        }
+
+        add_actor(world, world.id(handle), handle, transform, rigid_body);
+      });
+
+  m_reconcile_tick = world.advance_change_tick();
+  m_synced_world_revision = world.revision();
+  m_actors_synced = true;
+}
+
+void PhysicsSystem::add_actor(ecs::World &world, EntityID entity_id,
+                              ecs::EntityHandle handle,
+                              const scene::Transform &transform,
+                              const physics::RigidBody &rigid_body) {
+  auto *actor = create_actor(world.entity(handle), transform, rigid_body);
+  if (actor == nullptr) {
     return;
   }
 
-  {
-    ASTRA_PROFILE_N("PhysX::simulate");
-    g_scene->simulate(fixed_dt);
-    g_scene->fetchResults(true);
+  const auto index = static_cast<uint32_t>(m_actors.size());
+  actor->userData = reinterpret_cast<void *>(uintptr_t{index} + 1u);
+  g_scene->addActor(*actor);
+
+  m_actors.push_back(ActorEntry{
+      .entity_id = entity_id,
+      .handle = handle,
+      .actor = actor,
+      .mode = rigid_body.mode,
+      .synced_pose = to_px_transform(transform),
+  });
+  if (handle.index >= m_actor_by_slot.size()) {
+    m_actor_by_slot.resize(handle.index + 1u, 0u);
+  }
+  m_actor_by_slot[handle.index] = index + 1u;
+}
+
+void PhysicsSystem::remove_actor(size_t index) {
+  auto &entry = m_actors[index];
+  if (entry.actor != nullptr) {
+    g_scene->removeActor(*entry.actor);
+    entry.actor->release();
+  }
+  m_actor_by_slot[entry.handle.index] = 0u;
+
+  if (index + 1u != m_actors.size()) {
+    entry = m_actors.back();
+    entry.actor->userData = reinterpret_cast<void *>(uintptr_t{index} + 1u);
+    m_actor_by_slot[entry.handle.index] = static_cast<uint32_t>(index) + 1u;
+  }
+  m_actors.pop_back();
+}
+
+PhysicsSystem::ActorEntry *PhysicsSystem::find_actor(ecs::EntityHandle handle) {
+  if (handle.index >= m_actor_by_slot.size() ||
+      m_actor_by_slot[handle.index] == 0u) {
+    return nullptr;
   }
 
-  for (auto &[entity_id, actor] : m_actors) {
-    auto entity = world.entity(entity_id);
-    auto *transform = entity.get<scene::Transform>();
-    if (actor == nullptr || transform == nullptr) {
+  // A recycled slot keeps pointing at the old actor until reconcile drops
+  // it, so the generation has to match too.
+  auto &entry = m_actors[m_actor_by_slot[handle.index] - 1u];
+  return entry.handle == handle ? &entry : nullptr;
+}
+
+// Gameplay moves bodies by writing Transform, which the transform system
+// change-stamps. The query only visits archetypes and rows stamped since the
+// previous push, and rows whose pose still matches what PhysX last reported
+// are skipped so sleeping bodies are not woken by our own write-back. Poses
+// are collected first and applied in one pass.
+void PhysicsSystem::push_dirty_poses(ecs::World &world) {
+  ASTRA_PROFILE_N("PhysicsSystem::push_dirty_poses");
+
+  if (!m_pose_query.has_value()) {
+    m_pose_query.emplace(world);
+    m_pose_query->changed<scene::Transform>();
+  }
+
+  m_pending_poses.clear();
+  m_pose_query->each([&](ecs::EntityHandle handle,
+                         const scene::Transform &transform,
+                         const physics::RigidBody &) {
+    auto *entry = find_actor(handle);
+    if (entry == nullptr) {
+      return;
+    }
+
+    const PxTransform pose = to_px_transform(transform);
+    if (same_pose(pose, entry->synced_pose)) {
+      return;
+    }
+
+    entry->synced_pose = pose;
+    m_pending_poses.emplace_back(entry->actor, pose);
+  });
+
+  for (const auto &[actor, pose] : m_pending_poses) {
+    set_actor_pose(actor, pose);
+  }
+}
+
+void PhysicsSystem::pull_active_poses(ecs::World &world) {
+  ASTRA_PROFILE_N("PhysicsSystem::pull_active_poses");
+
+  PxU32 active_count = 0u;
+  PxActor **active_actors = g_scene->getActiveActors(active_count);
+
+  for (PxU32 active_index = 0u; active_index < active_count; ++active_index) {
+    auto *actor = active_actors[active_index]->is<PxRigidActor>();
+    if (actor == nullptr || actor->userData == nullptr) {
+      continue;
+    }
+
+    const size_t index = reinterpret_cast<uintptr_t>(actor->userData) - 1u;
+    if (index >= m_actors.size() || m_actors[index].actor != actor) {
+      continue;
+    }
+
+    auto &entry = m_actors[index];
+    auto *transform = world.get<scene::Transform>(entry.handle);
+    if (transform == nullptr) {
       continue;
     }
 
-    const PxTransform pose = actor_pose(actor);
+    const PxTransform pose = actor->getGlobalPose();
+    entry.synced_pose = pose;
     transform->position = glm::vec3(pose.p.x, pose.p.y, pose.p.z);
     transform->rotation = PxQuatToGlmQuat(pose.q);
     transform->dirty = true;
+    world.mark_changed<scene::Transform>(entry.handle);
   }
 }
 
@@ -324,15 +462,7 @@ void PhysicsSystem::update(double dt) {
 }
 
 PhysicsSystem::~PhysicsSystem() {
-  for (auto &[_, actor] : m_actors) {
-    if (actor != nullptr) {
-      if (g_scene != nullptr) {
-        g_scene->removeActor(*actor);
-      }
-      actor->release();
-    }
-  }
-  m_actors.clear();
+  clear_actors();
 
   if (g_scene != nullptr) {
     g_scene->release();
@@ -340,7 +470,7 @@ PhysicsSystem::~PhysicsSystem() {
   }
 
   if (g_dispatcher != nullptr) {
-    g_dispatcher->release();
+    delete g_dispatcher;
     g_dispatcher = nullptr;
   }
 
@@ -1,11 +1,17 @@
 #pragma once
 
 #include "PxRigidActor.h"
+#include "components/rigidbody.hpp"
+#include "components/transform.hpp"
+#include "foundation/PxTransform.h"
 #include "project.hpp"
 #include "systems/system.hpp"
-#include "unordered_map"
+#include "world.hpp"
 
 #include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
 
 namespace astralix {
 
@@ -32,16 +38,49 @@ public:
   void update(double dt) override;
 
 private:
+  // Dense actor table. Each actor's userData holds its index + 1 so active
+  // actors reported by PhysX map back to their entity without a lookup.
+  struct ActorEntry {
+    EntityID entity_id;
+    ecs::EntityHandle handle{0u, 0u};
+    physx::PxRigidActor *actor = nullptr;
+    physics::RigidBodyMode mode = physics::RigidBodyMode::Dynamic;
+    // Last pose exchanged with PhysX, used to skip echoing our own writes.
+    physx::PxTransform synced_pose;
+  };
+
+  void clear_actors();
+  void reconcile_actors(ecs::World &world);
+  void add_actor(ecs::World &world, EntityID entity_id,
+                 ecs::EntityHandle handle, const scene::Transform &transform,
+                 const physics::RigidBody &rigid_body);
+  void remove_actor(size_t index);
+  ActorEntry *find_actor(ecs::EntityHandle handle);
+  void push_dirty_poses(ecs::World &world);
+  void pull_active_poses(ecs::World &world);
+
   std::string
       m_backend; // Later we're going to add support for multiple backends
 
   glm::vec3 m_gravity;
 
   Pvd m_pvd;
+  uint32_t m_worker_budget = 0u;
   Scene *m_registered_scene = nullptr;
   uint64_t m_registered_scene_revision = 0u;
   uint64_t m_registered_scene_generation = 0u;
-  std::unordered_map<EntityID, physx::PxRigidActor *> m_actors;
+  uint64_t m_synced_world_revision = 0u;
+  uint32_t m_reconcile_tick = 0u;
+  bool m_actors_synced = false;
+
+  std::vector<ActorEntry> m_actors;
+  // Actor index + 1 per entity slot, 0 when the slot has no actor.
+  std::vector<uint32_t> m_actor_by_slot;
+  // Transform writes since the previous push; built per world.
+  std::optional<ecs::Query<const scene::Transform, const physics::RigidBody>>
+      m_pose_query;
+  std::vector<std::pair<physx::PxRigidActor *, physx::PxTransform>>
+      m_pending_poses;
 };
 
 } // namespace astralix
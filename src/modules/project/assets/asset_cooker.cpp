@@ -3,42 +3,48 @@
 #include "assert.hpp"
 #include "assets/asset_path.hpp"
 #include "entities/serializers/axmesh-serializer.hpp"
-#include "importers/model-importer.hpp"
+#include "fnv1a.hpp"
 
-#include <cctype>
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
 
 namespace astralix {
 namespace {
 
-uint64_t fnv1a_64(std::string_view input) {
-  uint64_t hash = 14695981039346656037ull;
-  for (unsigned char ch : input) {
-    hash ^= static_cast<uint64_t>(ch);
-    hash *= 1099511628211ull;
-  }
-  return hash;
+bool artifacts_exist(const std::filesystem::path &output_root, const CookedArtifacts &cooked) {
+  return std::all_of(
+      cooked.artifacts.begin(), cooked.artifacts.end(),
+      [&](const std::string &artifact) {
+        return std::filesystem::is_regular_file(output_root / artifact);
+      }
+  );
 }
 
-std::string hex_suffix(uint64_t value) {
-  std::ostringstream out;
-  out << std::hex << std::nouppercase << std::setw(8) << std::setfill('0')
-      << static_cast<uint32_t>(value & 0xffffffffu);
-  return out.str();
-}
+// Files the importer read besides the source, which the cook key already
+// covers. A changed .mtl can change the material slots without touching the
+// .obj, so these are checked before a cached artifact is reused.
+std::vector<CookedSideFile> side_files(
+    const std::filesystem::path &source_path,
+    std::span<const std::filesystem::path> read_files, const CookCache &previous,
+    CookCache &next
+) {
+  const auto source = source_path.lexically_normal();
 
-std::string sanitize_stem(const std::filesystem::path &path) {
-  std::string stem = path.stem().string();
-  for (char &ch : stem) {
-    if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '-') {
-      ch = '-';
+  std::vector<CookedSideFile> side_files;
+  for (const auto &file : read_files) {
+    const auto path = file.lexically_normal();
+    if (path == source || !std::filesystem::is_regular_file(path)) {
+      continue;
     }
+
+    side_files.push_back(CookedSideFile{
+        .path = path.generic_string(),
+        .hash = previous.hash_source(path, next),
+    });
   }
-  if (stem.empty()) {
-    stem = "asset";
-  }
-  return stem;
+
+  return side_files;
 }
 
 std::string to_manifest_asset_path(const ResolvedAssetPath &path) {
@@ -47,7 +53,54 @@ std::string to_manifest_asset_path(const ResolvedAssetPath &path) {
 
 } // namespace
 
-AssetCooker::AssetCooker(AssetGraphConfig config) : m_graph(std::move(config)) {}
+uint64_t model_cook_key(uint64_t source_hash, const ModelImportConfig &import) {
+  uint64_t hash = k_fnv1a64_offset_basis;
+  hash = fnv1a64_append_value(hash, k_asset_cooker_version);
+  hash = fnv1a64_append_value(hash, AxMeshSerializer::k_version);
+  hash = fnv1a64_append_value(hash, k_axmesh_binary_version);
+  hash = fnv1a64_append_value(hash, source_hash);
+  hash = fnv1a64_append_value(hash, import.triangulate);
+  hash = fnv1a64_append_value(hash, import.flip_uvs);
+  hash = fnv1a64_append_value(hash, import.generate_normals);
+  hash = fnv1a64_append_value(hash, import.calculate_tangents);
+  hash = fnv1a64_append_value(hash, import.pre_transform_vertices);
+  return hash;
+}
+
+size_t remove_unreferenced_artifacts(
+    const std::filesystem::path &output_root, const CookCache &cache
+) {
+  const auto artifacts_root = output_root / "artifacts";
+  if (!std::filesystem::exists(artifacts_root)) {
+    return 0u;
+  }
+
+  const auto referenced_list = cache.referenced_artifacts();
+  const std::unordered_set<std::string> referenced(
+      referenced_list.begin(), referenced_list.end()
+  );
+
+  std::vector<std::filesystem::path> stale;
+  for (const auto &entry : std::filesystem::recursive_directory_iterator(artifacts_root)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+
+    const auto relative = entry.path().lexically_relative(output_root).generic_string();
+    if (!referenced.contains(relative)) {
+      stale.push_back(entry.path());
+    }
+  }
+
+  for (const auto &path : stale) {
+    std::filesystem::remove(path);
+  }
+
+  return stale.size();
+}
+
+AssetCooker::AssetCooker(AssetGraphConfig config, ModelImportFn import_model)
+    : m_graph(std::move(config)), m_import_model(std::move(import_model)) {}
 
 AssetCookOutput AssetCooker::cook(
     std::span<const AssetBindingConfig> roots,
@@ -58,12 +111,16 @@ AssetCookOutput AssetCooker::cook(
   AssetCookOutput output;
   output.output_root = output_root.lexically_normal();
   output.manifest_path = (output.output_root / "pack.axpack").lexically_normal();
+  output.cache_path = (output.output_root / "cook-cache.json").lexically_normal();
   output.manifest.assets.reserve(m_graph.records().size());
 
   const auto artifact_models_root =
       (output.output_root / "artifacts" / "models").lexically_normal();
   std::filesystem::create_directories(artifact_models_root);
 
+  const CookCache previous = CookCache::load(output.cache_path);
+  CookCache next;
+
   for (const auto *record : m_graph.topological_order()) {
     PackManifestAsset manifest_asset{
         .descriptor_id = record->descriptor_id,
@@ -78,44 +135,73 @@ AssetCookOutput AssetCooker::cook(
 
     if (record->kind == AssetKind::Model) {
       const auto &payload = std::get<ModelAssetData>(record->payload);
-      auto imported = import_model_file(
-          m_graph.to_absolute_path(payload.source_path),
-          ModelImportSettings{
-              .triangulate = payload.import.triangulate,
-              .flip_uvs = payload.import.flip_uvs,
-              .generate_normals = payload.import.generate_normals,
-          }
-      );
+      const auto source_path = m_graph.to_absolute_path(payload.source_path);
+      const uint64_t cook_key =
+          model_cook_key(previous.hash_source(source_path, next), payload.import);
+
+      const CookedArtifacts *cooked = next.find(cook_key);
+      if (cooked != nullptr) {
+        ++output.deduplicated_artifact_count;
+      } else if (const auto *cached = previous.find(cook_key);
+                 cached != nullptr && artifacts_exist(output.output_root, *cached) &&
+                 previous.side_files_unchanged(*cached, next)) {
+        next.record(cook_key, *cached);
+        cooked = next.find(cook_key);
+        ++output.cache_hits;
+      } else {
+        auto imported = m_import_model(
+            source_path,
+            ModelImportSettings{
+                .triangulate = payload.import.triangulate,
+                .flip_uvs = payload.import.flip_uvs,
+                .generate_normals = payload.import.generate_normals,
+                .pre_transform_vertices = payload.import.pre_transform_vertices,
+            }
+        );
+
+        // Named by cook key, so assets with identical inputs share one file.
+        const auto artifact_relative =
+            (std::filesystem::path("artifacts") / "models" /
+             (fnv1a64_hex_digest(cook_key) + ".axmesh"))
+                .generic_string();
+        AxMeshSerializer::write(
+            (output.output_root / artifact_relative).lexically_normal(), imported.meshes
+        );
+
+        next.record(
+            cook_key,
+            CookedArtifacts{
+                .artifacts = {artifact_relative},
+                .material_slot_count = static_cast<uint32_t>(imported.material_slot_count),
+                .side_files = side_files(source_path, imported.source_files, previous, next),
+            }
+        );
+        cooked = next.find(cook_key);
+        ++output.cache_misses;
+        ++output.cooked_artifact_count;
+      }
 
       ASTRA_ENSURE(
-          imported.material_slot_count != payload.material_asset_keys.size(),
+          cooked->material_slot_count != payload.material_asset_keys.size(),
           "Model asset '",
           record->descriptor_id,
           "' declares ",
           payload.material_asset_keys.size(),
           " material asset(s) but importer found ",
-          imported.material_slot_count,
+          cooked->material_slot_count,
           " material slot(s)"
       );
 
-      const auto artifact_name =
-          sanitize_stem(record->asset_path.relative_path) + "-" +
-          hex_suffix(fnv1a_64(record->asset_key)) + ".axmesh";
-      const auto artifact_relative =
-          (std::filesystem::path("artifacts") / "models" / artifact_name)
-              .generic_string();
-      const auto artifact_absolute =
-          (output.output_root / artifact_relative).lexically_normal();
-
-      AxMeshSerializer::write(artifact_absolute, imported.meshes);
-      manifest_asset.artifacts.push_back(artifact_relative);
-      ++output.cooked_artifact_count;
+      manifest_asset.artifacts = cooked->artifacts;
     }
 
     output.manifest.assets.push_back(std::move(manifest_asset));
   }
 
+  output.removed_artifact_count = remove_unreferenced_artifacts(output.output_root, next);
+
   output.manifest.write(output.manifest_path);
+  next.save(output.cache_path);
   return output;
 }
 
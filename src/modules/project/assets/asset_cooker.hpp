@@ -2,9 +2,12 @@
 
 #include "assets/asset_binding.hpp"
 #include "assets/asset_graph.hpp"
+#include "assets/cook_cache.hpp"
 #include "assets/pack_manifest.hpp"
+#include "importers/model-importer.hpp"
 
 #include <filesystem>
+#include <functional>
 #include <span>
 
 namespace astralix {
@@ -13,12 +16,37 @@ struct AssetCookOutput {
   PackManifest manifest;
   std::filesystem::path output_root;
   std::filesystem::path manifest_path;
+  std::filesystem::path cache_path;
+  // Artifacts imported and written by this cook.
   size_t cooked_artifact_count = 0;
+  // Models whose cook key was found in the cook cache with its artifacts on
+  // disk, or already cooked for another asset earlier in this run.
+  size_t cache_hits = 0;
+  size_t deduplicated_artifact_count = 0;
+  size_t cache_misses = 0;
+  // Files under artifacts/ that no cache entry references any more.
+  size_t removed_artifact_count = 0;
 };
 
+// Cache key of a model artifact: the source bytes' hash, the import settings
+// and every version that shapes the cooked file.
+uint64_t model_cook_key(uint64_t source_hash, const ModelImportConfig &import);
+
+// Deletes files under `output_root`/artifacts that `cache` does not
+// reference and returns how many went.
+size_t remove_unreferenced_artifacts(
+    const std::filesystem::path &output_root, const CookCache &cache
+);
+
+using ModelImportFn = std::function<ImportedModelData(
+    const std::filesystem::path &, const ModelImportSettings &
+)>;
+
 class AssetCooker {
 public:
-  explicit AssetCooker(AssetGraphConfig config);
+  explicit AssetCooker(
+      AssetGraphConfig config, ModelImportFn import_model = import_model_file
+  );
 
   AssetCookOutput cook(
       std::span<const AssetBindingConfig> roots,
@@ -27,6 +55,7 @@ public:
 
 private:
   AssetGraph m_graph;
+  ModelImportFn m_import_model;
 };
 
 } // namespace astralix
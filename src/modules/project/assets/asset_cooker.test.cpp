@@ -0,0 +1,232 @@
+#include "assets/asset_cooker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace astralix {
+namespace {
+
+std::filesystem::path make_temp_root(const char *suffix) {
+  const auto root =
+      std::filesystem::temp_directory_path() / std::string(suffix);
+  std::filesystem::remove_all(root);
+  std::filesystem::create_directories(root);
+  return root;
+}
+
+void write_text(const std::filesystem::path &path, const std::string &text) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << text;
+}
+
+// A project with two models over one source and one that imports it with
+// other settings: two artifacts, one of them shared.
+class AssetCookerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    const std::string name =
+        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    m_root = make_temp_root(("astralix-asset-cooker-" + name).c_str());
+    write_text(resources_root() / "models" / "crate.obj", "v 0 0 0\n");
+    write_model("crate", "{}");
+    write_model("crate_copy", "{}");
+    write_model("crate_flat", R"json({"generate_normals": false})json");
+  }
+
+  std::filesystem::path resources_root() const { return m_root / "project" / "assets"; }
+  std::filesystem::path output_root() const { return m_root / "cooked"; }
+
+  void write_model(const std::string &name, const std::string &import) {
+    write_text(
+        resources_root() / "models" / (name + ".axmodel"),
+        R"json({"version": 1, "source": "crate.obj", "import": )json" + import + "}"
+    );
+  }
+
+  // Cooks with a fresh cooker, as a separate build run would, counting the
+  // sources the importer is asked for.
+  AssetCookOutput cook() {
+    AssetCooker cooker(
+        AssetGraphConfig{
+            .project_root = m_root / "project",
+            .project_resources_root = resources_root(),
+            .engine_assets_root = m_root / "engine",
+        },
+        [this](const std::filesystem::path &source, const ModelImportSettings &) {
+          ++m_imports;
+          // Reads the .mtl beside the source when there is one, like assimp.
+          ImportedModelData imported{.meshes = {Mesh::cube()}, .source_files = {source}};
+          const auto material_library = source.parent_path() / "crate.mtl";
+          if (std::filesystem::exists(material_library)) {
+            imported.source_files.push_back(material_library);
+          }
+          return imported;
+        }
+    );
+
+    const std::vector<AssetBindingConfig> roots = {
+        {.id = "models::crate", .asset_path = "models/crate.axmodel"},
+        {.id = "models::crate_copy", .asset_path = "models/crate_copy.axmodel"},
+        {.id = "models::crate_flat", .asset_path = "models/crate_flat.axmodel"},
+    };
+    return cooker.cook(roots, output_root());
+  }
+
+  static const PackManifestAsset &asset(const AssetCookOutput &output, const char *id) {
+    for (const auto &asset : output.manifest.assets) {
+      if (asset.descriptor_id == id) {
+        return asset;
+      }
+    }
+    ADD_FAILURE() << "no manifest entry for " << id;
+    return output.manifest.assets.front();
+  }
+
+  std::filesystem::path m_root;
+  size_t m_imports = 0u;
+};
+
+TEST_F(AssetCookerTest, FirstCookImportsEachCookKeyOnce) {
+  const auto output = cook();
+
+  EXPECT_EQ(m_imports, 2u);
+  EXPECT_EQ(output.cache_misses, 2u);
+  EXPECT_EQ(output.cooked_artifact_count, 2u);
+  EXPECT_EQ(output.deduplicated_artifact_count, 1u);
+  EXPECT_EQ(output.cache_hits, 0u);
+  EXPECT_EQ(output.removed_artifact_count, 0u);
+
+  // Identical inputs share one artifact; other import settings do not.
+  const auto &crate = asset(output, "models::crate");
+  ASSERT_EQ(crate.artifacts.size(), 1u);
+  EXPECT_EQ(asset(output, "models::crate_copy").artifacts, crate.artifacts);
+  EXPECT_NE(asset(output, "models::crate_flat").artifacts, crate.artifacts);
+  EXPECT_TRUE(std::filesystem::is_regular_file(output_root() / crate.artifacts.front()));
+}
+
+TEST_F(AssetCookerTest, UnchangedInputsImportAndDeleteNothing) {
+  const auto first = cook();
+  m_imports = 0u;
+
+  const auto second = cook();
+  EXPECT_EQ(m_imports, 0u);
+  EXPECT_EQ(second.cache_misses, 0u);
+  EXPECT_EQ(second.cooked_artifact_count, 0u);
+  EXPECT_EQ(second.cache_hits, 2u);
+  EXPECT_EQ(second.deduplicated_artifact_count, 1u);
+  EXPECT_EQ(second.removed_artifact_count, 0u);
+
+  for (const auto &asset : second.manifest.assets) {
+    EXPECT_EQ(asset.artifacts, AssetCookerTest::asset(first, asset.descriptor_id.c_str()).artifacts);
+    for (const auto &artifact : asset.artifacts) {
+      EXPECT_TRUE(std::filesystem::is_regular_file(output_root() / artifact)) << artifact;
+    }
+  }
+}
+
+TEST_F(AssetCookerTest, ChangedInputsMissAndCollectTheirOldArtifacts) {
+  const auto first = cook();
+  const auto old_artifact = asset(first, "models::crate_flat").artifacts.front();
+  m_imports = 0u;
+
+  write_model("crate_flat", R"json({"generate_normals": false, "flip_uvs": false})json");
+  const auto second = cook();
+
+  EXPECT_EQ(m_imports, 1u);
+  EXPECT_EQ(second.cache_misses, 1u);
+  EXPECT_EQ(second.cache_hits, 1u);
+  EXPECT_EQ(second.removed_artifact_count, 1u);
+  EXPECT_FALSE(std::filesystem::exists(output_root() / old_artifact));
+  EXPECT_NE(asset(second, "models::crate_flat").artifacts.front(), old_artifact);
+
+  // A new source invalidates every model cooked from it.
+  write_text(resources_root() / "models" / "crate.obj", "v 0 0 0\nv 1 0 0\n");
+  m_imports = 0u;
+  const auto third = cook();
+  EXPECT_EQ(m_imports, 2u);
+  EXPECT_EQ(third.cache_hits, 0u);
+  EXPECT_EQ(third.removed_artifact_count, 2u);
+}
+
+TEST_F(AssetCookerTest, CachedEntriesWithMissingArtifactsAreCookedAgain) {
+  const auto first = cook();
+  const auto artifact = asset(first, "models::crate").artifacts.front();
+  std::filesystem::remove(output_root() / artifact);
+  m_imports = 0u;
+
+  const auto second = cook();
+  EXPECT_EQ(m_imports, 1u);
+  EXPECT_EQ(second.cache_misses, 1u);
+  EXPECT_EQ(second.cache_hits, 1u);
+  EXPECT_EQ(second.deduplicated_artifact_count, 1u);
+  EXPECT_EQ(asset(second, "models::crate").artifacts.front(), artifact);
+  EXPECT_TRUE(std::filesystem::is_regular_file(output_root() / artifact));
+}
+
+TEST_F(AssetCookerTest, ChangedSideFilesMissWithAnUnchangedSource) {
+  write_text(resources_root() / "models" / "crate.mtl", "newmtl wood\n");
+  cook();
+  m_imports = 0u;
+
+  EXPECT_EQ(cook().cache_hits, 2u);
+  EXPECT_EQ(m_imports, 0u);
+
+  write_text(resources_root() / "models" / "crate.mtl", "newmtl wood\nnewmtl stone\n");
+  const auto edited = cook();
+  EXPECT_EQ(m_imports, 2u);
+  EXPECT_EQ(edited.cache_misses, 2u);
+  EXPECT_EQ(edited.cache_hits, 0u);
+  EXPECT_EQ(edited.removed_artifact_count, 0u);
+
+  std::filesystem::remove(resources_root() / "models" / "crate.mtl");
+  m_imports = 0u;
+  EXPECT_EQ(cook().cache_misses, 2u);
+  EXPECT_EQ(m_imports, 2u);
+
+  // Cooked without a side file: reused until one appears.
+  m_imports = 0u;
+  EXPECT_EQ(cook().cache_hits, 2u);
+  EXPECT_EQ(m_imports, 0u);
+}
+
+TEST(ArtifactGcTest, RemovesOnlyUnreferencedArtifacts) {
+  const auto root = make_temp_root("astralix-asset-cooker-gc");
+  write_text(root / "artifacts" / "models" / "kept.axmesh", "kept");
+  write_text(root / "artifacts" / "models" / "stale.axmesh", "stale");
+  write_text(root / "artifacts" / "old" / "nested.axmesh", "nested");
+  write_text(root / "pack.axpack", "manifest");
+
+  CookCache cache;
+  cache.record(1u, CookedArtifacts{.artifacts = {"artifacts/models/kept.axmesh"}});
+
+  EXPECT_EQ(remove_unreferenced_artifacts(root, cache), 2u);
+  EXPECT_TRUE(std::filesystem::exists(root / "artifacts" / "models" / "kept.axmesh"));
+  EXPECT_FALSE(std::filesystem::exists(root / "artifacts" / "models" / "stale.axmesh"));
+  EXPECT_FALSE(std::filesystem::exists(root / "artifacts" / "old" / "nested.axmesh"));
+  EXPECT_TRUE(std::filesystem::exists(root / "pack.axpack"));
+
+  EXPECT_EQ(remove_unreferenced_artifacts(root, cache), 0u);
+  EXPECT_EQ(remove_unreferenced_artifacts(root / "missing", cache), 0u);
+}
+
+TEST(ModelCookKeyTest, CoversTheSourceAndEveryImportSetting) {
+  const ModelImportConfig defaults;
+  const uint64_t key = model_cook_key(7u, defaults);
+  EXPECT_EQ(model_cook_key(7u, defaults), key);
+  EXPECT_NE(model_cook_key(8u, defaults), key);
+
+  for (bool ModelImportConfig::*setting :
+       {&ModelImportConfig::triangulate, &ModelImportConfig::flip_uvs,
+        &ModelImportConfig::generate_normals, &ModelImportConfig::calculate_tangents,
+        &ModelImportConfig::pre_transform_vertices}) {
+    ModelImportConfig changed;
+    changed.*setting = !(changed.*setting);
+    EXPECT_NE(model_cook_key(7u, changed), key);
+  }
+}
+
+} // namespace
+} // namespace astralix
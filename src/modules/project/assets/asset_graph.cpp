@@ -1,6 +1,6 @@
 #include "assets/asset_graph.hpp"
 
-#include "adapters/file/file-stream-reader.hpp"
+#include "adapters/file/mapped-file-stream-reader.hpp"
 #include "assert.hpp"
 #include "context-proxy.hpp"
 #include "log.hpp"
@@ -187,7 +187,7 @@ ParsedContext load_json_context(const std::filesystem::path &path) {
   ASTRA_ENSURE(!std::filesystem::is_regular_file(path), "Asset path is not a file: ", path);
   ASTRA_ENSURE(!is_json_file(path), "Asset file must use an .ax* extension: ", path);
 
-  FileStreamReader stream(path);
+  MappedFileStreamReader stream(path);
   stream.read();
 
   return SerializationContext::create(
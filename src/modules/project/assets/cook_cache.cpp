@@ -0,0 +1,223 @@
+#include "assets/cook_cache.hpp"
+
+#include "adapters/file/chunked-file-stream-reader.hpp"
+#include "adapters/file/file-stream-writer.hpp"
+#include "adapters/file/mapped-file-stream-reader.hpp"
+#include "arena.hpp"
+#include "context-proxy.hpp"
+#include "exceptions/base-exception.hpp"
+#include "fnv1a.hpp"
+#include "log.hpp"
+#include "serialization-context.hpp"
+#include "stream-buffer.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+namespace astralix {
+namespace {
+
+template <typename T> bool parse_number(std::string_view text, T &value, int base = 10) {
+  const char *end = text.data() + text.size();
+  const auto result = std::from_chars(text.data(), end, value, base);
+  return !text.empty() && result.ec == std::errc{} && result.ptr == end;
+}
+
+int64_t file_write_time(const std::filesystem::path &path) {
+  return static_cast<int64_t>(
+      std::filesystem::last_write_time(path).time_since_epoch().count()
+  );
+}
+
+} // namespace
+
+CookCache CookCache::load(const std::filesystem::path &path) {
+  CookCache cache;
+
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(path, error)) {
+    return cache;
+  }
+
+  try {
+    MappedFileStreamReader reader(path);
+    reader.read();
+    auto ctx = SerializationContext::create(SerializationFormat::Json, reader.get_buffer());
+
+    if ((*ctx)["version"].as<int>() != k_version ||
+        (*ctx)["cooker_version"].as<int>() != static_cast<int>(k_asset_cooker_version)) {
+      return cache;
+    }
+
+    auto entries = (*ctx)["entries"];
+    for (size_t entry_index = 0; entry_index < entries.size(); ++entry_index) {
+      auto entry_ctx = entries[static_cast<int>(entry_index)];
+
+      uint64_t key = 0u;
+      if (!parse_number(entry_ctx["key"].as<std::string>(), key, 16)) {
+        continue;
+      }
+
+      CookedArtifacts cooked;
+      cooked.material_slot_count =
+          static_cast<uint32_t>(std::max(entry_ctx["material_slot_count"].as<int>(), 0));
+
+      auto artifacts = entry_ctx["artifacts"];
+      for (size_t artifact_index = 0; artifact_index < artifacts.size(); ++artifact_index) {
+        cooked.artifacts.push_back(artifacts[static_cast<int>(artifact_index)].as<std::string>());
+      }
+
+      // An entry whose side files cannot be checked is not reused.
+      bool side_files_valid = true;
+      auto side_files = entry_ctx["side_files"];
+      for (size_t side_index = 0; side_index < side_files.size(); ++side_index) {
+        auto side_ctx = side_files[static_cast<int>(side_index)];
+
+        CookedSideFile side_file{.path = side_ctx["path"].as<std::string>()};
+        if (!parse_number(side_ctx["hash"].as<std::string>(), side_file.hash, 16)) {
+          side_files_valid = false;
+          break;
+        }
+
+        cooked.side_files.push_back(std::move(side_file));
+      }
+
+      if (side_files_valid) {
+        cache.m_entries.emplace(key, std::move(cooked));
+      }
+    }
+
+    auto sources = (*ctx)["sources"];
+    for (size_t source_index = 0; source_index < sources.size(); ++source_index) {
+      auto source_ctx = sources[static_cast<int>(source_index)];
+
+      SourceStamp stamp;
+      if (!parse_number(source_ctx["size"].as<std::string>(), stamp.size) ||
+          !parse_number(source_ctx["write_time"].as<std::string>(), stamp.write_time) ||
+          !parse_number(source_ctx["hash"].as<std::string>(), stamp.hash, 16)) {
+        continue;
+      }
+
+      cache.m_sources.emplace(source_ctx["path"].as<std::string>(), stamp);
+    }
+  } catch (const BaseException &) {
+    LOG_WARN("CookCache: ignoring unreadable cook cache ", path.string());
+    return CookCache{};
+  }
+
+  return cache;
+}
+
+void CookCache::save(const std::filesystem::path &path) const {
+  auto ctx = SerializationContext::create(SerializationFormat::Json);
+  (*ctx)["version"] = k_version;
+  (*ctx)["cooker_version"] = static_cast<int>(k_asset_cooker_version);
+
+  // Sorted so unchanged cooks rewrite an identical file.
+  std::vector<uint64_t> keys;
+  keys.reserve(m_entries.size());
+  for (const auto &[key, _] : m_entries) {
+    keys.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  for (size_t entry_index = 0; entry_index < keys.size(); ++entry_index) {
+    const auto &cooked = m_entries.at(keys[entry_index]);
+    auto entry_ctx = (*ctx)["entries"][static_cast<int>(entry_index)];
+    entry_ctx["key"] = fnv1a64_hex_digest(keys[entry_index]);
+    entry_ctx["material_slot_count"] = static_cast<int>(cooked.material_slot_count);
+
+    for (size_t artifact_index = 0; artifact_index < cooked.artifacts.size(); ++artifact_index) {
+      entry_ctx["artifacts"][static_cast<int>(artifact_index)] = cooked.artifacts[artifact_index];
+    }
+
+    for (size_t side_index = 0; side_index < cooked.side_files.size(); ++side_index) {
+      auto side_ctx = entry_ctx["side_files"][static_cast<int>(side_index)];
+      side_ctx["path"] = cooked.side_files[side_index].path;
+      side_ctx["hash"] = fnv1a64_hex_digest(cooked.side_files[side_index].hash);
+    }
+  }
+
+  std::vector<std::string> source_paths;
+  source_paths.reserve(m_sources.size());
+  for (const auto &[source_path, _] : m_sources) {
+    source_paths.push_back(source_path);
+  }
+  std::sort(source_paths.begin(), source_paths.end());
+
+  for (size_t source_index = 0; source_index < source_paths.size(); ++source_index) {
+    const auto &stamp = m_sources.at(source_paths[source_index]);
+    auto source_ctx = (*ctx)["sources"][static_cast<int>(source_index)];
+    source_ctx["path"] = source_paths[source_index];
+    source_ctx["size"] = std::to_string(stamp.size);
+    source_ctx["write_time"] = std::to_string(stamp.write_time);
+    source_ctx["hash"] = fnv1a64_hex_digest(stamp.hash);
+  }
+
+  std::filesystem::create_directories(path.parent_path());
+
+  ElasticArena arena(KB(64));
+  auto *block = ctx->to_buffer(arena);
+  auto writer = FileStreamWriter(path, clone_stream_buffer(block));
+  writer.write();
+}
+
+uint64_t CookCache::hash_source(const std::filesystem::path &source, CookCache &next) const {
+  const auto source_key = source.lexically_normal().generic_string();
+
+  if (auto it = next.m_sources.find(source_key); it != next.m_sources.end()) {
+    return it->second.hash;
+  }
+
+  SourceStamp stamp{
+      .size = static_cast<uint64_t>(std::filesystem::file_size(source)),
+      .write_time = file_write_time(source),
+  };
+
+  if (auto it = m_sources.find(source_key);
+      it != m_sources.end() && it->second.size == stamp.size &&
+      it->second.write_time == stamp.write_time) {
+    stamp.hash = it->second.hash;
+  } else {
+    uint64_t hash = k_fnv1a64_offset_basis;
+    ChunkedFileStreamReader reader(source);
+    for (auto chunk = reader.next_chunk(); !chunk.empty(); chunk = reader.next_chunk()) {
+      hash = fnv1a64_append_bytes(hash, chunk.data(), chunk.size());
+    }
+    stamp.hash = hash;
+  }
+
+  next.m_sources.insert_or_assign(source_key, stamp);
+  return stamp.hash;
+}
+
+bool CookCache::side_files_unchanged(const CookedArtifacts &cooked, CookCache &next) const {
+  return std::all_of(
+      cooked.side_files.begin(), cooked.side_files.end(),
+      [&](const CookedSideFile &side_file) {
+        std::error_code error;
+        return std::filesystem::is_regular_file(side_file.path, error) &&
+               hash_source(side_file.path, next) == side_file.hash;
+      }
+  );
+}
+
+const CookedArtifacts *CookCache::find(uint64_t cook_key) const {
+  auto it = m_entries.find(cook_key);
+  return it != m_entries.end() ? &it->second : nullptr;
+}
+
+void CookCache::record(uint64_t cook_key, CookedArtifacts artifacts) {
+  m_entries.insert_or_assign(cook_key, std::move(artifacts));
+}
+
+std::vector<std::string> CookCache::referenced_artifacts() const {
+  std::vector<std::string> artifacts;
+  for (const auto &[_, cooked] : m_entries) {
+    artifacts.insert(artifacts.end(), cooked.artifacts.begin(), cooked.artifacts.end());
+  }
+
+  return artifacts;
+}
+
+} // namespace astralix
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace astralix {
+
+// Bump whenever cooked output changes for the same inputs, so every cached
+// artifact is rebuilt on the next cook.
+inline constexpr uint32_t k_asset_cooker_version = 1u;
+
+// A file other than the model source that the importer read, such as an
+// .obj's .mtl, with the hash it had when the artifact was cooked.
+struct CookedSideFile {
+  std::string path;
+  uint64_t hash = 0u;
+};
+
+struct CookedArtifacts {
+  std::vector<std::string> artifacts;
+  uint32_t material_slot_count = 0u;
+  std::vector<CookedSideFile> side_files;
+};
+
+// Persistent record of what the cooker produced, stored next to the cooked
+// pack. Artifacts are keyed by a hash of their source bytes, import settings
+// and k_asset_cooker_version, so identical inputs share one artifact and
+// anything whose key is unchanged can be reused without importing again.
+class CookCache {
+public:
+  static constexpr int k_version = 2;
+
+  // A missing, unreadable or outdated cache loads empty.
+  static CookCache load(const std::filesystem::path &path);
+  void save(const std::filesystem::path &path) const;
+
+  // Hash of the file's bytes. The previous hash is reused while the file's
+  // size and write time are unchanged; the result is remembered in `next`.
+  uint64_t hash_source(const std::filesystem::path &source, CookCache &next) const;
+
+  // Whether every side file of `cooked` still exists with the same bytes.
+  // Hashes go through hash_source, so they are remembered in `next`.
+  bool side_files_unchanged(const CookedArtifacts &cooked, CookCache &next) const;
+
+  const CookedArtifacts *find(uint64_t cook_key) const;
+  void record(uint64_t cook_key, CookedArtifacts artifacts);
+
+  // Artifact paths, relative to the output root, referenced by any entry.
+  std::vector<std::string> referenced_artifacts() const;
+
+  size_t size() const { return m_entries.size(); }
+
+private:
+  struct SourceStamp {
+    uint64_t size = 0u;
+    int64_t write_time = 0;
+    uint64_t hash = 0u;
+  };
+
+  std::unordered_map<uint64_t, CookedArtifacts> m_entries;
+  std::unordered_map<std::string, SourceStamp> m_sources;
+};
+
+} // namespace astralix
@@ -0,0 +1,100 @@
+#include "assets/cook_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace astralix {
+namespace {
+
+std::filesystem::path make_temp_root(const char *suffix) {
+  const auto root =
+      std::filesystem::temp_directory_path() / std::string(suffix);
+  std::filesystem::remove_all(root);
+  std::filesystem::create_directories(root);
+  return root;
+}
+
+void write_text(const std::filesystem::path &path, const std::string &text) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << text;
+}
+
+TEST(CookCacheTest, RoundTripsEntriesAndSourceStamps) {
+  const auto root = make_temp_root("astralix-cook-cache-roundtrip");
+  const auto source = root / "crate.obj";
+  write_text(source, "v 0 0 0\n");
+
+  CookCache previous;
+  CookCache cache;
+  const uint64_t source_hash = previous.hash_source(source, cache);
+  cache.record(0x1234u, CookedArtifacts{
+                            .artifacts = {"artifacts/models/0000000000001234.axmesh"},
+                            .material_slot_count = 2u,
+                            .side_files = {{.path = "crate.mtl", .hash = 0xbeefu}},
+                        });
+  cache.save(root / "cook-cache.json");
+
+  const auto loaded = CookCache::load(root / "cook-cache.json");
+  const auto *cooked = loaded.find(0x1234u);
+  ASSERT_NE(cooked, nullptr);
+  EXPECT_EQ(cooked->material_slot_count, 2u);
+  ASSERT_EQ(cooked->artifacts.size(), 1u);
+  EXPECT_EQ(cooked->artifacts.front(), "artifacts/models/0000000000001234.axmesh");
+  ASSERT_EQ(cooked->side_files.size(), 1u);
+  EXPECT_EQ(cooked->side_files.front().path, "crate.mtl");
+  EXPECT_EQ(cooked->side_files.front().hash, 0xbeefu);
+  EXPECT_EQ(loaded.find(0x9999u), nullptr);
+
+  CookCache next;
+  EXPECT_EQ(loaded.hash_source(source, next), source_hash);
+}
+
+TEST(CookCacheTest, RehashesSourcesOnlyWhenTheirStampChanges) {
+  const auto root = make_temp_root("astralix-cook-cache-stamps");
+  const auto source = root / "crate.obj";
+  write_text(source, "aaaa");
+
+  CookCache empty;
+  CookCache first;
+  const uint64_t original_hash = empty.hash_source(source, first);
+
+  // Same size and write time: the stored hash is trusted without reading.
+  const auto write_time = std::filesystem::last_write_time(source);
+  write_text(source, "bbbb");
+  std::filesystem::last_write_time(source, write_time);
+
+  CookCache second;
+  EXPECT_EQ(first.hash_source(source, second), original_hash);
+
+  write_text(source, "bbbbb");
+  CookCache third;
+  EXPECT_NE(second.hash_source(source, third), original_hash);
+}
+
+TEST(CookCacheTest, UnreadableOrOutdatedCachesLoadEmpty) {
+  const auto root = make_temp_root("astralix-cook-cache-invalid");
+
+  EXPECT_EQ(CookCache::load(root / "missing.json").size(), 0u);
+
+  write_text(root / "corrupt.json", "{ not json");
+  EXPECT_EQ(CookCache::load(root / "corrupt.json").size(), 0u);
+
+  write_text(
+      root / "outdated.json",
+      R"json({"version": 1, "cooker_version": 0, "entries": [{"key": "1", "artifacts": ["a"]}]})json"
+  );
+  EXPECT_EQ(CookCache::load(root / "outdated.json").size(), 0u);
+
+  // Version 1 caches predate side files, so their entries cannot be trusted.
+  write_text(
+      root / "no-side-files.json",
+      R"json({"version": 1, "cooker_version": 1, "entries": [{"key": "1", "artifacts": ["a"]}]})json"
+  );
+  EXPECT_EQ(CookCache::load(root / "no-side-files.json").size(), 0u);
+}
+
+} // namespace
+} // namespace astralix
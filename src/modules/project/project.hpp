@@ -33,6 +33,7 @@ struct ProjectSerializationConfig {
         {"toml", SerializationFormat::Toml},
         {"yaml", SerializationFormat::Yaml},
         {"xml", SerializationFormat::Xml},
+        {"binary", SerializationFormat::Binary},
     };
 
     auto it = formats.find(format);
@@ -89,6 +90,8 @@ struct PhysicsSystemConfig {
   std::string pvd_host = "127.0.0.1";
   int pvd_port;
   int pvd_timeout = 5;
+  // Max PhysX tasks in flight on the JobSystem; 0 uses every worker.
+  uint32_t worker_budget = 0u;
 };
 
 struct MSAAConfig {
@@ -362,8 +365,12 @@ struct RenderSystemConfig {
 };
 
 struct AudioSystemConfig {
+  // "miniaudio" plays through the default device; "null" runs the same mixer
+  // on miniaudio's null device for headless runs.
   std::string backend = "miniaudio";
   float master_gain = 1.0f;
+  uint32_t one_shot_voices = 64;
+  uint32_t voice_budget = 32;
 };
 
 struct TerrainSystemConfig {
@@ -14,6 +14,7 @@
 #include "serialization-context.hpp"
 #include "serializer.hpp"
 #include <glm/glm.hpp>
+#include <limits>
 #include <string_view>
 #include <unordered_set>
 
@@ -134,6 +135,21 @@ float read_number(ContextProxy ctx, float fallback = 0.0f) {
   }
 }
 
+// Counts are read as floats; casting a negative, NaN or too large float to
+// uint32_t is undefined, so the value is clamped first.
+uint32_t read_count(ContextProxy ctx, uint32_t fallback = 0u) {
+  const float value = read_number(std::move(ctx), static_cast<float>(fallback));
+  if (!(value > 0.0f)) {
+    return 0u;
+  }
+
+  if (value >= static_cast<float>(std::numeric_limits<uint32_t>::max())) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+
+  return static_cast<uint32_t>(value);
+}
+
 glm::vec3 read_vec3(ContextProxy ctx, const glm::vec3 &fallback = glm::vec3(0.0f)) {
   if (ctx.kind() != SerializationTypeKind::Object) {
     return fallback;
@@ -204,6 +220,8 @@ std::string serialization_format_to_string(SerializationFormat format) {
       return "toml";
     case SerializationFormat::Xml:
       return "xml";
+    case SerializationFormat::Binary:
+      return "binary";
     default:
       ASTRA_EXCEPTION("Unknown serialization format");
   }
@@ -709,7 +727,15 @@ void deserialize_inline_resource(ProjectSerializer &serializer, ContextProxy &as
 
     ASTRA_ENSURE(path == nullptr, "AudioClip path is required");
 
-    AudioClip::create(id, path);
+    AudioClipStreaming streaming;
+    auto stream = asset["stream"];
+    streaming.enabled = read_bool(stream["enabled"], false);
+    streaming.chunk_frames = read_count(stream["chunk_frames"], 16384u);
+    streaming.chunk_count = read_count(stream["chunk_count"], 4u);
+    streaming.prefetch_threshold =
+        read_number(stream["prefetch_threshold"], 0.5f);
+
+    AudioClip::create(id, path, streaming);
     break;
   }
   case ResourceType::TerrainRecipe: {
@@ -928,6 +954,7 @@ void ProjectSerializer::deserialize() {
         physics.pvd_host = sys["content"]["pvd"]["host"].as<std::string>();
         physics.pvd_port = sys["content"]["pvd"]["port"].as<int>();
         physics.pvd_timeout = sys["content"]["pvd"]["timeout"].as<int>();
+        physics.worker_budget = read_count(sys["content"]["worker_budget"]);
 
         physics.gravity = {
             sys["content"]["scene"]["gravity"]["x"].as<float>(),
@@ -1291,6 +1318,9 @@ void ProjectSerializer::deserialize() {
 
         audio.backend = sys["content"]["backend"].as<std::string>();
         audio.master_gain = read_number(sys["content"]["master_gain"], 1.0f);
+        audio.one_shot_voices =
+            read_count(sys["content"]["one_shot_voices"], 64u);
+        audio.voice_budget = read_count(sys["content"]["voice_budget"], 32u);
 
         config.systems.push_back({
             .name = name,
@@ -1,7 +1,7 @@
 #include "scene.hpp"
 
-#include "adapters/file/file-stream-reader.hpp"
 #include "adapters/file/file-stream-writer.hpp"
+#include "adapters/file/mapped-file-stream-reader.hpp"
 #include "arena.hpp"
 #include "assert.hpp"
 #include "entities/scene-build-context.hpp"
@@ -592,7 +592,7 @@ bool Scene::load_artifact(SceneArtifactKind artifact_kind) {
     return false;
   }
 
-  auto reader = FileStreamReader(path);
+  auto reader = MappedFileStreamReader(path);
   reader.read();
   m_serializer->set_artifact_kind(artifact_kind);
   ctx->from_buffer(reader.get_buffer());
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "resources/mesh.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+namespace astralix {
+
+// On-disk layout of binary .axmesh files, little-endian:
+//
+//   AxMeshFileHeader
+//   AxMeshTableEntry[mesh_count]
+//   per mesh: vertex blob, index blob (uint32), each 16-byte aligned
+//
+// Offsets are from the start of the file, so a mapped file can be read in
+// place.
+
+inline constexpr char k_axmesh_magic[4] = {'A', 'X', 'M', 'B'};
+inline constexpr uint32_t k_axmesh_binary_version = 1u;
+inline constexpr uint64_t k_axmesh_blob_alignment = 16u;
+
+enum class AxMeshVertexFormat : uint32_t {
+  // Vertex as laid out in memory, 48 bytes.
+  Full = 0,
+  // AxMeshQuantizedVertex, 24 bytes.
+  Quantized = 1,
+};
+
+struct AxMeshFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t mesh_count;
+  uint32_t flags;
+  uint64_t file_size;
+  uint64_t table_offset;
+};
+
+struct AxMeshTableEntry {
+  uint64_t id;
+  uint64_t vertex_offset;
+  uint64_t index_offset;
+  uint32_t vertex_count;
+  uint32_t index_count;
+  uint32_t draw_type;
+  uint32_t vertex_format;
+  float bounds_min[3];
+  float bounds_max[3];
+};
+
+// Normal and tangent are octahedral-encoded snorm16 pairs, texture
+// coordinates are half floats. Bit 0 of tangent[1] holds the bitangent sign
+// (set means negative).
+struct AxMeshQuantizedVertex {
+  float position[3];
+  int16_t normal[2];
+  int16_t tangent[2];
+  uint16_t texture_coordinates[2];
+};
+
+static_assert(std::endian::native == std::endian::little, "AxMesh blobs are little-endian");
+static_assert(sizeof(AxMeshFileHeader) == 32u);
+static_assert(sizeof(AxMeshTableEntry) == 64u);
+static_assert(sizeof(AxMeshQuantizedVertex) == 24u);
+static_assert(sizeof(Vertex) == 48u && std::is_trivially_copyable_v<Vertex>,
+              "Full AxMesh vertex blobs are copied straight into Vertex");
+
+constexpr uint64_t align_axmesh_offset(uint64_t offset) {
+  return (offset + k_axmesh_blob_alignment - 1u) & ~(k_axmesh_blob_alignment - 1u);
+}
+
+constexpr uint32_t axmesh_vertex_stride(AxMeshVertexFormat format) {
+  return format == AxMeshVertexFormat::Quantized
+             ? static_cast<uint32_t>(sizeof(AxMeshQuantizedVertex))
+             : static_cast<uint32_t>(sizeof(Vertex));
+}
+
+} // namespace astralix
@@ -1,7 +1,7 @@
 #include "axmesh-serializer.hpp"
 
-#include "adapters/file/file-stream-reader.hpp"
 #include "adapters/file/file-stream-writer.hpp"
+#include "adapters/file/mapped-file-stream-reader.hpp"
 #include "arena.hpp"
 #include "assert.hpp"
 #include "context-proxy.hpp"
@@ -9,7 +9,12 @@
 #include "serialization-context-readers.hpp"
 #include "stream-buffer.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 
 namespace astralix {
 namespace {
@@ -25,9 +30,316 @@ void write_vec3(ContextProxy ctx, const glm::vec3 &value) {
   ctx["z"] = value.z;
 }
 
+// Round to nearest even, saturating to infinity like a hardware conversion.
+uint16_t float_to_half(float value) {
+  const uint32_t bits = std::bit_cast<uint32_t>(value);
+  const uint32_t sign = (bits >> 16u) & 0x8000u;
+  const uint32_t magnitude = bits & 0x7fffffffu;
+
+  if (magnitude >= 0x7f800000u) {
+    return static_cast<uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+  }
+  if (magnitude >= 0x477ff000u) {
+    return static_cast<uint16_t>(sign | 0x7c00u);
+  }
+
+  if (magnitude < 0x38800000u) {
+    if (magnitude < 0x33000000u) {
+      return static_cast<uint16_t>(sign);
+    }
+
+    const uint32_t shift = 126u - (magnitude >> 23u);
+    const uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+    const uint32_t rounded = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+    const uint32_t halfway = 1u << (shift - 1u);
+    return static_cast<uint16_t>(
+        sign | (rounded + (remainder > halfway || (remainder == halfway && (rounded & 1u))))
+    );
+  }
+
+  uint32_t half = (magnitude - 0x38000000u) >> 13u;
+  const uint32_t remainder = magnitude & 0x1fffu;
+  half += remainder > 0x1000u || (remainder == 0x1000u && (half & 1u));
+  return static_cast<uint16_t>(sign | half);
+}
+
+float half_to_float(uint16_t half) {
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16u;
+  const uint32_t exponent = (half >> 10u) & 0x1fu;
+  const uint32_t mantissa = half & 0x3ffu;
+
+  if (exponent == 0u) {
+    const float value = std::ldexp(static_cast<float>(mantissa), -24);
+    return sign != 0u ? -value : value;
+  }
+  if (exponent == 31u) {
+    return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13u));
+  }
+
+  return std::bit_cast<float>(sign | ((exponent + 112u) << 23u) | (mantissa << 13u));
+}
+
+int16_t to_snorm16(float value) {
+  return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+float from_snorm16(int16_t value) {
+  return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+}
+
+float sign_not_zero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+void encode_octahedral(const glm::vec3 &direction, int16_t out[2]) {
+  const float l1 = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+  if (l1 <= 0.0f) {
+    out[0] = 0;
+    out[1] = 0;
+    return;
+  }
+
+  float x = direction.x / l1;
+  float y = direction.y / l1;
+  if (direction.z < 0.0f) {
+    const float folded_x = (1.0f - std::abs(y)) * sign_not_zero(x);
+    y = (1.0f - std::abs(x)) * sign_not_zero(y);
+    x = folded_x;
+  }
+
+  out[0] = to_snorm16(x);
+  out[1] = to_snorm16(y);
+}
+
+glm::vec3 decode_octahedral(int16_t encoded_x, int16_t encoded_y) {
+  const float x = from_snorm16(encoded_x);
+  const float y = from_snorm16(encoded_y);
+  glm::vec3 direction(x, y, 1.0f - std::abs(x) - std::abs(y));
+  if (direction.z < 0.0f) {
+    direction.x = (1.0f - std::abs(y)) * sign_not_zero(x);
+    direction.y = (1.0f - std::abs(x)) * sign_not_zero(y);
+  }
+
+  const float length = std::sqrt(
+      direction.x * direction.x + direction.y * direction.y + direction.z * direction.z
+  );
+  return length > 0.0f ? direction / length : direction;
+}
+
+AxMeshQuantizedVertex quantize_vertex(const Vertex &vertex) {
+  AxMeshQuantizedVertex quantized{};
+  quantized.position[0] = vertex.position.x;
+  quantized.position[1] = vertex.position.y;
+  quantized.position[2] = vertex.position.z;
+  encode_octahedral(vertex.normal, quantized.normal);
+  encode_octahedral(vertex.tangent, quantized.tangent);
+  quantized.tangent[1] = static_cast<int16_t>(
+      (quantized.tangent[1] & ~int16_t{1}) | (vertex.bitangent_sign < 0.0f ? 1 : 0)
+  );
+  quantized.texture_coordinates[0] = float_to_half(vertex.texture_coordinates.x);
+  quantized.texture_coordinates[1] = float_to_half(vertex.texture_coordinates.y);
+  return quantized;
+}
+
+Vertex dequantize_vertex(const AxMeshQuantizedVertex &quantized) {
+  return Vertex{
+      .position = glm::vec3(quantized.position[0], quantized.position[1], quantized.position[2]),
+      .normal = decode_octahedral(quantized.normal[0], quantized.normal[1]),
+      .texture_coordinates = glm::vec2(
+          half_to_float(quantized.texture_coordinates[0]),
+          half_to_float(quantized.texture_coordinates[1])
+      ),
+      .tangent = decode_octahedral(quantized.tangent[0], quantized.tangent[1]),
+      .bitangent_sign = (quantized.tangent[1] & 1) != 0 ? -1.0f : 1.0f,
+  };
+}
+
+// count * stride fits in 64 bits for 32-bit counts, so only the offset can
+// push the end past the file; comparing against the remaining bytes avoids
+// wrapping on a crafted offset.
+bool blob_in_bounds(uint64_t offset, uint64_t count, uint64_t stride, uint64_t file_size) {
+  return offset <= file_size && count * stride <= file_size - offset;
+}
+
+bool is_draw_primitive(uint32_t value) {
+  return value <= static_cast<uint32_t>(RendererAPI::DrawPrimitive::TRIANGLES);
+}
+
 } // namespace
 
-void AxMeshSerializer::write(const std::filesystem::path &path, const std::vector<Mesh> &meshes) {
+AxMeshFile::AxMeshFile(const std::filesystem::path &path) : m_file(path) {
+  const auto file_size = static_cast<uint64_t>(m_file.size());
+  ASTRA_ENSURE(file_size < sizeof(AxMeshFileHeader), "AxMesh file is truncated: ", path);
+
+  m_header = reinterpret_cast<const AxMeshFileHeader *>(m_file.data());
+  ASTRA_ENSURE(std::memcmp(m_header->magic, k_axmesh_magic, sizeof(k_axmesh_magic)) != 0, "Not a binary AxMesh file: ", path);
+  ASTRA_ENSURE(m_header->version != k_axmesh_binary_version, "Unsupported binary AxMesh version: ", m_header->version);
+  ASTRA_ENSURE(m_header->file_size != file_size, "AxMesh file size does not match its header: ", path);
+
+  ASTRA_ENSURE(m_header->table_offset % alignof(AxMeshTableEntry) != 0u || !blob_in_bounds(m_header->table_offset, m_header->mesh_count, sizeof(AxMeshTableEntry), file_size), "AxMesh mesh table is out of bounds: ", path);
+
+  m_table = reinterpret_cast<const AxMeshTableEntry *>(m_file.data() + m_header->table_offset);
+
+  for (uint32_t index = 0; index < m_header->mesh_count; ++index) {
+    const auto &mesh = m_table[index];
+    ASTRA_ENSURE(mesh.vertex_format > static_cast<uint32_t>(AxMeshVertexFormat::Quantized), "Unknown AxMesh vertex format: ", mesh.vertex_format);
+    ASTRA_ENSURE(!is_draw_primitive(mesh.draw_type), "Unknown AxMesh draw type: ", mesh.draw_type);
+
+    const uint64_t vertex_stride =
+        axmesh_vertex_stride(static_cast<AxMeshVertexFormat>(mesh.vertex_format));
+    ASTRA_ENSURE(mesh.vertex_offset % k_axmesh_blob_alignment != 0u || mesh.index_offset % k_axmesh_blob_alignment != 0u, "AxMesh blob is misaligned: ", path);
+    ASTRA_ENSURE(!blob_in_bounds(mesh.vertex_offset, mesh.vertex_count, vertex_stride, file_size) || !blob_in_bounds(mesh.index_offset, mesh.index_count, sizeof(uint32_t), file_size), "AxMesh blob is out of bounds: ", path);
+  }
+}
+
+const AxMeshTableEntry &AxMeshFile::entry(size_t index) const {
+  ASTRA_ENSURE(index >= size(), "AxMesh index out of range: ", index);
+  return m_table[index];
+}
+
+AxMeshView AxMeshFile::mesh(size_t index) const {
+  const auto &mesh = entry(index);
+  const auto format = static_cast<AxMeshVertexFormat>(mesh.vertex_format);
+
+  return AxMeshView{
+      .id = static_cast<MeshID>(mesh.id),
+      .draw_type = static_cast<RendererAPI::DrawPrimitive>(mesh.draw_type),
+      .vertex_format = format,
+      .vertex_count = mesh.vertex_count,
+      .vertex_bytes = m_file.bytes().subspan(
+          mesh.vertex_offset,
+          static_cast<size_t>(mesh.vertex_count) * axmesh_vertex_stride(format)
+      ),
+      .indices = std::span<const uint32_t>(
+          reinterpret_cast<const uint32_t *>(m_file.data() + mesh.index_offset),
+          mesh.index_count
+      ),
+      .bounds = AABB{
+          .min = glm::vec3(mesh.bounds_min[0], mesh.bounds_min[1], mesh.bounds_min[2]),
+          .max = glm::vec3(mesh.bounds_max[0], mesh.bounds_max[1], mesh.bounds_max[2]),
+      },
+  };
+}
+
+void AxMeshFile::decode_vertices(size_t index, Vertex *out) const {
+  const auto view = mesh(index);
+
+  if (view.vertex_format == AxMeshVertexFormat::Full) {
+    std::memcpy(out, view.vertex_bytes.data(), view.vertex_bytes.size());
+    return;
+  }
+
+  const auto *quantized =
+      reinterpret_cast<const AxMeshQuantizedVertex *>(view.vertex_bytes.data());
+  for (uint32_t vertex = 0; vertex < view.vertex_count; ++vertex) {
+    out[vertex] = dequantize_vertex(quantized[vertex]);
+  }
+}
+
+Mesh AxMeshFile::decode(size_t index) const {
+  const auto view = mesh(index);
+
+  std::vector<Vertex> vertices(view.vertex_count);
+  decode_vertices(index, vertices.data());
+  std::vector<unsigned int> indices(view.indices.begin(), view.indices.end());
+
+  Mesh mesh = Mesh::from_cooked(
+      std::move(vertices), std::move(indices), view.bounds, view.id
+  );
+  mesh.draw_type = view.draw_type;
+  return mesh;
+}
+
+void AxMeshSerializer::write(const std::filesystem::path &path, const std::vector<Mesh> &meshes,
+                             AxMeshWriteOptions options) {
+  if (options.encoding == AxMeshEncoding::Json) {
+    write_json(path, meshes);
+    return;
+  }
+
+  write_binary(path, meshes, options.quantize);
+}
+
+void AxMeshSerializer::write_binary(const std::filesystem::path &path,
+                                    const std::vector<Mesh> &meshes, bool quantize) {
+  static_assert(sizeof(unsigned int) == sizeof(uint32_t));
+
+  const auto format = quantize ? AxMeshVertexFormat::Quantized : AxMeshVertexFormat::Full;
+  const uint32_t stride = axmesh_vertex_stride(format);
+
+  std::vector<AxMeshTableEntry> table(meshes.size());
+  uint64_t offset = align_axmesh_offset(
+      sizeof(AxMeshFileHeader) + meshes.size() * sizeof(AxMeshTableEntry)
+  );
+
+  for (size_t index = 0; index < meshes.size(); ++index) {
+    const auto &mesh = meshes[index];
+    auto &entry = table[index];
+
+    entry.id = static_cast<uint64_t>(mesh.id);
+    entry.vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+    entry.index_count = static_cast<uint32_t>(mesh.indices.size());
+    entry.draw_type = static_cast<uint32_t>(mesh.draw_type);
+    entry.vertex_format = static_cast<uint32_t>(format);
+    for (int axis = 0; axis < 3; ++axis) {
+      entry.bounds_min[axis] = mesh.bounds.min[axis];
+      entry.bounds_max[axis] = mesh.bounds.max[axis];
+    }
+
+    entry.vertex_offset = offset;
+    offset = align_axmesh_offset(offset + static_cast<uint64_t>(entry.vertex_count) * stride);
+    entry.index_offset = offset;
+    offset = align_axmesh_offset(offset + static_cast<uint64_t>(entry.index_count) * sizeof(uint32_t));
+  }
+
+  const AxMeshFileHeader header{
+      .magic = {k_axmesh_magic[0], k_axmesh_magic[1], k_axmesh_magic[2], k_axmesh_magic[3]},
+      .version = k_axmesh_binary_version,
+      .mesh_count = static_cast<uint32_t>(meshes.size()),
+      .flags = 0u,
+      .file_size = offset,
+      .table_offset = sizeof(AxMeshFileHeader),
+  };
+
+  auto buffer = create_scope<StreamBuffer>(static_cast<size_t>(offset));
+  char *bytes = buffer->data();
+  std::memcpy(bytes, &header, sizeof(header));
+  if (!table.empty()) {
+    std::memcpy(bytes + header.table_offset, table.data(), table.size() * sizeof(AxMeshTableEntry));
+  }
+
+  for (size_t index = 0; index < meshes.size(); ++index) {
+    const auto &mesh = meshes[index];
+    const auto &entry = table[index];
+
+    if (quantize) {
+      auto *quantized = reinterpret_cast<AxMeshQuantizedVertex *>(bytes + entry.vertex_offset);
+      for (size_t vertex = 0; vertex < mesh.vertices.size(); ++vertex) {
+        quantized[vertex] = quantize_vertex(mesh.vertices[vertex]);
+      }
+    } else if (!mesh.vertices.empty()) {
+      std::memcpy(bytes + entry.vertex_offset, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+    }
+
+    if (!mesh.indices.empty()) {
+      std::memcpy(bytes + entry.index_offset, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+    }
+  }
+
+  std::filesystem::create_directories(path.parent_path());
+
+  auto writer = FileStreamWriter(path, std::move(buffer));
+  writer.write();
+}
+
+bool AxMeshSerializer::is_binary(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[sizeof(k_axmesh_magic)] = {};
+  file.read(magic, sizeof(magic));
+  return file.gcount() == static_cast<std::streamsize>(sizeof(magic)) &&
+         std::memcmp(magic, k_axmesh_magic, sizeof(magic)) == 0;
+}
+
+void AxMeshSerializer::write_json(const std::filesystem::path &path, const std::vector<Mesh> &meshes) {
   auto ctx = SerializationContext::create(SerializationFormat::Json);
   (*ctx)["version"] = k_version;
 
@@ -65,7 +377,22 @@ void AxMeshSerializer::write(const std::filesystem::path &path, const std::vecto
 std::vector<Mesh> AxMeshSerializer::read(const std::filesystem::path &path) {
   ASTRA_ENSURE(!std::filesystem::exists(path), "AxMesh file not found: ", path);
 
-  auto reader = FileStreamReader(path);
+  if (!is_binary(path)) {
+    return read_json(path);
+  }
+
+  const AxMeshFile file(path);
+  std::vector<Mesh> meshes;
+  meshes.reserve(file.size());
+  for (size_t index = 0; index < file.size(); ++index) {
+    meshes.push_back(file.decode(index));
+  }
+
+  return meshes;
+}
+
+std::vector<Mesh> AxMeshSerializer::read_json(const std::filesystem::path &path) {
+  auto reader = MappedFileStreamReader(path);
   reader.read();
 
   auto ctx = SerializationContext::create(
@@ -1,18 +1,77 @@
 #pragma once
 
+#include "adapters/file/mapped-file.hpp"
+#include "axmesh-format.hpp"
 #include "resources/mesh.hpp"
 
 #include <filesystem>
+#include <span>
 #include <vector>
 
 namespace astralix {
 
+enum class AxMeshEncoding : uint8_t {
+  Binary,
+  // The original text layout, kept for inspecting cooked meshes by hand.
+  Json,
+};
+
+struct AxMeshWriteOptions {
+  AxMeshEncoding encoding = AxMeshEncoding::Binary;
+  // Binary only: store normals, tangents and texture coordinates in
+  // AxMeshQuantizedVertex.
+  bool quantize = false;
+};
+
+// One mesh of a mapped binary .axmesh. The spans point into the mapping.
+struct AxMeshView {
+  MeshID id = 0;
+  RendererAPI::DrawPrimitive draw_type = RendererAPI::DrawPrimitive::TRIANGLES;
+  AxMeshVertexFormat vertex_format = AxMeshVertexFormat::Full;
+  uint32_t vertex_count = 0u;
+  // Full-format blobs are Vertex[] and can be handed to a vertex buffer as is.
+  std::span<const std::byte> vertex_bytes;
+  std::span<const uint32_t> indices;
+  AABB bounds;
+};
+
+// A binary .axmesh mapped into memory and validated. Nothing is parsed or
+// copied until meshes are decoded.
+class AxMeshFile {
+public:
+  explicit AxMeshFile(const std::filesystem::path &path);
+
+  size_t size() const { return m_header->mesh_count; }
+  AxMeshView mesh(size_t index) const;
+
+  // Expands vertex_count vertices of mesh `index` into out.
+  void decode_vertices(size_t index, Vertex *out) const;
+  Mesh decode(size_t index) const;
+
+private:
+  const AxMeshTableEntry &entry(size_t index) const;
+
+  MappedFile m_file;
+  const AxMeshFileHeader *m_header = nullptr;
+  const AxMeshTableEntry *m_table = nullptr;
+};
+
 class AxMeshSerializer {
 public:
   static constexpr int k_version = 1;
 
-  static void write(const std::filesystem::path &path, const std::vector<Mesh> &meshes);
+  static void write(const std::filesystem::path &path, const std::vector<Mesh> &meshes,
+                    AxMeshWriteOptions options = {});
+  // Reads either encoding; binary files are recognised by their magic.
   static std::vector<Mesh> read(const std::filesystem::path &path);
+
+  static bool is_binary(const std::filesystem::path &path);
+
+private:
+  static void write_json(const std::filesystem::path &path, const std::vector<Mesh> &meshes);
+  static void write_binary(const std::filesystem::path &path, const std::vector<Mesh> &meshes,
+                           bool quantize);
+  static std::vector<Mesh> read_json(const std::filesystem::path &path);
 };
 
 } // namespace astralix
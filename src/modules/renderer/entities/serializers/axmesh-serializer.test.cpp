@@ -1,7 +1,12 @@
 #include "axmesh-serializer.hpp"
+#include "helpers/benchmark.hpp"
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -30,6 +35,47 @@ Mesh make_test_mesh() {
   return Mesh(std::move(vertices), {0, 1, 2});
 }
 
+Mesh make_grid_mesh(uint32_t side) {
+  std::vector<Vertex> vertices;
+  vertices.reserve(static_cast<size_t>(side) * side);
+  for (uint32_t y = 0; y < side; ++y) {
+    for (uint32_t x = 0; x < side; ++x) {
+      const float u = static_cast<float>(x) / static_cast<float>(side - 1u);
+      const float v = static_cast<float>(y) / static_cast<float>(side - 1u);
+      vertices.push_back(Vertex{
+          .position = glm::vec3(u * 10.0f, std::sin(u * 6.0f) * std::cos(v * 4.0f), v * 10.0f),
+          .normal = glm::vec3(0.0f, 1.0f, 0.0f),
+          .texture_coordinates = glm::vec2(u * 4.0f, v * 4.0f),
+      });
+    }
+  }
+
+  std::vector<unsigned int> indices;
+  indices.reserve(static_cast<size_t>(side - 1u) * (side - 1u) * 6u);
+  for (uint32_t y = 0; y + 1u < side; ++y) {
+    for (uint32_t x = 0; x + 1u < side; ++x) {
+      const unsigned int corner = y * side + x;
+      indices.insert(indices.end(), {corner, corner + side, corner + 1u,
+                                     corner + 1u, corner + side, corner + side + 1u});
+    }
+  }
+
+  return Mesh(std::move(vertices), std::move(indices));
+}
+
+// Overwrites a field of a valid binary file in place, at `offset` bytes from
+// the start, to build files the writer would never produce.
+template <typename T>
+void patch_file(const std::filesystem::path &path, uint64_t offset, T value) {
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(static_cast<std::streamoff>(offset));
+  file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+uint64_t mesh_entry_offset(uint32_t mesh, size_t field) {
+  return sizeof(AxMeshFileHeader) + mesh * sizeof(AxMeshTableEntry) + field;
+}
+
 void write_text(const std::filesystem::path &path, const std::string &text) {
   std::filesystem::create_directories(path.parent_path());
   std::ofstream out(path);
@@ -41,7 +87,10 @@ TEST(AxMeshSerializerTest, WritesRootlessFormatAndReadsLegacyWrappedFormat) {
   const auto rootless_path = root / "rootless.axmesh";
   const auto legacy_path = root / "legacy.axmesh";
 
-  AxMeshSerializer::write(rootless_path, {make_test_mesh()});
+  AxMeshSerializer::write(
+      rootless_path, {make_test_mesh()}, {.encoding = AxMeshEncoding::Json}
+  );
+  EXPECT_FALSE(AxMeshSerializer::is_binary(rootless_path));
 
   std::ifstream rootless_stream(rootless_path);
   std::stringstream rootless_buffer;
@@ -98,5 +147,157 @@ TEST(AxMeshSerializerTest, WritesRootlessFormatAndReadsLegacyWrappedFormat) {
   EXPECT_EQ(legacy_meshes[0].indices.size(), 3u);
 }
 
+TEST(AxMeshSerializerTest, BinaryRoundTripIsExact) {
+  const auto root = make_temp_root("astralix-axmesh-binary");
+  const auto path = root / "grid.axmesh";
+
+  Mesh lines = make_test_mesh();
+  lines.draw_type = RendererAPI::DrawPrimitive::LINES;
+  const std::vector<Mesh> meshes = {make_grid_mesh(17u), lines};
+
+  AxMeshSerializer::write(path, meshes);
+  ASSERT_TRUE(AxMeshSerializer::is_binary(path));
+
+  const auto loaded = AxMeshSerializer::read(path);
+  ASSERT_EQ(loaded.size(), meshes.size());
+  for (size_t index = 0; index < meshes.size(); ++index) {
+    const auto &expected = meshes[index];
+    const auto &actual = loaded[index];
+    ASSERT_EQ(actual.vertices.size(), expected.vertices.size());
+    EXPECT_EQ(std::memcmp(actual.vertices.data(), expected.vertices.data(),
+                          expected.vertices.size() * sizeof(Vertex)),
+              0);
+    EXPECT_EQ(actual.indices, expected.indices);
+    EXPECT_EQ(actual.id, expected.id);
+    EXPECT_EQ(actual.draw_type, expected.draw_type);
+    EXPECT_EQ(actual.bounds.min, expected.bounds.min);
+    EXPECT_EQ(actual.bounds.max, expected.bounds.max);
+  }
+}
+
+TEST(AxMeshSerializerTest, MappedViewsPointAtAlignedBlobs) {
+  const auto root = make_temp_root("astralix-axmesh-mapped");
+  const auto path = root / "grid.axmesh";
+
+  const Mesh mesh = make_grid_mesh(9u);
+  AxMeshSerializer::write(path, {make_test_mesh(), mesh});
+
+  const AxMeshFile file(path);
+  ASSERT_EQ(file.size(), 2u);
+
+  const auto view = file.mesh(1u);
+  EXPECT_EQ(view.vertex_format, AxMeshVertexFormat::Full);
+  EXPECT_EQ(view.vertex_count, mesh.vertices.size());
+  EXPECT_EQ(view.vertex_bytes.size(), mesh.vertices.size() * sizeof(Vertex));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(view.vertex_bytes.data()) % k_axmesh_blob_alignment, 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(view.indices.data()) % k_axmesh_blob_alignment, 0u);
+  ASSERT_EQ(view.indices.size(), mesh.indices.size());
+  EXPECT_TRUE(std::equal(view.indices.begin(), view.indices.end(), mesh.indices.begin()));
+}
+
+TEST(AxMeshSerializerTest, QuantizedVerticesStayWithinTolerance) {
+  const auto root = make_temp_root("astralix-axmesh-quantized");
+  const auto full_path = root / "full.axmesh";
+  const auto quantized_path = root / "quantized.axmesh";
+
+  const Mesh mesh = make_grid_mesh(33u);
+  AxMeshSerializer::write(full_path, {mesh});
+  AxMeshSerializer::write(quantized_path, {mesh}, {.quantize = true});
+
+  EXPECT_LT(std::filesystem::file_size(quantized_path),
+            std::filesystem::file_size(full_path) * 2u / 3u);
+
+  const auto loaded = AxMeshSerializer::read(quantized_path);
+  ASSERT_EQ(loaded.size(), 1u);
+  ASSERT_EQ(loaded[0].vertices.size(), mesh.vertices.size());
+  EXPECT_EQ(loaded[0].indices, mesh.indices);
+
+  for (size_t index = 0; index < mesh.vertices.size(); ++index) {
+    const auto &expected = mesh.vertices[index];
+    const auto &actual = loaded[0].vertices[index];
+    EXPECT_EQ(actual.position, expected.position);
+    EXPECT_GT(glm::dot(actual.normal, expected.normal), 0.9999f);
+    EXPECT_GT(glm::dot(actual.tangent, expected.tangent), 0.999f);
+    EXPECT_EQ(actual.bitangent_sign, expected.bitangent_sign);
+    EXPECT_NEAR(actual.texture_coordinates.x, expected.texture_coordinates.x, 2e-3f);
+    EXPECT_NEAR(actual.texture_coordinates.y, expected.texture_coordinates.y, 2e-3f);
+  }
+}
+
+TEST(AxMeshSerializerTest, RejectsTruncatedBinaryFiles) {
+  const auto root = make_temp_root("astralix-axmesh-truncated");
+  const auto path = root / "truncated.axmesh";
+
+  AxMeshSerializer::write(path, {make_grid_mesh(9u)});
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 16u);
+
+  EXPECT_ANY_THROW(AxMeshSerializer::read(path));
+}
+
+TEST(AxMeshSerializerTest, RejectsCraftedOffsetsThatWrapPastTheFileEnd) {
+  const auto root = make_temp_root("astralix-axmesh-crafted");
+  const auto path = root / "crafted.axmesh";
+
+  // offset + count * stride wraps to a small value for each of these, so a
+  // check on the end alone would accept them.
+  const auto craft = [&](uint64_t offset, uint64_t value) {
+    AxMeshSerializer::write(path, {make_test_mesh()});
+    ASSERT_NO_THROW(AxMeshFile{path});
+    patch_file(path, offset, value);
+  };
+
+  craft(offsetof(AxMeshFileHeader, table_offset), ~uint64_t{0} - 63u);
+  EXPECT_ANY_THROW(AxMeshFile{path});
+
+  craft(mesh_entry_offset(0u, offsetof(AxMeshTableEntry, vertex_offset)),
+        ~uint64_t{0} - 15u);
+  EXPECT_ANY_THROW(AxMeshFile{path});
+
+  craft(mesh_entry_offset(0u, offsetof(AxMeshTableEntry, index_offset)),
+        ~uint64_t{0} - 15u);
+  EXPECT_ANY_THROW(AxMeshFile{path});
+}
+
+TEST(AxMeshSerializerTest, RejectsUnknownDrawTypes) {
+  const auto root = make_temp_root("astralix-axmesh-draw-type");
+  const auto path = root / "draw-type.axmesh";
+
+  AxMeshSerializer::write(path, {make_test_mesh()});
+  patch_file(path, mesh_entry_offset(0u, offsetof(AxMeshTableEntry, draw_type)),
+             uint32_t{7u});
+
+  EXPECT_ANY_THROW(AxMeshFile{path});
+  EXPECT_ANY_THROW(AxMeshSerializer::read(path));
+}
+
+TEST(AxMeshBenchmark, DISABLED_JsonVersusBinaryLoad) {
+  const auto root = make_temp_root("astralix-axmesh-benchmark");
+  const auto json_path = root / "grid.json.axmesh";
+  const auto binary_path = root / "grid.axmesh";
+
+  const std::vector<Mesh> meshes = {make_grid_mesh(128u)};
+  AxMeshSerializer::write(json_path, meshes, {.encoding = AxMeshEncoding::Json});
+  AxMeshSerializer::write(binary_path, meshes);
+
+  const auto time_read = [](const std::filesystem::path &path) {
+    return testing::best_ms(5, [&] {
+      const auto loaded = AxMeshSerializer::read(path);
+      EXPECT_EQ(loaded.size(), 1u);
+    });
+  };
+
+  const double json_ms = time_read(json_path);
+  const double binary_ms = time_read(binary_path);
+
+  std::printf(
+      "[AxMeshBenchmark] %zu vertices: json %.2f ms (%ju bytes), binary %.3f ms (%ju bytes)\n",
+      meshes[0].vertices.size(), json_ms,
+      static_cast<uintmax_t>(std::filesystem::file_size(json_path)), binary_ms,
+      static_cast<uintmax_t>(std::filesystem::file_size(binary_path))
+  );
+  testing::record_ms("json", json_ms);
+  testing::record_ms("binary", binary_ms);
+}
+
 } // namespace
 } // namespace astralix
@@ -1,13 +1,35 @@
 #include "importers/model-importer.hpp"
 
 #include "assert.hpp"
+#include "assimp/DefaultIOSystem.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 
+#include <algorithm>
+
 namespace astralix {
 namespace {
 
+// Notes every file assimp opens, so cooks can tell when a side file such as
+// an .obj's .mtl changes.
+class RecordingIOSystem : public Assimp::DefaultIOSystem {
+public:
+  Assimp::IOStream *Open(const char *file, const char *mode = "rb") override {
+    Assimp::IOStream *stream = Assimp::DefaultIOSystem::Open(file, mode);
+    if (stream != nullptr) {
+      const auto path = std::filesystem::path(file).lexically_normal();
+      if (std::find(opened.begin(), opened.end(), path) == opened.end()) {
+        opened.push_back(path);
+      }
+    }
+
+    return stream;
+  }
+
+  std::vector<std::filesystem::path> opened;
+};
+
 unsigned int build_postprocess_flags(const ModelImportSettings &settings) {
   unsigned int flags = 0;
   if (settings.triangulate) {
@@ -98,6 +120,9 @@ ImportedModelData import_model_file(
     const ModelImportSettings &settings
 ) {
   Assimp::Importer importer;
+  // The importer owns and deletes its IO handler.
+  auto *io_system = new RecordingIOSystem();
+  importer.SetIOHandler(io_system);
   const aiScene *scene =
       importer.ReadFile(path, build_postprocess_flags(settings));
 
@@ -108,6 +133,7 @@ ImportedModelData import_model_file(
   );
 
   ImportedModelData imported;
+  imported.source_files = std::move(io_system->opened);
   imported.material_slot_count = static_cast<size_t>(scene->mNumMaterials);
   process_nodes(
       scene->mRootNode,
@@ -18,6 +18,8 @@ struct ImportedModelData {
   std::vector<Mesh> meshes;
   std::vector<uint32_t> mesh_material_slots;
   size_t material_slot_count = 0;
+  // Every file the importer read, the model source included.
+  std::vector<std::filesystem::path> source_files;
 };
 
 ImportedModelData import_model_file(
@@ -39,6 +39,7 @@ public:
     std::vector<Slot> slots;
     std::vector<uint32_t> freelist;
     std::unordered_map<ResourceDescriptorID, ResourceHandle> descriptor_to_id;
+    uint64_t revision = 0;
 
     ResourceHandle find_handle_strict_by_id(
         const ResourceDescriptorID &desc_id
@@ -89,6 +90,7 @@ public:
 
       slots[slot_idx] = {std::move(resource), gen};
       descriptor_to_id.emplace(desc_id, handle);
+      ++revision;
 
       return handle;
     }
@@ -136,6 +138,7 @@ public:
           slot.resource.reset();
           slot.generation++;
           freelist.push_back(handle.index);
+          ++revision;
         }
       }
     }
@@ -151,6 +154,7 @@ public:
     std::vector<Slot> slots;
     std::vector<uint32_t> freelist;
     std::unordered_map<ResourceDescriptorID, Handle> descriptor_to_id;
+    uint64_t revision = 0;
 
     bool has_handle_by_id(const ResourceDescriptorID &desc_id) const {
       auto it = descriptor_to_id.find(desc_id);
@@ -196,6 +200,7 @@ public:
 
       Handle handle{slot_idx, gen};
       descriptor_to_id.emplace(desc_id, handle);
+      ++revision;
 
       return handle;
     }
@@ -227,6 +232,7 @@ public:
           slot.descriptor.reset();
           slot.generation++;
           freelist.push_back(handle.index);
+          ++revision;
         }
       }
     }
@@ -380,6 +386,20 @@ public:
     return m_model_pool.slots.size() - m_model_pool.freelist.size();
   }
 
+  // Moves whenever a render-facing resource or descriptor is registered or
+  // released, or touch() reports an in-place edit. Caches of resolved
+  // resources compare it to know when to resolve again.
+  uint64_t revision() const {
+    return m_revision + m_texture_2d_pool.revision +
+           m_texture_3d_pool.revision + m_shader_pool.revision +
+           m_model_pool.revision + m_material_pool.revision +
+           m_material_descriptor_pool.revision +
+           m_model_descriptor_pool.revision;
+  }
+
+  // Call after mutating a descriptor in place, e.g. material edits.
+  void touch() { ++m_revision; }
+
   ResourceManager() = default;
 
 private:
@@ -400,6 +420,7 @@ private:
   ResourcePool<Material, MaterialDescriptor> m_material_pool;
   ResourcePool<Font, FontDescriptor> m_font_pool;
   ResourcePool<Svg, SvgDescriptor> m_svg_pool;
+  uint64_t m_revision = 0;
   mutable std::mutex m_async_resource_mutex;
   std::unordered_set<ResourceDescriptorID> m_pending_texture_2d_loads;
   std::unordered_set<ResourceDescriptorID> m_pending_model_loads;
@@ -60,6 +60,18 @@ public:
     id = generate_hash_id();
   };
 
+  // Adopts vertices whose tangents, bounds and id were computed at cook time.
+  static Mesh from_cooked(std::vector<Vertex> vertices,
+                          std::vector<unsigned int> indices, const AABB &bounds,
+                          MeshID id) {
+    Mesh mesh;
+    mesh.vertices = std::move(vertices);
+    mesh.indices = std::move(indices);
+    mesh.bounds = bounds;
+    mesh.id = id;
+    return mesh;
+  }
+
   ~Mesh() = default;
 
   void compute_bounds() {
@@ -91,6 +103,9 @@ public:
   }
 
   void calculate_tangents_mikktspace();
+
+private:
+  Mesh() = default;
 };
 
 } // namespace astralix
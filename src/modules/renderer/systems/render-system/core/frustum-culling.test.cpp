@@ -0,0 +1,214 @@
+#include "systems/render-system/frustum-culling.hpp"
+#include "systems/render-system/scene-culling.hpp"
+#include "helpers/benchmark.hpp"
+#include "systems/job-system/job-system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace astralix::rendering {
+namespace {
+
+// 90 degree pyramid looking down -z from the origin, near 1, far 500.
+Frustum make_frustum() {
+  Frustum frustum;
+  const float diagonal = 1.0f / std::sqrt(2.0f);
+  frustum.planes[0] = {glm::vec3(diagonal, 0.0f, -diagonal), 0.0f};
+  frustum.planes[1] = {glm::vec3(-diagonal, 0.0f, -diagonal), 0.0f};
+  frustum.planes[2] = {glm::vec3(0.0f, diagonal, -diagonal), 0.0f};
+  frustum.planes[3] = {glm::vec3(0.0f, -diagonal, -diagonal), 0.0f};
+  frustum.planes[4] = {glm::vec3(0.0f, 0.0f, -1.0f), -1.0f};
+  frustum.planes[5] = {glm::vec3(0.0f, 0.0f, 1.0f), 500.0f};
+  return frustum;
+}
+
+// Orthographic light looking down -z from the origin: 20 units wide and
+// tall, depth range [1, 20].
+glm::mat4 make_light_matrix() {
+  const float near_plane = 1.0f;
+  const float far_plane = 20.0f;
+  glm::mat4 projection(1.0f);
+  projection[0][0] = 0.1f;
+  projection[1][1] = 0.1f;
+  projection[2][2] = -2.0f / (far_plane - near_plane);
+  projection[3][2] = -(far_plane + near_plane) / (far_plane - near_plane);
+  return projection;
+}
+
+glm::mat4 make_model(const glm::vec3 &translation, float scale) {
+  glm::mat4 model(1.0f);
+  model[0][0] = scale;
+  model[1][1] = scale;
+  model[2][2] = scale;
+  model[3] = glm::vec4(translation, 1.0f);
+  return model;
+}
+
+struct RandomScene {
+  AABB local_bounds;
+  std::vector<glm::mat4> models;
+};
+
+RandomScene make_scene(size_t count, uint32_t seed) {
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<float> position(-600.0f, 600.0f);
+  std::uniform_real_distribution<float> scale(0.25f, 4.0f);
+
+  RandomScene scene;
+  scene.local_bounds.min = glm::vec3(-1.0f, -0.5f, -2.0f);
+  scene.local_bounds.max = glm::vec3(1.0f, 1.5f, 2.0f);
+  scene.models.reserve(count);
+  for (size_t index = 0; index < count; ++index) {
+    scene.models.push_back(make_model(
+        glm::vec3(position(random), position(random) * 0.25f, position(random)), scale(random)
+    ));
+  }
+  return scene;
+}
+
+CullBounds world_bounds(const RandomScene &scene) {
+  CullBounds bounds;
+  bounds.resize(scene.models.size());
+  for (size_t index = 0; index < scene.models.size(); ++index) {
+    bounds.set(index, transform_bounds(scene.local_bounds, scene.models[index]));
+  }
+  return bounds;
+}
+
+std::vector<uint8_t> brute_force(const Frustum &frustum, const CullBounds &bounds) {
+  std::vector<uint8_t> visible(bounds.size());
+  cull_bounds(frustum, bounds, 0u, bounds.size(), visible.data(), CullKernel::Scalar);
+  return visible;
+}
+
+TEST(FrustumCullingTest, KernelsMatchScalar) {
+  const auto frustum = make_frustum();
+  // Odd count exercises the scalar tail.
+  const auto bounds = world_bounds(make_scene(10003, 3));
+  const auto expected = brute_force(frustum, bounds);
+
+  std::vector<uint8_t> visible(bounds.size());
+  cull_bounds(frustum, bounds, 0u, bounds.size(), visible.data());
+  EXPECT_EQ(visible, expected) << cull_kernel_name(best_cull_kernel());
+  EXPECT_GT(std::count(expected.begin(), expected.end(), 1u), 0);
+  EXPECT_GT(std::count(expected.begin(), expected.end(), 0u), 0);
+}
+
+TEST(FrustumCullingTest, WorldBoundsMatchOrientedTestForUnrotatedModels) {
+  const auto frustum = make_frustum();
+  const auto scene = make_scene(4000, 5);
+  const auto visible = brute_force(frustum, world_bounds(scene));
+
+  for (size_t index = 0; index < scene.models.size(); ++index) {
+    EXPECT_EQ(visible[index] != 0u, is_aabb_visible(frustum, scene.local_bounds, scene.models[index]))
+        << "model " << index;
+  }
+}
+
+TEST(FrustumCullingTest, ShadowCasterFrustumExtendsTowardLight) {
+  const auto light_frustum = extract_frustum(make_light_matrix());
+  const auto caster_frustum = extract_shadow_caster_frustum(make_light_matrix());
+
+  CullBounds bounds;
+  bounds.resize(4u);
+  const glm::vec3 extents(0.5f);
+  bounds.set(0u, {.center = glm::vec3(2.0f, 3.0f, -10.0f), .extents = extents});
+  bounds.set(1u, {.center = glm::vec3(2.0f, 3.0f, 50.0f), .extents = extents});
+  bounds.set(2u, {.center = glm::vec3(2.0f, 3.0f, -40.0f), .extents = extents});
+  bounds.set(3u, {.center = glm::vec3(25.0f, 3.0f, -10.0f), .extents = extents});
+
+  // Inside, between the light and the near plane, past the far plane, and
+  // off to the side.
+  EXPECT_EQ(brute_force(light_frustum, bounds), (std::vector<uint8_t>{1u, 0u, 0u, 0u}));
+  EXPECT_EQ(brute_force(caster_frustum, bounds), (std::vector<uint8_t>{1u, 1u, 0u, 0u}));
+
+  std::vector<uint8_t> visible(bounds.size());
+  cull_bounds(caster_frustum, bounds, 0u, bounds.size(), visible.data());
+  EXPECT_EQ(visible, brute_force(caster_frustum, bounds));
+}
+
+TEST(SceneCullerTest, MatchesBruteForceAcrossWorkers) {
+  const auto frustum = make_frustum();
+  const auto bounds = world_bounds(make_scene(50003, 19));
+
+  JobSystem jobs(JobSystem::Config{.worker_count = 3});
+  jobs.start();
+
+  SceneCuller culler;
+  std::vector<uint8_t> visible;
+  culler.cull(frustum, bounds, visible);
+  jobs.end();
+
+  const auto expected = brute_force(frustum, bounds);
+  EXPECT_EQ(visible, expected);
+  EXPECT_EQ(culler.stats().candidates, static_cast<uint32_t>(bounds.size()));
+  EXPECT_EQ(culler.stats().visible,
+            static_cast<uint32_t>(std::count(expected.begin(), expected.end(), 1u)));
+}
+
+TEST(SceneCullerTest, CullsEveryView) {
+  glm::mat4 light_view(1.0f);
+  light_view[3] = glm::vec4(0.0f, 0.0f, 150.0f, 1.0f);
+  const std::vector<Frustum> frusta{
+      make_frustum(),
+      extract_shadow_caster_frustum(make_light_matrix()),
+      extract_shadow_caster_frustum(make_light_matrix() * light_view),
+  };
+  const auto bounds = world_bounds(make_scene(20000, 37));
+
+  SceneCuller culler;
+  std::vector<std::vector<uint8_t>> visible(frusta.size());
+  culler.cull(frusta, bounds, visible);
+
+  uint32_t expected_visible = 0;
+  for (size_t view = 0; view < frusta.size(); ++view) {
+    const auto expected = brute_force(frusta[view], bounds);
+    EXPECT_EQ(visible[view], expected) << "view " << view;
+    expected_visible += static_cast<uint32_t>(std::count(expected.begin(), expected.end(), 1u));
+  }
+  EXPECT_EQ(culler.stats().visible, expected_visible);
+}
+
+TEST(SceneCullerBenchmark, DISABLED_HundredThousandStaticRenderables) {
+  const auto frustum = make_frustum();
+  const auto scene = make_scene(100000, 31);
+  const auto bounds = world_bounds(scene);
+
+  size_t oriented_visible = 0;
+  const double oriented_ms = testing::elapsed_ms([&]() {
+    for (const auto &model : scene.models) {
+      oriented_visible += is_aabb_visible(frustum, scene.local_bounds, model) ? 1u : 0u;
+    }
+  });
+
+  std::vector<uint8_t> visible(bounds.size());
+  const double flat_ms = testing::best_ms(5, [&]() {
+    cull_bounds(frustum, bounds, 0u, bounds.size(), visible.data());
+  });
+
+  JobSystem jobs(JobSystem::Config{.worker_count = testing::benchmark_worker_count()});
+  jobs.start();
+  const uint32_t workers = jobs.worker_count();
+
+  SceneCuller culler;
+  const double culler_ms = testing::best_ms(5, [&]() { culler.cull(frustum, bounds, visible); });
+  jobs.end();
+
+  std::printf(
+      "[SceneCullerBenchmark] %zu renderables, %zu visible: per-mesh oriented %.2f ms, "
+      "flat %s %.2f ms, culler %.2f ms (%u workers)\n",
+      scene.models.size(), oriented_visible, oriented_ms, cull_kernel_name(best_cull_kernel()),
+      flat_ms, culler_ms, workers
+  );
+  testing::record_ms("oriented", oriented_ms);
+  testing::record_ms("flat", flat_ms);
+  testing::record_ms("culler", culler_ms);
+}
+
+} // namespace
+} // namespace astralix::rendering
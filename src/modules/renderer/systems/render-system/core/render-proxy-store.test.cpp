@@ -0,0 +1,134 @@
+#include "systems/render-system/scene-extraction.hpp"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+
+namespace astralix::rendering {
+namespace {
+
+// Drives sync_render_proxy_store with a resolver that needs no resources:
+// every active proxy gets one unit-cube mesh, and the material it would have
+// resolved is recorded per entity.
+class RenderProxyStoreTest : public ::testing::Test {
+protected:
+  ecs::EntityHandle spawn(const char *name, const char *material) {
+    auto entity = m_world.spawn(name);
+    entity.emplace<Renderable>();
+    entity.emplace<scene::Transform>();
+    entity.emplace<ShaderBinding>(ShaderBinding{.shader = "shaders::lit"});
+    entity.emplace<MaterialSlots>(MaterialSlots{.materials = {material}});
+    return entity.handle();
+  }
+
+  std::vector<EntityID> sync() {
+    std::vector<EntityID> resolved;
+    sync_render_proxy_store(m_world, m_store, false, [&](std::span<const uint32_t> stale) {
+      for (uint32_t index : stale) {
+        auto &proxy = m_store.proxies[index];
+        resolved.push_back(proxy.entity_id);
+        proxy.meshes.clear();
+        if (!proxy.active) {
+          continue;
+        }
+
+        proxy.meshes.push_back(RenderProxyMesh{
+            .mesh = ResolvedMeshDraw{
+                .local_bounds = AABB{.min = glm::vec3(-1.0f), .max = glm::vec3(1.0f)},
+            },
+        });
+        m_materials[proxy.entity_id] =
+            m_world.get<MaterialSlots>(proxy.handle)->materials.front();
+      }
+    });
+    return resolved;
+  }
+
+  EntityID id(ecs::EntityHandle handle) const { return m_world.id(handle); }
+
+  ecs::World m_world;
+  RenderProxyStore m_store;
+  std::unordered_map<EntityID, ResourceDescriptorID> m_materials;
+};
+
+TEST_F(RenderProxyStoreTest, ResolvesOnlyAddedRenderables) {
+  const auto first = spawn("first", "materials::stone");
+  const auto second = spawn("second", "materials::wood");
+  EXPECT_EQ(sync(), (std::vector<EntityID>{id(first), id(second)}));
+  EXPECT_EQ(m_store.stats.proxies, 2u);
+  EXPECT_EQ(m_store.stats.meshes, 2u);
+
+  const auto third = spawn("third", "materials::glass");
+  EXPECT_EQ(sync(), std::vector<EntityID>{id(third)});
+  EXPECT_EQ(m_store.stats.proxies, 3u);
+  EXPECT_EQ(m_store.pick_id_lut.size(), 3u);
+}
+
+TEST_F(RenderProxyStoreTest, DropsProxiesOfRemovedRenderables) {
+  const EntityID kept = id(spawn("kept", "materials::stone"));
+  const EntityID removed = id(spawn("removed", "materials::wood"));
+  sync();
+
+  m_world.destroy(removed);
+  EXPECT_TRUE(sync().empty());
+  EXPECT_EQ(m_store.stats.proxies, 1u);
+  EXPECT_EQ(m_store.meshes.size(), 1u);
+  EXPECT_EQ(m_store.proxies.front().entity_id, kept);
+  EXPECT_EQ(m_store.lookup.find(removed), m_store.lookup.end());
+}
+
+TEST_F(RenderProxyStoreTest, TransformOnlyEditsRebindWithoutResolving) {
+  spawn("still", "materials::stone");
+  const auto moving = spawn("moving", "materials::wood");
+  sync();
+
+  // Written the way physics writes poses: in place, then mark_changed.
+  m_world.get<scene::Transform>(moving)->matrix[3] = glm::vec4(5.0f, 0.0f, 0.0f, 1.0f);
+  m_world.mark_changed<scene::Transform>(moving);
+
+  // Only the moved mesh is re-bounded; a relayout would rewrite both.
+  EXPECT_TRUE(sync().empty());
+  EXPECT_EQ(m_store.mesh_bounds.center_x[1], 5.0f);
+  EXPECT_EQ(m_store.mesh_bounds.center_x[0], 0.0f);
+  EXPECT_EQ(m_store.stats.bounds_updated, 1u);
+
+  // Nothing changed since: nothing moves or resolves.
+  EXPECT_TRUE(sync().empty());
+  EXPECT_EQ(m_store.stats.bounds_updated, 0u);
+}
+
+TEST_F(RenderProxyStoreTest, MarkChangedMaterialEditsResolveThatProxyOnly) {
+  spawn("still", "materials::stone");
+  const auto edited = spawn("edited", "materials::wood");
+  sync();
+  const uint64_t world_revision = m_world.revision();
+
+  // An in-place edit leaves World::revision alone; only the column's change
+  // stamp tells the store to resolve the proxy again.
+  m_world.get<MaterialSlots>(edited)->materials.front() = "materials::gold";
+  m_world.mark_changed<MaterialSlots>(edited);
+  ASSERT_EQ(m_world.revision(), world_revision);
+
+  EXPECT_EQ(sync(), std::vector<EntityID>{id(edited)});
+  EXPECT_EQ(m_materials[id(edited)], "materials::gold");
+  EXPECT_EQ(m_store.stats.proxies, 2u);
+
+  EXPECT_TRUE(sync().empty());
+}
+
+TEST_F(RenderProxyStoreTest, ResourceChangesResolveEveryProxy) {
+  const auto first = spawn("first", "materials::stone");
+  const auto second = spawn("second", "materials::wood");
+  sync();
+
+  std::vector<EntityID> resolved;
+  sync_render_proxy_store(m_world, m_store, true, [&](std::span<const uint32_t> stale) {
+    for (uint32_t index : stale) {
+      resolved.push_back(m_store.proxies[index].entity_id);
+    }
+  });
+  EXPECT_EQ(resolved, (std::vector<EntityID>{id(first), id(second)}));
+}
+
+} // namespace
+} // namespace astralix::rendering
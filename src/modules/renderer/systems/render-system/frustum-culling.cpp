@@ -0,0 +1,137 @@
+#include "frustum-culling.hpp"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define ASTRA_CULL_AVX 1
+#define ASTRA_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace astralix::rendering {
+
+namespace {
+
+// Box i is outside when, for some plane, its center lies further behind the
+// plane than the box reaches along the plane normal.
+void cull_bounds_scalar(const Frustum &frustum, const CullBounds &bounds,
+                        size_t begin, size_t end, uint8_t *visible) {
+  for (size_t index = begin; index < end; ++index) {
+    bool inside = true;
+    for (const auto &plane : frustum.planes) {
+      const float distance = plane.normal.x * bounds.center_x[index] +
+                             plane.normal.y * bounds.center_y[index] +
+                             plane.normal.z * bounds.center_z[index] +
+                             plane.distance;
+      const float reach = std::abs(plane.normal.x) * bounds.extent_x[index] +
+                          std::abs(plane.normal.y) * bounds.extent_y[index] +
+                          std::abs(plane.normal.z) * bounds.extent_z[index];
+      if (distance + reach < 0.0f) {
+        inside = false;
+        break;
+      }
+    }
+    visible[index] = inside ? 1u : 0u;
+  }
+}
+
+#if defined(ASTRA_CULL_AVX)
+
+ASTRA_TARGET_AVX void cull_bounds_avx(const Frustum &frustum, const CullBounds &bounds,
+                                      size_t begin, size_t end, uint8_t *visible) {
+  struct PlaneLanes {
+    __m256 normal_x, normal_y, normal_z, distance;
+    __m256 reach_x, reach_y, reach_z;
+  };
+
+  PlaneLanes planes[6];
+  for (size_t index = 0; index < 6; ++index) {
+    const auto &plane = frustum.planes[index];
+    planes[index] = PlaneLanes{
+        _mm256_set1_ps(plane.normal.x),
+        _mm256_set1_ps(plane.normal.y),
+        _mm256_set1_ps(plane.normal.z),
+        _mm256_set1_ps(plane.distance),
+        _mm256_set1_ps(std::abs(plane.normal.x)),
+        _mm256_set1_ps(std::abs(plane.normal.y)),
+        _mm256_set1_ps(std::abs(plane.normal.z)),
+    };
+  }
+
+  const __m256 zero = _mm256_setzero_ps();
+  size_t index = begin;
+  for (; index + 8 <= end; index += 8) {
+    const __m256 center_x = _mm256_loadu_ps(bounds.center_x.data() + index);
+    const __m256 center_y = _mm256_loadu_ps(bounds.center_y.data() + index);
+    const __m256 center_z = _mm256_loadu_ps(bounds.center_z.data() + index);
+    const __m256 extent_x = _mm256_loadu_ps(bounds.extent_x.data() + index);
+    const __m256 extent_y = _mm256_loadu_ps(bounds.extent_y.data() + index);
+    const __m256 extent_z = _mm256_loadu_ps(bounds.extent_z.data() + index);
+
+    // Lanes set here are outside at least one plane.
+    __m256 outside = _mm256_setzero_ps();
+    for (const auto &plane : planes) {
+      __m256 distance = _mm256_mul_ps(plane.normal_x, center_x);
+      distance = _mm256_add_ps(distance, _mm256_mul_ps(plane.normal_y, center_y));
+      distance = _mm256_add_ps(distance, _mm256_mul_ps(plane.normal_z, center_z));
+      distance = _mm256_add_ps(distance, plane.distance);
+
+      __m256 reach = _mm256_mul_ps(plane.reach_x, extent_x);
+      reach = _mm256_add_ps(reach, _mm256_mul_ps(plane.reach_y, extent_y));
+      reach = _mm256_add_ps(reach, _mm256_mul_ps(plane.reach_z, extent_z));
+
+      outside = _mm256_or_ps(
+          outside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), zero, _CMP_LT_OQ)
+      );
+    }
+
+    const int mask = _mm256_movemask_ps(outside);
+    for (int lane = 0; lane < 8; ++lane) {
+      visible[index + lane] = ((mask >> lane) & 1) != 0 ? 0u : 1u;
+    }
+  }
+
+  cull_bounds_scalar(frustum, bounds, index, end, visible);
+}
+
+#endif
+
+} // namespace
+
+CullKernel best_cull_kernel() {
+#if defined(ASTRA_CULL_AVX)
+  static const CullKernel kernel =
+      __builtin_cpu_supports("avx") ? CullKernel::AVX : CullKernel::Scalar;
+  return kernel;
+#else
+  return CullKernel::Scalar;
+#endif
+}
+
+const char *cull_kernel_name(CullKernel kernel) {
+  switch (kernel) {
+    case CullKernel::Scalar:
+      return "Scalar";
+    case CullKernel::AVX:
+      return "AVX";
+  }
+
+  return "Unknown";
+}
+
+void cull_bounds(const Frustum &frustum, const CullBounds &bounds, size_t begin,
+                 size_t end, uint8_t *visible, CullKernel kernel) {
+  switch (kernel) {
+#if defined(ASTRA_CULL_AVX)
+    case CullKernel::AVX:
+      cull_bounds_avx(frustum, bounds, begin, end, visible);
+      return;
+#endif
+    default:
+      cull_bounds_scalar(frustum, bounds, begin, end, visible);
+      return;
+  }
+}
+
+} // namespace astralix::rendering
@@ -3,6 +3,10 @@
 #include "glm/glm.hpp"
 #include "resources/mesh.hpp"
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 namespace astralix::rendering {
 
@@ -59,6 +63,16 @@ inline Frustum extract_frustum(const glm::mat4 &view_projection) {
   return frustum;
 }
 
+// Frustum for gathering shadow casters of a light view. The near plane is
+// dropped so the volume extends toward the light without bound: geometry
+// between the light and the shadowed region still casts into it.
+inline Frustum extract_shadow_caster_frustum(const glm::mat4 &light_view_projection) {
+  Frustum frustum = extract_frustum(light_view_projection);
+  frustum.planes[4].normal = glm::vec3(0.0f);
+  frustum.planes[4].distance = std::numeric_limits<float>::max();
+  return frustum;
+}
+
 inline bool is_aabb_visible(const Frustum &frustum, const AABB &local_bounds, const glm::mat4 &model) {
   const glm::vec3 center = local_bounds.center();
   const glm::vec3 extents = local_bounds.extents();
@@ -86,4 +100,77 @@ inline bool is_aabb_visible(const Frustum &frustum, const AABB &local_bounds, co
   return true;
 }
 
+struct WorldBounds {
+  glm::vec3 center = glm::vec3(0.0f);
+  glm::vec3 extents = glm::vec3(0.0f);
+};
+
+// World-space box enclosing the transformed local bounds. Looser than the
+// oriented test in is_aabb_visible for rotated models, never tighter.
+inline WorldBounds transform_bounds(const AABB &local_bounds, const glm::mat4 &model) {
+  const glm::vec3 center = local_bounds.center();
+  const glm::vec3 extents = local_bounds.extents();
+
+  WorldBounds bounds;
+  bounds.center = glm::vec3(model * glm::vec4(center, 1.0f));
+  for (int axis = 0; axis < 3; ++axis) {
+    bounds.extents[axis] = extents.x * std::abs(model[0][axis]) +
+                           extents.y * std::abs(model[1][axis]) +
+                           extents.z * std::abs(model[2][axis]);
+  }
+  return bounds;
+}
+
+// World bounds laid out one component per array, so the culling kernels can
+// test eight boxes against a plane at a time.
+struct CullBounds {
+  std::vector<float> center_x;
+  std::vector<float> center_y;
+  std::vector<float> center_z;
+  std::vector<float> extent_x;
+  std::vector<float> extent_y;
+  std::vector<float> extent_z;
+
+  size_t size() const { return center_x.size(); }
+
+  void resize(size_t count) {
+    center_x.resize(count);
+    center_y.resize(count);
+    center_z.resize(count);
+    extent_x.resize(count);
+    extent_y.resize(count);
+    extent_z.resize(count);
+  }
+
+  void set(size_t index, const WorldBounds &bounds) {
+    center_x[index] = bounds.center.x;
+    center_y[index] = bounds.center.y;
+    center_z[index] = bounds.center.z;
+    extent_x[index] = bounds.extents.x;
+    extent_y[index] = bounds.extents.y;
+    extent_z[index] = bounds.extents.z;
+  }
+
+  WorldBounds get(size_t index) const {
+    return WorldBounds{
+        .center = glm::vec3(center_x[index], center_y[index], center_z[index]),
+        .extents = glm::vec3(extent_x[index], extent_y[index], extent_z[index]),
+    };
+  }
+};
+
+enum class CullKernel : uint8_t {
+  Scalar,
+  AVX,
+};
+
+// Widest kernel the running CPU supports.
+CullKernel best_cull_kernel();
+const char *cull_kernel_name(CullKernel kernel);
+
+// Sets visible[i] to 1 when bounds i in [begin, end) touches the frustum and
+// to 0 otherwise. Every kernel gives the same answer.
+void cull_bounds(const Frustum &frustum, const CullBounds &bounds, size_t begin,
+                 size_t end, uint8_t *visible, CullKernel kernel = best_cull_kernel());
+
 } // namespace astralix::rendering
@@ -200,7 +200,7 @@ inline LightFrameData collect_light_frame(ecs::World &world) {
   const auto main_camera = select_main_camera(world);
   size_t point_index = 0u;
 
-  world.each<scene::Transform, Light>([&](EntityID entity_id, scene::Transform &transform, Light &light) {
+  world.each<const scene::Transform, const Light>([&](EntityID entity_id, const scene::Transform &transform, const Light &light) {
     if (!world.active(entity_id)) {
       return;
     }
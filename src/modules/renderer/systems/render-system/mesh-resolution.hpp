@@ -103,7 +103,7 @@ prepare_render_meshes(ModelRef *model_ref, MeshSet *mesh_set,
 inline bool has_renderables(ecs::World &world) {
   bool found = false;
 
-  world.each<Renderable, scene::Transform>([&](EntityID entity_id, Renderable &, scene::Transform &) {
+  world.each<const Renderable, const scene::Transform>([&](EntityID entity_id, const Renderable &, const scene::Transform &) {
     if (found || !world.active(entity_id)) {
       return;
     }
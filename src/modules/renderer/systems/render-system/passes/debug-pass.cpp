@@ -21,7 +21,7 @@ rendering::DirectionalShadowSettings resolve_debug_shadow_settings() {
   rendering::DirectionalShadowSettings settings{};
   bool found = false;
 
-  world.each<scene::Transform, rendering::Light>(
+  world.each<const scene::Transform, const rendering::Light>(
       [&](EntityID entity_id, const scene::Transform &, const rendering::Light &light) {
         if (found || !world.active(entity_id) ||
             light.type != rendering::LightType::Directional) {
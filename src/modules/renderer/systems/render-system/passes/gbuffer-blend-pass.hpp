@@ -138,7 +138,7 @@ public:
 
       if (!pipeline.valid()) {
         const CullMode cull_mode =
-            surface.material.double_sided ? CullMode::None : CullMode::Back;
+            surface.material->double_sided ? CullMode::None : CullMode::Back;
         pipeline_desc.raster.cull_mode = cull_mode;
         pipeline = frame.register_pipeline(pipeline_desc, m_shader);
       }
@@ -166,7 +166,7 @@ public:
       }
 
       const auto material_key =
-          rendering::make_material_group_key(surface.material);
+          rendering::make_material_group_key(*surface.material);
       auto material_it = material_bindings.find(material_key);
       if (material_it == material_bindings.end()) {
         const auto material_group = frame.register_binding_group(
@@ -185,7 +185,7 @@ public:
         );
         const auto material_binding =
             rendering::record_resolved_material_bindings(
-                frame, material_group, surface.material, material_layout
+                frame, material_group, *surface.material, material_layout
             );
         rendering::record_shader_params(
             frame,
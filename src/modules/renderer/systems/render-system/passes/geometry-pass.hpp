@@ -237,12 +237,12 @@ public:
       }
 
       const CullMode cull_mode =
-          surface.material.double_sided ? CullMode::None : CullMode::Back;
+          surface.material->double_sided ? CullMode::None : CullMode::Back;
       const auto pipeline =
           ensure_pipeline_and_scene_bindings(cull_mode);
 
       const auto material_key =
-          rendering::make_material_group_key(surface.material);
+          rendering::make_material_group_key(*surface.material);
       auto material_it = material_bindings.find(material_key);
       if (material_it == material_bindings.end()) {
         const auto material_group = frame.register_binding_group(
@@ -261,7 +261,7 @@ public:
         );
         const auto material_binding =
             rendering::record_resolved_material_bindings(
-                frame, material_group, surface.material, material_layout
+                frame, material_group, *surface.material, material_layout
             );
         rendering::record_shader_params(
             frame,
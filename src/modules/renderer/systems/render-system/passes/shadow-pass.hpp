@@ -46,9 +46,9 @@ public:
     }
 
     const auto *scene_frame = ctx.scene();
-    if (scene_frame == nullptr || scene_frame->shadow_draws.empty() ||
+    if (scene_frame == nullptr || !scene_frame->has_shadow_draws() ||
         !scene_frame->light_frame.directional.valid || m_shader == nullptr) {
-      LOG_WARN("[ShadowPass] early exit: scene=", scene_frame != nullptr, " draws=", scene_frame ? scene_frame->shadow_draws.size() : 0, " light_valid=", scene_frame ? scene_frame->light_frame.directional.valid : false, " shader=", m_shader != nullptr);
+      LOG_WARN("[ShadowPass] early exit: scene=", scene_frame != nullptr, " draws=", scene_frame ? scene_frame->has_shadow_draws() : false, " light_valid=", scene_frame ? scene_frame->light_frame.directional.valid : false, " shader=", m_shader != nullptr);
       return;
     }
 
@@ -135,7 +135,10 @@ public:
       );
       recorder.bind_binding_group(scene_bindings);
 
-      for (const auto &shadow_draw : scene_frame->shadow_draws) {
+      const auto &shadow_draws = use_cascades
+                                     ? scene_frame->cascade_shadow_draws[cascade_index]
+                                     : scene_frame->shadow_draws;
+      for (const auto &shadow_draw : shadow_draws) {
         if (shadow_draw.mesh.vertex_array == nullptr ||
             shadow_draw.mesh.index_count == 0) {
           continue;
@@ -183,13 +186,25 @@ public:
     recorder.end_rendering();
 
     if (m_debug_frame_counter++ % 300 == 0) {
-      LOG_DEBUG("[ShadowPass] rendered: cascades=", use_cascades, " cascade_count=", cascade_count, " shadow_draws=", scene_frame->shadow_draws.size(), " extent=", extent.width, "x", extent.height);
+      LOG_DEBUG("[ShadowPass] rendered: cascades=", use_cascades, " cascade_count=", cascade_count, " shadow_draws=", shadow_draw_count(*scene_frame, use_cascades), " extent=", extent.width, "x", extent.height);
     }
   }
 
   std::string name() const override { return "ShadowPass"; }
 
 private:
+  static size_t shadow_draw_count(const rendering::SceneFrame &scene_frame, bool use_cascades) {
+    if (!use_cascades) {
+      return scene_frame.shadow_draws.size();
+    }
+
+    size_t count = 0;
+    for (const auto &draws : scene_frame.cascade_shadow_draws) {
+      count += draws.size();
+    }
+    return count;
+  }
+
   Ref<Shader> m_shader = nullptr;
   uint32_t m_debug_frame_counter = 0;
 };
@@ -4,12 +4,14 @@
 #include "components/mesh.hpp"
 #include "components/tags.hpp"
 #include "components/text.hpp"
+#include "containers/flat-hash-map.hpp"
 #include "glm/glm.hpp"
 #include "renderer-api.hpp"
 #include "resources/font.hpp"
 #include "resources/shader.hpp"
 #include "resources/svg.hpp"
 #include "resources/texture.hpp"
+#include "scene-culling.hpp"
 #include "types.hpp"
 #include "world.hpp"
 #include <algorithm>
@@ -19,6 +21,10 @@
 #include <unordered_map>
 #include <vector>
 
+namespace astralix {
+class RenderTarget;
+}
+
 namespace astralix::rendering {
 
 inline constexpr float k_default_directional_shadow_extent = 10.0f;
@@ -149,12 +155,36 @@ struct ResolvedMeshDraw {
   AABB local_bounds;
 };
 
+// Read-only material of a surface draw. Render proxies resolve a material
+// once and every frame that draws the surface shares it.
+class SurfaceMaterial {
+public:
+  SurfaceMaterial() = default;
+  SurfaceMaterial(ResolvedMaterialData data)
+      : m_data(create_ref<const ResolvedMaterialData>(std::move(data))) {}
+  SurfaceMaterial(Ref<const ResolvedMaterialData> data)
+      : m_data(std::move(data)) {}
+
+  const ResolvedMaterialData &operator*() const {
+    return m_data != nullptr ? *m_data : empty();
+  }
+  const ResolvedMaterialData *operator->() const { return &**this; }
+
+private:
+  static const ResolvedMaterialData &empty() {
+    static const ResolvedMaterialData data{};
+    return data;
+  }
+
+  Ref<const ResolvedMaterialData> m_data = nullptr;
+};
+
 struct SurfaceDrawItem {
   EntityID entity_id{};
   uint32_t pick_id = 0;
   ResourceDescriptorID shader_id;
   Ref<Shader> shader = nullptr;
-  ResolvedMaterialData material{};
+  SurfaceMaterial material{};
   ResolvedMeshDraw mesh{};
   glm::mat4 model = glm::mat4(1.0f);
   glm::mat4 previous_model = glm::mat4(1.0f);
@@ -334,7 +364,12 @@ struct SceneFrame {
   std::optional<SkyboxFrame> skybox;
   std::vector<SurfaceDrawItem> opaque_surfaces;
   std::vector<SurfaceDrawItem> blend_surfaces;
+  // Casters for the single light_space_matrix view, used when the
+  // directional light has no cascades.
   std::vector<ShadowDrawItem> shadow_draws;
+  // Casters culled against each cascade's light frustum.
+  std::array<std::vector<ShadowDrawItem>, k_shadow_cascade_count>
+      cascade_shadow_draws;
   std::vector<TextDrawItem> text_items;
   std::vector<UIRootDrawList> ui_roots;
   ResolvedUIResources ui_resources;
@@ -354,30 +389,126 @@ struct SceneFrame {
   TAAFrameSettings taa{};
   TonemappingFrameSettings tonemapping{};
 
+  [[nodiscard]] bool has_shadow_draws() const noexcept {
+    if (!shadow_draws.empty()) {
+      return true;
+    }
+
+    for (const auto &draws : cascade_shadow_draws) {
+      if (!draws.empty()) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
   [[nodiscard]] bool empty() const noexcept {
     return !main_camera.has_value() && !skybox.has_value() &&
-           opaque_surfaces.empty() && shadow_draws.empty() &&
+           opaque_surfaces.empty() && !has_shadow_draws() &&
            text_items.empty() && ui_roots.empty();
   }
 };
 
-struct RenderRuntimeState {
-  uint64_t surface_sort_key = 0;
+struct RenderProxyMesh {
+  ResolvedMeshDraw mesh{};
+  SurfaceMaterial material{};
+  uint64_t sort_key = 0;
+  uint64_t shadow_sort_key = 0;
+  bool alpha_blend = false;
+};
+
+// Everything extraction needs to draw one renderable entity. Resolved again
+// only when the entity's render components or the resources behind them
+// change; frames just refresh the transform.
+struct RenderProxy {
+  EntityID entity_id{};
+  ecs::EntityHandle handle{0u, 0u};
+  // Which optional render components the entity had when resolved.
+  uint32_t component_mask = 0;
+  bool active = false;
+  bool casts_shadow = true;
+  uint32_t pick_id = 0;
+  ResourceDescriptorID shader_id;
+  Ref<Shader> shader = nullptr;
+  BloomSettings bloom_settings{};
+  std::vector<RenderProxyMesh> meshes;
+  // First of this proxy's entries in RenderProxyStore::meshes.
+  uint32_t mesh_begin = 0;
+  glm::mat4 transform = glm::mat4(1.0f);
   glm::mat4 previous_model = glm::mat4(1.0f);
   bool has_previous_model = false;
-  bool initialized = false;
+  // Drawn as an opaque surface this frame; its transform becomes the
+  // previous model once the frame is done.
+  bool drawn = false;
+
+  bool drawable() const { return active && !meshes.empty(); }
 };
 
-struct RenderRuntimeStore {
-  std::unordered_map<EntityID, RenderRuntimeState> entity_states;
+struct RenderProxyMeshRef {
+  uint32_t proxy = 0;
+  uint32_t slot = 0;
+};
+
+struct RenderProxyStats {
+  uint32_t proxies = 0;
+  uint32_t meshes = 0;
+  uint32_t resolved = 0;
+  uint32_t bounds_updated = 0;
+};
+
+// Render proxies for every Renderable entity, in world iteration order, plus
+// per-mesh views rebuilt whenever a proxy is resolved again.
+struct RenderProxyStore {
+  std::vector<RenderProxy> proxies;
+  FlatHashMap<uint64_t, uint32_t> lookup;
+
+  // Drawable meshes in proxy order, with their world bounds.
+  std::vector<RenderProxyMeshRef> meshes;
+  CullBounds mesh_bounds;
+  // Indices into `meshes`: opaque ones by surface sort key and shadow
+  // casters by shadow sort key, so frames emit draws already sorted.
+  std::vector<uint32_t> opaque_order;
+  std::vector<uint32_t> shadow_order;
+  std::vector<EntityID> pick_id_lut;
+
+  const ecs::World *world = nullptr;
+  const RenderTarget *render_target = nullptr;
+  uint64_t world_revision = 0;
+  uint64_t resource_revision = 0;
+  uint32_t change_tick = 0;
+  bool synced = false;
+  RenderProxyStats stats;
 
-  void prune(const ecs::World &world) {
-    std::erase_if(entity_states, [&](const auto &entry) {
-      return !world.contains(entry.first);
-    });
+  void clear() {
+    *this = RenderProxyStore{};
+  }
+
+  void advance_history() {
+    for (auto &proxy : proxies) {
+      if (!proxy.drawn) {
+        continue;
+      }
+
+      proxy.previous_model = proxy.transform;
+      proxy.has_previous_model = true;
+      proxy.drawn = false;
+    }
+  }
+
+  void reset_history() {
+    for (auto &proxy : proxies) {
+      proxy.has_previous_model = false;
+    }
   }
 };
 
+struct RenderRuntimeStore {
+  RenderProxyStore render_proxies;
+  // Shared by the camera and every shadow view of a frame.
+  SceneCuller view_culler;
+};
+
 inline size_t hash_combine(size_t seed, size_t value) {
   return seed ^ (value + 0x9e3779b9 + (seed << 6u) + (seed >> 2u));
 }
@@ -389,4 +520,15 @@ inline uint64_t compute_surface_sort_key(const ResourceDescriptorID &shader_id,
   return static_cast<uint64_t>(seed);
 }
 
+// Every shadow draw goes through the one depth-only pipeline, so only the
+// primitive type can change pipeline state; it takes the top byte and the
+// mesh fills the rest, keeping draws of one vertex array together.
+inline uint64_t compute_shadow_sort_key(const ResolvedMeshDraw &mesh) {
+  const uint64_t pipeline_key = static_cast<uint64_t>(mesh.draw_type) & 0xffu;
+  const uint64_t mesh_key = static_cast<uint64_t>(
+      hash_combine(std::hash<size_t>{}(mesh.mesh_id), mesh.submesh_index)
+  );
+  return (pipeline_key << 56u) | (mesh_key & 0x00ffffffffffffffull);
+}
+
 } // namespace astralix::rendering
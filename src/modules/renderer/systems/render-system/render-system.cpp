@@ -1677,10 +1677,7 @@ void RenderSystem::set_render_graph_config(RenderGraphConfig config) {
 
 void RenderSystem::invalidate_ssgi_history() {
   m_camera_history = {};
-  for (auto &[entity_id, state] : m_render_runtime_store.entity_states) {
-    (void)entity_id;
-    state.has_previous_model = false;
-  }
+  m_render_runtime_store.render_proxies.reset_history();
 }
 
 void RenderSystem::advance_temporal_history(
@@ -1696,11 +1693,7 @@ void RenderSystem::advance_temporal_history(
     m_camera_history = {};
   }
 
-  for (const auto &surface : scene_frame.opaque_surfaces) {
-    auto &state = m_render_runtime_store.entity_states[surface.entity_id];
-    state.previous_model = surface.model;
-    state.has_previous_model = true;
-  }
+  m_render_runtime_store.render_proxies.advance_history();
 }
 
 void RenderSystem::rebuild_render_image_exports() {
@@ -0,0 +1,46 @@
+#include "scene-culling.hpp"
+#include "systems/job-system/parallel.hpp"
+#include "trace.hpp"
+
+namespace astralix::rendering {
+
+namespace {
+
+constexpr size_t k_flat_grain = 16384u;
+
+} // namespace
+
+void SceneCuller::cull(const Frustum &frustum, const CullBounds &bounds,
+                       std::vector<uint8_t> &visible) {
+  cull(std::span<const Frustum>(&frustum, 1u), bounds,
+       std::span<std::vector<uint8_t>>(&visible, 1u));
+}
+
+void SceneCuller::cull(std::span<const Frustum> frusta, const CullBounds &bounds,
+                       std::span<std::vector<uint8_t>> visible) {
+  ASTRA_PROFILE_N("SceneCuller::cull");
+
+  m_stats = {};
+  m_stats.candidates = static_cast<uint32_t>(bounds.size());
+
+  for (size_t view = 0; view < frusta.size(); ++view) {
+    cull_view(frusta[view], bounds, visible[view]);
+  }
+
+  ASTRA_PROFILE_PLOT("Scene cull candidates", static_cast<int64_t>(m_stats.candidates));
+  ASTRA_PROFILE_PLOT("Scene cull visible", static_cast<int64_t>(m_stats.visible));
+}
+
+void SceneCuller::cull_view(const Frustum &frustum, const CullBounds &bounds,
+                            std::vector<uint8_t> &visible) {
+  visible.resize(bounds.size());
+  parallel_for(0u, bounds.size(), k_flat_grain, [&](size_t begin, size_t end) {
+    cull_bounds(frustum, bounds, begin, end, visible.data());
+  });
+
+  for (uint8_t flag : visible) {
+    m_stats.visible += flag;
+  }
+}
+
+} // namespace astralix::rendering
@@ -12,9 +12,12 @@
 #include "render-frame.hpp"
 #include "render-residency.hpp"
 #include "scene-selection.hpp"
+#include "systems/job-system/parallel.hpp"
 #include "targets/render-target.hpp"
+#include "trace.hpp"
 #include <algorithm>
 #include <optional>
+#include <span>
 #include <unordered_map>
 
 namespace astralix::rendering {
@@ -43,8 +46,8 @@ inline const Model *resolve_primary_model(const ModelRef *model_ref) {
   return first_model;
 }
 
-inline void gather_initial_scene_residency_requests(
-    ecs::World &world, const std::optional<SkyboxFrame> &skybox,
+inline void gather_frame_residency_requests(
+    const std::optional<SkyboxFrame> &skybox,
     const std::vector<TextDrawItem> &text_items,
     const std::vector<UIRootDrawList> &ui_roots,
     SceneResidencyRequests &requests
@@ -63,98 +66,72 @@ inline void gather_initial_scene_residency_requests(
       request_ui_command_resources(requests, command);
     }
   }
+}
 
-  world.each<Renderable, scene::Transform, ShaderBinding>(
-      [&](EntityID entity_id, Renderable &, scene::Transform &, ShaderBinding &shader) {
-        if (!world.active(entity_id)) {
-          return;
-        }
-
-        auto entity = world.entity(entity_id);
-        auto *model_ref = entity.get<ModelRef>();
-        auto *mesh_set = entity.get<MeshSet>();
-        if (model_ref == nullptr && mesh_set == nullptr) {
-          return;
-        }
+inline void request_renderable_resources(
+    ecs::World &world, ecs::EntityHandle handle, SceneResidencyRequests &requests
+) {
+  const auto *model_ref = world.get<ModelRef>(handle);
+  if (model_ref == nullptr && !world.has<MeshSet>(handle)) {
+    return;
+  }
 
-        request_shader(requests, shader.shader);
+  request_shader(requests, world.get<ShaderBinding>(handle)->shader);
 
-        if (model_ref != nullptr) {
-          for (const auto &resource_id : model_ref->resource_ids) {
-            request_model(requests, resource_id);
-          }
-        }
+  if (model_ref != nullptr) {
+    for (const auto &resource_id : model_ref->resource_ids) {
+      request_model(requests, resource_id);
+    }
+  }
 
-        if (auto *materials = entity.get<MaterialSlots>();
-            materials != nullptr) {
-          for (const auto &material_id : materials->materials) {
-            request_material(requests, material_id);
-          }
-        }
+  if (const auto *materials = world.get<MaterialSlots>(handle);
+      materials != nullptr) {
+    for (const auto &material_id : materials->materials) {
+      request_material(requests, material_id);
+    }
+  }
 
-        request_texture_bindings(requests, entity.get<TextureBindings>());
-      }
-  );
+  request_texture_bindings(requests, world.get<TextureBindings>(handle));
 }
 
-inline void gather_material_residency_requests(ecs::World &world, SceneResidencyRequests &requests) {
-  world.each<Renderable, scene::Transform, ShaderBinding>(
-      [&](EntityID entity_id, Renderable &, scene::Transform &, ShaderBinding &) {
-        if (!world.active(entity_id)) {
-          return;
-        }
-
-        auto entity = world.entity(entity_id);
-        auto *model_ref = entity.get<ModelRef>();
-        auto *mesh_set = entity.get<MeshSet>();
-        if (model_ref == nullptr && mesh_set == nullptr) {
-          return;
-        }
-
-        if (model_ref != nullptr) {
-          for (const auto &resource_id : model_ref->resource_ids) {
-            auto descriptor =
-                resource_manager()->get_descriptor_by_id<ModelDescriptor>(
-                    resource_id
-                );
-            if (descriptor == nullptr) {
-              continue;
-            }
-
-            for (const auto &material_id : descriptor->material_ids) {
-              request_material_descriptor_textures(requests, material_id);
-            }
-          }
-        }
+// Runs once the models requested by request_renderable_resources are in,
+// since fallback material slots come from the loaded model.
+inline void request_renderable_material_textures(
+    ecs::World &world, ecs::EntityHandle handle, SceneResidencyRequests &requests
+) {
+  const auto *model_ref = world.get<ModelRef>(handle);
+  if (model_ref == nullptr && !world.has<MeshSet>(handle)) {
+    return;
+  }
 
-        const Model *model = resolve_primary_model(model_ref);
-        MaterialSlots fallback_slots;
-        const auto *material_slots = resolve_material_slots(
-            model, entity.get<MaterialSlots>(), fallback_slots
-        );
-        if (material_slots == nullptr) {
-          return;
-        }
+  if (model_ref != nullptr) {
+    for (const auto &resource_id : model_ref->resource_ids) {
+      auto descriptor =
+          resource_manager()->get_descriptor_by_id<ModelDescriptor>(
+              resource_id
+          );
+      if (descriptor == nullptr) {
+        continue;
+      }
 
-        for (const auto &material_id : material_slots->materials) {
-          request_material_descriptor_textures(requests, material_id);
-        }
+      for (const auto &material_id : descriptor->material_ids) {
+        request_material_descriptor_textures(requests, material_id);
       }
-  );
-}
+    }
+  }
 
-inline uint32_t ensure_pick_id(
-    EntityID entity_id, std::vector<EntityID> &pick_id_lut,
-    std::unordered_map<EntityID, uint32_t> &pick_ids_by_entity
-) {
-  auto [it, inserted] =
-      pick_ids_by_entity.emplace(entity_id, static_cast<uint32_t>(0));
-  if (inserted) {
-    pick_id_lut.push_back(entity_id);
-    it->second = static_cast<uint32_t>(pick_id_lut.size());
+  const Model *model = resolve_primary_model(model_ref);
+  MaterialSlots fallback_slots;
+  const auto *material_slots = resolve_material_slots(
+      model, world.get<MaterialSlots>(handle), fallback_slots
+  );
+  if (material_slots == nullptr) {
+    return;
   }
 
-  return it->second;
+  for (const auto &material_id : material_slots->materials) {
+    request_material_descriptor_textures(requests, material_id);
+  }
 }
 
 inline void resolve_ui_resources(SceneFrame &frame) {
@@ -250,14 +227,317 @@ inline void resolve_ui_resources(SceneFrame &frame) {
   }
 }
 
+// Bits of RenderProxy::component_mask.
+inline constexpr uint32_t k_render_proxy_model_ref = 1u << 0u;
+inline constexpr uint32_t k_render_proxy_mesh_set = 1u << 1u;
+inline constexpr uint32_t k_render_proxy_material_slots = 1u << 2u;
+inline constexpr uint32_t k_render_proxy_texture_bindings = 1u << 3u;
+inline constexpr uint32_t k_render_proxy_bloom_settings = 1u << 4u;
+
+inline uint32_t render_proxy_component_mask(const ecs::World &world, ecs::EntityHandle handle) {
+  uint32_t mask = 0u;
+  mask |= world.has<ModelRef>(handle) ? k_render_proxy_model_ref : 0u;
+  mask |= world.has<MeshSet>(handle) ? k_render_proxy_mesh_set : 0u;
+  mask |= world.has<MaterialSlots>(handle) ? k_render_proxy_material_slots : 0u;
+  mask |= world.has<TextureBindings>(handle) ? k_render_proxy_texture_bindings : 0u;
+  mask |= world.has<BloomSettings>(handle) ? k_render_proxy_bloom_settings : 0u;
+  return mask;
+}
+
+inline bool render_proxy_inputs_changed(const ecs::World &world, ecs::EntityHandle handle, uint32_t tick) {
+  return world.changed_since<ShaderBinding>(handle, tick) ||
+         world.changed_since<ModelRef>(handle, tick) ||
+         world.changed_since<MeshSet>(handle, tick) ||
+         world.changed_since<MaterialSlots>(handle, tick) ||
+         world.changed_since<TextureBindings>(handle, tick) ||
+         world.changed_since<BloomSettings>(handle, tick);
+}
+
+// Column-level version of render_proxy_inputs_changed: whether any entity's
+// render components were written since `tick`, without visiting rows.
+inline bool render_proxy_columns_changed(const ecs::World &world, uint32_t tick) {
+  return world.any_changed_since<ShaderBinding>(tick) ||
+         world.any_changed_since<ModelRef>(tick) ||
+         world.any_changed_since<MeshSet>(tick) ||
+         world.any_changed_since<MaterialSlots>(tick) ||
+         world.any_changed_since<TextureBindings>(tick) ||
+         world.any_changed_since<BloomSettings>(tick);
+}
+
+inline void resolve_render_proxy(ecs::World &world, RenderProxy &proxy, Ref<RenderTarget> render_target) {
+  const auto *shader_binding = world.get<ShaderBinding>(proxy.handle);
+  auto *model_ref = world.get<ModelRef>(proxy.handle);
+  auto *mesh_set = world.get<MeshSet>(proxy.handle);
+
+  proxy.meshes.clear();
+  proxy.shader_id = shader_binding->shader;
+  proxy.shader =
+      resource_manager()->get_by_descriptor_id<Shader>(proxy.shader_id);
+  proxy.bloom_settings =
+      resolve_bloom_settings(world.get<BloomSettings>(proxy.handle));
+
+  if (!proxy.active || (model_ref == nullptr && mesh_set == nullptr)) {
+    return;
+  }
+
+  const Model *model = resolve_primary_model(model_ref);
+  const auto *material_slots = world.get<MaterialSlots>(proxy.handle);
+  const auto *texture_bindings = world.get<TextureBindings>(proxy.handle);
+
+  auto resolved_meshes =
+      prepare_render_meshes(model_ref, mesh_set, render_target);
+  proxy.meshes.reserve(resolved_meshes.size());
+  for (auto &mesh : resolved_meshes) {
+    auto material = resolve_material_data(
+        model, material_slots, texture_bindings, mesh.submesh_index
+    );
+    const uint64_t sort_key = compute_surface_sort_key(
+        proxy.shader_id, material.material_id, mesh.mesh_id
+    );
+    const bool alpha_blend = material.alpha_blend;
+    const uint64_t shadow_sort_key = compute_shadow_sort_key(mesh);
+
+    proxy.meshes.push_back(RenderProxyMesh{
+        .mesh = std::move(mesh),
+        .material = SurfaceMaterial(std::move(material)),
+        .sort_key = sort_key,
+        .shadow_sort_key = shadow_sort_key,
+        .alpha_blend = alpha_blend,
+    });
+  }
+}
+
+inline void write_render_proxy_bounds(RenderProxyStore &store, const RenderProxy &proxy) {
+  if (!proxy.drawable()) {
+    return;
+  }
+
+  for (size_t slot = 0; slot < proxy.meshes.size(); ++slot) {
+    store.mesh_bounds.set(
+        proxy.mesh_begin + slot,
+        transform_bounds(proxy.meshes[slot].mesh.local_bounds, proxy.transform)
+    );
+  }
+}
+
+// Lays the drawable meshes of every proxy out for culling and draw emission.
+inline void rebuild_render_proxy_views(RenderProxyStore &store) {
+  store.meshes.clear();
+  store.pick_id_lut.clear();
+  store.lookup.clear();
+
+  for (size_t index = 0; index < store.proxies.size(); ++index) {
+    auto &proxy = store.proxies[index];
+    store.lookup[proxy.entity_id] = static_cast<uint32_t>(index);
+    proxy.mesh_begin = static_cast<uint32_t>(store.meshes.size());
+    proxy.pick_id = 0u;
+    if (!proxy.drawable()) {
+      continue;
+    }
+
+    store.pick_id_lut.push_back(proxy.entity_id);
+    proxy.pick_id = static_cast<uint32_t>(store.pick_id_lut.size());
+
+    for (size_t slot = 0; slot < proxy.meshes.size(); ++slot) {
+      store.meshes.push_back(RenderProxyMeshRef{
+          .proxy = static_cast<uint32_t>(index),
+          .slot = static_cast<uint32_t>(slot),
+      });
+    }
+  }
+
+  store.mesh_bounds.resize(store.meshes.size());
+  parallel_for(0u, store.proxies.size(), 1024u, [&](size_t begin, size_t end) {
+    for (size_t index = begin; index < end; ++index) {
+      write_render_proxy_bounds(store, store.proxies[index]);
+    }
+  });
+  store.stats.bounds_updated = static_cast<uint32_t>(store.meshes.size());
+
+  const auto mesh_at = [&](uint32_t index) -> const RenderProxyMesh & {
+    const auto &ref = store.meshes[index];
+    return store.proxies[ref.proxy].meshes[ref.slot];
+  };
+
+  store.opaque_order.clear();
+  store.shadow_order.clear();
+  for (uint32_t index = 0; index < static_cast<uint32_t>(store.meshes.size()); ++index) {
+    if (!mesh_at(index).alpha_blend) {
+      store.opaque_order.push_back(index);
+    }
+    if (store.proxies[store.meshes[index].proxy].casts_shadow) {
+      store.shadow_order.push_back(index);
+    }
+  }
+
+  std::stable_sort(
+      store.opaque_order.begin(), store.opaque_order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return mesh_at(lhs).sort_key < mesh_at(rhs).sort_key;
+      }
+  );
+  std::stable_sort(
+      store.shadow_order.begin(), store.shadow_order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return mesh_at(lhs).shadow_sort_key < mesh_at(rhs).shadow_sort_key;
+      }
+  );
+}
+
+// Brings the proxy store up to date with the world. While neither the world's
+// structure (World::revision) nor any render component column has changed
+// and `resources_changed` is false, this only copies transforms and
+// re-bounds the meshes that moved. Otherwise every renderable is checked
+// against its proxy, and `resolve` is handed the indices of the proxies
+// whose render components changed, or of all of them after a resource
+// change.
+template <typename ResolveFn>
+inline void sync_render_proxy_store(ecs::World &world, RenderProxyStore &store,
+                                    bool resources_changed, ResolveFn &&resolve) {
+  store.stats.resolved = 0u;
+  store.stats.bounds_updated = 0u;
+
+  resources_changed = resources_changed || !store.synced;
+  const bool world_changed =
+      !store.synced || store.world_revision != world.revision();
+
+  if (!world_changed && !resources_changed &&
+      !render_proxy_columns_changed(world, store.change_tick)) {
+    size_t cursor = 0;
+    world.each<const Renderable, const scene::Transform, const ShaderBinding>(
+        [&](EntityID entity_id, const Renderable &, const scene::Transform &transform, const ShaderBinding &) {
+          RenderProxy *proxy = nullptr;
+          if (cursor < store.proxies.size() &&
+              store.proxies[cursor].entity_id == entity_id) {
+            proxy = &store.proxies[cursor++];
+          } else if (auto it = store.lookup.find(entity_id);
+                     it != store.lookup.end()) {
+            cursor = it->second + 1u;
+            proxy = &store.proxies[it->second];
+          }
+
+          if (proxy == nullptr || proxy->transform == transform.matrix) {
+            return;
+          }
+
+          proxy->transform = transform.matrix;
+          write_render_proxy_bounds(store, *proxy);
+          store.stats.bounds_updated += static_cast<uint32_t>(proxy->meshes.size());
+        }
+    );
+    return;
+  }
+
+  const bool use_shadow_caster_tags = world.count<ShadowCaster>() > 0u;
+  std::vector<RenderProxy> previous = std::move(store.proxies);
+  store.proxies.clear();
+  store.proxies.reserve(previous.size());
+  std::vector<uint32_t> stale;
+
+  size_t cursor = 0;
+  world.each<const Renderable, const scene::Transform, const ShaderBinding>(
+      [&](EntityID entity_id, const Renderable &, const scene::Transform &transform, const ShaderBinding &) {
+        RenderProxy proxy;
+        bool found = false;
+        if (cursor < previous.size() && previous[cursor].entity_id == entity_id) {
+          proxy = std::move(previous[cursor++]);
+          found = true;
+        } else if (auto it = store.lookup.find(entity_id);
+                   it != store.lookup.end()) {
+          cursor = it->second + 1u;
+          proxy = std::move(previous[it->second]);
+          found = true;
+        }
+
+        const ecs::EntityHandle handle = world.handle(entity_id);
+        const uint32_t component_mask = render_proxy_component_mask(world, handle);
+        const bool active = world.active(handle);
+        if (!found || resources_changed || proxy.handle != handle ||
+            proxy.component_mask != component_mask || proxy.active != active ||
+            render_proxy_inputs_changed(world, handle, store.change_tick)) {
+          stale.push_back(static_cast<uint32_t>(store.proxies.size()));
+        }
+
+        proxy.entity_id = entity_id;
+        proxy.handle = handle;
+        proxy.component_mask = component_mask;
+        proxy.active = active;
+        proxy.casts_shadow =
+            !use_shadow_caster_tags || world.has<ShadowCaster>(handle);
+        proxy.transform = transform.matrix;
+        store.proxies.push_back(std::move(proxy));
+      }
+  );
+
+  if (!stale.empty()) {
+    resolve(std::span<const uint32_t>(stale));
+  }
+
+  rebuild_render_proxy_views(store);
+
+  store.stats.proxies = static_cast<uint32_t>(store.proxies.size());
+  store.stats.meshes = static_cast<uint32_t>(store.meshes.size());
+  store.stats.resolved = static_cast<uint32_t>(stale.size());
+  store.change_tick = world.advance_change_tick();
+  store.world_revision = world.revision();
+  store.synced = true;
+}
+
+// Resolves the listed proxies against the resource manager, loading what
+// they need first.
+inline void resolve_render_proxies(ecs::World &world, Ref<RenderTarget> render_target,
+                                   RenderProxyStore &store, std::span<const uint32_t> stale) {
+  SceneResidencyRequests requests;
+  for (uint32_t index : stale) {
+    if (store.proxies[index].active) {
+      request_renderable_resources(world, store.proxies[index].handle, requests);
+    }
+  }
+  resolve_scene_residency_async(requests, render_target);
+
+  SceneResidencyRequests material_requests;
+  for (uint32_t index : stale) {
+    if (store.proxies[index].active) {
+      request_renderable_material_textures(
+          world, store.proxies[index].handle, material_requests
+      );
+    }
+  }
+  resolve_scene_residency_async(material_requests, render_target);
+
+  for (uint32_t index : stale) {
+    resolve_render_proxy(world, store.proxies[index], render_target);
+  }
+}
+
+inline void sync_render_proxies(ecs::World &world, Ref<RenderTarget> render_target, RenderProxyStore &store) {
+  ASTRA_PROFILE_N("sync_render_proxies");
+
+  auto manager = resource_manager();
+  if (store.world != &world || store.render_target != render_target.get()) {
+    store.clear();
+    store.world = &world;
+    store.render_target = render_target.get();
+  }
+
+  sync_render_proxy_store(
+      world, store, store.resource_revision != manager->revision(),
+      [&](std::span<const uint32_t> stale) {
+        resolve_render_proxies(world, render_target, store, stale);
+      }
+  );
+
+  // Read after resolving: registrations made by this sync's own requests
+  // are already reflected in the proxies.
+  store.resource_revision = manager->revision();
+
+  ASTRA_PROFILE_PLOT("Render proxies resolved", static_cast<int64_t>(store.stats.resolved));
+}
+
 inline SceneFrame build_scene_frame(
     ecs::World &world,
     Ref<RenderTarget> render_target,
     RenderRuntimeStore &render_runtime_store,
     const CameraHistoryState &camera_history = {}
 ) {
-  render_runtime_store.prune(world);
-
   SceneFrame frame;
   frame.main_camera = extract_main_camera_frame(world);
   if (frame.main_camera.has_value()) {
@@ -286,15 +566,10 @@ inline SceneFrame build_scene_frame(
     return frame;
   }
 
-  SceneResidencyRequests initial_requests;
-  gather_initial_scene_residency_requests(world, frame.skybox, frame.text_items, frame.ui_roots, initial_requests);
-  resolve_scene_residency_async(initial_requests, render_target);
-
-  SceneResidencyRequests material_requests;
-  gather_material_residency_requests(world, material_requests);
-  resolve_scene_residency_async(material_requests, render_target);
-
-  prepare_requested_font_glyphs(initial_requests);
+  SceneResidencyRequests frame_requests;
+  gather_frame_residency_requests(frame.skybox, frame.text_items, frame.ui_roots, frame_requests);
+  resolve_scene_residency_async(frame_requests, render_target);
+  prepare_requested_font_glyphs(frame_requests);
 
   if (frame.skybox.has_value()) {
     frame.skybox->shader =
@@ -319,109 +594,105 @@ inline SceneFrame build_scene_frame(
     );
   }
 
-  std::unordered_map<EntityID, uint32_t> pick_ids_by_entity;
-  const bool use_shadow_caster_tags = world.count<ShadowCaster>() > 0u;
+  auto &proxies = render_runtime_store.render_proxies;
+  sync_render_proxies(world, render_target, proxies);
+  frame.pick_id_lut = proxies.pick_id_lut;
 
-  world.each<Renderable, scene::Transform, ShaderBinding>(
-      [&](EntityID entity_id, Renderable &, scene::Transform &transform, ShaderBinding &shader_binding) {
-        if (!world.active(entity_id)) {
-          return;
-        }
+  // Every view of the frame culls the same synced set: the camera first
+  // when there is one, then the shadow views of the directional light.
+  const auto &directional = frame.light_frame.directional;
+  std::vector<Frustum> view_frusta;
+  if (camera_frustum.has_value()) {
+    view_frusta.push_back(*camera_frustum);
+  }
 
-        auto entity = world.entity(entity_id);
-        auto *model_ref = entity.get<ModelRef>();
-        auto *mesh_set = entity.get<MeshSet>();
-        if (model_ref == nullptr && mesh_set == nullptr) {
-          return;
-        }
+  const size_t shadow_view_begin = view_frusta.size();
+  if (directional.valid && directional.cascades_valid) {
+    for (const auto &cascade_matrix : directional.cascade_matrices) {
+      view_frusta.push_back(extract_shadow_caster_frustum(cascade_matrix));
+    }
+  } else if (directional.valid) {
+    view_frusta.push_back(
+        extract_shadow_caster_frustum(directional.light_space_matrix)
+    );
+  }
 
-        auto resolved_meshes =
-            prepare_render_meshes(model_ref, mesh_set, render_target);
-        if (resolved_meshes.empty()) {
-          return;
-        }
+  std::vector<std::vector<uint8_t>> visible_to_view(view_frusta.size());
+  if (!view_frusta.empty()) {
+    render_runtime_store.view_culler.cull(
+        view_frusta, proxies.mesh_bounds, visible_to_view
+    );
+  }
 
-        const uint32_t pick_id = ensure_pick_id(
-            entity_id, frame.pick_id_lut, pick_ids_by_entity
-        );
-        const bool casts_shadow =
-            !use_shadow_caster_tags || entity.get<ShadowCaster>() != nullptr;
-
-        const Model *model = resolve_primary_model(model_ref);
-        const auto bloom_settings =
-            resolve_bloom_settings(entity.get<BloomSettings>());
-        const auto shader =
-            resource_manager()->get_by_descriptor_id<Shader>(
-                shader_binding.shader
-            );
+  // Meshes are visited in the store's presorted orders, so every list comes
+  // out sorted without sorting per frame.
+  for (size_t view = shadow_view_begin; view < view_frusta.size(); ++view) {
+    const auto &visible_to_light = visible_to_view[view];
+    auto &shadow_draws = directional.cascades_valid
+                             ? frame.cascade_shadow_draws[view - shadow_view_begin]
+                             : frame.shadow_draws;
 
-        for (const auto &mesh : resolved_meshes) {
-          const bool visible_to_camera =
-              !camera_frustum.has_value() ||
-              is_aabb_visible(*camera_frustum, mesh.local_bounds, transform.matrix);
-
-          if (casts_shadow) {
-            frame.shadow_draws.push_back(ShadowDrawItem{
-                .entity_id = entity_id,
-                .model = transform.matrix,
-                .mesh = mesh,
-                .sort_key = 0,
-            });
-          }
+    for (uint32_t index : proxies.shadow_order) {
+      if (visible_to_light[index] == 0u) {
+        continue;
+      }
 
-          if (!visible_to_camera) {
-            continue;
-          }
+      const auto &ref = proxies.meshes[index];
+      const auto &proxy = proxies.proxies[ref.proxy];
+      const auto &proxy_mesh = proxy.meshes[ref.slot];
+      shadow_draws.push_back(ShadowDrawItem{
+          .entity_id = proxy.entity_id,
+          .model = proxy.transform,
+          .mesh = proxy_mesh.mesh,
+          .sort_key = proxy_mesh.shadow_sort_key,
+      });
+    }
+  }
 
-          const auto material = resolve_material_data(
-              model,
-              entity.get<MaterialSlots>(),
-              entity.get<TextureBindings>(),
-              mesh.submesh_index
-          );
-          const uint64_t sort_key = compute_surface_sort_key(
-              shader_binding.shader, material.material_id, mesh.mesh_id
-          );
-          auto &runtime_state = render_runtime_store.entity_states[entity_id];
-          const bool has_previous_model = runtime_state.has_previous_model;
-          const glm::mat4 previous_model =
-              has_previous_model ? runtime_state.previous_model
-                                 : transform.matrix;
-          runtime_state.surface_sort_key = sort_key;
-          runtime_state.initialized = true;
-
-          auto &target_list = material.alpha_blend
-                                   ? frame.blend_surfaces
-                                   : frame.opaque_surfaces;
-          target_list.push_back(SurfaceDrawItem{
-              .entity_id = entity_id,
-              .pick_id = pick_id,
-              .shader_id = shader_binding.shader,
-              .shader = shader,
-              .material = material,
-              .mesh = mesh,
-              .model = transform.matrix,
-              .previous_model = previous_model,
-              .has_previous_model = has_previous_model,
-              .bloom_enabled = bloom_settings.enabled,
-              .bloom_layer = bloom_settings.render_layer,
-              .casts_shadow = casts_shadow,
-              .sort_key = sort_key,
-          });
-        }
-      }
-  );
+  const uint8_t *visible_to_camera =
+      camera_frustum.has_value() ? visible_to_view.front().data() : nullptr;
+  const auto make_surface = [&](uint32_t index) {
+    const auto &ref = proxies.meshes[index];
+    auto &proxy = proxies.proxies[ref.proxy];
+    const auto &proxy_mesh = proxy.meshes[ref.slot];
+    return SurfaceDrawItem{
+        .entity_id = proxy.entity_id,
+        .pick_id = proxy.pick_id,
+        .shader_id = proxy.shader_id,
+        .shader = proxy.shader,
+        .material = proxy_mesh.material,
+        .mesh = proxy_mesh.mesh,
+        .model = proxy.transform,
+        .previous_model = proxy.has_previous_model ? proxy.previous_model
+                                                   : proxy.transform,
+        .has_previous_model = proxy.has_previous_model,
+        .bloom_enabled = proxy.bloom_settings.enabled,
+        .bloom_layer = proxy.bloom_settings.render_layer,
+        .casts_shadow = proxy.casts_shadow,
+        .sort_key = proxy_mesh.sort_key,
+    };
+  };
+
+  frame.opaque_surfaces.reserve(proxies.opaque_order.size());
+  for (uint32_t index : proxies.opaque_order) {
+    if (visible_to_camera != nullptr && visible_to_camera[index] == 0u) {
+      continue;
+    }
 
-  std::stable_sort(
-      frame.opaque_surfaces.begin(), frame.opaque_surfaces.end(), [](const SurfaceDrawItem &lhs, const SurfaceDrawItem &rhs) {
-        return lhs.sort_key < rhs.sort_key;
-      }
-  );
-  std::stable_sort(
-      frame.shadow_draws.begin(), frame.shadow_draws.end(), [](const ShadowDrawItem &lhs, const ShadowDrawItem &rhs) {
-        return lhs.sort_key < rhs.sort_key;
-      }
-  );
+    frame.opaque_surfaces.push_back(make_surface(index));
+    proxies.proxies[proxies.meshes[index].proxy].drawn = true;
+  }
+
+  const auto mesh_count = static_cast<uint32_t>(proxies.meshes.size());
+  for (uint32_t index = 0; index < mesh_count; ++index) {
+    const auto &ref = proxies.meshes[index];
+    if (!proxies.proxies[ref.proxy].meshes[ref.slot].alpha_blend ||
+        (visible_to_camera != nullptr && visible_to_camera[index] == 0u)) {
+      continue;
+    }
+
+    frame.blend_surfaces.push_back(make_surface(index));
+  }
 
   return frame;
 }
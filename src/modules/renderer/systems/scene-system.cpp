@@ -87,8 +87,8 @@ void SceneSystem::update(double dt) {
 
   {
     ASTRA_PROFILE_N("SceneSystem::recalculate_cameras");
-    world.each<scene::Transform, rendering::Camera>(
-      [&](EntityID, scene::Transform &transform, rendering::Camera &camera) {
+    world.each<const scene::Transform, rendering::Camera>(
+      [&](EntityID, const scene::Transform &transform, rendering::Camera &camera) {
         scene::recalculate_camera_view_matrix(camera, transform, aspect_ratio);
 
         if (camera.orthographic) {
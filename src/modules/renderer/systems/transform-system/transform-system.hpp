@@ -25,9 +25,18 @@ inline void recalculate_transform(scene::Transform &transform) {
   transform.dirty = false;
 }
 
+// Rebuilding a dirty matrix also stamps the Transform change tick, which is
+// what change-filtered queries downstream (physics, extraction) observe. The
+// callback reports the rows it rebuilt, so clean transforms keep their tick.
 inline void update_transforms(ecs::World &world) {
-  world.each<scene::Transform>(
-      [](EntityID, scene::Transform &transform) { recalculate_transform(transform); });
+  world.par_each<scene::Transform>([](EntityID, scene::Transform &transform) {
+    if (!transform.dirty) {
+      return false;
+    }
+
+    recalculate_transform(transform);
+    return true;
+  });
 }
 
 } // namespace astralix::scene
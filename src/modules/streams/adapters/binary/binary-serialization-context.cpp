@@ -0,0 +1,612 @@
+#include "adapters/binary/binary-serialization-context.hpp"
+#include "arena.hpp"
+#include "assert.hpp"
+#include "base.hpp"
+#include "context-proxy.hpp"
+#include "stream-buffer.hpp"
+
+#include <any>
+#include <bit>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace astralix {
+
+namespace {
+
+using Node = binary_detail::Node;
+using NodeKind = binary_detail::NodeKind;
+using Document = binary_detail::Document;
+
+constexpr char k_magic[4] = {'A', 'X', 'S', 'B'};
+
+enum class Tag : uint8_t {
+  Null = 0,
+  String = 1,
+  Int = 2,
+  Float = 3,
+  False = 4,
+  True = 5,
+  Object = 6,
+  Array = 7,
+};
+
+void reset_node(Node &node, NodeKind kind) {
+  node.kind = kind;
+  node.string_value.clear();
+  node.int_value = 0;
+  node.float_value = 0.0f;
+  node.bool_value = false;
+  node.object_items.clear();
+  node.array_items.clear();
+}
+
+// Copies `source` (owned by `source_document`) into `target`, re-interning
+// object keys.
+Node clone_node(const Document &source_document, const Node &source, Document &target) {
+  Node clone;
+  clone.kind = source.kind;
+  clone.int_value = source.int_value;
+  clone.float_value = source.float_value;
+  clone.bool_value = source.bool_value;
+  clone.string_value = source.string_value;
+
+  clone.object_items.reserve(source.object_items.size());
+  for (const auto &[key, value] : source.object_items) {
+    const uint32_t target_key = target.intern(source_document.keys[key]);
+    auto &child = target.make_node();
+    child = clone_node(source_document, *value, target);
+    clone.object_items.emplace_back(target_key, &child);
+  }
+
+  clone.array_items.reserve(source.array_items.size());
+  for (const auto *item : source.array_items) {
+    auto &child = target.make_node();
+    child = clone_node(source_document, *item, target);
+    clone.array_items.push_back(&child);
+  }
+
+  return clone;
+}
+
+Node *find_object_child(Node &node, uint32_t key) {
+  for (auto &[entry_key, value] : node.object_items) {
+    if (entry_key == key) {
+      return value;
+    }
+  }
+
+  return nullptr;
+}
+
+Node &ensure_object_child(Document &document, Node &node, const std::string &key) {
+  if (node.kind == NodeKind::Null) {
+    reset_node(node, NodeKind::Object);
+  }
+
+  ASTRA_ENSURE(node.kind != NodeKind::Object, "Binary node is not an object for string indexing");
+
+  const uint32_t key_id = document.intern(key);
+  if (auto *existing = find_object_child(node, key_id)) {
+    return *existing;
+  }
+
+  auto &child = document.make_node();
+  node.object_items.emplace_back(key_id, &child);
+  return child;
+}
+
+Node &ensure_array_child(Document &document, Node &node, int index) {
+  ASTRA_ENSURE(index < 0, "Binary array index cannot be negative");
+
+  if (node.kind == NodeKind::Null) {
+    reset_node(node, NodeKind::Array);
+  }
+
+  ASTRA_ENSURE(node.kind != NodeKind::Array, "Binary node is not an array for integer indexing");
+
+  while (static_cast<int>(node.array_items.size()) <= index) {
+    node.array_items.push_back(&document.make_node());
+  }
+
+  return *node.array_items[static_cast<size_t>(index)];
+}
+
+std::string convert_key_to_string(const SerializableKey &key) {
+  return std::visit(
+      [](auto &&value) -> std::string {
+        using T = std::decay_t<decltype(value)>;
+
+        if constexpr (std::is_same_v<T, std::string>) {
+          return value;
+        } else if constexpr (std::is_same_v<T, bool>) {
+          return value ? "true" : "false";
+        } else {
+          return std::to_string(value);
+        }
+      },
+      key
+  );
+}
+
+std::string format_float(float value) {
+  std::ostringstream stream;
+  stream << std::setprecision(std::numeric_limits<float>::max_digits10) << value;
+  return stream.str();
+}
+
+int parse_string_to_int(std::string_view value) {
+  int parsed = 0;
+  const auto result = std::from_chars(value.data(), value.data() + value.size(), parsed);
+  return result.ec == std::errc{} && result.ptr == value.data() + value.size() ? parsed : 0;
+}
+
+float parse_string_to_float(std::string_view value) {
+  if (value.empty()) {
+    return 0.0f;
+  }
+
+  const std::string text(value);
+  char *end = nullptr;
+  const float parsed = std::strtof(text.c_str(), &end);
+  return end == text.c_str() + text.size() ? parsed : 0.0f;
+}
+
+class BinaryWriter {
+public:
+  explicit BinaryWriter(const Document &document) : m_document(document) {}
+
+  std::string write() {
+    m_output.append(k_magic, sizeof(k_magic));
+    m_output.push_back(static_cast<char>(BinarySerializationContext::k_version));
+
+    write_varint(m_document.keys.size());
+    for (const auto &key : m_document.keys) {
+      write_string(key);
+    }
+
+    write_node(*m_document.root);
+    return std::move(m_output);
+  }
+
+private:
+  void write_varint(uint64_t value) {
+    while (value >= 0x80u) {
+      m_output.push_back(static_cast<char>((value & 0x7fu) | 0x80u));
+      value >>= 7u;
+    }
+
+    m_output.push_back(static_cast<char>(value));
+  }
+
+  void write_string(std::string_view value) {
+    write_varint(value.size());
+    m_output.append(value.data(), value.size());
+  }
+
+  void write_tag(Tag tag) { m_output.push_back(static_cast<char>(tag)); }
+
+  void write_node(const Node &node) {
+    switch (node.kind) {
+      case NodeKind::Null:
+        write_tag(Tag::Null);
+        break;
+      case NodeKind::String:
+        write_tag(Tag::String);
+        write_string(node.string_value);
+        break;
+      case NodeKind::Int: {
+        write_tag(Tag::Int);
+        const auto value = static_cast<uint32_t>(node.int_value);
+        write_varint((value << 1u) ^ static_cast<uint32_t>(node.int_value >> 31));
+        break;
+      }
+      case NodeKind::Float: {
+        write_tag(Tag::Float);
+        const auto bits = std::bit_cast<uint32_t>(node.float_value);
+        for (uint32_t shift = 0u; shift < 32u; shift += 8u) {
+          m_output.push_back(static_cast<char>((bits >> shift) & 0xffu));
+        }
+        break;
+      }
+      case NodeKind::Bool:
+        write_tag(node.bool_value ? Tag::True : Tag::False);
+        break;
+      case NodeKind::Object:
+        write_tag(Tag::Object);
+        write_varint(node.object_items.size());
+        for (const auto &[key, value] : node.object_items) {
+          write_varint(key);
+          write_node(*value);
+        }
+        break;
+      case NodeKind::Array:
+        write_tag(Tag::Array);
+        write_varint(node.array_items.size());
+        for (const auto *item : node.array_items) {
+          write_node(*item);
+        }
+        break;
+    }
+  }
+
+  const Document &m_document;
+  std::string m_output;
+};
+
+class BinaryParser {
+public:
+  BinaryParser(std::string_view input, Document &document)
+      : m_input(input), m_document(document) {}
+
+  void parse_document() {
+    ASTRA_ENSURE(m_input.size() < sizeof(k_magic) + 1u || std::memcmp(m_input.data(), k_magic, sizeof(k_magic)) != 0, "Binary serialization buffer has no AXSB header");
+    m_position = sizeof(k_magic);
+
+    const auto version = static_cast<uint8_t>(m_input[m_position++]);
+    ASTRA_ENSURE(version != BinarySerializationContext::k_version, "Unsupported binary serialization version: ", static_cast<int>(version));
+
+    const uint64_t key_count = read_count();
+    m_document.keys.reserve(key_count);
+    for (uint64_t index = 0; index < key_count; ++index) {
+      m_document.intern(std::string(read_string()));
+    }
+
+    parse_node(*m_document.root);
+    ASTRA_ENSURE(m_position != m_input.size(), "Unexpected trailing binary content at position ", m_position);
+  }
+
+private:
+  uint64_t read_varint() {
+    uint64_t value = 0u;
+    for (uint32_t shift = 0u; shift < 64u; shift += 7u) {
+      ASTRA_ENSURE(m_position >= m_input.size(), "Unexpected end of binary input at position ", m_position);
+
+      const auto byte = static_cast<uint8_t>(m_input[m_position++]);
+      value |= static_cast<uint64_t>(byte & 0x7fu) << shift;
+      if ((byte & 0x80u) == 0u) {
+        return value;
+      }
+    }
+
+    ASTRA_EXCEPTION("Malformed binary varint at position ", m_position);
+  }
+
+  // Every counted item takes at least one byte, which bounds reservations
+  // on corrupt input.
+  uint64_t read_count() {
+    const uint64_t count = read_varint();
+    ASTRA_ENSURE(count > m_input.size() - m_position, "Binary count exceeds input at position ", m_position);
+    return count;
+  }
+
+  std::string_view read_string() {
+    const uint64_t length = read_varint();
+    ASTRA_ENSURE(length > m_input.size() - m_position, "Binary string exceeds input at position ", m_position);
+
+    const auto value = m_input.substr(m_position, static_cast<size_t>(length));
+    m_position += static_cast<size_t>(length);
+    return value;
+  }
+
+  void parse_node(Node &node) {
+    ASTRA_ENSURE(m_position >= m_input.size(), "Unexpected end of binary input at position ", m_position);
+
+    const auto tag = static_cast<Tag>(m_input[m_position++]);
+    switch (tag) {
+      case Tag::Null:
+        node.kind = NodeKind::Null;
+        return;
+      case Tag::String:
+        node.kind = NodeKind::String;
+        node.string_value = read_string();
+        return;
+      case Tag::Int: {
+        node.kind = NodeKind::Int;
+        const auto encoded = static_cast<uint32_t>(read_varint());
+        node.int_value = static_cast<int>((encoded >> 1u) ^ (0u - (encoded & 1u)));
+        return;
+      }
+      case Tag::Float: {
+        ASTRA_ENSURE(m_input.size() - m_position < 4u, "Unexpected end of binary float at position ", m_position);
+
+        uint32_t bits = 0u;
+        for (uint32_t byte = 0u; byte < 4u; ++byte) {
+          bits |= static_cast<uint32_t>(static_cast<uint8_t>(m_input[m_position++])) << (byte * 8u);
+        }
+
+        node.kind = NodeKind::Float;
+        node.float_value = std::bit_cast<float>(bits);
+        return;
+      }
+      case Tag::False:
+      case Tag::True:
+        node.kind = NodeKind::Bool;
+        node.bool_value = tag == Tag::True;
+        return;
+      case Tag::Object: {
+        node.kind = NodeKind::Object;
+        const uint64_t count = read_count();
+        node.object_items.reserve(count);
+        for (uint64_t index = 0; index < count; ++index) {
+          const uint64_t key = read_varint();
+          ASTRA_ENSURE(key >= m_document.keys.size(), "Binary object key index out of range at position ", m_position);
+
+          auto &child = m_document.make_node();
+          node.object_items.emplace_back(static_cast<uint32_t>(key), &child);
+          parse_node(child);
+        }
+        return;
+      }
+      case Tag::Array: {
+        node.kind = NodeKind::Array;
+        const uint64_t count = read_count();
+        node.array_items.reserve(count);
+        for (uint64_t index = 0; index < count; ++index) {
+          auto &child = m_document.make_node();
+          node.array_items.push_back(&child);
+          parse_node(child);
+        }
+        return;
+      }
+    }
+
+    ASTRA_EXCEPTION("Unknown binary value tag at position ", m_position - 1);
+  }
+
+  std::string_view m_input;
+  size_t m_position = 0;
+  Document &m_document;
+};
+
+} // namespace
+
+BinarySerializationContext::BinarySerializationContext()
+    : m_document(std::make_shared<Document>()), m_current(m_document->root) {}
+
+BinarySerializationContext::BinarySerializationContext(Scope<StreamBuffer> buffer)
+    : BinarySerializationContext() {
+  from_buffer(std::move(buffer));
+}
+
+BinarySerializationContext::BinarySerializationContext(std::shared_ptr<Document> document, Node *current)
+    : m_document(std::move(document)), m_current(current) {}
+
+size_t BinarySerializationContext::node_size(const Node *node) {
+  if (node == nullptr) {
+    return 0;
+  }
+
+  switch (node->kind) {
+    case NodeKind::Object:
+      return node->object_items.size();
+    case NodeKind::Array:
+      return node->array_items.size();
+    default:
+      return 0;
+  }
+}
+
+size_t BinarySerializationContext::root_size() { return node_size(m_document->root); }
+
+size_t BinarySerializationContext::size() { return node_size(m_current); }
+
+ContextProxy
+BinarySerializationContext::operator[](const SerializableKey &key) {
+  if (std::holds_alternative<int>(key)) {
+    const int index = std::get<int>(key);
+    auto *child = &ensure_array_child(*m_document, *m_current, index);
+
+    return ContextProxy(
+        Scope<SerializationContext>(new BinarySerializationContext(m_document, child)),
+        std::to_string(index)
+    );
+  }
+
+  const auto str_key = convert_key_to_string(key);
+  auto *child = &ensure_object_child(*m_document, *m_current, str_key);
+
+  return ContextProxy(
+      Scope<SerializationContext>(new BinarySerializationContext(m_document, child)),
+      str_key
+  );
+}
+
+void BinarySerializationContext::set_value(const SerializableValue &value) {
+  ASTRA_ENSURE(m_current == nullptr, "Binary context has no current node");
+
+  if (std::holds_alternative<int>(value)) {
+    reset_node(*m_current, NodeKind::Int);
+    m_current->int_value = std::get<int>(value);
+  } else if (std::holds_alternative<float>(value)) {
+    reset_node(*m_current, NodeKind::Float);
+    m_current->float_value = std::get<float>(value);
+  } else if (std::holds_alternative<std::string>(value)) {
+    reset_node(*m_current, NodeKind::String);
+    m_current->string_value = std::get<std::string>(value);
+  } else if (std::holds_alternative<bool>(value)) {
+    reset_node(*m_current, NodeKind::Bool);
+    m_current->bool_value = std::get<bool>(value);
+  }
+}
+
+void BinarySerializationContext::set_value(Ref<SerializationContext> ctx) {
+  auto binary_ctx = static_cast<BinarySerializationContext *>(ctx.get());
+  ASTRA_ENSURE(binary_ctx == nullptr || binary_ctx->m_document == nullptr, "Invalid binary serialization context");
+
+  *m_current = clone_node(*binary_ctx->m_document, *binary_ctx->m_document->root, *m_document);
+}
+
+ElasticArena::Block *BinarySerializationContext::to_buffer(ElasticArena &arena) {
+  const std::string encoded = BinaryWriter(*m_document).write();
+
+  auto block = arena.allocate(encoded.size());
+  std::memcpy(block->data, encoded.data(), encoded.size());
+  return block;
+}
+
+void BinarySerializationContext::from_buffer(Scope<StreamBuffer> buffer) {
+  Document parsed;
+  BinaryParser(std::string_view(buffer->data(), buffer->size()), parsed)
+      .parse_document();
+
+  *m_document = std::move(parsed);
+  m_current = m_document->root;
+}
+
+std::string BinarySerializationContext::as_string() {
+  ASTRA_ENSURE(m_current == nullptr, "Binary context has no current node");
+
+  switch (m_current->kind) {
+    case NodeKind::String:
+      return m_current->string_value;
+    case NodeKind::Int:
+      return std::to_string(m_current->int_value);
+    case NodeKind::Float:
+      return format_float(m_current->float_value);
+    case NodeKind::Bool:
+      return m_current->bool_value ? "true" : "false";
+    default:
+      return "";
+  }
+}
+
+int BinarySerializationContext::as_int() {
+  ASTRA_ENSURE(m_current == nullptr, "Binary context has no current node");
+
+  switch (m_current->kind) {
+    case NodeKind::Int:
+      return m_current->int_value;
+    case NodeKind::Float:
+      return static_cast<int>(m_current->float_value);
+    case NodeKind::Bool:
+      return m_current->bool_value ? 1 : 0;
+    case NodeKind::String:
+      return parse_string_to_int(m_current->string_value);
+    default:
+      return 0;
+  }
+}
+
+float BinarySerializationContext::as_float() {
+  ASTRA_ENSURE(m_current == nullptr, "Binary context has no current node");
+
+  switch (m_current->kind) {
+    case NodeKind::Float:
+      return m_current->float_value;
+    case NodeKind::Int:
+      return static_cast<float>(m_current->int_value);
+    case NodeKind::Bool:
+      return m_current->bool_value ? 1.0f : 0.0f;
+    case NodeKind::String:
+      return parse_string_to_float(m_current->string_value);
+    default:
+      return 0.0f;
+  }
+}
+
+bool BinarySerializationContext::as_bool() {
+  ASTRA_ENSURE(m_current == nullptr, "Binary context has no current node");
+
+  switch (m_current->kind) {
+    case NodeKind::Bool:
+      return m_current->bool_value;
+    case NodeKind::Int:
+      return m_current->int_value != 0;
+    case NodeKind::Float:
+      return m_current->float_value != 0.0f;
+    case NodeKind::String:
+      return m_current->string_value == "true";
+    default:
+      return false;
+  }
+}
+
+std::vector<std::any> BinarySerializationContext::as_array() {
+  std::vector<std::any> items;
+
+  if (m_current == nullptr || m_current->kind != NodeKind::Array) {
+    return items;
+  }
+
+  items.reserve(m_current->array_items.size());
+  for (auto *item : m_current->array_items) {
+    items.push_back(item);
+  }
+
+  return items;
+}
+
+std::vector<std::string> BinarySerializationContext::object_keys() {
+  std::vector<std::string> keys;
+
+  if (m_current == nullptr || m_current->kind != NodeKind::Object) {
+    return keys;
+  }
+
+  keys.reserve(m_current->object_items.size());
+  for (const auto &[key, value] : m_current->object_items) {
+    keys.push_back(m_document->keys[key]);
+  }
+
+  return keys;
+}
+
+SerializationTypeKind BinarySerializationContext::kind() {
+  if (m_current == nullptr) {
+    return SerializationTypeKind::Unknown;
+  }
+
+  switch (m_current->kind) {
+    case NodeKind::String:
+      return SerializationTypeKind::String;
+    case NodeKind::Int:
+      return SerializationTypeKind::Int;
+    case NodeKind::Float:
+      return SerializationTypeKind::Float;
+    case NodeKind::Bool:
+      return SerializationTypeKind::Bool;
+    case NodeKind::Object:
+      return SerializationTypeKind::Object;
+    case NodeKind::Array:
+      return SerializationTypeKind::Array;
+    case NodeKind::Null:
+    default:
+      return SerializationTypeKind::Unknown;
+  }
+}
+
+bool BinarySerializationContext::is_string() {
+  return m_current != nullptr && m_current->kind == NodeKind::String;
+}
+
+bool BinarySerializationContext::is_int() {
+  return m_current != nullptr && m_current->kind == NodeKind::Int;
+}
+
+bool BinarySerializationContext::is_float() {
+  return m_current != nullptr && m_current->kind == NodeKind::Float;
+}
+
+bool BinarySerializationContext::is_bool() {
+  return m_current != nullptr && m_current->kind == NodeKind::Bool;
+}
+
+bool BinarySerializationContext::is_array() {
+  return m_current != nullptr && m_current->kind == NodeKind::Array;
+}
+
+bool BinarySerializationContext::is_object() {
+  return m_current != nullptr && m_current->kind == NodeKind::Object;
+}
+
+} // namespace astralix
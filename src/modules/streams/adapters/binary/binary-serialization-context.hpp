@@ -0,0 +1,134 @@
+#pragma once
+
+#include "arena.hpp"
+#include "assert.hpp"
+#include "base.hpp"
+#include "guid.hpp"
+#include "serialization-context.hpp"
+#include "stream-buffer.hpp"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace astralix::binary_detail {
+
+  enum class NodeKind : uint8_t {
+    Null,
+    String,
+    Int,
+    Float,
+    Bool,
+    Object,
+    Array,
+  };
+
+  struct Node {
+    NodeKind kind = NodeKind::Null;
+    int int_value = 0;
+    float float_value = 0.0f;
+    bool bool_value = false;
+    std::string string_value;
+    // Keys are indices into Document::keys.
+    std::vector<std::pair<uint32_t, Node *>> object_items;
+    std::vector<Node *> array_items;
+  };
+
+  // Owns every node of one context tree. Nodes live in a deque so the
+  // pointers handed to child contexts stay valid as the tree grows; nodes
+  // orphaned by an overwrite are reclaimed with the document.
+  struct Document {
+    std::deque<Node> nodes;
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, uint32_t> key_ids;
+    Node *root = nullptr;
+
+    Document() { root = &make_node(); }
+
+    Node &make_node(NodeKind kind = NodeKind::Null) {
+      auto &node = nodes.emplace_back();
+      node.kind = kind;
+      return node;
+    }
+
+    uint32_t intern(const std::string &key) {
+      auto [it, inserted] =
+          key_ids.try_emplace(key, static_cast<uint32_t>(keys.size()));
+      if (inserted) {
+        keys.push_back(key);
+      }
+
+      return it->second;
+    }
+  };
+
+} // namespace astralix::binary_detail
+
+namespace astralix {
+
+  // Compact binary encoding of the serialization tree:
+  //
+  //   "AXSB" u8 version
+  //   varint key_count, key_count x (varint length, bytes)
+  //   root value
+  //
+  // A value is a one byte tag followed by its payload: zigzag varint for
+  // ints, four little-endian bytes for floats, varint length and bytes for
+  // strings, varint count and items for arrays, and varint count and
+  // (varint key index, value) pairs for objects.
+  class BinarySerializationContext : public SerializationContext {
+  public:
+    BinarySerializationContext();
+    BinarySerializationContext(Scope<StreamBuffer> buffer);
+
+    ~BinarySerializationContext() = default;
+    void set_value(const SerializableValue& value) override;
+    void set_value(Ref<SerializationContext> ctx) override;
+
+    std::any get_root() override { return m_document->root; }
+
+    size_t root_size() override;
+    size_t size() override;
+
+    ElasticArena::Block* to_buffer(ElasticArena& arena) override;
+
+    std::string as_string() override;
+    int as_int() override;
+    float as_float() override;
+    bool as_bool() override;
+
+    std::vector<std::any> as_array() override;
+    std::vector<std::string> object_keys() override;
+
+    SerializationTypeKind kind() override;
+
+    bool is_string() override;
+    bool is_int() override;
+    bool is_float() override;
+    bool is_bool() override;
+    bool is_array() override;
+    bool is_object() override;
+
+    ContextProxy operator[](const SerializableKey& key) override;
+
+    std::string extension() const override { return ".axb"; }
+    void from_buffer(Scope<StreamBuffer> buffer) override;
+
+    static constexpr uint8_t k_version = 1u;
+
+  private:
+    using Node = binary_detail::Node;
+    using Document = binary_detail::Document;
+
+    BinarySerializationContext(std::shared_ptr<Document> document, Node* current);
+
+    static size_t node_size(const Node* node);
+
+    std::shared_ptr<Document> m_document;
+    Node* m_current = nullptr;
+  };
+} // namespace astralix
@@ -0,0 +1,248 @@
+#include "serialization-context.hpp"
+
+#include "arena.hpp"
+#include "base.hpp"
+#include "exceptions/base-exception.hpp"
+#include "helpers/benchmark.hpp"
+#include "stream-buffer.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace astralix;
+
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_BINARY)
+
+namespace {
+
+Scope<StreamBuffer> make_buffer(const std::string &content) {
+  auto buffer = create_scope<StreamBuffer>(content.size());
+  if (!content.empty()) {
+    std::memcpy(buffer->data(), content.data(), content.size());
+  }
+  return buffer;
+}
+
+std::string encode(Ref<SerializationContext> context) {
+  ElasticArena arena(4096);
+  auto block = context->to_buffer(arena);
+  return std::string(static_cast<const char *>(block->data), block->size);
+}
+
+Ref<SerializationContext> roundtrip_binary(Ref<SerializationContext> context) {
+  return SerializationContext::create(SerializationFormat::Binary, make_buffer(encode(context)));
+}
+
+} // namespace
+
+TEST(BinarySerializationContext, WritesAndReadsScalarValues) {
+  auto context = SerializationContext::create(SerializationFormat::Binary);
+
+  (*context)["name"] = std::string("astra");
+  (*context)["version"] = 42;
+  (*context)["negative"] = -1234567;
+  (*context)["pi"] = 3.14f;
+  (*context)["active"] = true;
+
+  auto restored = roundtrip_binary(context);
+
+  EXPECT_EQ((*restored)["name"].as<std::string>(), "astra");
+  EXPECT_EQ((*restored)["version"].as<int>(), 42);
+  EXPECT_EQ((*restored)["negative"].as<int>(), -1234567);
+  EXPECT_EQ((*restored)["pi"].as<float>(), 3.14f);
+  EXPECT_EQ((*restored)["active"].as<bool>(), true);
+}
+
+TEST(BinarySerializationContext, DetectsTypesCorrectly) {
+  auto context = SerializationContext::create(SerializationFormat::Binary);
+
+  (*context)["str"] = std::string("hello");
+  (*context)["num"] = 7;
+  (*context)["flt"] = 2.5f;
+  (*context)["flag"] = false;
+  (*context)["items"][1] = 1;
+
+  auto restored = roundtrip_binary(context);
+
+  EXPECT_EQ((*restored)["str"].kind(), SerializationTypeKind::String);
+  EXPECT_EQ((*restored)["num"].kind(), SerializationTypeKind::Int);
+  EXPECT_EQ((*restored)["flt"].kind(), SerializationTypeKind::Float);
+  EXPECT_EQ((*restored)["flag"].kind(), SerializationTypeKind::Bool);
+  EXPECT_EQ((*restored)["items"].kind(), SerializationTypeKind::Array);
+  EXPECT_EQ((*restored)["items"][0].kind(), SerializationTypeKind::Unknown);
+}
+
+TEST(BinarySerializationContext, WritesAndReadsRootArraysOfObjects) {
+  auto context = SerializationContext::create(SerializationFormat::Binary);
+
+  (*context)[0]["name"] = std::string("hero");
+  (*context)[0]["health"] = 100;
+  (*context)[1]["name"] = std::string("mage");
+  (*context)[1]["health"] = 75;
+
+  auto restored = roundtrip_binary(context);
+
+  EXPECT_EQ(restored->root_size(), 2u);
+  EXPECT_EQ((*restored)[0]["name"].as<std::string>(), "hero");
+  EXPECT_EQ((*restored)[0]["health"].as<int>(), 100);
+  EXPECT_EQ((*restored)[1]["name"].as<std::string>(), "mage");
+  EXPECT_EQ((*restored)[1]["health"].as<int>(), 75);
+}
+
+TEST(BinarySerializationContext, InternsRepeatedKeysOnce) {
+  auto context = SerializationContext::create(SerializationFormat::Binary);
+  for (int index = 0; index < 64; ++index) {
+    (*context)["entities"][index]["transform_component"] = index;
+  }
+
+  const auto encoded = encode(context);
+  size_t occurrences = 0;
+  for (size_t at = encoded.find("transform_component"); at != std::string::npos;
+       at = encoded.find("transform_component", at + 1)) {
+    ++occurrences;
+  }
+  EXPECT_EQ(occurrences, 1u);
+
+  auto restored = roundtrip_binary(context);
+  EXPECT_EQ((*restored)["entities"][63]["transform_component"].as<int>(), 63);
+  EXPECT_EQ((*restored)["entities"][0].object_keys(), std::vector<std::string>{"transform_component"});
+}
+
+TEST(BinarySerializationContext, PreservesObjectKeyOrder) {
+  auto context = SerializationContext::create(SerializationFormat::Binary);
+  (*context)["zeta"] = 1;
+  (*context)["alpha"] = 2;
+  (*context)["mid"] = 3;
+
+  auto restored = roundtrip_binary(context);
+
+  const std::vector<std::string> expected = {"zeta", "alpha", "mid"};
+  EXPECT_EQ(restored->object_keys(), expected);
+}
+
+TEST(BinarySerializationContext, CopiesContextsAcrossDocuments) {
+  auto component = SerializationContext::create(SerializationFormat::Binary);
+  (*component)["name"] = std::string("rigid_body");
+  (*component)["mass"] = 2.0f;
+
+  auto scene = SerializationContext::create(SerializationFormat::Binary);
+  (*scene)["other"] = 1;
+  (*scene)["components"][0] = component;
+
+  auto restored = roundtrip_binary(scene);
+
+  EXPECT_EQ((*restored)["components"][0]["name"].as<std::string>(), "rigid_body");
+  EXPECT_EQ((*restored)["components"][0]["mass"].as<float>(), 2.0f);
+}
+
+TEST(BinarySerializationContext, MissingKeysRemainUnknown) {
+  auto context = SerializationContext::create(SerializationFormat::Binary);
+  (*context)["present"] = std::string("value");
+
+  auto restored = roundtrip_binary(context);
+  auto missing = (*restored)["missing"];
+
+  EXPECT_EQ(missing.kind(), SerializationTypeKind::Unknown);
+  EXPECT_EQ(missing.size(), 0u);
+  EXPECT_EQ(missing.as<std::string>(), "");
+}
+
+TEST(BinarySerializationContext, RejectsMalformedInput) {
+  auto context = SerializationContext::create(SerializationFormat::Binary);
+  (*context)["name"] = std::string("astra");
+  const auto encoded = encode(context);
+
+  EXPECT_THROW(
+      SerializationContext::create(SerializationFormat::Binary, make_buffer("{\"name\":1}")),
+      BaseException
+  );
+  EXPECT_THROW(
+      SerializationContext::create(SerializationFormat::Binary, make_buffer(encoded.substr(0, encoded.size() - 2u))),
+      BaseException
+  );
+  EXPECT_THROW(
+      SerializationContext::create(SerializationFormat::Binary, make_buffer(encoded + '\0')),
+      BaseException
+  );
+}
+
+TEST(BinarySerializationContext, ReturnsCorrectExtension) {
+  auto context = SerializationContext::create(SerializationFormat::Binary);
+  EXPECT_EQ(context->extension(), ".axb");
+}
+
+namespace {
+
+// Shaped like a saved scene: many entities with a handful of flat fields.
+// Components stay inline because TOML cannot nest tables in table arrays.
+void fill_scene(SerializationContext &context, int entity_count) {
+  for (int entity = 0; entity < entity_count; ++entity) {
+    auto entity_ctx = context["entities"][entity];
+    entity_ctx["id"] = std::string("entity-") + std::to_string(entity);
+    entity_ctx["name"] = std::string("Entity ") + std::to_string(entity);
+    entity_ctx["active"] = true;
+
+    for (int axis = 0; axis < 3; ++axis) {
+      entity_ctx["position"][axis] = static_cast<float>(entity) * 0.5f + static_cast<float>(axis);
+      entity_ctx["scale"][axis] = 1.0f;
+    }
+    for (int axis = 0; axis < 4; ++axis) {
+      entity_ctx["rotation"][axis] = axis == 3 ? 1.0f : 0.0f;
+    }
+
+    entity_ctx["model"] = std::string("models::crate");
+    entity_ctx["material"] = std::string("materials::wood");
+    entity_ctx["layer"] = entity % 4;
+  }
+}
+
+} // namespace
+
+TEST(SerializationFormatBenchmark, DISABLED_EncodeDecodeThroughput) {
+  std::vector<std::pair<const char *, SerializationFormat>> formats;
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_JSON)
+  formats.emplace_back("json", SerializationFormat::Json);
+#endif
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_YAML)
+  formats.emplace_back("yaml", SerializationFormat::Yaml);
+#endif
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_TOML)
+  formats.emplace_back("toml", SerializationFormat::Toml);
+#endif
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_XML)
+  formats.emplace_back("xml", SerializationFormat::Xml);
+#endif
+  formats.emplace_back("binary", SerializationFormat::Binary);
+
+  constexpr int k_entity_count = 2000;
+
+  for (const auto &[name, format] : formats) {
+    auto context = SerializationContext::create(format);
+    fill_scene(*context, k_entity_count);
+
+    std::string encoded;
+    const double encode_ms =
+        astralix::testing::elapsed_ms([&] { encoded = encode(context); });
+
+    Ref<SerializationContext> restored;
+    const double decode_ms = astralix::testing::elapsed_ms([&] {
+      restored = SerializationContext::create(format, make_buffer(encoded));
+    });
+
+    EXPECT_EQ((*restored)["entities"].size(), static_cast<size_t>(k_entity_count));
+
+    const double megabytes = static_cast<double>(encoded.size()) / (1024.0 * 1024.0);
+    std::printf(
+        "[SerializationFormatBenchmark] %-6s %8zu bytes: encode %7.2f ms (%6.1f MB/s), decode %7.2f ms (%6.1f MB/s)\n",
+        name, encoded.size(), encode_ms, megabytes / (encode_ms / 1000.0), decode_ms,
+        megabytes / (decode_ms / 1000.0)
+    );
+    astralix::testing::record_ms(std::string(name) + "_encode", encode_ms);
+    astralix::testing::record_ms(std::string(name) + "_decode", decode_ms);
+  }
+}
+
+#endif
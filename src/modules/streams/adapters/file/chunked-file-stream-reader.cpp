@@ -0,0 +1,48 @@
+#include "chunked-file-stream-reader.hpp"
+#include "assert.hpp"
+
+#include <algorithm>
+
+namespace astralix {
+
+ChunkedFileStreamReader::ChunkedFileStreamReader(
+    const std::filesystem::path &path, size_t chunk_size
+)
+    : m_path(path), m_chunk_size(chunk_size) {
+  ASTRA_ENSURE(m_chunk_size == 0u, "Chunk size must be greater than 0");
+
+  m_file.open(m_path, std::ios::binary);
+  ASTRA_ENSURE(!m_file.is_open(), "Cannot open file ", m_path.string());
+
+  m_file.seekg(0, std::ios::end);
+  const auto total_size = m_file.tellg();
+  ASTRA_ENSURE(
+      total_size < 0, "Cannot determine file size ", m_path.string()
+  );
+
+  m_total_size = static_cast<size_t>(total_size);
+  m_file.seekg(0, std::ios::beg);
+
+  m_chunk = std::make_unique_for_overwrite<char[]>(
+      std::min(m_chunk_size, std::max<size_t>(m_total_size, 1u))
+  );
+}
+
+std::span<const char> ChunkedFileStreamReader::next_chunk() {
+  const size_t remaining = m_total_size - m_bytes_read;
+  if (remaining == 0u) {
+    return {};
+  }
+
+  const size_t length = std::min(remaining, m_chunk_size);
+  m_file.read(m_chunk.get(), static_cast<std::streamsize>(length));
+  ASTRA_ENSURE(
+      static_cast<size_t>(m_file.gcount()) != length, "Cannot read file ",
+      m_path.string()
+  );
+
+  m_bytes_read += length;
+  return {m_chunk.get(), length};
+}
+
+} // namespace astralix
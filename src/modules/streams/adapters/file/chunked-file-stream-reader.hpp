@@ -0,0 +1,27 @@
+#pragma once
+#include "chunked-stream-reader.hpp"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace astralix {
+
+// Streams a file through one reusable chunk buffer, for files that should
+// not be mapped or held in memory whole.
+class ChunkedFileStreamReader : public ChunkedStreamReader {
+public:
+  ChunkedFileStreamReader(const std::filesystem::path &path,
+                          size_t chunk_size = k_default_chunk_size);
+
+  std::span<const char> next_chunk() override;
+  size_t total_size() const override { return m_total_size; }
+
+private:
+  std::ifstream m_file;
+  std::filesystem::path m_path;
+  size_t m_total_size = 0u;
+  size_t m_chunk_size = k_default_chunk_size;
+  std::unique_ptr<char[]> m_chunk;
+};
+
+} // namespace astralix
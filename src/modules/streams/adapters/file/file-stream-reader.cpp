@@ -3,6 +3,8 @@
 #include "log.hpp"
 #include "stream-buffer.hpp"
 
+#include <memory>
+
 namespace astralix {
 
 FileStreamReader::FileStreamReader(const std::filesystem::path &path)
@@ -21,8 +23,6 @@ FileStreamReader::FileStreamReader(const std::filesystem::path &path)
   m_total_size = static_cast<size_t>(total_size);
 
   m_file.seekg(0, std::ios::beg);
-
-  m_buffer = create_scope<StreamBuffer>(m_total_size);
 }
 
 FileStreamReader::~FileStreamReader() {
@@ -34,17 +34,23 @@ void FileStreamReader::read() {
   )
 
   if (m_total_size == 0u) {
+    m_buffer = create_scope<StreamBuffer>(0u);
     m_file.close();
     return;
   }
 
-  m_file.read(m_buffer->data(), m_buffer->size());
+  // Read straight into uninitialised storage the buffer takes over, rather
+  // than zero-filling an arena page and copying over it.
+  Ref<char[]> storage = std::make_unique_for_overwrite<char[]>(m_total_size);
+  m_file.read(storage.get(), static_cast<std::streamsize>(m_total_size));
 
   auto total_read = m_file.gcount();
 
   ASTRA_ENSURE(total_read != m_total_size,
                "Cannot read file ", m_path.string());
 
+  m_buffer = create_scope<StreamBuffer>(storage.get(), m_total_size, storage);
+
   if (m_file.eof()) {
     m_file.close();
   }
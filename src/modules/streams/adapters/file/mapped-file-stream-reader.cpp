@@ -0,0 +1,43 @@
+#include "mapped-file-stream-reader.hpp"
+#include "assert.hpp"
+#include "stream-buffer.hpp"
+
+#include <algorithm>
+
+namespace astralix {
+
+MappedFileStreamReader::MappedFileStreamReader(
+    const std::filesystem::path &path, size_t chunk_size
+)
+    : StreamReader(), m_file(create_ref<MappedFile>(path)),
+      m_chunk_size(chunk_size) {
+  ASTRA_ENSURE(m_chunk_size == 0u, "Chunk size must be greater than 0");
+}
+
+void MappedFileStreamReader::read() {
+  if (m_file->size() == 0u) {
+    m_buffer = create_scope<StreamBuffer>(0u);
+    return;
+  }
+
+  // The buffer shares ownership of the mapping, so it outlives the reader.
+  auto *data =
+      const_cast<char *>(reinterpret_cast<const char *>(m_file->data()));
+  m_buffer = create_scope<StreamBuffer>(data, m_file->size(), m_file);
+}
+
+std::span<const char> MappedFileStreamReader::next_chunk() {
+  const size_t remaining = m_file->size() - m_bytes_read;
+  if (remaining == 0u) {
+    return {};
+  }
+
+  const size_t length = std::min(remaining, m_chunk_size);
+  const auto *start =
+      reinterpret_cast<const char *>(m_file->data()) + m_bytes_read;
+  m_bytes_read += length;
+
+  return {start, length};
+}
+
+} // namespace astralix
@@ -0,0 +1,27 @@
+#pragma once
+#include "adapters/file/mapped-file.hpp"
+#include "base.hpp"
+#include "chunked-stream-reader.hpp"
+#include "stream-reader.hpp"
+#include <filesystem>
+
+namespace astralix {
+
+// Reads a file through MappedFile. read() hands out a StreamBuffer that points
+// into the mapping, and chunks are slices of it, so nothing is copied.
+class MappedFileStreamReader : public StreamReader, public ChunkedStreamReader {
+public:
+  MappedFileStreamReader(const std::filesystem::path &path,
+                         size_t chunk_size = k_default_chunk_size);
+
+  void read() override;
+
+  std::span<const char> next_chunk() override;
+  size_t total_size() const override { return m_file->size(); }
+
+private:
+  Ref<MappedFile> m_file;
+  size_t m_chunk_size = k_default_chunk_size;
+};
+
+} // namespace astralix
@@ -0,0 +1,140 @@
+#include "mapped-file-stream-reader.hpp"
+
+#include "chunked-file-stream-reader.hpp"
+#include "exceptions/base-exception.hpp"
+#include "file-stream-reader.hpp"
+#include "stream-buffer.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace astralix;
+
+namespace {
+
+std::filesystem::path write_fixture(const std::string &name,
+                                    const std::string &content) {
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(content.data(), static_cast<std::streamsize>(content.size()));
+  return path;
+}
+
+std::string make_content(size_t size) {
+  std::string content(size, '\0');
+  for (size_t index = 0; index < size; ++index) {
+    content[index] = static_cast<char>('a' + index % 26u);
+  }
+  return content;
+}
+
+std::string drain(ChunkedStreamReader &reader, size_t &chunk_count) {
+  std::string out;
+  chunk_count = 0u;
+  for (auto chunk = reader.next_chunk(); !chunk.empty();
+       chunk = reader.next_chunk()) {
+    out.append(chunk.data(), chunk.size());
+    ++chunk_count;
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(StreamBuffer, WrapsExternalMemoryWithoutCopying) {
+  std::string content = "external";
+  StreamBuffer buffer(content.data(), content.size());
+
+  EXPECT_TRUE(buffer.is_external());
+  EXPECT_EQ(buffer.data(), content.data());
+  EXPECT_EQ(buffer.size(), content.size());
+
+  buffer.reset();
+  EXPECT_EQ(buffer.size(), 0u);
+}
+
+TEST(MappedFileStreamReader, BufferPointsIntoTheMapping) {
+  const auto content = make_content(100000u);
+  const auto path = write_fixture("astralix-mapped-reader.test", content);
+
+  Scope<StreamBuffer> buffer;
+  {
+    MappedFileStreamReader reader(path);
+    reader.read();
+    buffer = reader.get_buffer();
+  }
+
+  // The buffer keeps the mapping alive after the reader is gone.
+  ASSERT_TRUE(buffer->is_external());
+  ASSERT_EQ(buffer->size(), content.size());
+  EXPECT_EQ(std::string(buffer->data(), buffer->size()), content);
+
+  std::filesystem::remove(path);
+}
+
+TEST(MappedFileStreamReader, ChunksCoverTheWholeFile) {
+  const auto content = make_content(10000u);
+  const auto path = write_fixture("astralix-mapped-chunks.test", content);
+
+  MappedFileStreamReader reader(path, 4096u);
+  size_t chunk_count = 0u;
+
+  EXPECT_EQ(drain(reader, chunk_count), content);
+  EXPECT_EQ(chunk_count, 3u);
+  EXPECT_TRUE(reader.done());
+  EXPECT_EQ(reader.bytes_read(), content.size());
+
+  std::filesystem::remove(path);
+}
+
+TEST(MappedFileStreamReader, EmptyFilesYieldAnEmptyBuffer) {
+  const auto path = write_fixture("astralix-mapped-empty.test", "");
+
+  MappedFileStreamReader reader(path);
+  reader.read();
+  auto buffer = reader.get_buffer();
+
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(buffer->size(), 0u);
+  EXPECT_TRUE(reader.next_chunk().empty());
+
+  std::filesystem::remove(path);
+}
+
+TEST(ChunkedFileStreamReader, ChunksCoverTheWholeFile) {
+  const auto content = make_content(10000u);
+  const auto path = write_fixture("astralix-chunked-reader.test", content);
+
+  ChunkedFileStreamReader reader(path, 4096u);
+  size_t chunk_count = 0u;
+
+  EXPECT_EQ(reader.total_size(), content.size());
+  EXPECT_EQ(drain(reader, chunk_count), content);
+  EXPECT_EQ(chunk_count, 3u);
+  EXPECT_TRUE(reader.done());
+
+  std::filesystem::remove(path);
+}
+
+TEST(ChunkedFileStreamReader, MissingFileThrowsBaseException) {
+  const auto missing_path = std::filesystem::temp_directory_path() /
+                            "astralix-missing-chunked-reader.test";
+  std::filesystem::remove(missing_path);
+
+  EXPECT_THROW(ChunkedFileStreamReader reader(missing_path), BaseException);
+}
+
+TEST(FileStreamReader, ReadsWholeFile) {
+  const auto content = make_content(5000u);
+  const auto path = write_fixture("astralix-file-reader.test", content);
+
+  FileStreamReader reader(path);
+  reader.read();
+  auto buffer = reader.get_buffer();
+
+  ASSERT_EQ(buffer->size(), content.size());
+  EXPECT_EQ(std::string(buffer->data(), buffer->size()), content);
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,93 @@
+#include "mapped-file.hpp"
+#include "assert.hpp"
+
+#include <utility>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace astralix {
+
+MappedFile::MappedFile(const std::filesystem::path &path) : m_path(path) {
+#if defined(_WIN32)
+  std::ifstream file(m_path, std::ios::binary | std::ios::ate);
+  ASTRA_ENSURE(!file.is_open(), "Cannot open file ", m_path.string());
+
+  const auto total_size = file.tellg();
+  ASTRA_ENSURE(total_size < 0, "Cannot determine file size ", m_path.string());
+
+  m_fallback.resize(static_cast<size_t>(total_size));
+  file.seekg(0, std::ios::beg);
+  file.read(reinterpret_cast<char *>(m_fallback.data()), total_size);
+  ASTRA_ENSURE(file.gcount() != total_size, "Cannot read file ", m_path.string());
+
+  m_data = m_fallback.data();
+  m_size = m_fallback.size();
+#else
+  const int fd = ::open(m_path.c_str(), O_RDONLY);
+  ASTRA_ENSURE(fd < 0, "Cannot open file ", m_path.string());
+
+  struct stat info {};
+  const bool stat_failed = ::fstat(fd, &info) != 0;
+  if (stat_failed || info.st_size == 0) {
+    ::close(fd);
+  }
+  ASTRA_ENSURE(stat_failed, "Cannot determine file size ", m_path.string());
+
+  m_size = static_cast<size_t>(info.st_size);
+  if (m_size == 0u) {
+    return;
+  }
+
+  void *mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  ASTRA_ENSURE(mapping == MAP_FAILED, "Cannot map file ", m_path.string());
+
+  m_data = static_cast<const std::byte *>(mapping);
+  m_mapped = true;
+#endif
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_path(std::move(other.m_path)),
+      m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0u)),
+      m_mapped(std::exchange(other.m_mapped, false)),
+      m_fallback(std::move(other.m_fallback)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    unmap();
+    m_path = std::move(other.m_path);
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0u);
+    m_mapped = std::exchange(other.m_mapped, false);
+    m_fallback = std::move(other.m_fallback);
+  }
+
+  return *this;
+}
+
+void MappedFile::unmap() {
+#if !defined(_WIN32)
+  if (m_mapped) {
+    ::munmap(const_cast<std::byte *>(m_data), m_size);
+  }
+#endif
+
+  m_data = nullptr;
+  m_size = 0u;
+  m_mapped = false;
+  m_fallback.clear();
+}
+
+} // namespace astralix
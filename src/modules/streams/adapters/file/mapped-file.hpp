@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace astralix {
+
+// Read-only view of a whole file. On POSIX the file is mmap'd so pages are
+// faulted in on first touch and never copied; elsewhere it is read into a
+// heap buffer once.
+class MappedFile {
+public:
+  explicit MappedFile(const std::filesystem::path &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  const std::byte *data() const { return m_data; }
+  size_t size() const { return m_size; }
+  std::span<const std::byte> bytes() const { return {m_data, m_size}; }
+
+  const std::filesystem::path &path() const { return m_path; }
+
+private:
+  void unmap();
+
+  std::filesystem::path m_path;
+  const std::byte *m_data = nullptr;
+  size_t m_size = 0u;
+  bool m_mapped = false;
+  std::vector<std::byte> m_fallback;
+};
+
+} // namespace astralix
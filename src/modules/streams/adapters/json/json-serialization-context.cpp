@@ -6,19 +6,22 @@
 #include "stream-buffer.hpp"
 
 #include <any>
-#include <cctype>
+#include <bit>
 #include <charconv>
 #include <cstdlib>
 #include <cstring>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <sstream>
 #include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define ASTRA_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace astralix {
 
 namespace {
@@ -26,79 +29,126 @@ namespace {
 using Node = json_detail::Node;
 using NodeKind = json_detail::NodeKind;
 
-Node make_node(NodeKind kind = NodeKind::Null) {
-  Node node;
-  node.kind = kind;
-  return node;
-}
+using Document = json_detail::Document;
+using MapEntry = json_detail::MapEntry;
+using json_detail::k_object_index_threshold;
 
 void reset_node(Node &node, NodeKind kind) {
+  node = Node{};
   node.kind = kind;
-  node.string_value.clear();
-  node.int_value = 0;
-  node.float_value = 0.0f;
-  node.bool_value = false;
-  node.object_items.clear();
-  node.array_items.clear();
 }
 
-Node clone_node(const Node &node) {
-  Node clone = make_node(node.kind);
-  clone.string_value = node.string_value;
-  clone.int_value = node.int_value;
-  clone.float_value = node.float_value;
-  clone.bool_value = node.bool_value;
+uint32_t hash_key(uint32_t key) { return key * 0x9E3779B1u; }
 
-  for (const auto &entry : node.object_items) {
-    clone.object_items.push_back(
-        {entry.key, std::make_unique<Node>(clone_node(*entry.value))}
-    );
+void insert_object_index(Node &node, uint32_t key, uint32_t position) {
+  const uint32_t mask = node.object_index.size - 1u;
+  uint32_t slot = hash_key(key) & mask;
+  while (node.object_index[slot] != 0u) {
+    slot = (slot + 1u) & mask;
   }
 
-  for (const auto &item : node.array_items) {
-    clone.array_items.push_back(std::make_unique<Node>(clone_node(*item)));
+  node.object_index[slot] = position + 1u;
+}
+
+// Keeps the table at most half full so probes stay short.
+void build_object_index(Document &document, Node &node) {
+  uint32_t slot_count = 2u * k_object_index_threshold;
+  while (slot_count < node.object_items.size * 2u) {
+    slot_count *= 2u;
   }
 
-  return clone;
+  auto *slots = static_cast<uint32_t *>(
+      document.arena.allocate(sizeof(uint32_t) * slot_count, alignof(uint32_t))
+  );
+  std::memset(slots, 0, sizeof(uint32_t) * slot_count);
+  node.object_index.data = slots;
+  node.object_index.size = slot_count;
+  node.object_index.capacity = slot_count;
+
+  for (uint32_t position = 0; position < node.object_items.size; ++position) {
+    insert_object_index(node, node.object_items[position].key, position);
+  }
 }
 
-Node *find_object_child(Node &node, std::string_view key) {
-  for (auto &entry : node.object_items) {
-    if (entry.key == key) {
-      return entry.value.get();
+int64_t find_object_position(const Node &node, uint32_t key) {
+  if (!node.object_index.empty()) {
+    const uint32_t mask = node.object_index.size - 1u;
+    for (uint32_t slot = hash_key(key) & mask;; slot = (slot + 1u) & mask) {
+      const uint32_t entry = node.object_index[slot];
+      if (entry == 0u) {
+        return -1;
+      }
+
+      if (node.object_items[entry - 1u].key == key) {
+        return entry - 1u;
+      }
+    }
+  }
+
+  for (uint32_t position = 0; position < node.object_items.size; ++position) {
+    if (node.object_items[position].key == key) {
+      return position;
     }
   }
 
-  return nullptr;
+  return -1;
 }
 
-void assign_object_value(Node &node, const std::string &key, Node value) {
-  ASTRA_ENSURE(node.kind != NodeKind::Object, "Internal JSON parser expected an object node");
+void append_object_entry(Document &document, Node &node, uint32_t key, Node *value) {
+  node.object_items.push_back(document.arena, MapEntry{key, value});
+
+  const uint32_t size = node.object_items.size;
+  if (size <= k_object_index_threshold) {
+    return;
+  }
 
-  if (auto *existing = find_object_child(node, key)) {
-    *existing = std::move(value);
+  if (node.object_index.empty() || size * 2u > node.object_index.size) {
+    build_object_index(document, node);
     return;
   }
 
-  node.object_items.push_back({key, std::make_unique<Node>(std::move(value))});
+  insert_object_index(node, key, size - 1u);
+}
+
+Node *clone_node(const Document &source, const Node &node, Document &target) {
+  Node *clone = target.make_node(node.kind);
+  clone->string_value = target.store(node.string_value);
+  clone->int_value = node.int_value;
+  clone->float_value = node.float_value;
+  clone->bool_value = node.bool_value;
+
+  for (const auto &entry : node.object_items) {
+    const std::string_view key = source.keys[entry.key];
+    append_object_entry(
+        target, *clone, target.intern(key), clone_node(source, *entry.value, target)
+    );
+  }
+
+  for (const Node *item : node.array_items) {
+    clone->array_items.push_back(target.arena, clone_node(source, *item, target));
+  }
+
+  return clone;
 }
 
-Node &ensure_object_child(Node &node, const std::string &key) {
+Node &ensure_object_child(Document &document, Node &node, std::string_view key) {
   if (node.kind == NodeKind::Null) {
     reset_node(node, NodeKind::Object);
   }
 
   ASTRA_ENSURE(node.kind != NodeKind::Object, "JSON node is not an object for string indexing");
 
-  if (auto *existing = find_object_child(node, key)) {
-    return *existing;
+  const uint32_t key_id = document.intern(key);
+  if (const auto position = find_object_position(node, key_id); position >= 0) {
+    return *node.object_items[static_cast<size_t>(position)].value;
   }
 
-  node.object_items.push_back({key, std::make_unique<Node>(make_node())});
-  return *node.object_items.back().value;
+  Node *child = document.make_node();
+  append_object_entry(document, node, key_id, child);
+  return *child;
 }
 
-Node &ensure_array_child(Node &node, int index) {
+Node &ensure_array_child(Document &document, Node &node, int index) {
   ASTRA_ENSURE(index < 0, "JSON array index cannot be negative");
 
   if (node.kind == NodeKind::Null) {
@@ -107,8 +157,8 @@ Node &ensure_array_child(Node &node, int index) {
 
   ASTRA_ENSURE(node.kind != NodeKind::Array, "JSON node is not an array for integer indexing");
 
-  while (static_cast<int>(node.array_items.size()) <= index) {
-    node.array_items.push_back(std::make_unique<Node>(make_node()));
+  while (static_cast<int>(node.array_items.size) <= index) {
+    node.array_items.push_back(document.arena, document.make_node());
   }
 
   return *node.array_items[static_cast<size_t>(index)];
@@ -121,24 +171,24 @@ size_t current_size(const Node *node) {
 
   switch (node->kind) {
     case NodeKind::Object:
-      return node->object_items.size();
+      return node->object_items.size;
     case NodeKind::Array:
-      return node->array_items.size();
+      return node->array_items.size;
     default:
       return 0;
   }
 }
 
-std::vector<std::string> current_object_keys(const Node *node) {
+std::vector<std::string> current_object_keys(const Document &document, const Node *node) {
   std::vector<std::string> keys;
 
   if (node == nullptr || node->kind != NodeKind::Object) {
     return keys;
   }
 
-  keys.reserve(node->object_items.size());
+  keys.reserve(node->object_items.size);
   for (const auto &entry : node->object_items) {
-    keys.push_back(entry.key);
+    keys.emplace_back(document.keys[entry.key]);
   }
 
   return keys;
@@ -160,11 +210,21 @@ bool parse_float_strict(std::string_view text, float &value) {
     return false;
   }
 
+  // String values are views into the arena, not NUL-terminated, so only
+  // bounded parsers may read them.
   const char *begin = text.data();
-  char *end = nullptr;
-  value = std::strtof(begin, &end);
+  const char *end = text.data() + text.size();
+  const auto result = std::from_chars(begin, end, value);
+  if (result.ec == std::errc{} && result.ptr == end) {
+    return true;
+  }
 
-  return end == begin + text.size();
+  // What strtof also takes: leading spaces or '+', hex, and out-of-range
+  // values, which it saturates.
+  const std::string token(text);
+  char *token_end = nullptr;
+  value = std::strtof(token.c_str(), &token_end);
+  return token_end == token.c_str() + token.size();
 }
 
 int parse_string_to_int(std::string_view value) {
@@ -201,10 +261,14 @@ float parse_string_to_float(std::string_view value) {
 
 bool parse_string_to_bool(std::string_view value) { return value == "true"; }
 
+// Same text as streaming with max_digits10 precision, without the stream.
 std::string format_float(float value) {
-  std::ostringstream stream;
-  stream << std::setprecision(std::numeric_limits<float>::max_digits10) << value;
-  return stream.str();
+  char buffer[32];
+  const auto result = std::to_chars(
+      buffer, buffer + sizeof(buffer), value, std::chars_format::general,
+      std::numeric_limits<float>::max_digits10
+  );
+  return std::string(buffer, result.ptr);
 }
 
 void append_utf8(std::string &output, uint32_t code_point) {
@@ -248,64 +312,82 @@ void append_unicode_escape(std::string &output, uint32_t code_point) {
   output.push_back(hex_digit(code_point & 0xF));
 }
 
-std::string escape_json_string(std::string_view value) {
-  std::string escaped;
-  escaped.reserve(value.size() + 2);
+bool needs_escape(unsigned char ch) {
+  return ch == '"' || ch == '\\' || ch < 0x20;
+}
+
+void append_escaped(std::string &output, std::string_view value) {
+  size_t run_start = 0;
+
+  for (size_t i = 0; i < value.size(); ++i) {
+    const auto ch = static_cast<unsigned char>(value[i]);
+    if (!needs_escape(ch)) {
+      continue;
+    }
+
+    output.append(value.data() + run_start, i - run_start);
+    run_start = i + 1;
 
-  for (unsigned char ch : value) {
     switch (ch) {
       case '"':
-        escaped += "\\\"";
+        output += "\\\"";
         break;
       case '\\':
-        escaped += "\\\\";
+        output += "\\\\";
         break;
       case '\b':
-        escaped += "\\b";
+        output += "\\b";
         break;
       case '\f':
-        escaped += "\\f";
+        output += "\\f";
         break;
       case '\n':
-        escaped += "\\n";
+        output += "\\n";
         break;
       case '\r':
-        escaped += "\\r";
+        output += "\\r";
         break;
       case '\t':
-        escaped += "\\t";
+        output += "\\t";
         break;
       default:
-        if (ch < 0x20) {
-          append_unicode_escape(escaped, ch);
-        } else {
-          escaped.push_back(static_cast<char>(ch));
-        }
+        append_unicode_escape(output, ch);
         break;
     }
   }
 
-  return escaped;
+  output.append(value.data() + run_start, value.size() - run_start);
 }
 
-std::string emit_scalar(const Node &node) {
+void append_scalar(const Node &node, std::string &output) {
   switch (node.kind) {
-    case NodeKind::Null:
-      return "null";
     case NodeKind::String:
-      return "\"" + escape_json_string(node.string_value) + "\"";
-    case NodeKind::Int:
-      return std::to_string(node.int_value);
+      output.push_back('"');
+      append_escaped(output, node.string_value);
+      output.push_back('"');
+      break;
+    case NodeKind::Int: {
+      char buffer[16];
+      const auto result = std::to_chars(buffer, buffer + sizeof(buffer), node.int_value);
+      output.append(buffer, result.ptr);
+      break;
+    }
     case NodeKind::Float:
-      return format_float(node.float_value);
+      output += format_float(node.float_value);
+      break;
     case NodeKind::Bool:
-      return node.bool_value ? "true" : "false";
+      output += node.bool_value ? "true" : "false";
+      break;
     case NodeKind::Object:
-      return "{}";
+      output += "{}";
+      break;
     case NodeKind::Array:
-      return "[]";
+      output += "[]";
+      break;
+    case NodeKind::Null:
     default:
-      return "null";
+      output += "null";
+      break;
   }
 }
 
@@ -313,9 +395,9 @@ void append_indent(std::string &output, int indent) {
   output.append(static_cast<size_t>(indent), ' ');
 }
 
-void emit_node(const Node &node, int indent, std::string &output);
+void emit_node(const Document &document, const Node &node, int indent, std::string &output);
 
-void emit_object(const Node &node, int indent, std::string &output) {
+void emit_object(const Document &document, const Node &node, int indent, std::string &output) {
   if (node.object_items.empty()) {
     output += "{}";
     return;
@@ -323,14 +405,14 @@ void emit_object(const Node &node, int indent, std::string &output) {
 
   output += "{\n";
 
-  for (size_t i = 0; i < node.object_items.size(); ++i) {
+  for (uint32_t i = 0; i < node.object_items.size; ++i) {
     append_indent(output, indent + 2);
     output += "\"";
-    output += escape_json_string(node.object_items[i].key);
+    append_escaped(output, document.keys[node.object_items[i].key]);
     output += "\": ";
-    emit_node(*node.object_items[i].value, indent + 2, output);
+    emit_node(document, *node.object_items[i].value, indent + 2, output);
 
-    if (i + 1 != node.object_items.size()) {
+    if (i + 1 != node.object_items.size) {
       output += ",";
     }
 
@@ -341,7 +423,7 @@ void emit_object(const Node &node, int indent, std::string &output) {
   output += "}";
 }
 
-void emit_array(const Node &node, int indent, std::string &output) {
+void emit_array(const Document &document, const Node &node, int indent, std::string &output) {
   if (node.array_items.empty()) {
     output += "[]";
     return;
@@ -349,11 +431,11 @@ void emit_array(const Node &node, int indent, std::string &output) {
 
   output += "[\n";
 
-  for (size_t i = 0; i < node.array_items.size(); ++i) {
+  for (uint32_t i = 0; i < node.array_items.size; ++i) {
     append_indent(output, indent + 2);
-    emit_node(*node.array_items[i], indent + 2, output);
+    emit_node(document, *node.array_items[i], indent + 2, output);
 
-    if (i + 1 != node.array_items.size()) {
+    if (i + 1 != node.array_items.size) {
       output += ",";
     }
 
@@ -364,29 +446,107 @@ void emit_array(const Node &node, int indent, std::string &output) {
   output += "]";
 }
 
-void emit_node(const Node &node, int indent, std::string &output) {
+void emit_node(const Document &document, const Node &node, int indent, std::string &output) {
   switch (node.kind) {
     case NodeKind::Object:
-      emit_object(node, indent, output);
+      emit_object(document, node, indent, output);
       break;
     case NodeKind::Array:
-      emit_array(node, indent, output);
+      emit_array(document, node, indent, output);
       break;
     default:
-      output += emit_scalar(node);
+      append_scalar(node, output);
       break;
   }
 }
 
+bool is_json_space(char ch) {
+  return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+// First position at or after `position` that is not whitespace.
+size_t skip_json_spaces(std::string_view input, size_t position) {
+#if defined(ASTRA_JSON_SSE2)
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i control_span = _mm_set1_epi8('\r' - '\t');
+
+  while (position + 16u <= input.size()) {
+    const __m128i chunk = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(input.data() + position)
+    );
+    // '\t'..'\r' as one unsigned range check.
+    const __m128i offset = _mm_sub_epi8(chunk, tab);
+    const __m128i control =
+        _mm_cmpeq_epi8(_mm_min_epu8(offset, control_span), offset);
+    const __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(chunk, space), control);
+
+    const auto mask = static_cast<uint32_t>(~_mm_movemask_epi8(spaces)) & 0xFFFFu;
+    if (mask != 0u) {
+      return position + static_cast<size_t>(std::countr_zero(mask));
+    }
+
+    position += 16u;
+  }
+#endif
+
+  while (position < input.size() && is_json_space(input[position])) {
+    ++position;
+  }
+
+  return position;
+}
+
+// First position at or after `position` holding a quote, a backslash or a
+// control character.
+size_t find_string_special(std::string_view input, size_t position) {
+#if defined(ASTRA_JSON_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control_max = _mm_set1_epi8(0x1F);
+
+  while (position + 16u <= input.size()) {
+    const __m128i chunk = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(input.data() + position)
+    );
+    __m128i special =
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+    special = _mm_or_si128(
+        special, _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max), chunk)
+    );
+
+    const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+    if (mask != 0u) {
+      return position + static_cast<size_t>(std::countr_zero(mask));
+    }
+
+    position += 16u;
+  }
+#endif
+
+  while (position < input.size() &&
+         !needs_escape(static_cast<unsigned char>(input[position]))) {
+    ++position;
+  }
+
+  return position;
+}
+
+bool is_digit(char ch) { return ch >= '0' && ch <= '9'; }
+
+// Single pass over the input straight into the document arena. Container
+// children are gathered on shared scratch stacks and copied out once the
+// container closes, so every object and array is sized exactly.
 class JsonParser {
 public:
-  explicit JsonParser(std::string_view input) : m_input(input) {}
+  JsonParser(std::string_view input, Document &document)
+      : m_input(input), m_document(document) {}
 
-  Node parse_document() {
+  Node *parse_document() {
     skip_whitespace();
     ASTRA_ENSURE(m_position >= m_input.size(), "JSON buffer is empty");
 
-    Node root = parse_value();
+    Node *root = parse_value();
     skip_whitespace();
 
     ASTRA_ENSURE(m_position != m_input.size(), "Unexpected trailing JSON content at position ", m_position);
@@ -395,11 +555,17 @@ public:
   }
 
 private:
+  struct KeyMark {
+    uint32_t stamp = 0u;
+    uint32_t position = 0u;
+  };
+
   void skip_whitespace() {
-    while (m_position < m_input.size() &&
-           std::isspace(static_cast<unsigned char>(m_input[m_position]))) {
-      ++m_position;
+    if (m_position < m_input.size() && !is_json_space(m_input[m_position])) {
+      return;
     }
+
+    m_position = skip_json_spaces(m_input, m_position);
   }
 
   bool consume(char expected) {
@@ -416,7 +582,7 @@ private:
     m_position += sequence.size();
   }
 
-  Node parse_value() {
+  Node *parse_value() {
     skip_whitespace();
     ASTRA_ENSURE(m_position >= m_input.size(), "Unexpected end of JSON input at position ", m_position);
 
@@ -430,89 +596,136 @@ private:
     }
 
     if (current == '"') {
-      Node node = make_node(NodeKind::String);
-      node.string_value = parse_string();
+      Node *node = m_document.make_node(NodeKind::String);
+      node->string_value = m_document.store(parse_string());
       return node;
     }
 
     if (current == 't') {
       expect_sequence("true");
-      Node node = make_node(NodeKind::Bool);
-      node.bool_value = true;
+      Node *node = m_document.make_node(NodeKind::Bool);
+      node->bool_value = true;
       return node;
     }
 
     if (current == 'f') {
       expect_sequence("false");
-      Node node = make_node(NodeKind::Bool);
-      node.bool_value = false;
+      Node *node = m_document.make_node(NodeKind::Bool);
+      node->bool_value = false;
       return node;
     }
 
     if (current == 'n') {
       expect_sequence("null");
-      return make_node(NodeKind::Null);
+      return m_document.make_node(NodeKind::Null);
     }
 
-    if (current == '-' || std::isdigit(static_cast<unsigned char>(current))) {
+    if (current == '-' || is_digit(current)) {
       return parse_number();
     }
 
     ASTRA_EXCEPTION("Unexpected JSON token at position ", m_position);
   }
 
-  Node parse_object() {
+  Node *parse_object() {
     ASTRA_ENSURE(!consume('{'), "Expected '{' at position ", m_position);
 
-    Node object = make_node(NodeKind::Object);
+    Node *object = m_document.make_node(NodeKind::Object);
     skip_whitespace();
 
     if (consume('}')) {
       return object;
     }
 
+    const size_t first_entry = m_entries.size();
+
     while (true) {
       skip_whitespace();
       ASTRA_ENSURE(m_position >= m_input.size() || m_input[m_position] != '"', "Expected JSON object key at position ", m_position);
 
-      const std::string key = parse_string();
+      const uint32_t key = m_document.intern(parse_string());
       skip_whitespace();
       ASTRA_ENSURE(!consume(':'), "Expected ':' after JSON object key at position ", m_position);
 
-      Node value = parse_value();
-      assign_object_value(object, key, std::move(value));
+      Node *value = parse_value();
+      m_entries.push_back({key, value});
 
       skip_whitespace();
       if (consume('}')) {
-        return object;
+        break;
       }
 
       ASTRA_ENSURE(!consume(','), "Expected ',' or '}' in JSON object at position ", m_position);
     }
+
+    MapEntry *entries = m_entries.data() + first_entry;
+    const uint32_t count = collapse_duplicate_keys(
+        entries, static_cast<uint32_t>(m_entries.size() - first_entry)
+    );
+
+    object->object_items.assign(m_document.arena, entries, count);
+    if (count > k_object_index_threshold) {
+      build_object_index(m_document, *object);
+    }
+
+    m_entries.resize(first_entry);
+    return object;
+  }
+
+  // A repeated key keeps its first position and takes the last value, the
+  // same result as assigning the entries one by one.
+  uint32_t collapse_duplicate_keys(MapEntry *entries, uint32_t count) {
+    if (m_key_marks.size() < m_document.keys.size()) {
+      m_key_marks.resize(m_document.keys.size());
+    }
+
+    ++m_stamp;
+    uint32_t kept = 0u;
+
+    for (uint32_t i = 0; i < count; ++i) {
+      auto &mark = m_key_marks[entries[i].key];
+      if (mark.stamp == m_stamp) {
+        entries[mark.position].value = entries[i].value;
+        continue;
+      }
+
+      mark = {m_stamp, kept};
+      entries[kept++] = entries[i];
+    }
+
+    return kept;
   }
 
-  Node parse_array() {
+  Node *parse_array() {
     ASTRA_ENSURE(!consume('['), "Expected '[' at position ", m_position);
 
-    Node array = make_node(NodeKind::Array);
+    Node *array = m_document.make_node(NodeKind::Array);
     skip_whitespace();
 
     if (consume(']')) {
       return array;
     }
 
+    const size_t first_item = m_items.size();
+
     while (true) {
-      array.array_items.push_back(
-          std::make_unique<Node>(parse_value())
-      );
+      m_items.push_back(parse_value());
 
       skip_whitespace();
       if (consume(']')) {
-        return array;
+        break;
       }
 
       ASTRA_ENSURE(!consume(','), "Expected ',' or ']' in JSON array at position ", m_position);
     }
+
+    array->array_items.assign(
+        m_document.arena, m_items.data() + first_item,
+        static_cast<uint32_t>(m_items.size() - first_item)
+    );
+
+    m_items.resize(first_item);
+    return array;
   }
 
   int hex_to_int(char ch) const {
@@ -545,53 +758,63 @@ private:
     return code_unit;
   }
 
-  std::string parse_string() {
+  // Strings without escapes are returned as views into the input; the rest
+  // are unescaped into a scratch string. Either way the view only lives
+  // until the next call.
+  std::string_view parse_string() {
     ASTRA_ENSURE(!consume('"'), "Expected JSON string at position ", m_position);
 
-    std::string result;
+    const size_t start = m_position;
+    size_t special = find_string_special(m_input, m_position);
+    ASTRA_ENSURE(special >= m_input.size(), "Unterminated JSON string at position ", m_input.size());
+
+    if (m_input[special] == '"') {
+      m_position = special + 1;
+      return m_input.substr(start, special - start);
+    }
+
+    m_scratch.clear();
 
     while (true) {
-      ASTRA_ENSURE(m_position >= m_input.size(), "Unterminated JSON string at position ", m_position);
+      special = find_string_special(m_input, m_position);
+      ASTRA_ENSURE(special >= m_input.size(), "Unterminated JSON string at position ", m_input.size());
+
+      m_scratch.append(m_input.data() + m_position, special - m_position);
+      m_position = special;
 
       const char ch = m_input[m_position++];
       if (ch == '"') {
-        return result;
+        return m_scratch;
       }
 
       ASTRA_ENSURE(static_cast<unsigned char>(ch) < 0x20, "Control character in JSON string at position ", m_position - 1);
-
-      if (ch != '\\') {
-        result.push_back(ch);
-        continue;
-      }
-
       ASTRA_ENSURE(m_position >= m_input.size(), "Invalid JSON escape at position ", m_position);
 
       const char escaped = m_input[m_position++];
       switch (escaped) {
         case '"':
-          result.push_back('"');
+          m_scratch.push_back('"');
           break;
         case '\\':
-          result.push_back('\\');
+          m_scratch.push_back('\\');
           break;
         case '/':
-          result.push_back('/');
+          m_scratch.push_back('/');
           break;
         case 'b':
-          result.push_back('\b');
+          m_scratch.push_back('\b');
           break;
         case 'f':
-          result.push_back('\f');
+          m_scratch.push_back('\f');
           break;
         case 'n':
-          result.push_back('\n');
+          m_scratch.push_back('\n');
           break;
         case 'r':
-          result.push_back('\r');
+          m_scratch.push_back('\r');
           break;
         case 't':
-          result.push_back('\t');
+          m_scratch.push_back('\t');
           break;
         case 'u': {
           uint32_t code_point = parse_unicode_escape();
@@ -611,7 +834,7 @@ private:
             ASTRA_ENSURE(code_point >= 0xDC00 && code_point <= 0xDFFF, "Unexpected low surrogate in JSON string at position ", m_position - 4);
           }
 
-          append_utf8(result, code_point);
+          append_utf8(m_scratch, code_point);
           break;
         }
         default:
@@ -620,7 +843,13 @@ private:
     }
   }
 
-  Node parse_number() {
+  void skip_digits() {
+    while (m_position < m_input.size() && is_digit(m_input[m_position])) {
+      ++m_position;
+    }
+  }
+
+  Node *parse_number() {
     const size_t start = m_position;
 
     consume('-');
@@ -629,30 +858,18 @@ private:
 
     if (m_input[m_position] == '0') {
       ++m_position;
-      ASTRA_ENSURE(m_position < m_input.size() && std::isdigit(static_cast<unsigned char>(m_input[m_position])), "Invalid JSON number with leading zero at position ", m_position);
+      ASTRA_ENSURE(m_position < m_input.size() && is_digit(m_input[m_position]), "Invalid JSON number with leading zero at position ", m_position);
     } else {
-      ASTRA_ENSURE(
-          !std::isdigit(static_cast<unsigned char>(m_input[m_position])),
-          "Invalid JSON number at position ",
-          m_position
-      );
-
-      while (m_position < m_input.size() &&
-             std::isdigit(static_cast<unsigned char>(m_input[m_position]))) {
-        ++m_position;
-      }
+      ASTRA_ENSURE(!is_digit(m_input[m_position]), "Invalid JSON number at position ", m_position);
+      skip_digits();
     }
 
     bool is_float = false;
 
     if (consume('.')) {
       is_float = true;
-      ASTRA_ENSURE(m_position >= m_input.size() || !std::isdigit(static_cast<unsigned char>(m_input[m_position])), "Invalid JSON fractional number at position ", m_position);
-
-      while (m_position < m_input.size() &&
-             std::isdigit(static_cast<unsigned char>(m_input[m_position]))) {
-        ++m_position;
-      }
+      ASTRA_ENSURE(m_position >= m_input.size() || !is_digit(m_input[m_position]), "Invalid JSON fractional number at position ", m_position);
+      skip_digits();
     }
 
     if (m_position < m_input.size() &&
@@ -665,63 +882,70 @@ private:
         ++m_position;
       }
 
-      ASTRA_ENSURE(m_position >= m_input.size() || !std::isdigit(static_cast<unsigned char>(m_input[m_position])), "Invalid JSON exponent at position ", m_position);
-
-      while (m_position < m_input.size() &&
-             std::isdigit(static_cast<unsigned char>(m_input[m_position]))) {
-        ++m_position;
-      }
+      ASTRA_ENSURE(m_position >= m_input.size() || !is_digit(m_input[m_position]), "Invalid JSON exponent at position ", m_position);
+      skip_digits();
     }
 
-    const std::string_view token = m_input.substr(start, m_position - start);
+    const char *begin = m_input.data() + start;
+    const char *end = m_input.data() + m_position;
 
     if (!is_float) {
       long long int_value = 0;
-      const char *begin = token.data();
-      const char *end = token.data() + token.size();
       auto result = std::from_chars(begin, end, int_value);
 
       if (result.ec == std::errc{} && result.ptr == end &&
           int_value >= std::numeric_limits<int>::min() &&
           int_value <= std::numeric_limits<int>::max()) {
-        Node node = make_node(NodeKind::Int);
-        node.int_value = static_cast<int>(int_value);
+        Node *node = m_document.make_node(NodeKind::Int);
+        node->int_value = static_cast<int>(int_value);
         return node;
       }
     }
 
-    const std::string token_string(token);
-    char *end = nullptr;
-    const double parsed = std::strtod(token_string.c_str(), &end);
-    ASTRA_ENSURE(end == token_string.c_str() || static_cast<size_t>(end - token_string.c_str()) != token_string.size(), "Invalid JSON number at position ", start);
+    double parsed = 0.0;
+    const auto result = std::from_chars(begin, end, parsed);
+    if (result.ec == std::errc::result_out_of_range) {
+      // from_chars leaves the value alone on overflow; strtod saturates.
+      const std::string token(begin, end);
+      parsed = std::strtod(token.c_str(), nullptr);
+    } else {
+      ASTRA_ENSURE(result.ec != std::errc{} || result.ptr != end, "Invalid JSON number at position ", start);
+    }
 
-    Node node = make_node(NodeKind::Float);
-    node.float_value = static_cast<float>(parsed);
+    Node *node = m_document.make_node(NodeKind::Float);
+    node->float_value = static_cast<float>(parsed);
     return node;
   }
 
   std::string_view m_input;
   size_t m_position = 0;
+  Document &m_document;
+
+  std::vector<MapEntry> m_entries;
+  std::vector<Node *> m_items;
+  std::vector<KeyMark> m_key_marks;
+  uint32_t m_stamp = 0u;
+  std::string m_scratch;
 };
 
 } // namespace
 
 JsonSerializationContext::JsonSerializationContext()
-    : m_root(std::make_shared<Node>(make_node())), m_current(m_root.get()) {}
+    : m_document(std::make_shared<Document>()), m_current(m_document->root) {}
 
 JsonSerializationContext::JsonSerializationContext(Scope<StreamBuffer> buffer)
     : JsonSerializationContext() {
   from_buffer(std::move(buffer));
 }
 
-JsonSerializationContext::JsonSerializationContext(std::shared_ptr<Node> root, Node *current)
-    : m_root(std::move(root)), m_current(current) {}
+JsonSerializationContext::JsonSerializationContext(std::shared_ptr<Document> document, Node *current)
+    : m_document(std::move(document)), m_current(current) {}
 
 size_t JsonSerializationContext::node_size(const Node *node) {
   return current_size(node);
 }
 
-size_t JsonSerializationContext::root_size() { return node_size(m_root.get()); }
+size_t JsonSerializationContext::root_size() { return node_size(m_document->root); }
 
 size_t JsonSerializationContext::size() { return node_size(m_current); }
 
@@ -742,21 +966,21 @@ JsonSerializationContext::operator[](const SerializableKey &key) {
 
   if (std::holds_alternative<std::string>(parsed_key)) {
     const auto &str_key = std::get<std::string>(parsed_key);
-    auto *child = &ensure_object_child(*m_current, str_key);
+    auto *child = &ensure_object_child(*m_document, *m_current, str_key);
 
     return ContextProxy(
         Scope<SerializationContext>(
-            new JsonSerializationContext(m_root, child)
+            new JsonSerializationContext(m_document, child)
         ),
         str_key
     );
   }
 
   const int index = std::get<int>(parsed_key);
-  auto *child = &ensure_array_child(*m_current, index);
+  auto *child = &ensure_array_child(*m_document, *m_current, index);
 
   return ContextProxy(
-      Scope<SerializationContext>(new JsonSerializationContext(m_root, child)),
+      Scope<SerializationContext>(new JsonSerializationContext(m_document, child)),
       std::to_string(index)
   );
 }
@@ -772,7 +996,7 @@ void JsonSerializationContext::set_value(const SerializableValue &value) {
     m_current->float_value = std::get<float>(value);
   } else if (std::holds_alternative<std::string>(value)) {
     reset_node(*m_current, NodeKind::String);
-    m_current->string_value = std::get<std::string>(value);
+    m_current->string_value = m_document->store(std::get<std::string>(value));
   } else if (std::holds_alternative<bool>(value)) {
     reset_node(*m_current, NodeKind::Bool);
     m_current->bool_value = std::get<bool>(value);
@@ -781,14 +1005,15 @@ void JsonSerializationContext::set_value(const SerializableValue &value) {
 
 void JsonSerializationContext::set_value(Ref<SerializationContext> ctx) {
   auto json_ctx = static_cast<JsonSerializationContext *>(ctx.get());
-  ASTRA_ENSURE(json_ctx == nullptr || json_ctx->m_root == nullptr, "Invalid JSON serialization context");
+  ASTRA_ENSURE(json_ctx == nullptr || json_ctx->m_document == nullptr, "Invalid JSON serialization context");
 
-  *m_current = clone_node(*json_ctx->m_root);
+  const auto &source = *json_ctx->m_document;
+  *m_current = *clone_node(source, *source.root, *m_document);
 }
 
 ElasticArena::Block *JsonSerializationContext::to_buffer(ElasticArena &arena) {
   std::string json_string;
-  emit_node(*m_root, 0, json_string);
+  emit_node(*m_document, *m_document->root, 0, json_string);
 
   auto block = arena.allocate(json_string.size());
   if (!json_string.empty()) {
@@ -799,12 +1024,14 @@ ElasticArena::Block *JsonSerializationContext::to_buffer(ElasticArena &arena) {
 }
 
 void JsonSerializationContext::from_buffer(Scope<StreamBuffer> buffer) {
-  const std::string_view input(buffer->data(), buffer->size());
-  const std::string content(normalize_json_input(input));
-  JsonParser parser(content);
+  const std::string_view input =
+      normalize_json_input(std::string_view(buffer->data(), buffer->size()));
+
+  Document parsed;
+  parsed.root = JsonParser(input, parsed).parse_document();
 
-  *m_root = parser.parse_document();
-  m_current = m_root.get();
+  *m_document = std::move(parsed);
+  m_current = m_document->root;
 }
 
 std::string JsonSerializationContext::as_string() {
@@ -812,7 +1039,7 @@ std::string JsonSerializationContext::as_string() {
 
   switch (m_current->kind) {
     case NodeKind::String:
-      return m_current->string_value;
+      return std::string(m_current->string_value);
     case NodeKind::Int:
       return std::to_string(m_current->int_value);
     case NodeKind::Float:
@@ -882,16 +1109,16 @@ std::vector<std::any> JsonSerializationContext::as_array() {
     return items;
   }
 
-  items.reserve(m_current->array_items.size());
-  for (const auto &item : m_current->array_items) {
-    items.push_back(item.get());
+  items.reserve(m_current->array_items.size);
+  for (Node *item : m_current->array_items) {
+    items.push_back(item);
   }
 
   return items;
 }
 
 std::vector<std::string> JsonSerializationContext::object_keys() {
-  return current_object_keys(m_current);
+  return current_object_keys(*m_document, m_current);
 }
 
 SerializationTypeKind JsonSerializationContext::kind() {
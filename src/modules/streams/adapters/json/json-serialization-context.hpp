@@ -3,17 +3,23 @@
 #include "arena.hpp"
 #include "assert.hpp"
 #include "base.hpp"
+#include "bump.hpp"
 #include "guid.hpp"
 #include "serialization-context.hpp"
 #include "stream-buffer.hpp"
 
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace astralix::json_detail {
 
-  enum class NodeKind {
+  enum class NodeKind : uint8_t {
     Null,
     String,
     Int,
@@ -23,23 +29,113 @@ namespace astralix::json_detail {
     Array,
   };
 
+  // Growable array whose storage lives in the document arena. Growing
+  // abandons the old storage to the arena rather than freeing it.
+  template <typename T> struct ArenaVector {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    T* data = nullptr;
+    uint32_t size = 0u;
+    uint32_t capacity = 0u;
+
+    T* begin() const { return data; }
+    T* end() const { return data + size; }
+    T& operator[](size_t index) const { return data[index]; }
+    T& back() const { return data[size - 1u]; }
+    bool empty() const { return size == 0u; }
+
+    void assign(BumpAllocator& arena, const T* items, uint32_t count) {
+      data = count > 0u ? static_cast<T*>(arena.allocate(sizeof(T) * count, alignof(T)))
+                        : nullptr;
+      if (count > 0u) {
+        std::memcpy(data, items, sizeof(T) * count);
+      }
+      size = count;
+      capacity = count;
+    }
+
+    void push_back(BumpAllocator& arena, const T& value) {
+      if (size == capacity) {
+        const uint32_t next_capacity = capacity == 0u ? 4u : capacity * 2u;
+        T* next = static_cast<T*>(arena.allocate(sizeof(T) * next_capacity, alignof(T)));
+        if (size > 0u) {
+          std::memcpy(next, data, sizeof(T) * size);
+        }
+        data = next;
+        capacity = next_capacity;
+      }
+
+      data[size++] = value;
+    }
+  };
+
+  // Objects with more entries than this get a hash index over their keys.
+  inline constexpr uint32_t k_object_index_threshold = 16u;
+
   struct Node;
 
   struct MapEntry {
-    std::string key;
-    Scope<Node> value;
+    // Index into Document::keys.
+    uint32_t key = 0u;
+    Node* value = nullptr;
   };
 
   struct Node {
     NodeKind kind = NodeKind::Null;
-    std::string string_value;
+    bool bool_value = false;
     int int_value = 0;
     float float_value = 0.0f;
-    bool bool_value = false;
-    std::vector<MapEntry> object_items;
-    std::vector<Scope<Node>> array_items;
+    // Points into the document arena.
+    std::string_view string_value;
+    ArenaVector<MapEntry> object_items;
+    ArenaVector<Node*> array_items;
+    // Open-addressed key -> object_items position + 1, built once an object
+    // grows past k_object_index_threshold entries.
+    ArenaVector<uint32_t> object_index;
   };
 
+  // Every node, string and key of one context tree lives in a single bump
+  // arena, so a document is freed in a few large chunks and nodes never move.
+  struct Document {
+    BumpAllocator arena{KB(64)};
+    std::vector<std::string_view> keys;
+    std::unordered_map<std::string_view, uint32_t> key_ids;
+    Node* root = nullptr;
+
+    Document() { root = make_node(); }
+
+    Node* make_node(NodeKind kind = NodeKind::Null) {
+      auto* node = arena.allocate_object<Node>();
+      node->kind = kind;
+      return node;
+    }
+
+    std::string_view store(std::string_view text) {
+      if (text.empty()) {
+        return {};
+      }
+
+      auto* bytes = static_cast<char*>(arena.allocate(text.size(), 1u));
+      std::memcpy(bytes, text.data(), text.size());
+      return {bytes, text.size()};
+    }
+
+    uint32_t intern(std::string_view key) {
+      if (auto it = key_ids.find(key); it != key_ids.end()) {
+        return it->second;
+      }
+
+      const auto stored = store(key);
+      const auto id = static_cast<uint32_t>(keys.size());
+      keys.push_back(stored);
+      key_ids.emplace(stored, id);
+      return id;
+    }
+  };
+
+  static_assert(std::is_trivially_destructible_v<Node>,
+                "JSON nodes are released with their arena");
+
 } // namespace astralix::json_detail
 
 namespace astralix {
@@ -53,7 +149,7 @@ namespace astralix {
     void set_value(const SerializableValue& value) override;
     void set_value(Ref<SerializationContext> ctx) override;
 
-    std::any get_root() override { return m_root.get(); }
+    std::any get_root() override { return m_document->root; }
 
     size_t root_size() override;
     size_t size() override;
@@ -102,12 +198,13 @@ namespace astralix {
 
   private:
     using Node = json_detail::Node;
+    using Document = json_detail::Document;
 
-    JsonSerializationContext(std::shared_ptr<Node> root, Node* current);
+    JsonSerializationContext(std::shared_ptr<Document> document, Node* current);
 
     static size_t node_size(const Node* node);
 
-    std::shared_ptr<Node> m_root;
+    std::shared_ptr<Document> m_document;
     Node* m_current = nullptr;
   };
 } // namespace astralix
@@ -3,9 +3,14 @@
 #include "arena.hpp"
 #include "base.hpp"
 #include "exceptions/base-exception.hpp"
+#include "helpers/benchmark.hpp"
 #include "stream-buffer.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <string>
+#include <vector>
 
 using namespace astralix;
 
@@ -170,9 +175,137 @@ TEST(JsonSerializationContext, RejectsMalformedJsonInput) {
   );
 }
 
+TEST(JsonSerializationContext, IndexesWideObjects) {
+  auto context = SerializationContext::create(SerializationFormat::Json);
+
+  constexpr int k_key_count = 500;
+  for (int index = 0; index < k_key_count; ++index) {
+    (*context)["wide"]["key_" + std::to_string(index)] = index;
+  }
+  (*context)["wide"]["key_42"] = -42;
+
+  EXPECT_EQ((*context)["wide"].size(), static_cast<size_t>(k_key_count));
+  EXPECT_EQ((*context)["wide"]["key_42"].as<int>(), -42);
+
+  auto restored = roundtrip_json(context);
+
+  ASSERT_EQ((*restored)["wide"].size(), static_cast<size_t>(k_key_count));
+  EXPECT_EQ((*restored)["wide"].object_keys().front(), "key_0");
+  EXPECT_EQ((*restored)["wide"].object_keys().back(), "key_499");
+  for (int index = 0; index < k_key_count; ++index) {
+    const int expected = index == 42 ? -42 : index;
+    EXPECT_EQ((*restored)["wide"]["key_" + std::to_string(index)].as<int>(), expected);
+  }
+}
+
+TEST(JsonSerializationContext, DuplicateKeysKeepFirstPositionAndLastValue) {
+  const std::string json = R"json({"a":1,"b":2,"a":3})json";
+
+  auto restored = SerializationContext::create(SerializationFormat::Json, make_buffer(json));
+
+  const std::vector<std::string> expected_keys = {"a", "b"};
+  EXPECT_EQ(restored->object_keys(), expected_keys);
+  EXPECT_EQ((*restored)["a"].as<int>(), 3);
+  EXPECT_EQ((*restored)["b"].as<int>(), 2);
+}
+
+TEST(JsonSerializationContext, ParsesNumbersAtTheEdges) {
+  const std::string json =
+      R"json({"big":2147483648,"small":-2147483648,"exp":1.5e3,"tiny":-2.5E-2,"huge":1e400})json";
+
+  auto restored = SerializationContext::create(SerializationFormat::Json, make_buffer(json));
+
+  EXPECT_EQ((*restored)["big"].kind(), SerializationTypeKind::Float);
+  EXPECT_EQ((*restored)["small"].as<int>(), -2147483647 - 1);
+  EXPECT_FLOAT_EQ((*restored)["exp"].as<float>(), 1500.0f);
+  EXPECT_FLOAT_EQ((*restored)["tiny"].as<float>(), -0.025f);
+  EXPECT_TRUE(std::isinf((*restored)["huge"].as<float>()));
+}
+
+// String values are arena views; the key interned right after one must not
+// bleed into its numeric conversion.
+TEST(JsonSerializationContext, ConvertsNumericStringsFollowedByDigitKeys) {
+  const std::string json = R"json({"a":"1","7":0,"b":"12","3":0})json";
+
+  auto restored = SerializationContext::create(SerializationFormat::Json, make_buffer(json));
+
+  EXPECT_FLOAT_EQ((*restored)["a"].as<float>(), 1.0f);
+  EXPECT_EQ((*restored)["b"].as<int>(), 12);
+
+  auto context = SerializationContext::create(SerializationFormat::Json);
+  (*context)["a"] = std::string("2.5");
+  (*context)["5"] = 1;
+  (*context)["padded"] = std::string(" +4");
+  EXPECT_FLOAT_EQ((*context)["a"].as<float>(), 2.5f);
+  EXPECT_FLOAT_EQ((*context)["padded"].as<float>(), 4.0f);
+}
+
+TEST(JsonSerializationContext, CopiesContextsAcrossDocuments) {
+  auto component = SerializationContext::create(SerializationFormat::Json);
+  (*component)["name"] = std::string("rigid_body");
+  (*component)["mass"] = 2.0f;
+
+  auto scene = SerializationContext::create(SerializationFormat::Json);
+  (*scene)["components"][0] = component;
+
+  auto restored = roundtrip_json(scene);
+
+  EXPECT_EQ((*restored)["components"][0]["name"].as<std::string>(), "rigid_body");
+  EXPECT_EQ((*restored)["components"][0]["mass"].as<float>(), 2.0f);
+}
+
 TEST(JsonSerializationContext, ReturnsCorrectExtension) {
   auto context = SerializationContext::create(SerializationFormat::Json);
   EXPECT_EQ(context->extension(), ".json");
 }
 
+namespace {
+
+// Pretty-printed like a saved scene, with some escaped strings mixed in.
+std::string make_scene_json(int entity_count) {
+  std::string json = "{\n  \"entities\": [\n";
+  for (int entity = 0; entity < entity_count; ++entity) {
+    const auto id = std::to_string(entity);
+    json += "    {\n";
+    json += "      \"id\": \"entity-" + id + "\",\n";
+    json += "      \"name\": \"Entity \\\"" + id + "\\\"\",\n";
+    json += "      \"active\": true,\n";
+    json += "      \"layer\": " + std::to_string(entity % 4) + ",\n";
+    json += "      \"position\": [" + id + ".5, 1.25, -3.0e-1],\n";
+    json += "      \"rotation\": [0, 0, 0, 1],\n";
+    json += "      \"model\": \"models::crate\",\n";
+    json += "      \"material\": \"materials::wood\"\n";
+    json += entity + 1 == entity_count ? "    }\n" : "    },\n";
+  }
+  json += "  ]\n}\n";
+  return json;
+}
+
+} // namespace
+
+TEST(JsonSerializationBenchmark, DISABLED_ParseThroughput) {
+  constexpr int k_entity_count = 40000;
+  const std::string json = make_scene_json(k_entity_count);
+
+  // The buffer is built outside the timed call, so only the parse is measured.
+  double best_ms = 0.0;
+  for (int run = 0; run < 3; ++run) {
+    auto buffer = make_buffer(json);
+    Ref<SerializationContext> context;
+    const double elapsed_ms = astralix::testing::elapsed_ms([&] {
+      context = SerializationContext::create(SerializationFormat::Json, std::move(buffer));
+    });
+
+    ASSERT_EQ((*context)["entities"].size(), static_cast<size_t>(k_entity_count));
+    best_ms = run == 0 ? elapsed_ms : std::min(best_ms, elapsed_ms);
+  }
+
+  const double megabytes = static_cast<double>(json.size()) / (1024.0 * 1024.0);
+  std::printf(
+      "[JsonSerializationBenchmark] %.1f MB: parse %.2f ms (%.1f MB/s)\n", megabytes,
+      best_ms, megabytes / (best_ms / 1000.0)
+  );
+  astralix::testing::record_ms("parse", best_ms);
+}
+
 #endif
@@ -0,0 +1,30 @@
+#pragma once
+#include "arena.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace astralix {
+
+// Hands out a stream a chunk at a time so callers can hash or parse large
+// files without holding all of them in memory.
+class ChunkedStreamReader {
+public:
+  static constexpr size_t k_default_chunk_size = KB(64);
+
+  virtual ~ChunkedStreamReader() = default;
+
+  // The next run of bytes, empty once the stream is exhausted. The span is
+  // valid until the next call.
+  virtual std::span<const char> next_chunk() = 0;
+
+  virtual size_t total_size() const = 0;
+
+  size_t bytes_read() const { return m_bytes_read; }
+  bool done() const { return m_bytes_read >= total_size(); }
+
+protected:
+  size_t m_bytes_read = 0u;
+};
+
+} // namespace astralix
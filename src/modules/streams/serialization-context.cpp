@@ -12,6 +12,9 @@
 #if defined(ASTRALIX_SERIALIZATION_ENABLE_YAML)
 #include "adapters/yaml/yaml-serialization-context.hpp"
 #endif
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_BINARY)
+#include "adapters/binary/binary-serialization-context.hpp"
+#endif
 
 #include "assert.hpp"
 #include "stream-buffer.hpp"
@@ -36,6 +39,10 @@ SerializationContext::create(SerializationFormat format) {
 #if defined(ASTRALIX_SERIALIZATION_ENABLE_XML)
   case astralix::SerializationFormat::Xml:
     return create_ref<XmlSerializationContext>();
+#endif
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_BINARY)
+  case astralix::SerializationFormat::Binary:
+    return create_ref<BinarySerializationContext>();
 #endif
   default:
     break;
@@ -63,6 +70,10 @@ SerializationContext::create(SerializationFormat format,
 #if defined(ASTRALIX_SERIALIZATION_ENABLE_XML)
   case astralix::SerializationFormat::Xml:
     return create_ref<XmlSerializationContext>(std::move(buffer));
+#endif
+#if defined(ASTRALIX_SERIALIZATION_ENABLE_BINARY)
+  case astralix::SerializationFormat::Binary:
+    return create_ref<BinarySerializationContext>(std::move(buffer));
 #endif
   default:
     break;
@@ -11,7 +11,7 @@
 
 namespace astralix {
 
-enum SerializationFormat { Json, Yaml, Toml, Xml };
+enum SerializationFormat { Json, Yaml, Toml, Xml, Binary };
 
 enum class SerializationTypeKind {
   Unknown = 0,
@@ -72,6 +72,11 @@ function(astralix_streams_enable_serialization_formats target)
         "${CMAKE_CURRENT_FUNCTION_LIST_DIR}/adapters/xml/xml-serialization-context.cpp")
       target_compile_definitions(${target} PRIVATE
         ASTRALIX_SERIALIZATION_ENABLE_XML)
+    elseif(format STREQUAL "Binary")
+      target_sources(${target} PRIVATE
+        "${CMAKE_CURRENT_FUNCTION_LIST_DIR}/adapters/binary/binary-serialization-context.cpp")
+      target_compile_definitions(${target} PRIVATE
+        ASTRALIX_SERIALIZATION_ENABLE_BINARY)
     else()
       message(FATAL_ERROR
               "astralix_streams_enable_serialization_formats: unknown format '${format}'")
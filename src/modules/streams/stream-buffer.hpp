@@ -2,10 +2,12 @@
 #include "arena.hpp"
 
 #include "assert.hpp"
+#include "base.hpp"
 
 #include <cstddef>
 #include <cstring>
 #include <string_view>
+#include <utility>
 
 namespace astralix {
 
@@ -18,17 +20,19 @@ public:
     }
   }
 
-  ~StreamBuffer() {
-    m_arena.reset();
-    m_data = nullptr;
-  }
+  // Wraps memory owned elsewhere without copying it. `owner` is kept alive
+  // as long as the buffer, e.g. the mapping behind a MappedFile. Consumers
+  // only read stream buffers, so the memory may be read-only.
+  StreamBuffer(char *data, size_t size, Ref<void> owner = nullptr)
+      : m_size(size), m_external(data), m_owner(std::move(owner)) {}
 
-  void write(char *src, size_t size) {
-    auto block = m_arena.allocate(size);
+  ~StreamBuffer() { reset(); }
 
-    block->data = src;
+  void write(char *src, size_t size) {
+    reset();
 
-    m_data = block;
+    m_external = src;
+    m_size = size;
   }
 
   void reset() {
@@ -36,18 +40,32 @@ public:
       m_arena.release(m_data);
       m_data = nullptr;
     }
+
+    if (m_external != nullptr) {
+      m_external = nullptr;
+      m_owner = nullptr;
+      m_size = 0u;
+    }
   }
 
   char *data() {
+    if (m_external != nullptr) {
+      return m_external;
+    }
+
     return m_data != nullptr ? static_cast<char *>(m_data->data) : &m_empty;
   }
 
   size_t size() const { return m_data != nullptr ? m_data->size : m_size; }
 
+  bool is_external() const { return m_external != nullptr; }
+
 private:
   ElasticArena m_arena;
   ElasticArena::Block *m_data = nullptr;
   size_t m_size = 0u;
+  char *m_external = nullptr;
+  Ref<void> m_owner = nullptr;
   char m_empty = '\0';
 };
 
@@ -1,3 +1,4 @@
+#pragma once
 #include "stream-buffer.hpp"
 
 namespace astralix {
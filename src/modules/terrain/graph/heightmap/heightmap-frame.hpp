@@ -1,5 +1,6 @@
 #pragma once
 
+#include "base.hpp"
 #include <algorithm>
 #include <cstdint>
 #include <glm/glm.hpp>
@@ -15,11 +16,41 @@ enum class HeightmapField : uint8_t {
   MeshData,
 };
 
-struct ClipmapRing {
-  std::vector<glm::vec3> positions;
-  std::vector<glm::vec3> normals;
-  std::vector<glm::vec2> uvs;
+inline constexpr size_t k_heightmap_field_count = 5;
+
+// Vertex layout and triangle list of one clipmap level. Every level with
+// the same cell count and hole shares one topology, across tiles as well.
+struct ClipmapTopology {
+  uint32_t cells_per_side = 0;
+  bool has_hole = false;
+  // Grid coordinates (gx, gy) of each vertex, interleaved.
+  std::vector<uint16_t> grid;
   std::vector<uint32_t> indices;
+
+  uint32_t vertex_count() const { return static_cast<uint32_t>(grid.size() / 2); }
+};
+
+// Heights are normalized to [0, 65535] and scaled by height_scale when
+// drawn. coarse_height is the height the next coarser level interpolates at
+// this vertex; morph blends towards it near the outer edge of the level.
+struct ClipmapVertex {
+  uint16_t height = 0;
+  uint16_t coarse_height = 0;
+  uint16_t morph = 0;
+};
+
+// One level of the clipmap. World position of vertex i is
+// origin + grid[i] * spacing on xz; uv and normal come from the heightmap
+// texel at the same spot.
+struct ClipmapRing {
+  Ref<const ClipmapTopology> topology;
+  std::vector<ClipmapVertex> vertices;
+  glm::vec2 origin = glm::vec2(0.0f, 0.0f);
+  float spacing = 0.0f;
+  // Heightmap texel of grid (0, 0) and texels per grid step.
+  int32_t texel_x = 0;
+  int32_t texel_y = 0;
+  uint32_t texel_step = 1;
   uint32_t level = 0;
 };
 
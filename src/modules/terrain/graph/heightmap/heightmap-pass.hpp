@@ -17,6 +17,12 @@ public:
   virtual std::span<const HeightmapField> reads() const = 0;
   virtual std::span<const HeightmapField> writes() const = 0;
 
+  // Recipe settings the pass depends on, plus a hash of any settings the pass
+  // owns itself. HeightmapSubgraph skips the pass while these and its input
+  // fields are unchanged.
+  virtual std::span<const TerrainRecipeField> recipe_reads() const { return {}; }
+  virtual uint64_t settings_hash() const { return 0; }
+
   bool enabled = true;
 };
 
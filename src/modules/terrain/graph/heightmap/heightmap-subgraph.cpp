@@ -1,12 +1,25 @@
 #include "heightmap-subgraph.hpp"
 #include "assert.hpp"
+#include "fnv1a.hpp"
+#include "log.hpp"
 #include "trace.hpp"
 #include <algorithm>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
 namespace astralix::terrain {
 
+namespace {
+
+size_t field_slot(HeightmapField field) { return static_cast<size_t>(field); }
+
+uint64_t output_hash(uint64_t pass_key, HeightmapField field) {
+  return fnv1a64_append_value(pass_key, field);
+}
+
+} // namespace
+
 void HeightmapSubgraph::add_pass(Scope<HeightmapPass> pass) {
   m_passes.push_back(std::move(pass));
   m_compiled = false;
@@ -76,9 +89,27 @@ void HeightmapSubgraph::compile() {
     sorted_passes.push_back(std::move(m_passes[index]));
   }
   m_passes = std::move(sorted_passes);
+
+  m_rewritten_later.assign(pass_count, {});
+  for (size_t index = 0; index < pass_count; ++index) {
+    for (size_t later = index + 1; later < pass_count; ++later) {
+      for (HeightmapField field : m_passes[later]->writes()) {
+        m_rewritten_later[index][field_slot(field)] = true;
+      }
+    }
+  }
+
+  invalidate();
   m_compiled = true;
 }
 
+void HeightmapSubgraph::invalidate() {
+  m_frame.clear();
+  m_pass_keys.assign(m_passes.size(), 0);
+  m_field_hashes.fill(0);
+  m_snapshots.clear();
+}
+
 void HeightmapSubgraph::process(
     const std::unordered_map<std::string, const SubgraphOutputData *> &inputs
 ) {
@@ -86,12 +117,10 @@ void HeightmapSubgraph::process(
 
   ASTRA_ENSURE(!m_compiled, "HeightmapSubgraph::process called before compile()");
 
-  m_frame.clear();
-
-  for (auto &pass : m_passes) {
-    if (pass->enabled) {
-      pass->process(m_frame, m_recipe);
-    }
+  if (!run_passes()) {
+    LOG_DEBUG("[HeightmapSubgraph] cached field missing, rebuilding every pass");
+    invalidate();
+    run_passes();
   }
 
   uint32_t res = m_frame.resolution;
@@ -118,6 +147,157 @@ void HeightmapSubgraph::process(
   };
 }
 
+bool HeightmapSubgraph::run_passes() {
+  m_cache_stats = {};
+
+  // Hash every field should hold at this point of the chain.
+  std::array<uint64_t, k_heightmap_field_count> expected{};
+
+  for (size_t index = 0; index < m_passes.size(); ++index) {
+    auto &pass = m_passes[index];
+    if (!pass->enabled) {
+      continue;
+    }
+
+    uint64_t key = fnv1a64_append_string(pass->name());
+    key = fnv1a64_append_value(key, pass->settings_hash());
+    for (TerrainRecipeField recipe_field : pass->recipe_reads()) {
+      key = fnv1a64_append_value(key, hash_recipe_field(m_recipe, recipe_field));
+    }
+    for (HeightmapField field : pass->reads()) {
+      key = fnv1a64_append_value(key, expected[field_slot(field)]);
+    }
+
+    const bool hit = key == m_pass_keys[index];
+    const std::string trace_note =
+        std::string(pass->name()) + (hit ? ": cached" : ": executed");
+    ASTRA_PROFILE_TEXT(trace_note.c_str(), trace_note.size());
+
+    if (hit) {
+      ++m_cache_stats.hits;
+      for (HeightmapField field : pass->writes()) {
+        expected[field_slot(field)] = output_hash(key, field);
+      }
+      continue;
+    }
+
+    for (HeightmapField field : pass->reads()) {
+      const uint64_t hash = expected[field_slot(field)];
+      if (m_field_hashes[field_slot(field)] != hash && !restore_field(field, hash)) {
+        return false;
+      }
+    }
+
+    LOG_DEBUG("[HeightmapSubgraph] running pass", pass->name());
+    pass->process(m_frame, m_recipe);
+    ++m_cache_stats.misses;
+    m_pass_keys[index] = key;
+
+    for (HeightmapField field : pass->writes()) {
+      const uint64_t hash = output_hash(key, field);
+      expected[field_slot(field)] = hash;
+      m_field_hashes[field_slot(field)] = hash;
+
+      if (m_rewritten_later[index][field_slot(field)]) {
+        save_snapshot(index, field, hash);
+      }
+    }
+  }
+
+  // A skipped or disabled pass can leave a field holding a later version
+  // than the chain ends with.
+  for (size_t slot = 0; slot < k_heightmap_field_count; ++slot) {
+    const auto field = static_cast<HeightmapField>(slot);
+    if (m_field_hashes[slot] != expected[slot] && !restore_field(field, expected[slot])) {
+      return false;
+    }
+  }
+
+  ASTRA_PROFILE_PLOT("Terrain pass cache hits", static_cast<int64_t>(m_cache_stats.hits));
+  ASTRA_PROFILE_PLOT("Terrain pass cache misses", static_cast<int64_t>(m_cache_stats.misses));
+  return true;
+}
+
+void HeightmapSubgraph::save_snapshot(size_t pass_index, HeightmapField field, uint64_t hash) {
+  auto iterator = std::find_if(m_snapshots.begin(), m_snapshots.end(), [&](const FieldSnapshot &snapshot) {
+    return snapshot.pass_index == pass_index && snapshot.field == field;
+  });
+  if (iterator == m_snapshots.end()) {
+    iterator = m_snapshots.insert(m_snapshots.end(), FieldSnapshot{.pass_index = pass_index, .field = field});
+  }
+
+  iterator->hash = hash;
+  switch (field) {
+    case HeightmapField::Heightmap:
+      iterator->values = m_frame.heightmap;
+      break;
+    case HeightmapField::ErosionMap:
+      iterator->values = m_frame.erosion_map;
+      break;
+    case HeightmapField::NormalMap:
+      iterator->normals = m_frame.normal_map;
+      break;
+    case HeightmapField::SplatMap:
+      iterator->splats = m_frame.splat_map;
+      break;
+    case HeightmapField::MeshData:
+      iterator->rings = m_frame.clipmap_rings;
+      break;
+  }
+}
+
+// Hash 0 stands for the field as HeightmapFrame::allocate leaves it.
+bool HeightmapSubgraph::restore_field(HeightmapField field, uint64_t hash) {
+  const size_t texel_count = static_cast<size_t>(m_frame.resolution) * m_frame.resolution;
+  const FieldSnapshot *snapshot = nullptr;
+
+  if (hash != 0) {
+    auto iterator = std::find_if(m_snapshots.begin(), m_snapshots.end(), [&](const FieldSnapshot &candidate) {
+      return candidate.field == field && candidate.hash == hash;
+    });
+    if (iterator == m_snapshots.end()) {
+      return false;
+    }
+    snapshot = &*iterator;
+  }
+
+  switch (field) {
+    case HeightmapField::Heightmap:
+      if (snapshot != nullptr)
+        m_frame.heightmap = snapshot->values;
+      else
+        m_frame.heightmap.assign(texel_count, 0.0f);
+      break;
+    case HeightmapField::ErosionMap:
+      if (snapshot != nullptr)
+        m_frame.erosion_map = snapshot->values;
+      else
+        m_frame.erosion_map.assign(texel_count, 0.0f);
+      break;
+    case HeightmapField::NormalMap:
+      if (snapshot != nullptr)
+        m_frame.normal_map = snapshot->normals;
+      else
+        m_frame.normal_map.assign(texel_count, glm::vec4(0.0f, 1.0f, 0.0f, 0.0f));
+      break;
+    case HeightmapField::SplatMap:
+      if (snapshot != nullptr)
+        m_frame.splat_map = snapshot->splats;
+      else
+        m_frame.splat_map.assign(texel_count, glm::u8vec4(255, 0, 0, 0));
+      break;
+    case HeightmapField::MeshData:
+      if (snapshot != nullptr)
+        m_frame.clipmap_rings = snapshot->rings;
+      else
+        m_frame.clipmap_rings.clear();
+      break;
+  }
+
+  m_field_hashes[field_slot(field)] = hash;
+  return true;
+}
+
 const SubgraphOutputData *HeightmapSubgraph::get_output(const std::string &port_name) const {
   auto iterator = m_outputs.find(port_name);
   return iterator != m_outputs.end() ? &iterator->second : nullptr;
@@ -127,4 +307,13 @@ std::span<const Scope<HeightmapPass>> HeightmapSubgraph::passes() const {
   return m_passes;
 }
 
+HeightmapPass *HeightmapSubgraph::find_pass(std::string_view pass_name) {
+  for (auto &pass : m_passes) {
+    if (pass->name() == pass_name) {
+      return pass.get();
+    }
+  }
+  return nullptr;
+}
+
 } // namespace astralix::terrain
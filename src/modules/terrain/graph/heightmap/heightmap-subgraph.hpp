@@ -5,15 +5,29 @@
 #include "heightmap-frame.hpp"
 #include "heightmap-pass.hpp"
 #include "recipe/terrain-recipe-data.hpp"
+#include <array>
 #include <vector>
 
 namespace astralix::terrain {
 
+// Runs its passes in dependency order and skips every pass whose recipe
+// settings, own settings and input fields hash the same as on its last run.
+// Each field carries the hash of the pass run that produced it; a field that
+// a later pass rewrites in place (Heightmap through Erosion) is snapshotted so
+// an upstream-only rerun can start from the earlier version.
 class HeightmapSubgraph : public TerrainSubgraph {
 public:
+  struct CacheStats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+  };
+
   void add_pass(Scope<HeightmapPass> pass);
   void set_recipe(const TerrainRecipeData &recipe);
 
+  // Drops every cached result so the next process() runs all passes.
+  void invalidate();
+
   void compile() override;
   void process(const std::unordered_map<std::string, const SubgraphOutputData *> &inputs) override;
 
@@ -28,6 +42,8 @@ public:
 
   const HeightmapFrame &frame() const { return m_frame; }
   std::span<const Scope<HeightmapPass>> passes() const;
+  HeightmapPass *find_pass(std::string_view pass_name);
+  const CacheStats &cache_stats() const { return m_cache_stats; }
 
 private:
   static constexpr SubgraphPort s_output_ports[] = {
@@ -37,11 +53,31 @@ private:
       {"mesh", SubgraphOutputKind::Mesh},
   };
 
+  struct FieldSnapshot {
+    size_t pass_index = 0;
+    HeightmapField field = HeightmapField::Heightmap;
+    uint64_t hash = 0;
+    std::vector<float> values;
+    std::vector<glm::vec4> normals;
+    std::vector<glm::u8vec4> splats;
+    std::vector<ClipmapRing> rings;
+  };
+
+  bool run_passes();
+  void save_snapshot(size_t pass_index, HeightmapField field, uint64_t hash);
+  bool restore_field(HeightmapField field, uint64_t hash);
+
   std::vector<Scope<HeightmapPass>> m_passes;
   HeightmapFrame m_frame;
   TerrainRecipeData m_recipe;
   bool m_compiled = false;
 
+  std::vector<uint64_t> m_pass_keys;
+  std::vector<std::array<bool, k_heightmap_field_count>> m_rewritten_later;
+  std::array<uint64_t, k_heightmap_field_count> m_field_hashes{};
+  std::vector<FieldSnapshot> m_snapshots;
+  CacheStats m_cache_stats;
+
   std::unordered_map<std::string, SubgraphOutputData> m_outputs;
 };
 
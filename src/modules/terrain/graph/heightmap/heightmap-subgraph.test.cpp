@@ -0,0 +1,131 @@
+#include "heightmap-subgraph.hpp"
+#include "passes/erosion-pass.hpp"
+#include "passes/mesh-build-pass.hpp"
+#include "passes/noise-pass.hpp"
+#include "passes/normal-pass.hpp"
+#include "passes/splat-pass.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace astralix::terrain {
+namespace {
+
+TerrainRecipeData make_recipe() {
+  TerrainRecipeData recipe;
+  recipe.resolution = 65;
+  recipe.noise.frequency = 0.05f;
+  recipe.erosion.iterations = 2000;
+  recipe.splat.layers.push_back(SplatLayerConfig{
+      .material_id = "materials::grass",
+      .channel = "g",
+      .max_height = 0.5f,
+  });
+  return recipe;
+}
+
+Scope<HeightmapSubgraph> make_subgraph(const TerrainRecipeData &recipe) {
+  auto subgraph = create_scope<HeightmapSubgraph>();
+  subgraph->add_pass(create_scope<NoisePass>());
+  subgraph->add_pass(create_scope<ErosionPass>());
+  subgraph->add_pass(create_scope<NormalPass>());
+  subgraph->add_pass(create_scope<SplatPass>());
+  subgraph->add_pass(create_scope<MeshBuildPass>(3, 16));
+  subgraph->set_recipe(recipe);
+  subgraph->compile();
+  return subgraph;
+}
+
+template <typename T>
+bool same_bytes(const std::vector<T> &left, const std::vector<T> &right) {
+  return left.size() == right.size() &&
+         std::memcmp(left.data(), right.data(), left.size() * sizeof(T)) == 0;
+}
+
+void expect_same_frame(const HeightmapFrame &left, const HeightmapFrame &right) {
+  EXPECT_TRUE(same_bytes(left.heightmap, right.heightmap));
+  EXPECT_TRUE(same_bytes(left.erosion_map, right.erosion_map));
+  EXPECT_TRUE(same_bytes(left.normal_map, right.normal_map));
+  EXPECT_TRUE(same_bytes(left.splat_map, right.splat_map));
+  ASSERT_EQ(left.clipmap_rings.size(), right.clipmap_rings.size());
+  for (size_t index = 0; index < left.clipmap_rings.size(); ++index) {
+    EXPECT_TRUE(same_bytes(left.clipmap_rings[index].vertices, right.clipmap_rings[index].vertices));
+  }
+}
+
+TEST(HeightmapSubgraphTest, UnchangedRecipeHitsEveryPass) {
+  auto subgraph = make_subgraph(make_recipe());
+
+  subgraph->process({});
+  EXPECT_EQ(subgraph->cache_stats().misses, 5u);
+
+  subgraph->process({});
+  EXPECT_EQ(subgraph->cache_stats().hits, 5u);
+  EXPECT_EQ(subgraph->cache_stats().misses, 0u);
+}
+
+TEST(HeightmapSubgraphTest, SplatEditRerunsOnlySplat) {
+  auto recipe = make_recipe();
+  auto subgraph = make_subgraph(recipe);
+  subgraph->process({});
+
+  recipe.splat.layers[0].max_height = 0.8f;
+  subgraph->set_recipe(recipe);
+  subgraph->process({});
+
+  EXPECT_EQ(subgraph->cache_stats().hits, 4u);
+  EXPECT_EQ(subgraph->cache_stats().misses, 1u);
+
+  auto fresh = make_subgraph(recipe);
+  fresh->process({});
+  expect_same_frame(subgraph->frame(), fresh->frame());
+}
+
+TEST(HeightmapSubgraphTest, ClipmapEditRerunsOnlyMeshBuild) {
+  auto subgraph = make_subgraph(make_recipe());
+  subgraph->process({});
+
+  auto *mesh_pass = static_cast<MeshBuildPass *>(subgraph->find_pass("MeshBuild"));
+  ASSERT_NE(mesh_pass, nullptr);
+  mesh_pass->set_clipmap(4, 16);
+  subgraph->process({});
+
+  EXPECT_EQ(subgraph->cache_stats().hits, 4u);
+  EXPECT_EQ(subgraph->cache_stats().misses, 1u);
+  EXPECT_EQ(subgraph->frame().clipmap_rings.size(), 4u);
+}
+
+TEST(HeightmapSubgraphTest, ErosionEditRestartsFromCachedNoise) {
+  auto recipe = make_recipe();
+  auto subgraph = make_subgraph(recipe);
+  subgraph->process({});
+
+  recipe.erosion.iterations = 3000;
+  subgraph->set_recipe(recipe);
+  subgraph->process({});
+
+  EXPECT_EQ(subgraph->cache_stats().hits, 1u);
+  EXPECT_EQ(subgraph->cache_stats().misses, 4u);
+
+  auto fresh = make_subgraph(recipe);
+  fresh->process({});
+  expect_same_frame(subgraph->frame(), fresh->frame());
+}
+
+TEST(HeightmapSubgraphTest, DisablingErosionRestoresNoiseHeightmap) {
+  auto subgraph = make_subgraph(make_recipe());
+  subgraph->process({});
+
+  subgraph->find_pass("Erosion")->enabled = false;
+  subgraph->process({});
+  EXPECT_EQ(subgraph->cache_stats().hits, 1u);
+
+  auto fresh = make_subgraph(make_recipe());
+  fresh->find_pass("Erosion")->enabled = false;
+  fresh->process({});
+  expect_same_frame(subgraph->frame(), fresh->frame());
+}
+
+} // namespace
+} // namespace astralix::terrain
@@ -0,0 +1,377 @@
+#include "fbm.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ASTRA_FBM_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(ASTRA_FBM_X86) && (defined(__GNUC__) || defined(__clang__))
+#define ASTRA_FBM_AVX2 1
+#define ASTRA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace astralix::terrain {
+
+namespace {
+
+// Same formula as libstdc++'s std::lerp, spelled out so the batched kernels
+// have a fixed operation order to reproduce on every standard library.
+float lerp_exact(float a, float b, float t) {
+  if ((a <= 0 && b >= 0) || (a >= 0 && b <= 0))
+    return t * b + (1 - t) * a;
+
+  if (t == 1)
+    return b;
+
+  const float x = a + t * (b - a);
+  return (t > 1) == (b > a) ? (b < x ? x : b) : (b > x ? x : b);
+}
+
+float fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+float gradient(int hash, float gx, float gy) {
+  switch (hash & 3) {
+    case 0: return  gx + gy;
+    case 1: return -gx + gy;
+    case 2: return  gx - gy;
+    case 3: return -gx - gy;
+  }
+  return 0.0f;
+}
+
+float fbm_texel(const PerlinTable &table, const FbmParams &params, uint32_t x, uint32_t y) {
+  float amplitude = params.amplitude;
+  float frequency = params.frequency;
+  float value = 0.0f;
+
+  for (uint32_t octave = 0; octave < params.octaves; ++octave) {
+    float sample_x = static_cast<float>(x) * frequency;
+    float sample_y = static_cast<float>(y) * frequency;
+    value += table.noise2d(sample_x, sample_y) * amplitude;
+    frequency *= params.lacunarity;
+    amplitude *= params.persistence;
+  }
+
+  return value;
+}
+
+void fbm_row_scalar(const PerlinTable &table, const FbmParams &params, uint32_t y,
+                    uint32_t x_begin, uint32_t count, float *out) {
+  for (uint32_t index = 0; index < count; ++index) {
+    out[index] = fbm_texel(table, params, x_begin + index, y);
+  }
+}
+
+// The y terms of noise2d are shared by a whole row, so the kernels compute
+// them once per octave with the scalar operations and broadcast them. Doing
+// it up front also keeps libm calls out of the AVX2 loop.
+struct RowTerms {
+  float frequency;
+  float amplitude;
+  int32_t yi;
+  float yf;
+  float yf_minus_one;
+  float v;
+};
+
+std::vector<RowTerms> row_terms(const FbmParams &params, uint32_t y) {
+  std::vector<RowTerms> octaves(params.octaves);
+  float amplitude = params.amplitude;
+  float frequency = params.frequency;
+
+  for (auto &terms : octaves) {
+    const float sample_y = static_cast<float>(y) * frequency;
+    terms.frequency = frequency;
+    terms.amplitude = amplitude;
+    terms.yi = static_cast<int>(std::floor(sample_y)) & 255;
+    terms.yf = sample_y - std::floor(sample_y);
+    terms.yf_minus_one = terms.yf - 1.0f;
+    terms.v = fade(terms.yf);
+    frequency *= params.lacunarity;
+    amplitude *= params.persistence;
+  }
+
+  return octaves;
+}
+
+#if defined(ASTRA_FBM_X86)
+
+__m128 blend_sse2(__m128 a, __m128 b, __m128 mask) {
+  return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+}
+
+// floor() without SSE4.1. Integral inputs, including -0.0 and anything past
+// 2^23, are returned unchanged the way std::floor does.
+__m128 floor_sse2(__m128 x) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+  __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+  truncated = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), one));
+
+  const __m128 keep = _mm_or_ps(
+      _mm_cmpge_ps(_mm_and_ps(x, abs_mask), _mm_set1_ps(8388608.0f)),
+      _mm_cmpeq_ps(truncated, x));
+  return blend_sse2(truncated, x, keep);
+}
+
+__m128 fade_sse2(__m128 t) {
+  __m128 cubic = _mm_mul_ps(_mm_mul_ps(t, t), t);
+  __m128 inner = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+  inner = _mm_add_ps(_mm_mul_ps(t, inner), _mm_set1_ps(10.0f));
+  return _mm_mul_ps(cubic, inner);
+}
+
+__m128 gradient_sse2(__m128i hash, __m128 gx, __m128 gy) {
+  const __m128 flip_x = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(hash, _mm_set1_epi32(1)), 31));
+  const __m128 flip_y = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(hash, _mm_set1_epi32(2)), 30));
+  return _mm_add_ps(_mm_xor_ps(gx, flip_x), _mm_xor_ps(gy, flip_y));
+}
+
+__m128 lerp_sse2(__m128 a, __m128 b, __m128 t) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+
+  const __m128 straddles = _mm_or_ps(
+      _mm_and_ps(_mm_cmple_ps(a, zero), _mm_cmpge_ps(b, zero)),
+      _mm_and_ps(_mm_cmpge_ps(a, zero), _mm_cmple_ps(b, zero)));
+  const __m128 straddle_value =
+      _mm_add_ps(_mm_mul_ps(t, b), _mm_mul_ps(_mm_sub_ps(one, t), a));
+
+  const __m128 x = _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+  const __m128 same_side = _mm_xor_ps(
+      _mm_xor_ps(_mm_cmpgt_ps(t, one), _mm_cmpgt_ps(b, a)),
+      _mm_castsi128_ps(_mm_set1_epi32(-1)));
+  const __m128 bounded = blend_sse2(
+      blend_sse2(b, x, _mm_cmpgt_ps(b, x)),
+      blend_sse2(b, x, _mm_cmplt_ps(b, x)),
+      same_side);
+
+  return blend_sse2(blend_sse2(bounded, b, _mm_cmpeq_ps(t, one)), straddle_value, straddles);
+}
+
+__m128 noise_sse2(const PerlinTable &table, __m128 sample_x, const RowTerms &row) {
+  const __m128 floor_x = floor_sse2(sample_x);
+  const __m128i xi = _mm_and_si128(_mm_cvttps_epi32(floor_x), _mm_set1_epi32(255));
+  const __m128 xf = _mm_sub_ps(sample_x, floor_x);
+  const __m128 xf_minus_one = _mm_sub_ps(xf, _mm_set1_ps(1.0f));
+  const __m128 u = fade_sse2(xf);
+
+  alignas(16) int32_t lanes[4];
+  alignas(16) int32_t hashes[4][4];
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes), xi);
+  for (int lane = 0; lane < 4; ++lane) {
+    const int32_t a = table.perm[lanes[lane]] + row.yi;
+    const int32_t b = table.perm[lanes[lane] + 1] + row.yi;
+    hashes[0][lane] = table.perm[a];
+    hashes[1][lane] = table.perm[a + 1];
+    hashes[2][lane] = table.perm[b];
+    hashes[3][lane] = table.perm[b + 1];
+  }
+
+  const __m128 yf = _mm_set1_ps(row.yf);
+  const __m128 yf_minus_one = _mm_set1_ps(row.yf_minus_one);
+  const __m128 aa = gradient_sse2(_mm_load_si128(reinterpret_cast<const __m128i *>(hashes[0])), xf, yf);
+  const __m128 ab = gradient_sse2(_mm_load_si128(reinterpret_cast<const __m128i *>(hashes[1])), xf, yf_minus_one);
+  const __m128 ba = gradient_sse2(_mm_load_si128(reinterpret_cast<const __m128i *>(hashes[2])), xf_minus_one, yf);
+  const __m128 bb = gradient_sse2(_mm_load_si128(reinterpret_cast<const __m128i *>(hashes[3])), xf_minus_one, yf_minus_one);
+
+  const __m128 x1 = lerp_sse2(aa, ba, u);
+  const __m128 x2 = lerp_sse2(ab, bb, u);
+  return lerp_sse2(x1, x2, _mm_set1_ps(row.v));
+}
+
+void fbm_row_sse2(const PerlinTable &table, const FbmParams &params, uint32_t y,
+                  uint32_t x_begin, uint32_t count, float *out) {
+  const __m128i lane_offsets = _mm_setr_epi32(0, 1, 2, 3);
+  const std::vector<RowTerms> octaves = row_terms(params, y);
+  uint32_t index = 0;
+
+  for (; index + 4 <= count; index += 4) {
+    const __m128 texel_x = _mm_cvtepi32_ps(_mm_add_epi32(
+        _mm_set1_epi32(static_cast<int32_t>(x_begin + index)), lane_offsets));
+
+    __m128 value = _mm_setzero_ps();
+
+    for (const RowTerms &row : octaves) {
+      const __m128 sample_x = _mm_mul_ps(texel_x, _mm_set1_ps(row.frequency));
+      value = _mm_add_ps(value, _mm_mul_ps(noise_sse2(table, sample_x, row), _mm_set1_ps(row.amplitude)));
+    }
+
+    _mm_storeu_ps(out + index, value);
+  }
+
+  fbm_row_scalar(table, params, y, x_begin + index, count - index, out + index);
+}
+
+#endif
+
+#if defined(ASTRA_FBM_AVX2)
+
+ASTRA_TARGET_AVX2 __m256 fade_avx2(__m256 t) {
+  __m256 cubic = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+  __m256 inner = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+  inner = _mm256_add_ps(_mm256_mul_ps(t, inner), _mm256_set1_ps(10.0f));
+  return _mm256_mul_ps(cubic, inner);
+}
+
+ASTRA_TARGET_AVX2 __m256 gradient_avx2(__m256i hash, __m256 gx, __m256 gy) {
+  const __m256 flip_x = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(1)), 31));
+  const __m256 flip_y = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(2)), 30));
+  return _mm256_add_ps(_mm256_xor_ps(gx, flip_x), _mm256_xor_ps(gy, flip_y));
+}
+
+ASTRA_TARGET_AVX2 __m256 lerp_avx2(__m256 a, __m256 b, __m256 t) {
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+
+  const __m256 straddles = _mm256_or_ps(
+      _mm256_and_ps(_mm256_cmp_ps(a, zero, _CMP_LE_OQ), _mm256_cmp_ps(b, zero, _CMP_GE_OQ)),
+      _mm256_and_ps(_mm256_cmp_ps(a, zero, _CMP_GE_OQ), _mm256_cmp_ps(b, zero, _CMP_LE_OQ)));
+  const __m256 straddle_value =
+      _mm256_add_ps(_mm256_mul_ps(t, b), _mm256_mul_ps(_mm256_sub_ps(one, t), a));
+
+  const __m256 x = _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+  const __m256 same_side = _mm256_xor_ps(
+      _mm256_xor_ps(_mm256_cmp_ps(t, one, _CMP_GT_OQ), _mm256_cmp_ps(b, a, _CMP_GT_OQ)),
+      _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+  const __m256 bounded = _mm256_blendv_ps(
+      _mm256_blendv_ps(b, x, _mm256_cmp_ps(b, x, _CMP_GT_OQ)),
+      _mm256_blendv_ps(b, x, _mm256_cmp_ps(b, x, _CMP_LT_OQ)),
+      same_side);
+
+  return _mm256_blendv_ps(
+      _mm256_blendv_ps(bounded, b, _mm256_cmp_ps(t, one, _CMP_EQ_OQ)),
+      straddle_value, straddles);
+}
+
+ASTRA_TARGET_AVX2 __m256 noise_avx2(const PerlinTable &table, __m256 sample_x, const RowTerms &row) {
+  const __m256 floor_x = _mm256_floor_ps(sample_x);
+  const __m256i xi = _mm256_and_si256(_mm256_cvttps_epi32(floor_x), _mm256_set1_epi32(255));
+  const __m256 xf = _mm256_sub_ps(sample_x, floor_x);
+  const __m256 xf_minus_one = _mm256_sub_ps(xf, _mm256_set1_ps(1.0f));
+  const __m256 u = fade_avx2(xf);
+
+  const int *perm = table.perm.data();
+  const __m256i yi = _mm256_set1_epi32(row.yi);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i a = _mm256_add_epi32(_mm256_i32gather_epi32(perm, xi, 4), yi);
+  const __m256i b = _mm256_add_epi32(_mm256_i32gather_epi32(perm, _mm256_add_epi32(xi, one), 4), yi);
+
+  const __m256 yf = _mm256_set1_ps(row.yf);
+  const __m256 yf_minus_one = _mm256_set1_ps(row.yf_minus_one);
+  const __m256 aa = gradient_avx2(_mm256_i32gather_epi32(perm, a, 4), xf, yf);
+  const __m256 ab = gradient_avx2(_mm256_i32gather_epi32(perm, _mm256_add_epi32(a, one), 4), xf, yf_minus_one);
+  const __m256 ba = gradient_avx2(_mm256_i32gather_epi32(perm, b, 4), xf_minus_one, yf);
+  const __m256 bb = gradient_avx2(_mm256_i32gather_epi32(perm, _mm256_add_epi32(b, one), 4), xf_minus_one, yf_minus_one);
+
+  const __m256 x1 = lerp_avx2(aa, ba, u);
+  const __m256 x2 = lerp_avx2(ab, bb, u);
+  return lerp_avx2(x1, x2, _mm256_set1_ps(row.v));
+}
+
+ASTRA_TARGET_AVX2 void fbm_row_avx2(const PerlinTable &table, const FbmParams &params, uint32_t y,
+                                    uint32_t x_begin, uint32_t count, float *out) {
+  const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const std::vector<RowTerms> octaves = row_terms(params, y);
+  uint32_t index = 0;
+
+  for (; index + 8 <= count; index += 8) {
+    const __m256 texel_x = _mm256_cvtepi32_ps(_mm256_add_epi32(
+        _mm256_set1_epi32(static_cast<int32_t>(x_begin + index)), lane_offsets));
+
+    __m256 value = _mm256_setzero_ps();
+
+    for (const RowTerms &row : octaves) {
+      const __m256 sample_x = _mm256_mul_ps(texel_x, _mm256_set1_ps(row.frequency));
+      value = _mm256_add_ps(value, _mm256_mul_ps(noise_avx2(table, sample_x, row), _mm256_set1_ps(row.amplitude)));
+    }
+
+    _mm256_storeu_ps(out + index, value);
+  }
+
+  fbm_row_sse2(table, params, y, x_begin + index, count - index, out + index);
+}
+
+#endif
+
+} // namespace
+
+void PerlinTable::seed(uint32_t seed_value) {
+  std::array<int, 256> permutation;
+  std::iota(permutation.begin(), permutation.end(), 0);
+  std::mt19937 rng(seed_value);
+  std::shuffle(permutation.begin(), permutation.end(), rng);
+  for (int index = 0; index < 256; ++index) {
+    perm[index] = perm[index + 256] = permutation[index];
+  }
+}
+
+float PerlinTable::noise2d(float x, float y) const {
+  int xi = static_cast<int>(std::floor(x)) & 255;
+  int yi = static_cast<int>(std::floor(y)) & 255;
+  float xf = x - std::floor(x);
+  float yf = y - std::floor(y);
+  float u = fade(xf);
+  float v = fade(yf);
+
+  int aa = perm[perm[xi] + yi];
+  int ab = perm[perm[xi] + yi + 1];
+  int ba = perm[perm[xi + 1] + yi];
+  int bb = perm[perm[xi + 1] + yi + 1];
+
+  float x1 = lerp_exact(gradient(aa, xf, yf), gradient(ba, xf - 1.0f, yf), u);
+  float x2 = lerp_exact(gradient(ab, xf, yf - 1.0f), gradient(bb, xf - 1.0f, yf - 1.0f), u);
+  return lerp_exact(x1, x2, v);
+}
+
+FbmKernel best_fbm_kernel() {
+#if defined(ASTRA_FBM_AVX2)
+  static const FbmKernel kernel =
+      __builtin_cpu_supports("avx2") ? FbmKernel::AVX2 : FbmKernel::SSE2;
+  return kernel;
+#elif defined(ASTRA_FBM_X86)
+  return FbmKernel::SSE2;
+#else
+  return FbmKernel::Scalar;
+#endif
+}
+
+const char *fbm_kernel_name(FbmKernel kernel) {
+  switch (kernel) {
+    case FbmKernel::Scalar:
+      return "Scalar";
+    case FbmKernel::SSE2:
+      return "SSE2";
+    case FbmKernel::AVX2:
+      return "AVX2";
+  }
+
+  return "Unknown";
+}
+
+void fbm_row(const PerlinTable &table, const FbmParams &params, uint32_t y,
+             uint32_t x_begin, uint32_t count, float *out, FbmKernel kernel) {
+  switch (kernel) {
+#if defined(ASTRA_FBM_AVX2)
+    case FbmKernel::AVX2:
+      fbm_row_avx2(table, params, y, x_begin, count, out);
+      return;
+#endif
+#if defined(ASTRA_FBM_X86)
+    case FbmKernel::SSE2:
+      fbm_row_sse2(table, params, y, x_begin, count, out);
+      return;
+#endif
+    default:
+      fbm_row_scalar(table, params, y, x_begin, count, out);
+      return;
+  }
+}
+
+} // namespace astralix::terrain
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace astralix::terrain {
+
+struct PerlinTable {
+  std::array<int32_t, 512> perm;
+
+  void seed(uint32_t seed_value);
+
+  // Scalar reference every batched kernel has to match bit for bit.
+  float noise2d(float x, float y) const;
+};
+
+struct FbmParams {
+  uint32_t octaves = 6;
+  float frequency = 0.005f;
+  float lacunarity = 2.0f;
+  float persistence = 0.5f;
+  float amplitude = 1.0f;
+};
+
+enum class FbmKernel : uint8_t {
+  Scalar,
+  SSE2,
+  AVX2,
+};
+
+// Widest kernel the running CPU supports.
+FbmKernel best_fbm_kernel();
+const char *fbm_kernel_name(FbmKernel kernel);
+
+// Writes fBm at texels (x_begin + i, y) for i in [0, count) to out[i]. Every
+// kernel evaluates the same operations in the same order as
+// PerlinTable::noise2d, so the choice of kernel never changes the result.
+void fbm_row(const PerlinTable &table, const FbmParams &params, uint32_t y,
+             uint32_t x_begin, uint32_t count, float *out,
+             FbmKernel kernel = best_fbm_kernel());
+
+} // namespace astralix::terrain
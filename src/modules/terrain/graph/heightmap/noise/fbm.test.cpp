@@ -0,0 +1,141 @@
+#include "fbm.hpp"
+#include "graph/heightmap/passes/noise-pass.hpp"
+#include "helpers/benchmark.hpp"
+#include "systems/job-system/job-system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace astralix::terrain {
+namespace {
+
+// NoisePass before the batched kernels, kept to pin existing recipes.
+float legacy_noise2d(const PerlinTable &table, float x, float y) {
+  const auto &perm = table.perm;
+  int xi = static_cast<int>(std::floor(x)) & 255;
+  int yi = static_cast<int>(std::floor(y)) & 255;
+  float xf = x - std::floor(x);
+  float yf = y - std::floor(y);
+  float u = xf * xf * xf * (xf * (xf * 6.0f - 15.0f) + 10.0f);
+  float v = yf * yf * yf * (yf * (yf * 6.0f - 15.0f) + 10.0f);
+
+  int aa = perm[perm[xi] + yi];
+  int ab = perm[perm[xi] + yi + 1];
+  int ba = perm[perm[xi + 1] + yi];
+  int bb = perm[perm[xi + 1] + yi + 1];
+
+  auto grad = [](int hash, float gx, float gy) -> float {
+    switch (hash & 3) {
+      case 0: return  gx + gy;
+      case 1: return -gx + gy;
+      case 2: return  gx - gy;
+      case 3: return -gx - gy;
+    }
+    return 0.0f;
+  };
+
+  float x1 = std::lerp(grad(aa, xf, yf), grad(ba, xf - 1.0f, yf), u);
+  float x2 = std::lerp(grad(ab, xf, yf - 1.0f), grad(bb, xf - 1.0f, yf - 1.0f), u);
+  return std::lerp(x1, x2, v);
+}
+
+std::vector<FbmKernel> supported_kernels() {
+  std::vector<FbmKernel> kernels{FbmKernel::Scalar};
+  if (best_fbm_kernel() != FbmKernel::Scalar)
+    kernels.push_back(FbmKernel::SSE2);
+  if (best_fbm_kernel() == FbmKernel::AVX2)
+    kernels.push_back(FbmKernel::AVX2);
+  return kernels;
+}
+
+void expect_bit_exact(const std::vector<float> &expected, const std::vector<float> &actual,
+                      FbmKernel kernel) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t index = 0; index < expected.size(); ++index) {
+    ASSERT_EQ(std::bit_cast<uint32_t>(expected[index]), std::bit_cast<uint32_t>(actual[index]))
+        << fbm_kernel_name(kernel) << " texel " << index;
+  }
+}
+
+TEST(FbmTest, ScalarReferenceMatchesLegacyNoise) {
+  PerlinTable table;
+  table.seed(42);
+
+  for (int y = -300; y < 300; y += 7) {
+    for (int x = -1000; x < 1000; ++x) {
+      const float sample_x = static_cast<float>(x) * 0.137f;
+      const float sample_y = static_cast<float>(y) * 0.291f;
+      ASSERT_EQ(std::bit_cast<uint32_t>(table.noise2d(sample_x, sample_y)),
+                std::bit_cast<uint32_t>(legacy_noise2d(table, sample_x, sample_y)));
+    }
+  }
+}
+
+TEST(FbmTest, KernelsAreBitExactWithScalarReference) {
+  const FbmParams cases[] = {
+      {},
+      {.octaves = 8, .frequency = 0.0131f, .lacunarity = 2.03f, .persistence = 0.47f},
+      {.octaves = 3, .frequency = -0.021f, .lacunarity = 1.7f, .persistence = 0.6f, .amplitude = 2.5f},
+      {.octaves = 4, .frequency = 3.1f, .lacunarity = 2.0f, .persistence = 0.5f},
+  };
+
+  PerlinTable table;
+  table.seed(1234);
+
+  for (const auto &params : cases) {
+    for (uint32_t y : {0u, 1u, 511u, 4095u}) {
+      // Odd offsets and lengths exercise the scalar tails.
+      const uint32_t x_begin = 3u;
+      const uint32_t count = 4093u;
+
+      std::vector<float> expected(count);
+      fbm_row(table, params, y, x_begin, count, expected.data(), FbmKernel::Scalar);
+
+      for (FbmKernel kernel : supported_kernels()) {
+        std::vector<float> actual(count);
+        fbm_row(table, params, y, x_begin, count, actual.data(), kernel);
+        expect_bit_exact(expected, actual, kernel);
+      }
+    }
+  }
+}
+
+TEST(FbmBenchmark, DISABLED_NoisePassResolution2048) {
+  TerrainRecipeData recipe;
+  recipe.resolution = 2048;
+
+  PerlinTable table;
+  table.seed(recipe.noise.seed);
+  const FbmParams params{};
+  std::vector<float> row(recipe.resolution);
+
+  const double scalar_ms = testing::elapsed_ms([&]() {
+    for (uint32_t y = 0; y < recipe.resolution; ++y) {
+      fbm_row(table, params, y, 0u, recipe.resolution, row.data(), FbmKernel::Scalar);
+    }
+  });
+
+  JobSystem jobs(JobSystem::Config{.worker_count = testing::benchmark_worker_count()});
+  jobs.start();
+  const uint32_t workers = jobs.worker_count();
+
+  HeightmapFrame frame;
+  const double pass_ms = testing::elapsed_ms([&]() { NoisePass().process(frame, recipe); });
+  jobs.end();
+
+  std::printf(
+      "[FbmBenchmark] %ux%u, %u octaves: scalar rows %.1f ms, NoisePass (%s, %u workers) %.1f ms\n",
+      recipe.resolution, recipe.resolution, params.octaves, scalar_ms,
+      fbm_kernel_name(best_fbm_kernel()), workers, pass_ms
+  );
+  testing::record_ms("scalar", scalar_ms);
+  testing::record_ms("pass", pass_ms);
+}
+
+} // namespace
+} // namespace astralix::terrain
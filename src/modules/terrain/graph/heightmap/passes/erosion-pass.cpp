@@ -1,160 +1,340 @@
 #include "erosion-pass.hpp"
+#include "systems/job-system/parallel.hpp"
 #include "trace.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <random>
 #include <utility>
 #include <vector>
 
 namespace astralix::terrain {
 
-void ErosionPass::process(HeightmapFrame &frame, const TerrainRecipeData &recipe) {
-  ASTRA_PROFILE_N("ErosionPass::process");
+namespace {
 
-  const auto &erosion = recipe.erosion;
-  const uint32_t resolution = frame.resolution;
+struct ErosionBrush {
+  std::vector<std::pair<int, int>> offsets;
+  std::vector<float> weights;
+};
 
-  if (resolution == 0 || frame.heightmap.empty())
-    return;
+// Region a droplet may travel in, in texels: nodes in [min, max) on both axes.
+struct DropletBounds {
+  int min_x;
+  int min_y;
+  int max_x;
+  int max_y;
+};
 
-  std::mt19937 rng(recipe.noise.seed + 1);
-  std::uniform_real_distribution<float> distribution(0.0f, static_cast<float>(resolution - 1));
-
-  std::vector<std::pair<int, int>> brush_offsets;
-  std::vector<float> brush_weights;
+ErosionBrush build_brush(uint32_t erode_radius) {
+  ErosionBrush brush;
   float weight_sum = 0.0f;
 
-  int radius = static_cast<int>(erosion.erode_radius);
+  int radius = static_cast<int>(erode_radius);
   for (int dy = -radius; dy <= radius; ++dy) {
     for (int dx = -radius; dx <= radius; ++dx) {
       float distance = std::sqrt(static_cast<float>(dx * dx + dy * dy));
       if (distance <= static_cast<float>(radius)) {
         float weight = std::max(0.0f, static_cast<float>(radius) - distance);
-        brush_offsets.emplace_back(dx, dy);
-        brush_weights.push_back(weight);
+        brush.offsets.emplace_back(dx, dy);
+        brush.weights.push_back(weight);
         weight_sum += weight;
       }
     }
   }
-  for (auto &weight : brush_weights)
-    weight /= weight_sum;
-
-  auto gradient_at = [&](float px, float py) -> glm::vec2 {
-    int x0 = std::clamp(static_cast<int>(px), 0, static_cast<int>(resolution) - 2);
-    int y0 = std::clamp(static_cast<int>(py), 0, static_cast<int>(resolution) - 2);
-    float u = px - static_cast<float>(x0);
-    float v = py - static_cast<float>(y0);
-
-    float h00 = frame.heightmap[y0 * resolution + x0];
-    float h10 = frame.heightmap[y0 * resolution + x0 + 1];
-    float h01 = frame.heightmap[(y0 + 1) * resolution + x0];
-    float h11 = frame.heightmap[(y0 + 1) * resolution + x0 + 1];
-
-    float gx = (h10 - h00) * (1 - v) + (h11 - h01) * v;
-    float gy = (h01 - h00) * (1 - u) + (h11 - h10) * u;
-    return {gx, gy};
+
+  if (weight_sum > 0.0f) {
+    for (auto &weight : brush.weights)
+      weight /= weight_sum;
+  }
+
+  return brush;
+}
+
+// splitmix64 finalizer. Hashing (seed, tile, droplet, axis) gives every
+// droplet its own stream, so results do not depend on which thread runs it.
+uint64_t mix_bits(uint64_t value) {
+  value += 0x9e3779b97f4a7c15ull;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+float counter_random(uint64_t seed, uint64_t tile, uint64_t droplet, uint64_t axis) {
+  uint64_t hash = mix_bits(seed);
+  hash = mix_bits(hash ^ tile);
+  hash = mix_bits(hash ^ droplet);
+  hash = mix_bits(hash ^ axis);
+  return static_cast<float>(hash >> 40) * (1.0f / 16777216.0f);
+}
+
+void simulate_droplet(HeightmapFrame &frame, const ErosionConfig &erosion,
+                      const ErosionBrush &brush, const DropletBounds &bounds,
+                      float px, float py) {
+  const int resolution = static_cast<int>(frame.resolution);
+  float *heights = frame.heightmap.data();
+  float *erosion_map = frame.erosion_map.data();
+
+  auto height_at = [&](float x, float y) -> float {
+    int x0 = static_cast<int>(x);
+    int y0 = static_cast<int>(y);
+    float u = x - static_cast<float>(x0);
+    float v = y - static_cast<float>(y0);
+    const float *row = heights + y0 * resolution + x0;
+
+    return (row[0] * (1 - u) + row[1] * u) * (1 - v) +
+           (row[resolution] * (1 - u) + row[resolution + 1] * u) * v;
   };
 
+  float dx = 0.0f, dy = 0.0f;
+  float speed = 1.0f;
+  float water = 1.0f;
+  float sediment = 0.0f;
+
+  for (uint32_t step = 0; step < erosion.drop_lifetime; ++step) {
+    int node_x = static_cast<int>(px);
+    int node_y = static_cast<int>(py);
+
+    if (node_x < bounds.min_x || node_x >= bounds.max_x ||
+        node_y < bounds.min_y || node_y >= bounds.max_y)
+      break;
+
+    float frac_x = px - static_cast<float>(node_x);
+    float frac_y = py - static_cast<float>(node_y);
+
+    int i00 = node_y * resolution + node_x;
+    int i10 = i00 + 1;
+    int i01 = i00 + resolution;
+    int i11 = i01 + 1;
+
+    float h00 = heights[i00];
+    float h10 = heights[i10];
+    float h01 = heights[i01];
+    float h11 = heights[i11];
+
+    float gradient_x = (h10 - h00) * (1 - frac_y) + (h11 - h01) * frac_y;
+    float gradient_y = (h01 - h00) * (1 - frac_x) + (h11 - h10) * frac_x;
+
+    dx = dx * erosion.inertia - gradient_x * (1.0f - erosion.inertia);
+    dy = dy * erosion.inertia - gradient_y * (1.0f - erosion.inertia);
+
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length < 1e-6f)
+      break;
+    dx /= length;
+    dy /= length;
+
+    float new_px = px + dx;
+    float new_py = py + dy;
+
+    if (new_px < static_cast<float>(bounds.min_x) ||
+        new_px >= static_cast<float>(bounds.max_x) ||
+        new_py < static_cast<float>(bounds.min_y) ||
+        new_py >= static_cast<float>(bounds.max_y))
+      break;
+
+    float old_height = (h00 * (1 - frac_x) + h10 * frac_x) * (1 - frac_y) +
+                       (h01 * (1 - frac_x) + h11 * frac_x) * frac_y;
+    float new_height = height_at(new_px, new_py);
+    float height_diff = new_height - old_height;
+
+    float capacity = std::max(-height_diff * speed * water * erosion.sediment_capacity, erosion.min_sediment_capacity);
+
+    if (sediment > capacity || height_diff > 0) {
+      float deposit = (height_diff > 0)
+                          ? std::min(height_diff, sediment)
+                          : (sediment - capacity) * erosion.deposit_speed;
+
+      sediment -= deposit;
+
+      float w00 = (1.0f - frac_x) * (1.0f - frac_y);
+      float w10 = frac_x * (1.0f - frac_y);
+      float w01 = (1.0f - frac_x) * frac_y;
+      float w11 = frac_x * frac_y;
+
+      heights[i00] = std::clamp(h00 + deposit * w00, 0.0f, 1.0f);
+      heights[i10] = std::clamp(h10 + deposit * w10, 0.0f, 1.0f);
+      heights[i01] = std::clamp(h01 + deposit * w01, 0.0f, 1.0f);
+      heights[i11] = std::clamp(h11 + deposit * w11, 0.0f, 1.0f);
+      erosion_map[i00] += deposit * w00;
+      erosion_map[i10] += deposit * w10;
+      erosion_map[i01] += deposit * w01;
+      erosion_map[i11] += deposit * w11;
+    } else {
+      float erode_amount = std::min((capacity - sediment) * erosion.erode_speed, -height_diff);
+
+      for (size_t brush_index = 0; brush_index < brush.offsets.size(); ++brush_index) {
+        int bx = node_x + brush.offsets[brush_index].first;
+        int by = node_y + brush.offsets[brush_index].second;
+        if (bx >= 0 && bx < resolution && by >= 0 && by < resolution) {
+          int bidx = by * resolution + bx;
+          float delta = erode_amount * brush.weights[brush_index];
+          heights[bidx] = std::clamp(heights[bidx] - delta, 0.0f, 1.0f);
+          erosion_map[bidx] -= delta;
+        }
+      }
+      sediment += erode_amount;
+    }
+
+    speed = std::sqrt(std::max(speed * speed + height_diff * erosion.gravity, 0.0f));
+    water *= (1.0f - erosion.evaporate_speed);
+    px = new_px;
+    py = new_py;
+  }
+}
+
+void erode_serial(HeightmapFrame &frame, const ErosionConfig &erosion,
+                  const ErosionBrush &brush, uint32_t seed) {
+  const int resolution = static_cast<int>(frame.resolution);
+
+  std::mt19937 rng(seed + 1);
+  std::uniform_real_distribution<float> distribution(0.0f, static_cast<float>(resolution - 1));
+
+  const DropletBounds bounds{0, 0, resolution - 1, resolution - 1};
+
   for (uint32_t iteration = 0; iteration < erosion.iterations; ++iteration) {
     float px = distribution(rng);
     float py = distribution(rng);
-    float dx = 0.0f, dy = 0.0f;
-    float speed = 1.0f;
-    float water = 1.0f;
-    float sediment = 0.0f;
-
-    for (uint32_t step = 0; step < erosion.drop_lifetime; ++step) {
-      int node_x = static_cast<int>(px);
-      int node_y = static_cast<int>(py);
-
-      if (node_x < 0 || node_x >= static_cast<int>(resolution) - 1 ||
-          node_y < 0 || node_y >= static_cast<int>(resolution) - 1)
-        break;
-
-      glm::vec2 gradient = gradient_at(px, py);
-
-      dx = dx * erosion.inertia - gradient.x * (1.0f - erosion.inertia);
-      dy = dy * erosion.inertia - gradient.y * (1.0f - erosion.inertia);
-
-      float length = std::sqrt(dx * dx + dy * dy);
-      if (length < 1e-6f)
-        break;
-      dx /= length;
-      dy /= length;
-
-      float new_px = px + dx;
-      float new_py = py + dy;
-
-      if (new_px < 0 || new_px >= static_cast<float>(resolution) - 1 ||
-          new_py < 0 || new_py >= static_cast<float>(resolution) - 1)
-        break;
-
-      float old_height = frame.sample_height(px / static_cast<float>(resolution - 1), py / static_cast<float>(resolution - 1));
-      float new_height = frame.sample_height(new_px / static_cast<float>(resolution - 1), new_py / static_cast<float>(resolution - 1));
-      float height_diff = new_height - old_height;
-
-      float capacity = std::max(-height_diff * speed * water * erosion.sediment_capacity, erosion.min_sediment_capacity);
-
-      if (sediment > capacity || height_diff > 0) {
-        float deposit = (height_diff > 0)
-                            ? std::min(height_diff, sediment)
-                            : (sediment - capacity) * erosion.deposit_speed;
-
-        sediment -= deposit;
-
-        float frac_x = px - static_cast<float>(node_x);
-        float frac_y = py - static_cast<float>(node_y);
-        int x1 = std::min(node_x + 1, static_cast<int>(resolution) - 1);
-        int y1 = std::min(node_y + 1, static_cast<int>(resolution) - 1);
-        float w00 = (1.0f - frac_x) * (1.0f - frac_y);
-        float w10 = frac_x * (1.0f - frac_y);
-        float w01 = (1.0f - frac_x) * frac_y;
-        float w11 = frac_x * frac_y;
-
-        int i00 = node_y * static_cast<int>(resolution) + node_x;
-        int i10 = node_y * static_cast<int>(resolution) + x1;
-        int i01 = y1 * static_cast<int>(resolution) + node_x;
-        int i11 = y1 * static_cast<int>(resolution) + x1;
-
-        frame.heightmap[i00] = std::clamp(frame.heightmap[i00] + deposit * w00, 0.0f, 1.0f);
-        frame.heightmap[i10] = std::clamp(frame.heightmap[i10] + deposit * w10, 0.0f, 1.0f);
-        frame.heightmap[i01] = std::clamp(frame.heightmap[i01] + deposit * w01, 0.0f, 1.0f);
-        frame.heightmap[i11] = std::clamp(frame.heightmap[i11] + deposit * w11, 0.0f, 1.0f);
-        frame.erosion_map[i00] += deposit * w00;
-        frame.erosion_map[i10] += deposit * w10;
-        frame.erosion_map[i01] += deposit * w01;
-        frame.erosion_map[i11] += deposit * w11;
-      } else {
-        float erode_amount = std::min((capacity - sediment) * erosion.erode_speed, -height_diff);
-
-        for (size_t brush_index = 0; brush_index < brush_offsets.size(); ++brush_index) {
-          int bx = node_x + brush_offsets[brush_index].first;
-          int by = node_y + brush_offsets[brush_index].second;
-          if (bx >= 0 && bx < static_cast<int>(resolution) &&
-              by >= 0 && by < static_cast<int>(resolution)) {
-            int bidx = by * static_cast<int>(resolution) + bx;
-            float delta = erode_amount * brush_weights[brush_index];
-            frame.heightmap[bidx] = std::clamp(frame.heightmap[bidx] - delta, 0.0f, 1.0f);
-            frame.erosion_map[bidx] -= delta;
-          }
+    simulate_droplet(frame, erosion, brush, bounds, px, py);
+  }
+}
+
+// Splits the map into square tiles and colors them 2x2, so tiles of one color
+// are a full tile apart. Each droplet stays within its tile core widened by a
+// halo small enough that neither its brush nor its bilinear reads reach a
+// same-colored neighbour, which lets the tiles of a phase run in parallel
+// without locks. Phases run in a fixed order and droplets draw their start
+// from a counter-based hash, so a seed yields the same map on any thread
+// count.
+void erode_tiled(HeightmapFrame &frame, const ErosionConfig &erosion,
+                 const ErosionBrush &brush, uint32_t seed) {
+  const int resolution = static_cast<int>(frame.resolution);
+  const int radius = static_cast<int>(erosion.erode_radius);
+
+  // Smallest tile that still leaves the brush a one texel halo.
+  const int min_tile = 2 * (radius + 3);
+  const int tile_size = std::max(static_cast<int>(erosion.tile_size), min_tile);
+  const int halo = tile_size / 2 - radius - 2;
+
+  const int tiles_per_axis = (resolution + tile_size - 1) / tile_size;
+  const uint64_t total_texels = static_cast<uint64_t>(resolution) * resolution;
+
+  struct Tile {
+    uint32_t index;
+    int x0, y0, x1, y1;
+    uint64_t first_droplet;
+    uint64_t droplet_count;
+  };
+
+  // Droplets are shared out by core area; cumulative rounding keeps the total
+  // exact and the split independent of the phase order.
+  std::vector<Tile> tiles;
+  tiles.reserve(static_cast<size_t>(tiles_per_axis) * tiles_per_axis);
+  uint64_t covered_texels = 0;
+  uint64_t next_droplet = 0;
+
+  for (int tile_y = 0; tile_y < tiles_per_axis; ++tile_y) {
+    for (int tile_x = 0; tile_x < tiles_per_axis; ++tile_x) {
+      Tile tile;
+      tile.index = static_cast<uint32_t>(tile_y * tiles_per_axis + tile_x);
+      tile.x0 = tile_x * tile_size;
+      tile.y0 = tile_y * tile_size;
+      tile.x1 = std::min(tile.x0 + tile_size, resolution);
+      tile.y1 = std::min(tile.y0 + tile_size, resolution);
+
+      covered_texels += static_cast<uint64_t>(tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+      const uint64_t end_droplet = erosion.iterations * covered_texels / total_texels;
+      tile.first_droplet = next_droplet;
+      tile.droplet_count = end_droplet - next_droplet;
+      next_droplet = end_droplet;
+
+      tiles.push_back(tile);
+    }
+  }
+
+  std::vector<const Tile *> phase_tiles;
+  phase_tiles.reserve(tiles.size());
+
+  for (int phase = 0; phase < 4; ++phase) {
+    ASTRA_PROFILE_N("ErosionPass::phase");
+
+    phase_tiles.clear();
+    for (const auto &tile : tiles) {
+      const int tile_x = tile.x0 / tile_size;
+      const int tile_y = tile.y0 / tile_size;
+      if ((tile_x & 1) + 2 * (tile_y & 1) == phase && tile.droplet_count > 0)
+        phase_tiles.push_back(&tile);
+    }
+
+    parallel_for(0u, phase_tiles.size(), 1u, [&](size_t begin, size_t end) {
+      for (size_t slot = begin; slot < end; ++slot) {
+        const Tile &tile = *phase_tiles[slot];
+
+        const DropletBounds bounds{
+            std::max(tile.x0 - halo, 0),
+            std::max(tile.y0 - halo, 0),
+            std::min(tile.x1 + halo, resolution - 1),
+            std::min(tile.y1 + halo, resolution - 1),
+        };
+
+        const float span_x = static_cast<float>(std::min(tile.x1, resolution - 1) - tile.x0);
+        const float span_y = static_cast<float>(std::min(tile.y1, resolution - 1) - tile.y0);
+
+        for (uint64_t droplet = 0; droplet < tile.droplet_count; ++droplet) {
+          const uint64_t id = tile.first_droplet + droplet;
+          float px = static_cast<float>(tile.x0) + counter_random(seed, tile.index, id, 0) * span_x;
+          float py = static_cast<float>(tile.y0) + counter_random(seed, tile.index, id, 1) * span_y;
+          simulate_droplet(frame, erosion, brush, bounds, px, py);
         }
-        sediment += erode_amount;
       }
+    });
+  }
+}
 
-      speed = std::sqrt(std::max(speed * speed + height_diff * erosion.gravity, 0.0f));
-      water *= (1.0f - erosion.evaporate_speed);
-      px = new_px;
-      py = new_py;
-    }
+} // namespace
+
+void ErosionPass::process(HeightmapFrame &frame, const TerrainRecipeData &recipe) {
+  ASTRA_PROFILE_N("ErosionPass::process");
+
+  const auto &erosion = recipe.erosion;
+  const uint32_t resolution = frame.resolution;
+
+  if (resolution < 2 || frame.heightmap.empty())
+    return;
+
+  // The map accumulates per droplet, and the subgraph may rerun this pass on
+  // a frame that still holds the previous result.
+  std::fill(frame.erosion_map.begin(), frame.erosion_map.end(), 0.0f);
+
+  const ErosionBrush brush = build_brush(erosion.erode_radius);
+
+  if (erosion.mode == "tiled") {
+    erode_tiled(frame, erosion, brush, recipe.noise.seed);
+  } else {
+    erode_serial(frame, erosion, brush, recipe.noise.seed);
   }
 
-  float min_height = *std::min_element(frame.heightmap.begin(), frame.heightmap.end());
-  float max_height = *std::max_element(frame.heightmap.begin(), frame.heightmap.end());
+  constexpr size_t k_texel_grain = 64u * 1024u;
+  const size_t texel_count = frame.heightmap.size();
+
+  auto [min_height, max_height] = parallel_reduce(
+      0u, texel_count, k_texel_grain,
+      std::pair{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()},
+      [&](size_t begin, size_t end) {
+        auto [low, high] = std::minmax_element(frame.heightmap.begin() + begin,
+                                               frame.heightmap.begin() + end);
+        return std::pair{*low, *high};
+      },
+      [](std::pair<float, float> left, std::pair<float, float> right) {
+        return std::pair{std::min(left.first, right.first), std::max(left.second, right.second)};
+      });
+
   float range = max_height - min_height;
   if (range > 0.0f) {
-    for (auto &height : frame.heightmap) {
-      height = (height - min_height) / range;
-    }
+    parallel_for(0u, texel_count, k_texel_grain, [&](size_t begin, size_t end) {
+      for (size_t texel = begin; texel < end; ++texel) {
+        frame.heightmap[texel] = (frame.heightmap[texel] - min_height) / range;
+      }
+    });
   }
 }
 
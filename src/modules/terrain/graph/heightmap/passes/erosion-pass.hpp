@@ -10,10 +10,12 @@ public:
   std::string_view name() const override { return "Erosion"; }
   std::span<const HeightmapField> reads() const override { return s_reads; }
   std::span<const HeightmapField> writes() const override { return s_writes; }
+  std::span<const TerrainRecipeField> recipe_reads() const override { return s_recipe_reads; }
 
 private:
   static constexpr HeightmapField s_reads[] = {HeightmapField::Heightmap};
   static constexpr HeightmapField s_writes[] = {HeightmapField::Heightmap, HeightmapField::ErosionMap};
+  static constexpr TerrainRecipeField s_recipe_reads[] = {TerrainRecipeField::Noise, TerrainRecipeField::Erosion};
 };
 
 } // namespace astralix::terrain
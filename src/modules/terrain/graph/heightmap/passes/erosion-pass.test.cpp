@@ -0,0 +1,117 @@
+#include "erosion-pass.hpp"
+#include "helpers/benchmark.hpp"
+#include "systems/job-system/job-system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace astralix::terrain {
+namespace {
+
+HeightmapFrame make_frame(uint32_t resolution) {
+  HeightmapFrame frame;
+  frame.allocate(resolution);
+
+  for (uint32_t y = 0; y < resolution; ++y) {
+    for (uint32_t x = 0; x < resolution; ++x) {
+      const float fx = static_cast<float>(x) / static_cast<float>(resolution);
+      const float fy = static_cast<float>(y) / static_cast<float>(resolution);
+      frame.heightmap[y * resolution + x] =
+          0.5f + 0.25f * std::sin(fx * 9.0f) * std::cos(fy * 7.0f) +
+          0.125f * std::sin((fx + fy) * 23.0f);
+    }
+  }
+
+  return frame;
+}
+
+TerrainRecipeData make_recipe(const char *mode, uint32_t iterations) {
+  TerrainRecipeData recipe;
+  recipe.noise.seed = 7;
+  recipe.erosion.mode = mode;
+  recipe.erosion.iterations = iterations;
+  recipe.erosion.tile_size = 64;
+  return recipe;
+}
+
+HeightmapFrame erode(const TerrainRecipeData &recipe, uint32_t resolution) {
+  auto frame = make_frame(resolution);
+  ErosionPass().process(frame, recipe);
+  return frame;
+}
+
+double erode_milliseconds(const TerrainRecipeData &recipe, uint32_t resolution) {
+  auto frame = make_frame(resolution);
+  return testing::elapsed_ms([&]() { ErosionPass().process(frame, recipe); });
+}
+
+TEST(ErosionPassTest, TiledModeIsIndependentOfWorkerCount) {
+  const auto recipe = make_recipe("tiled", 20000);
+  const auto inline_frame = erode(recipe, 257);
+
+  for (uint32_t workers : {1u, 4u}) {
+    JobSystem jobs(JobSystem::Config{.worker_count = workers});
+    jobs.start();
+    const auto frame = erode(recipe, 257);
+    jobs.end();
+
+    EXPECT_EQ(frame.heightmap, inline_frame.heightmap) << "workers=" << workers;
+    EXPECT_EQ(frame.erosion_map, inline_frame.erosion_map) << "workers=" << workers;
+  }
+}
+
+TEST(ErosionPassTest, TiledModeDependsOnSeed) {
+  auto recipe = make_recipe("tiled", 5000);
+  const auto first = erode(recipe, 129);
+
+  recipe.noise.seed += 1;
+  const auto second = erode(recipe, 129);
+
+  EXPECT_NE(first.erosion_map, second.erosion_map);
+}
+
+TEST(ErosionPassTest, BothModesErodeAndRenormalize) {
+  for (const char *mode : {"serial", "tiled"}) {
+    const auto frame = erode(make_recipe(mode, 5000), 129);
+    const auto [low, high] =
+        std::minmax_element(frame.heightmap.begin(), frame.heightmap.end());
+
+    EXPECT_FLOAT_EQ(*low, 0.0f) << mode;
+    EXPECT_FLOAT_EQ(*high, 1.0f) << mode;
+    EXPECT_TRUE(std::any_of(
+        frame.erosion_map.begin(), frame.erosion_map.end(),
+        [](float value) { return value != 0.0f; }
+    )) << mode;
+  }
+}
+
+TEST(ErosionPassBenchmark, DISABLED_SerialVersusTiled) {
+  constexpr uint32_t k_resolution = 1025;
+  constexpr uint32_t k_iterations = 200000;
+
+  const double serial_ms =
+      erode_milliseconds(make_recipe("serial", k_iterations), k_resolution);
+
+  auto tiled = make_recipe("tiled", k_iterations);
+  tiled.erosion.tile_size = 128;
+
+  JobSystem jobs(JobSystem::Config{.worker_count = testing::benchmark_worker_count()});
+  jobs.start();
+  const uint32_t workers = jobs.worker_count();
+  const double tiled_ms = erode_milliseconds(tiled, k_resolution);
+  jobs.end();
+
+  std::printf(
+      "[ErosionPassBenchmark] %ux%u, %u droplets: serial %.1f ms, tiled %.1f ms "
+      "(%u workers)\n",
+      k_resolution, k_resolution, k_iterations, serial_ms, tiled_ms, workers
+  );
+  testing::record_ms("serial", serial_ms);
+  testing::record_ms("tiled", tiled_ms);
+}
+
+} // namespace
+} // namespace astralix::terrain
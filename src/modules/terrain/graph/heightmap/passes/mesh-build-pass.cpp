@@ -1,65 +1,197 @@
 #include "mesh-build-pass.hpp"
+#include "systems/job-system/parallel.hpp"
 #include "trace.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 
 namespace astralix::terrain {
 
-void MeshBuildPass::process(HeightmapFrame &frame, const TerrainRecipeData &recipe) {
-  ASTRA_PROFILE_N("MeshBuildPass::process");
+namespace {
 
-  frame.clipmap_rings.clear();
-  frame.clipmap_rings.reserve(m_clipmap_levels);
+// Each level covers twice the extent of the one inside it, so the hole is
+// the middle half of the grid.
+bool cell_in_hole(uint32_t cells, uint32_t cell_x, uint32_t cell_y) {
+  const uint32_t low = cells / 4;
+  const uint32_t high = cells - low;
+  return cell_x >= low && cell_x < high && cell_y >= low && cell_y < high;
+}
 
-  uint32_t resolution = frame.resolution;
-  if (resolution == 0) return;
+bool vertex_in_hole(uint32_t cells, uint32_t gx, uint32_t gy) {
+  const uint32_t low = cells / 4;
+  const uint32_t high = cells - low;
+  return gx > low && gx < high && gy > low && gy < high;
+}
 
-  float world_size = frame.tile_world_size;
-  float texel_world = world_size / static_cast<float>(resolution - 1);
+Ref<const ClipmapTopology> build_topology(uint32_t cells, bool has_hole) {
+  ASTRA_PROFILE_N("MeshBuildPass::build_topology");
 
-  for (uint32_t level = 0; level < m_clipmap_levels; ++level) {
-    ClipmapRing ring;
-    ring.level = level;
+  auto topology = create_ref<ClipmapTopology>();
+  topology->cells_per_side = cells;
+  topology->has_hole = has_hole;
+
+  const uint32_t side = cells + 1;
+  constexpr uint32_t k_unused = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> remap(static_cast<size_t>(side) * side, k_unused);
+  topology->grid.reserve(remap.size() * 2);
+
+  for (uint32_t gy = 0; gy < side; ++gy) {
+    for (uint32_t gx = 0; gx < side; ++gx) {
+      if (has_hole && vertex_in_hole(cells, gx, gy)) continue;
+      remap[gy * side + gx] = topology->vertex_count();
+      topology->grid.push_back(static_cast<uint16_t>(gx));
+      topology->grid.push_back(static_cast<uint16_t>(gy));
+    }
+  }
 
-    uint32_t step = 1u << level;
-    uint32_t grid_resolution = m_ring_vertices;
+  topology->indices.reserve(static_cast<size_t>(cells) * cells * 6);
+  for (uint32_t cy = 0; cy < cells; ++cy) {
+    for (uint32_t cx = 0; cx < cells; ++cx) {
+      if (has_hole && cell_in_hole(cells, cx, cy)) continue;
 
-    uint32_t inner_step = (level > 0) ? (1u << (level - 1)) : 0;
+      // Same winding and diagonal as a full-resolution heightmap grid.
+      const uint32_t top_left = remap[cy * side + cx];
+      const uint32_t top_right = remap[cy * side + cx + 1];
+      const uint32_t bottom_left = remap[(cy + 1) * side + cx];
+      const uint32_t bottom_right = remap[(cy + 1) * side + cx + 1];
 
-    for (uint32_t gy = 0; gy < grid_resolution; ++gy) {
-      for (uint32_t gx = 0; gx < grid_resolution; ++gx) {
-        uint32_t hx = gx * step;
-        uint32_t hy = gy * step;
+      topology->indices.push_back(top_left);
+      topology->indices.push_back(bottom_left);
+      topology->indices.push_back(top_right);
 
-        if (hx >= resolution || hy >= resolution) continue;
+      topology->indices.push_back(top_right);
+      topology->indices.push_back(bottom_left);
+      topology->indices.push_back(bottom_right);
+    }
+  }
 
-        if (level > 0 && gx > 0 && gx < grid_resolution - 1 &&
-            gy > 0 && gy < grid_resolution - 1) {
-          uint32_t inner_grid = grid_resolution;
-          uint32_t inner_gx = gx * step / inner_step;
-          uint32_t inner_gy = gy * step / inner_step;
-          if (inner_gx > 0 && inner_gx < inner_grid - 1 &&
-              inner_gy > 0 && inner_gy < inner_grid - 1) {
-            continue;
-          }
-        }
+  return topology;
+}
 
-        float world_x = static_cast<float>(hx) * texel_world - world_size * 0.5f;
-        float world_z = static_cast<float>(hy) * texel_world - world_size * 0.5f;
-        float height = frame.heightmap[hy * resolution + hx] * frame.height_scale;
+uint16_t quantize_height(float height) {
+  return static_cast<uint16_t>(std::clamp(height, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
 
-        ring.positions.push_back(glm::vec3(world_x, height, world_z));
+uint16_t average(uint16_t left, uint16_t right) {
+  return static_cast<uint16_t>((static_cast<uint32_t>(left) + right + 1u) / 2u);
+}
 
-        glm::vec4 normal_data = frame.normal_map[hy * resolution + hx];
-        ring.normals.push_back(glm::vec3(normal_data));
+void build_level(const HeightmapFrame &frame, const ClipmapTopology &topology,
+                 bool morphs, ClipmapRing &ring, std::vector<uint16_t> &heights) {
+  const uint32_t cells = topology.cells_per_side;
+  const uint32_t side = cells + 1;
+  const int32_t last_texel = static_cast<int32_t>(frame.resolution) - 1;
+
+  heights.resize(static_cast<size_t>(side) * side);
+  for (uint32_t gy = 0; gy < side; ++gy) {
+    const int32_t texel_y = std::clamp(
+        ring.texel_y + static_cast<int32_t>(gy * ring.texel_step), 0, last_texel
+    );
+    const float *row = frame.heightmap.data() + static_cast<size_t>(texel_y) * frame.resolution;
+
+    for (uint32_t gx = 0; gx < side; ++gx) {
+      const int32_t texel_x = std::clamp(
+          ring.texel_x + static_cast<int32_t>(gx * ring.texel_step), 0, last_texel
+      );
+      heights[gy * side + gx] = quantize_height(row[texel_x]);
+    }
+  }
+
+  // Morph over the outer tenth of the level so its border matches the
+  // coarser level exactly.
+  const int32_t half = static_cast<int32_t>(cells / 2);
+  const int32_t width = std::max(1, static_cast<int32_t>(cells / 10));
+  const int32_t morph_start = half - width;
+
+  const uint32_t vertex_count = topology.vertex_count();
+  ring.vertices.resize(vertex_count);
+
+  for (uint32_t index = 0; index < vertex_count; ++index) {
+    const uint32_t gx = topology.grid[index * 2];
+    const uint32_t gy = topology.grid[index * 2 + 1];
+    const uint16_t height = heights[gy * side + gx];
+
+    // Odd vertices fall on a coarse edge or on the coarse cell diagonal.
+    uint16_t coarse = height;
+    if ((gx & 1u) != 0 && (gy & 1u) != 0) {
+      coarse = average(heights[(gy - 1) * side + gx + 1], heights[(gy + 1) * side + gx - 1]);
+    } else if ((gx & 1u) != 0) {
+      coarse = average(heights[gy * side + gx - 1], heights[gy * side + gx + 1]);
+    } else if ((gy & 1u) != 0) {
+      coarse = average(heights[(gy - 1) * side + gx], heights[(gy + 1) * side + gx]);
+    }
 
-        ring.uvs.push_back(glm::vec2(
-            static_cast<float>(hx) / static_cast<float>(resolution - 1),
-            static_cast<float>(hy) / static_cast<float>(resolution - 1)
-        ));
-      }
+    uint16_t morph = 0;
+    if (morphs) {
+      const int32_t distance = std::max(
+          std::abs(static_cast<int32_t>(gx) - half), std::abs(static_cast<int32_t>(gy) - half)
+      );
+      const int32_t ramp = std::clamp(distance - morph_start, 0, width);
+      morph = static_cast<uint16_t>(ramp * 65535 / width);
     }
 
-    frame.clipmap_rings.push_back(std::move(ring));
+    ring.vertices[index] = ClipmapVertex{height, coarse, morph};
   }
 }
 
+} // namespace
+
+Ref<const ClipmapTopology> MeshBuildPass::topology(uint32_t cells_per_side, bool has_hole) {
+  auto &cached = m_topologies[has_hole ? 1 : 0];
+  if (cached == nullptr || cached->cells_per_side != cells_per_side) {
+    cached = build_topology(cells_per_side, has_hole);
+  }
+  return cached;
+}
+
+void MeshBuildPass::process(HeightmapFrame &frame, const TerrainRecipeData &recipe) {
+  ASTRA_PROFILE_N("MeshBuildPass::process");
+
+  frame.clipmap_rings.clear();
+
+  uint32_t resolution = frame.resolution;
+  if (resolution < 2 || m_clipmap_levels == 0) return;
+
+  // The hole needs the cell count divisible by four.
+  const uint32_t ring_vertices =
+      std::clamp(m_ring_vertices, k_min_ring_vertices, k_max_ring_vertices);
+  const uint32_t cells = (ring_vertices - 1u) & ~3u;
+
+  // Level n spans cells << n texels; add levels until one covers the tile.
+  const uint64_t tile_texels = resolution - 1;
+  uint32_t level_count = 1;
+  while (level_count < m_clipmap_levels &&
+         (static_cast<uint64_t>(cells) << (level_count - 1)) < tile_texels) {
+    ++level_count;
+  }
+
+  float world_size = frame.tile_world_size;
+  float texel_world = world_size / static_cast<float>(resolution - 1);
+  const int32_t center_texel = static_cast<int32_t>((resolution - 1) / 2);
+
+  frame.clipmap_rings.resize(level_count);
+  for (uint32_t level = 0; level < level_count; ++level) {
+    auto &ring = frame.clipmap_rings[level];
+    ring.level = level;
+    ring.topology = topology(cells, level > 0);
+    ring.texel_step = 1u << level;
+    ring.texel_x = center_texel - static_cast<int32_t>(cells / 2 * ring.texel_step);
+    ring.texel_y = ring.texel_x;
+    ring.spacing = static_cast<float>(ring.texel_step) * texel_world;
+    ring.origin = glm::vec2(
+        static_cast<float>(ring.texel_x) * texel_world - world_size * 0.5f,
+        static_cast<float>(ring.texel_y) * texel_world - world_size * 0.5f
+    );
+  }
+
+  parallel_for(size_t{0}, size_t{level_count}, 1u, [&](size_t level_begin, size_t level_end) {
+    std::vector<uint16_t> heights;
+    for (size_t level = level_begin; level < level_end; ++level) {
+      auto &ring = frame.clipmap_rings[level];
+      // The outermost level has nothing coarser to blend into.
+      build_level(frame, *ring.topology, level + 1 < level_count, ring, heights);
+    }
+  });
+}
+
 } // namespace astralix::terrain
@@ -1,25 +1,49 @@
 #pragma once
 
+#include "assert.hpp"
 #include "graph/heightmap/heightmap-pass.hpp"
 
 namespace astralix::terrain {
 
+// Ring vertices are clamped to [k_min_ring_vertices, k_max_ring_vertices]
+// when the levels are built. Levels stop once one covers the whole tile, so
+// the outermost level spans less than twice the tile.
 class MeshBuildPass : public HeightmapPass {
 public:
-  explicit MeshBuildPass(uint32_t clipmap_levels = 6, uint32_t ring_vertices = 64)
-      : m_clipmap_levels(clipmap_levels), m_ring_vertices(ring_vertices) {}
+  static constexpr uint32_t k_min_ring_vertices = 5u;
+  static constexpr uint32_t k_max_ring_vertices = 1025u;
+
+  explicit MeshBuildPass(uint32_t clipmap_levels = 6, uint32_t ring_vertices = 64) {
+    set_clipmap(clipmap_levels, ring_vertices);
+  }
+
+  void set_clipmap(uint32_t clipmap_levels, uint32_t ring_vertices) {
+    ASTRA_ENSURE(ring_vertices == 0u, "MeshBuildPass: ring_vertices must be positive");
+    m_clipmap_levels = clipmap_levels;
+    m_ring_vertices = ring_vertices;
+  }
 
   void process(HeightmapFrame &frame, const TerrainRecipeData &recipe) override;
   std::string_view name() const override { return "MeshBuild"; }
   std::span<const HeightmapField> reads() const override { return s_reads; }
   std::span<const HeightmapField> writes() const override { return s_writes; }
+  uint64_t settings_hash() const override {
+    return (static_cast<uint64_t>(m_clipmap_levels) << 32) | m_ring_vertices;
+  }
 
 private:
-  static constexpr HeightmapField s_reads[] = {HeightmapField::Heightmap, HeightmapField::NormalMap};
+  // Normals are sampled from the normal map when drawn, so only heights feed
+  // the mesh.
+  static constexpr HeightmapField s_reads[] = {HeightmapField::Heightmap};
   static constexpr HeightmapField s_writes[] = {HeightmapField::MeshData};
 
-  uint32_t m_clipmap_levels;
-  uint32_t m_ring_vertices;
+  Ref<const ClipmapTopology> topology(uint32_t cells_per_side, bool has_hole);
+
+  uint32_t m_clipmap_levels = 0u;
+  uint32_t m_ring_vertices = 0u;
+
+  // Full grid for level 0, holed grid for every coarser level.
+  Ref<const ClipmapTopology> m_topologies[2];
 };
 
 } // namespace astralix::terrain
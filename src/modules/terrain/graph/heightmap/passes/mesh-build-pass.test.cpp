@@ -0,0 +1,150 @@
+#include "mesh-build-pass.hpp"
+#include "systems/job-system/job-system.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace astralix::terrain {
+namespace {
+
+HeightmapFrame make_frame(uint32_t resolution) {
+  HeightmapFrame frame;
+  frame.allocate(resolution);
+
+  // Linear ramp along x, so every interpolated coarse height is exact.
+  for (uint32_t y = 0; y < resolution; ++y) {
+    for (uint32_t x = 0; x < resolution; ++x) {
+      frame.heightmap[y * resolution + x] =
+          static_cast<float>(x) / static_cast<float>(resolution - 1);
+    }
+  }
+
+  return frame;
+}
+
+TEST(MeshBuildPassTest, LevelsShareTopologyAcrossTiles) {
+  MeshBuildPass pass(4, 33);
+  auto first = make_frame(257);
+  auto second = make_frame(257);
+  pass.process(first, {});
+  pass.process(second, {});
+
+  ASSERT_EQ(first.clipmap_rings.size(), 4u);
+  EXPECT_FALSE(first.clipmap_rings[0].topology->has_hole);
+  for (uint32_t level = 1; level < 4; ++level) {
+    EXPECT_EQ(first.clipmap_rings[level].topology, first.clipmap_rings[1].topology);
+  }
+  EXPECT_EQ(first.clipmap_rings[0].topology, second.clipmap_rings[0].topology);
+  EXPECT_EQ(first.clipmap_rings[3].topology, second.clipmap_rings[3].topology);
+}
+
+TEST(MeshBuildPassTest, RingTopologyLeavesHoleForFinerLevel) {
+  MeshBuildPass pass(2, 33);
+  auto frame = make_frame(129);
+  pass.process(frame, {});
+
+  const auto &full = *frame.clipmap_rings[0].topology;
+  const auto &ring = *frame.clipmap_rings[1].topology;
+  ASSERT_EQ(full.cells_per_side, 32u);
+
+  EXPECT_EQ(full.vertex_count(), 33u * 33u);
+  EXPECT_EQ(full.indices.size(), 32u * 32u * 6u);
+  EXPECT_EQ(ring.vertex_count(), 33u * 33u - 15u * 15u);
+  EXPECT_EQ(ring.indices.size(), (32u * 32u - 16u * 16u) * 6u);
+
+  for (const auto *topology : {&full, &ring}) {
+    EXPECT_TRUE(std::all_of(
+        topology->indices.begin(), topology->indices.end(),
+        [&](uint32_t index) { return index < topology->vertex_count(); }
+    ));
+  }
+}
+
+TEST(MeshBuildPassTest, VerticesPackHeightsAndMorph) {
+  MeshBuildPass pass(3, 33);
+  auto frame = make_frame(257);
+  pass.process(frame, {});
+
+  for (const auto &ring : frame.clipmap_rings) {
+    const auto &topology = *ring.topology;
+    ASSERT_EQ(ring.vertices.size(), topology.vertex_count());
+    const bool outermost = ring.level + 1 == frame.clipmap_rings.size();
+
+    for (uint32_t index = 0; index < topology.vertex_count(); ++index) {
+      const uint32_t gx = topology.grid[index * 2];
+      const uint32_t gy = topology.grid[index * 2 + 1];
+      const auto &vertex = ring.vertices[index];
+
+      const int32_t texel_x = ring.texel_x + static_cast<int32_t>(gx * ring.texel_step);
+      const float expected = static_cast<float>(texel_x) / 256.0f;
+      EXPECT_NEAR(vertex.height / 65535.0f, expected, 1.0f / 65535.0f);
+      EXPECT_NEAR(vertex.coarse_height, vertex.height, 1.0f);
+
+      const bool on_border = gx == 0 || gy == 0 || gx == 32 || gy == 32;
+      if (outermost) {
+        EXPECT_EQ(vertex.morph, 0u);
+      } else if (on_border) {
+        EXPECT_EQ(vertex.morph, 65535u);
+      }
+      if (gx == 16 && gy == 16) {
+        EXPECT_EQ(vertex.morph, 0u);
+      }
+    }
+  }
+}
+
+TEST(MeshBuildPassTest, ClampsRingVerticesAndRejectsZero) {
+  EXPECT_ANY_THROW(MeshBuildPass(4, 0));
+  MeshBuildPass pass(1, 64);
+  EXPECT_ANY_THROW(pass.set_clipmap(1, 0));
+
+  auto frame = make_frame(65);
+  pass.set_clipmap(1, 1);
+  pass.process(frame, {});
+  ASSERT_EQ(frame.clipmap_rings.size(), 1u);
+  EXPECT_EQ(frame.clipmap_rings[0].topology->cells_per_side, 4u);
+
+  pass.set_clipmap(1, 1u << 20);
+  pass.process(frame, {});
+  ASSERT_EQ(frame.clipmap_rings.size(), 1u);
+  EXPECT_EQ(frame.clipmap_rings[0].topology->cells_per_side, 1024u);
+}
+
+TEST(MeshBuildPassTest, StopsAddingLevelsOnceOneCoversTheTile) {
+  // 32 cells on a 256-texel tile: levels span 32, 64, 128 and 256 texels.
+  MeshBuildPass pass(40, 33);
+  auto frame = make_frame(257);
+  pass.process(frame, {});
+
+  ASSERT_EQ(frame.clipmap_rings.size(), 4u);
+  const auto &outermost = frame.clipmap_rings.back();
+  EXPECT_EQ(outermost.texel_step, 8u);
+  EXPECT_EQ(outermost.texel_x, 128 - 16 * 8);
+  EXPECT_LT(outermost.topology->cells_per_side * outermost.texel_step, 2u * 256u);
+}
+
+TEST(MeshBuildPassTest, ParallelLevelsMatchInline) {
+  MeshBuildPass pass(6, 65);
+  auto inline_frame = make_frame(513);
+  pass.process(inline_frame, {});
+
+  JobSystem jobs(JobSystem::Config{.worker_count = 3});
+  jobs.start();
+  auto frame = make_frame(513);
+  pass.process(frame, {});
+  jobs.end();
+
+  ASSERT_EQ(frame.clipmap_rings.size(), inline_frame.clipmap_rings.size());
+  for (size_t level = 0; level < frame.clipmap_rings.size(); ++level) {
+    const auto &left = frame.clipmap_rings[level].vertices;
+    const auto &right = inline_frame.clipmap_rings[level].vertices;
+    ASSERT_EQ(left.size(), right.size());
+    EXPECT_TRUE(std::equal(left.begin(), left.end(), right.begin(), [](const auto &a, const auto &b) {
+      return a.height == b.height && a.coarse_height == b.coarse_height && a.morph == b.morph;
+    }));
+  }
+}
+
+} // namespace
+} // namespace astralix::terrain
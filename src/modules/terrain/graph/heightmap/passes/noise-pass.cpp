@@ -1,58 +1,12 @@
 #include "noise-pass.hpp"
+#include "graph/heightmap/noise/fbm.hpp"
+#include "systems/job-system/parallel.hpp"
 #include "trace.hpp"
-#include <array>
-#include <cmath>
-#include <numeric>
-#include <random>
+#include <algorithm>
+#include <utility>
 
 namespace astralix::terrain {
 
-namespace {
-
-struct PerlinState {
-  std::array<int, 512> perm;
-
-  void seed(uint32_t seed_value) {
-    std::array<int, 256> permutation;
-    std::iota(permutation.begin(), permutation.end(), 0);
-    std::mt19937 rng(seed_value);
-    std::shuffle(permutation.begin(), permutation.end(), rng);
-    for (int index = 0; index < 256; ++index) {
-      perm[index] = perm[index + 256] = permutation[index];
-    }
-  }
-
-  float noise2d(float x, float y) const {
-    int xi = static_cast<int>(std::floor(x)) & 255;
-    int yi = static_cast<int>(std::floor(y)) & 255;
-    float xf = x - std::floor(x);
-    float yf = y - std::floor(y);
-    float u = xf * xf * xf * (xf * (xf * 6.0f - 15.0f) + 10.0f);
-    float v = yf * yf * yf * (yf * (yf * 6.0f - 15.0f) + 10.0f);
-
-    int aa = perm[perm[xi] + yi];
-    int ab = perm[perm[xi] + yi + 1];
-    int ba = perm[perm[xi + 1] + yi];
-    int bb = perm[perm[xi + 1] + yi + 1];
-
-    auto grad = [](int hash, float gx, float gy) -> float {
-      switch (hash & 3) {
-        case 0: return  gx + gy;
-        case 1: return -gx + gy;
-        case 2: return  gx - gy;
-        case 3: return -gx - gy;
-      }
-      return 0.0f;
-    };
-
-    float x1 = std::lerp(grad(aa, xf, yf), grad(ba, xf - 1.0f, yf), u);
-    float x2 = std::lerp(grad(ab, xf, yf - 1.0f), grad(bb, xf - 1.0f, yf - 1.0f), u);
-    return std::lerp(x1, x2, v);
-  }
-};
-
-} // namespace
-
 void NoisePass::process(HeightmapFrame &frame, const TerrainRecipeData &recipe) {
   ASTRA_PROFILE_N("NoisePass::process");
 
@@ -60,37 +14,48 @@ void NoisePass::process(HeightmapFrame &frame, const TerrainRecipeData &recipe)
 
   frame.allocate(recipe.resolution);
 
-  PerlinState perlin;
+  PerlinTable perlin;
   perlin.seed(noise.seed);
 
-  float max_value = 0.0f;
-  float min_value = 0.0f;
-
-  for (uint32_t y = 0; y < frame.resolution; ++y) {
-    for (uint32_t x = 0; x < frame.resolution; ++x) {
-      float amplitude = noise.amplitude;
-      float frequency = noise.frequency;
-      float value = 0.0f;
-
-      for (uint32_t octave = 0; octave < noise.octaves; ++octave) {
-        float sample_x = static_cast<float>(x) * frequency;
-        float sample_y = static_cast<float>(y) * frequency;
-        value += perlin.noise2d(sample_x, sample_y) * amplitude;
-        frequency *= noise.lacunarity;
-        amplitude *= noise.persistence;
-      }
-
-      frame.heightmap[y * frame.resolution + x] = value;
-      max_value = std::max(max_value, value);
-      min_value = std::min(min_value, value);
-    }
-  }
+  const FbmParams params{
+      .octaves = noise.octaves,
+      .frequency = noise.frequency,
+      .lacunarity = noise.lacunarity,
+      .persistence = noise.persistence,
+      .amplitude = noise.amplitude,
+  };
+  const FbmKernel kernel = best_fbm_kernel();
+  const uint32_t resolution = frame.resolution;
+
+  constexpr size_t k_row_grain = 16u;
+
+  // Rows are independent; min/max start at zero like the serial loop did so
+  // the normalized output is unchanged.
+  auto [min_value, max_value] = parallel_reduce(
+      0u, static_cast<size_t>(resolution), k_row_grain, std::pair{0.0f, 0.0f},
+      [&](size_t row_begin, size_t row_end) {
+        std::pair bounds{0.0f, 0.0f};
+        for (size_t y = row_begin; y < row_end; ++y) {
+          float *row = frame.heightmap.data() + y * resolution;
+          fbm_row(perlin, params, static_cast<uint32_t>(y), 0u, resolution, row, kernel);
+
+          auto [low, high] = std::minmax_element(row, row + resolution);
+          bounds.first = std::min(bounds.first, *low);
+          bounds.second = std::max(bounds.second, *high);
+        }
+        return bounds;
+      },
+      [](std::pair<float, float> left, std::pair<float, float> right) {
+        return std::pair{std::min(left.first, right.first), std::max(left.second, right.second)};
+      });
 
   float range = max_value - min_value;
   if (range > 0.0f) {
-    for (auto &height : frame.heightmap) {
-      height = (height - min_value) / range;
-    }
+    parallel_for(0u, static_cast<size_t>(resolution), k_row_grain, [&](size_t row_begin, size_t row_end) {
+      for (size_t texel = row_begin * resolution; texel < row_end * resolution; ++texel) {
+        frame.heightmap[texel] = (frame.heightmap[texel] - min_value) / range;
+      }
+    });
   }
 }
 
@@ -10,9 +10,11 @@ public:
   std::string_view name() const override { return "Noise"; }
   std::span<const HeightmapField> reads() const override { return {}; }
   std::span<const HeightmapField> writes() const override { return s_writes; }
+  std::span<const TerrainRecipeField> recipe_reads() const override { return s_recipe_reads; }
 
 private:
   static constexpr HeightmapField s_writes[] = {HeightmapField::Heightmap};
+  static constexpr TerrainRecipeField s_recipe_reads[] = {TerrainRecipeField::Resolution, TerrainRecipeField::Noise};
 };
 
 } // namespace astralix::terrain
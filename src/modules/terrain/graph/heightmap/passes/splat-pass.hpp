@@ -10,10 +10,12 @@ public:
   std::string_view name() const override { return "Splat"; }
   std::span<const HeightmapField> reads() const override { return s_reads; }
   std::span<const HeightmapField> writes() const override { return s_writes; }
+  std::span<const TerrainRecipeField> recipe_reads() const override { return s_recipe_reads; }
 
 private:
   static constexpr HeightmapField s_reads[] = {HeightmapField::Heightmap, HeightmapField::NormalMap};
   static constexpr HeightmapField s_writes[] = {HeightmapField::SplatMap};
+  static constexpr TerrainRecipeField s_recipe_reads[] = {TerrainRecipeField::Splat};
 };
 
 } // namespace astralix::terrain
@@ -233,10 +233,28 @@ void TerrainGraph::process() {
   }
 }
 
+void TerrainGraph::rerun(std::string_view subgraph_name) {
+  for (size_t index = 0; index < m_subgraphs.size(); ++index) {
+    if (m_subgraphs[index]->name() == subgraph_name &&
+        index < m_one_shot_executed.size()) {
+      m_one_shot_executed[index] = false;
+    }
+  }
+}
+
 std::span<const Scope<TerrainSubgraph>> TerrainGraph::subgraphs() const {
   return m_subgraphs;
 }
 
+TerrainSubgraph *TerrainGraph::find_subgraph(std::string_view name) {
+  for (const auto &subgraph : m_subgraphs) {
+    if (subgraph->name() == name) {
+      return subgraph.get();
+    }
+  }
+  return nullptr;
+}
+
 const TerrainSubgraph *TerrainGraph::find_subgraph(std::string_view name) const {
   for (const auto &subgraph : m_subgraphs) {
     if (subgraph->name() == name) {
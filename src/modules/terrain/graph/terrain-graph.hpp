@@ -14,7 +14,12 @@ public:
   void compile();
   void process();
 
+  // Lets a OneShot subgraph run again on the next process(), e.g. after its
+  // recipe changed.
+  void rerun(std::string_view subgraph_name);
+
   std::span<const Scope<TerrainSubgraph>> subgraphs() const;
+  TerrainSubgraph *find_subgraph(std::string_view name);
   const TerrainSubgraph *find_subgraph(std::string_view name) const;
 
 private:
@@ -2,6 +2,7 @@
 #include "adapters/file/file-stream-reader.hpp"
 #include "assert.hpp"
 #include "context-proxy.hpp"
+#include "fnv1a.hpp"
 #include "log.hpp"
 #include "serialization-context.hpp"
 
@@ -20,6 +21,12 @@ float read_number(ContextProxy ctx, float fallback = 0.0f) {
   }
 }
 
+// Length-prefixed so adjacent strings cannot shift into each other.
+uint64_t append_string(uint64_t hash, const std::string &value) {
+  hash = fnv1a64_append_value(hash, value.size());
+  return fnv1a64_append_string(value, hash);
+}
+
 } // namespace
 
 TerrainRecipeData parse_terrain_recipe(const std::string &recipe_path) {
@@ -82,6 +89,10 @@ TerrainRecipeData parse_terrain_recipe(const std::string &recipe_path) {
     data.erosion.gravity = read_number(erosion["gravity"], 4.0f);
     data.erosion.erode_radius = static_cast<uint32_t>(
         read_number(erosion["erode_radius"], 3.0f));
+    if (erosion["mode"].kind() == SerializationTypeKind::String)
+      data.erosion.mode = erosion["mode"].as<std::string>();
+    data.erosion.tile_size = static_cast<uint32_t>(
+        read_number(erosion["tile_size"], 128.0f));
   }
 
   auto splat = field("splat");
@@ -120,4 +131,53 @@ TerrainRecipeData parse_terrain_recipe(const std::string &recipe_path) {
   return data;
 }
 
+uint64_t hash_recipe_field(const TerrainRecipeData &recipe, TerrainRecipeField field) {
+  uint64_t hash = fnv1a64_append_value(k_fnv1a64_offset_basis, field);
+
+  switch (field) {
+    case TerrainRecipeField::Resolution:
+      return fnv1a64_append_value(hash, recipe.resolution);
+
+    case TerrainRecipeField::Noise: {
+      const auto &noise = recipe.noise;
+      hash = append_string(hash, noise.type);
+      hash = fnv1a64_append_value(hash, noise.seed);
+      hash = fnv1a64_append_value(hash, noise.octaves);
+      hash = fnv1a64_append_value(hash, noise.frequency);
+      hash = fnv1a64_append_value(hash, noise.lacunarity);
+      hash = fnv1a64_append_value(hash, noise.persistence);
+      return fnv1a64_append_value(hash, noise.amplitude);
+    }
+
+    case TerrainRecipeField::Erosion: {
+      const auto &erosion = recipe.erosion;
+      hash = fnv1a64_append_value(hash, erosion.iterations);
+      hash = fnv1a64_append_value(hash, erosion.drop_lifetime);
+      hash = fnv1a64_append_value(hash, erosion.inertia);
+      hash = fnv1a64_append_value(hash, erosion.sediment_capacity);
+      hash = fnv1a64_append_value(hash, erosion.min_sediment_capacity);
+      hash = fnv1a64_append_value(hash, erosion.deposit_speed);
+      hash = fnv1a64_append_value(hash, erosion.erode_speed);
+      hash = fnv1a64_append_value(hash, erosion.evaporate_speed);
+      hash = fnv1a64_append_value(hash, erosion.gravity);
+      hash = fnv1a64_append_value(hash, erosion.erode_radius);
+      hash = append_string(hash, erosion.mode);
+      return fnv1a64_append_value(hash, erosion.tile_size);
+    }
+
+    case TerrainRecipeField::Splat:
+      for (const auto &layer : recipe.splat.layers) {
+        hash = append_string(hash, layer.material_id);
+        hash = append_string(hash, layer.channel);
+        hash = fnv1a64_append_value(hash, layer.min_slope);
+        hash = fnv1a64_append_value(hash, layer.max_slope);
+        hash = fnv1a64_append_value(hash, layer.min_height);
+        hash = fnv1a64_append_value(hash, layer.max_height);
+      }
+      return fnv1a64_append_value(hash, recipe.splat.layers.size());
+  }
+
+  return hash;
+}
+
 } // namespace astralix::terrain
@@ -27,6 +27,8 @@ struct ErosionConfig {
   float evaporate_speed = 0.01f;
   float gravity = 4.0f;
   uint32_t erode_radius = 3;
+  std::string mode = "serial";
+  uint32_t tile_size = 128;
 };
 
 struct SplatLayerConfig {
@@ -49,6 +51,16 @@ struct TerrainRecipeData {
   SplatConfig splat;
 };
 
+// Groups of recipe settings a heightmap pass can declare it reads.
+enum class TerrainRecipeField : uint8_t {
+  Resolution,
+  Noise,
+  Erosion,
+  Splat,
+};
+
 TerrainRecipeData parse_terrain_recipe(const std::string &recipe_path);
 
+uint64_t hash_recipe_field(const TerrainRecipeData &recipe, TerrainRecipeField field);
+
 } // namespace astralix::terrain
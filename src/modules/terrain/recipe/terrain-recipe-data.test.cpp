@@ -73,5 +73,23 @@ TEST(TerrainRecipeDataTest, ParsesLegacyWrappedRecipe) {
   EXPECT_EQ(recipe.noise.seed, 42u);
 }
 
+TEST(TerrainRecipeDataTest, ParsesTiledErosionMode) {
+  const auto root = make_temp_root("astralix-terrain-erosion");
+  const auto recipe_path = root / "erosion.axterrain";
+
+  write_text(
+      recipe_path,
+      R"json({
+  "version": 1,
+  "erosion": { "iterations": 500000, "mode": "tiled", "tile_size": 256 }
+})json"
+  );
+
+  const auto recipe = parse_terrain_recipe(recipe_path.string());
+  EXPECT_EQ(recipe.erosion.iterations, 500000u);
+  EXPECT_EQ(recipe.erosion.mode, "tiled");
+  EXPECT_EQ(recipe.erosion.tile_size, 256u);
+}
+
 } // namespace
 } // namespace astralix::terrain
@@ -1,4 +1,5 @@
 #include "terrain-system.hpp"
+#include "components/terrain-clipmap-controller.hpp"
 #include "components/terrain-tile.hpp"
 #include "components/material.hpp"
 #include "components/mesh.hpp"
@@ -16,11 +17,12 @@
 #include "resources/texture.hpp"
 #include "log.hpp"
 #include "trace.hpp"
+#include <algorithm>
 
 namespace astralix {
 
 TerrainSystem::TerrainSystem(TerrainSystemConfig &config)
-    : m_config(config) {}
+    : m_config(config), m_clipmap_levels(std::max(config.clipmap_levels, 1u)) {}
 
 void TerrainSystem::start() {
   ASTRA_PROFILE_N("TerrainSystem::start");
@@ -30,8 +32,9 @@ void TerrainSystem::start() {
   heightmap->add_pass(create_scope<terrain::ErosionPass>());
   heightmap->add_pass(create_scope<terrain::NormalPass>());
   heightmap->add_pass(create_scope<terrain::SplatPass>());
-  heightmap->add_pass(create_scope<terrain::MeshBuildPass>(
-      m_config.clipmap_levels, 64));
+  auto mesh_build = create_scope<terrain::MeshBuildPass>(m_clipmap_levels, m_ring_vertices);
+  m_mesh_build_pass = mesh_build.get();
+  heightmap->add_pass(std::move(mesh_build));
 
   m_graph.add_subgraph(std::move(heightmap));
   m_graph.compile();
@@ -56,8 +59,8 @@ void TerrainSystem::update(double dt) {
   };
   std::vector<PendingAttach> pending;
 
-  world.each<terrain::TerrainTile>(
-      [&](EntityID entity_id, terrain::TerrainTile &tile) {
+  world.each<const terrain::TerrainTile>(
+      [&](EntityID entity_id, const terrain::TerrainTile &tile) {
         if (!tile.enabled || tile.recipe_id.empty()) return;
         if (!world.active(entity_id)) return;
 
@@ -82,21 +85,25 @@ void TerrainSystem::update(double dt) {
         }
       });
 
+  sync_clipmap(world);
+
   for (auto &entry : pending) {
     auto entity = world.entity(entry.entity_id);
     auto &generated = m_terrains[entry.recipe_id];
 
-    entity.emplace<rendering::Renderable>();
-    entity.emplace<rendering::ShadowCaster>();
-    entity.emplace<rendering::MeshSet>(rendering::MeshSet{
-        .meshes = {*generated.mesh},
-    });
-    entity.emplace<rendering::ShaderBinding>(rendering::ShaderBinding{
-        .shader = "shaders::g_buffer",
-    });
-    entity.emplace<rendering::MaterialSlots>(rendering::MaterialSlots{
-        .materials = {"materials::brick"},
-    });
+    entity.emplace_bundle(
+        rendering::Renderable{},
+        rendering::ShadowCaster{},
+        rendering::MeshSet{
+            .meshes = {*generated.mesh},
+        },
+        rendering::ShaderBinding{
+            .shader = "shaders::g_buffer",
+        },
+        rendering::MaterialSlots{
+            .materials = {"materials::brick"},
+        }
+    );
   }
 }
 
@@ -114,11 +121,12 @@ void TerrainSystem::generate_terrain(const std::string &recipe_id) {
   std::string resolved_path = path_manager()->resolve(descriptor->path).string();
   terrain::TerrainRecipeData recipe = terrain::parse_terrain_recipe(resolved_path);
 
-  auto *subgraph = const_cast<terrain::HeightmapSubgraph *>(heightmap_subgraph());
+  auto *subgraph = heightmap_subgraph();
   if (subgraph == nullptr) return;
 
   subgraph->set_recipe(recipe);
 
+  m_graph.rerun(subgraph->name());
   m_graph.process();
 
   const auto &frame = subgraph->frame();
@@ -135,6 +143,43 @@ void TerrainSystem::generate_terrain(const std::string &recipe_id) {
   upload_textures(recipe_id, *subgraph);
 }
 
+// Clipmap settings only feed MeshBuildPass, so the heightmap subgraph serves
+// every other pass from its cache when they change. Tiles keep drawing the
+// full-resolution mesh, which the settings do not touch.
+void TerrainSystem::sync_clipmap(ecs::World &world) {
+  const terrain::TerrainClipmapController *active = nullptr;
+  world.each<const terrain::TerrainClipmapController>(
+      [&](EntityID, const terrain::TerrainClipmapController &controller) {
+        if (active == nullptr && controller.enabled) {
+          active = &controller;
+        }
+      });
+
+  if (active == nullptr) return;
+
+  const uint32_t levels = std::max(active->levels, 1u);
+  const uint32_t ring_vertices =
+      std::clamp(active->ring_vertices, terrain::MeshBuildPass::k_min_ring_vertices,
+                 terrain::MeshBuildPass::k_max_ring_vertices);
+  if (levels == m_clipmap_levels && ring_vertices == m_ring_vertices) return;
+
+  m_clipmap_levels = levels;
+  m_ring_vertices = ring_vertices;
+
+  auto *subgraph = heightmap_subgraph();
+  if (subgraph == nullptr || m_mesh_build_pass == nullptr) return;
+
+  m_mesh_build_pass->set_clipmap(m_clipmap_levels, m_ring_vertices);
+
+  if (!m_terrains.empty()) {
+    m_graph.rerun(subgraph->name());
+    m_graph.process();
+  }
+}
+
+// Full-resolution grid of the tile. frame.clipmap_rings are not drawn yet:
+// they only pay off for a renderer that recentres the levels on the camera
+// and morphs between them in the shader.
 Mesh TerrainSystem::build_terrain_mesh(const terrain::HeightmapFrame &frame,
                                         float height_scale) {
   ASTRA_PROFILE_N("TerrainSystem::build_terrain_mesh");
@@ -251,6 +296,10 @@ void TerrainSystem::upload_textures(const std::string &recipe_id,
 
 const terrain::TerrainGraph &TerrainSystem::graph() const { return m_graph; }
 
+terrain::HeightmapSubgraph *TerrainSystem::heightmap_subgraph() {
+  return static_cast<terrain::HeightmapSubgraph *>(m_graph.find_subgraph("Heightmap"));
+}
+
 const terrain::HeightmapSubgraph *TerrainSystem::heightmap_subgraph() const {
   auto *subgraph = m_graph.find_subgraph("Heightmap");
   return static_cast<const terrain::HeightmapSubgraph *>(subgraph);
@@ -2,10 +2,12 @@
 
 #include "graph/terrain-graph.hpp"
 #include "graph/heightmap/heightmap-subgraph.hpp"
+#include "graph/heightmap/passes/mesh-build-pass.hpp"
 #include "recipe/terrain-recipe-data.hpp"
 #include "resources/mesh.hpp"
 #include "project.hpp"
 #include "systems/system.hpp"
+#include "world.hpp"
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -23,15 +25,21 @@ public:
   void update(double dt) override;
 
   const terrain::TerrainGraph &graph() const;
+  terrain::HeightmapSubgraph *heightmap_subgraph();
   const terrain::HeightmapSubgraph *heightmap_subgraph() const;
 
 private:
   void generate_terrain(const std::string &recipe_id);
   void upload_textures(const std::string &recipe_id, const terrain::HeightmapSubgraph &subgraph);
+  void sync_clipmap(ecs::World &world);
   Mesh build_terrain_mesh(const terrain::HeightmapFrame &frame, float height_scale);
 
   TerrainSystemConfig m_config;
   terrain::TerrainGraph m_graph;
+  // Owned by the heightmap subgraph.
+  terrain::MeshBuildPass *m_mesh_build_pass = nullptr;
+  uint32_t m_clipmap_levels;
+  uint32_t m_ring_vertices = 64;
 
   struct GeneratedTerrain {
     terrain::TerrainRecipeData recipe;
@@ -2,10 +2,16 @@
 
 #include "assert.hpp"
 #include "base.hpp"
+#include "bump.hpp"
+#include "containers/flat-hash-map.hpp"
 #include "guid.hpp"
 #include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -17,6 +23,7 @@
 namespace astralix::ecs {
 
 using ComponentTypeID = TypeID;
+using EntityHandle = Handle;
 
 namespace detail {
 
@@ -95,6 +102,17 @@ struct Signature {
     return std::all_of(words.begin(), words.end(), [](uint64_t word) { return word == 0u; });
   }
 
+  bool intersects(const Signature &other) const {
+    const size_t common = std::min(words.size(), other.words.size());
+    for (size_t i = 0; i < common; ++i) {
+      if ((words[i] & other.words[i]) != 0u) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
   friend bool operator==(const Signature &lhs, const Signature &rhs) {
     return lhs.words == rhs.words;
   }
@@ -118,6 +136,41 @@ struct SignatureHash {
   }
 };
 
+// Component access declared by a parallel query: `const T` reads, `T` writes.
+struct ComponentAccess {
+  Signature reads;
+  Signature writes;
+
+  bool conflicts_with(const ComponentAccess &other) const {
+    return writes.intersects(other.writes) || writes.intersects(other.reads) ||
+           reads.intersects(other.writes);
+  }
+};
+
+template <typename... Ts>
+inline ComponentAccess component_access() {
+  ComponentAccess access;
+  ((std::is_const_v<std::remove_reference_t<Ts>>
+        ? access.reads.set(component_type_id<Ts>())
+        : access.writes.set(component_type_id<Ts>())),
+   ...);
+  return access;
+}
+
+// Runs task(context, index) for every index in [0, task_count) and returns once
+// all of them finished. The job system installs one on start; without it,
+// parallel queries run inline on the calling thread.
+using ParallelDispatch = void (*)(size_t task_count, void *context, void (*task)(void *context, size_t index));
+
+inline ParallelDispatch &parallel_dispatch() {
+  static ParallelDispatch dispatch = nullptr;
+  return dispatch;
+}
+
+inline void set_parallel_dispatch(ParallelDispatch dispatch) {
+  parallel_dispatch() = dispatch;
+}
+
 class World;
 
 class EntityRef {
@@ -137,25 +190,54 @@ public:
   T *get();
   template <typename T, typename... Args>
   T &emplace(Args &&...args);
+  template <typename... Ts>
+  void emplace_bundle(Ts &&...components);
   template <typename T>
   void erase();
 
+  EntityHandle handle() const;
+
 private:
   EntityRef(World *world, EntityID entity_id)
       : m_world(world), m_entity_id(entity_id) {}
+  EntityRef(World *world, EntityID entity_id, EntityHandle handle)
+      : m_world(world), m_entity_id(entity_id), m_handle(handle) {}
 
   World *m_world = nullptr;
   std::optional<EntityID> m_entity_id;
+  // Cached slot handle; re-resolved through the id lookup when stale.
+  mutable EntityHandle m_handle{0u, 0u};
 
   friend class World;
   friend class CommandBuffer;
 };
 
+namespace detail {
+
+// Recorded commands form an intrusive list inside the buffer's arena; each
+// payload carries its own apply/destroy thunks so no per-command heap node or
+// std::function is needed.
+struct CommandHeader {
+  void (*apply)(CommandHeader *command, World &world) = nullptr;
+  void (*destroy)(CommandHeader *command) = nullptr;
+  CommandHeader *next = nullptr;
+};
+
+struct SpawnCommand;
+
+} // namespace detail
+
 class CommandBuffer {
 public:
-  explicit CommandBuffer(World *world) : m_world(world) {}
+  explicit CommandBuffer(World *world);
+  ~CommandBuffer();
 
-  EntityRef spawn(std::string name, bool active = true);
+  CommandBuffer(const CommandBuffer &) = delete;
+  CommandBuffer &operator=(const CommandBuffer &) = delete;
+  CommandBuffer(CommandBuffer &&other) noexcept;
+  CommandBuffer &operator=(CommandBuffer &&other) noexcept;
+
+  EntityRef spawn(std::string_view name, bool active = true);
   void destroy(EntityID entity_id);
 
   template <typename T, typename... Args>
@@ -163,27 +245,90 @@ public:
 
   template <typename T>
   void erase(EntityID entity_id);
-  void set_name(EntityID entity_id, std::string name);
+  void set_name(EntityID entity_id, std::string_view name);
   void set_active(EntityID entity_id, bool active);
 
   void apply(World &world);
   void apply();
+  void clear();
+
+  size_t size() const { return m_count; }
+  bool empty() const { return m_count == 0u; }
+
+private:
+  static constexpr size_t k_arena_bytes = 4096u;
+
+  template <typename Command, typename... Args>
+  Command *record(Args &&...args);
+  std::string_view copy_string(std::string_view value);
+  EntityID next_spawn_id();
+  void destroy_from(detail::CommandHeader *command);
+
+  World *m_world = nullptr;
+  BumpAllocator m_arena{0u};
+  detail::CommandHeader *m_head = nullptr;
+  detail::CommandHeader *m_tail = nullptr;
+  size_t m_count = 0u;
+  uint64_t m_spawn_state = 0u;
+};
+
+// Fixed set of command buffers for parallel recording. Each job records into
+// the stream at its own index and apply() replays streams in index order, so
+// the merged result does not depend on how jobs were scheduled.
+class CommandStreams {
+public:
+  CommandStreams(World &world, size_t stream_count);
+
+  CommandBuffer &stream(size_t index);
+  size_t size() const { return m_streams.size(); }
+
+  void apply();
 
 private:
   World *m_world = nullptr;
-  std::vector<std::function<void(World &)>> m_commands;
-  std::vector<EntityID> m_reserved_ids;
+  std::vector<CommandBuffer> m_streams;
 };
 
 namespace detail {
 
 struct ColumnBase {
+  // Change ticks, one per row: when the component was added and last written.
+  std::vector<uint32_t> added_ticks;
+  std::vector<uint32_t> changed_ticks;
+  // Newest tick in each vector, so change filters can skip a whole archetype.
+  // Never lowered when rows leave, so they may overstate.
+  uint32_t last_added_tick = 0u;
+  uint32_t last_changed_tick = 0u;
+
   virtual ~ColumnBase() = default;
   virtual Scope<ColumnBase> clone_empty() const = 0;
-  virtual void append_from(const ColumnBase &other, size_t row) = 0;
+  virtual void move_append_from(ColumnBase &other, size_t row) = 0;
   virtual void swap_remove(size_t row) = 0;
   virtual void *raw_at(size_t row) = 0;
   virtual const void *raw_at(size_t row) const = 0;
+
+protected:
+  void append_ticks_from(const ColumnBase &other, size_t row) {
+    push_ticks(other.added_ticks[row], other.changed_ticks[row]);
+  }
+
+  void push_ticks(uint32_t added, uint32_t changed) {
+    added_ticks.push_back(added);
+    changed_ticks.push_back(changed);
+    last_added_tick = std::max(last_added_tick, added);
+    last_changed_tick = std::max(last_changed_tick, changed);
+  }
+
+  void swap_remove_ticks(size_t row) {
+    const size_t last_row = added_ticks.size() - 1u;
+    if (row != last_row) {
+      added_ticks[row] = added_ticks[last_row];
+      changed_ticks[row] = changed_ticks[last_row];
+    }
+
+    added_ticks.pop_back();
+    changed_ticks.pop_back();
+  }
 };
 
 template <typename T>
@@ -194,9 +339,16 @@ struct Column final : ColumnBase {
     return create_scope<Column<T>>();
   }
 
-  void append_from(const ColumnBase &other, size_t row) override {
-    const auto &typed_other = static_cast<const Column<T> &>(other);
-    data.push_back(typed_other.data[row]);
+  template <typename U>
+  void push(U &&value, uint32_t tick) {
+    data.push_back(std::forward<U>(value));
+    push_ticks(tick, tick);
+  }
+
+  void move_append_from(ColumnBase &other, size_t row) override {
+    auto &typed_other = static_cast<Column<T> &>(other);
+    data.push_back(std::move(typed_other.data[row]));
+    append_ticks_from(other, row);
   }
 
   void swap_remove(size_t row) override {
@@ -208,6 +360,7 @@ struct Column final : ColumnBase {
     }
 
     data.pop_back();
+    swap_remove_ticks(row);
   }
 
   void *raw_at(size_t row) override {
@@ -224,18 +377,90 @@ struct Column final : ColumnBase {
 struct ArchetypeStorage {
   Signature signature;
   std::vector<EntityID> entity_ids;
+  std::vector<uint32_t> entity_slots;
   std::unordered_map<ComponentTypeID, Scope<ColumnBase>> columns;
+  // Cached transitions to the archetype with one component added / removed.
+  std::unordered_map<ComponentTypeID, uint32_t> add_edges;
+  std::unordered_map<ComponentTypeID, uint32_t> remove_edges;
+
+  template <typename T>
+  T *column_data() {
+    auto &column = static_cast<Column<std::remove_cvref_t<T>> &>(
+        *columns.at(ecs::component_type_id<T>())
+    );
+    return column.data.data();
+  }
+
+  template <typename T>
+  const T *column_data() const {
+    const auto &column = static_cast<const Column<std::remove_cvref_t<T>> &>(
+        *columns.at(ecs::component_type_id<T>())
+    );
+    return column.data.data();
+  }
+};
+
+struct QueryFilter {
+  enum class Kind : uint8_t {
+    Added,
+    Changed,
+  };
+
+  ComponentTypeID type_id = 0u;
+  Kind kind = Kind::Changed;
 };
 
+struct QueryChunk {
+  uint32_t archetype_index = 0u;
+  size_t begin = 0u;
+  size_t end = 0u;
+};
+
+struct ParallelAccessTracker {
+  std::mutex mutex;
+  std::vector<ComponentAccess> active;
+};
+
+// Matching archetypes for a component set. Archetypes are append-only, so a
+// cache only has to scan the ones created since its last refresh.
+struct QueryCache {
+  Signature required;
+  std::vector<uint32_t> archetypes;
+  size_t seen_archetypes = 0u;
+  bool initialized = false;
+};
+
+inline size_t next_query_type_id() {
+  static size_t counter = 0;
+  return counter++;
+}
+
+template <typename... Ts>
+inline size_t query_type_id() {
+  static const size_t id = next_query_type_id();
+  return id;
+}
+
 } // namespace detail
 
+template <typename... Ts>
+class Query;
+
 struct EntityRecord {
-  Signature signature;
   size_t archetype_index = 0u;
   size_t row = 0u;
   bool active = true;
 };
 
+// Dense entity storage addressed by EntityHandle. Slots are recycled through a
+// freelist and the generation is bumped on destroy so stale handles miss.
+struct EntitySlot {
+  EntityRecord record;
+  EntityID id = EntityID(0u);
+  uint32_t generation = 1u;
+  bool alive = false;
+};
+
 class World {
 public:
   World();
@@ -244,22 +469,64 @@ public:
   EntityRef ensure(EntityID entity_id, std::string name, bool active = true);
   void destroy(EntityID entity_id);
 
-  EntityRef entity(EntityID entity_id) { return EntityRef(this, entity_id); }
+  EntityRef entity(EntityID entity_id) {
+    return EntityRef(this, entity_id, handle(entity_id));
+  }
+  EntityRef entity(EntityHandle handle) {
+    return contains(handle) ? EntityRef(this, m_slots[handle.index].id, handle)
+                            : EntityRef();
+  }
+
   bool contains(EntityID entity_id) const {
-    return m_entity_records.find(entity_id) != m_entity_records.end();
+    return m_entity_lookup.find(entity_id) != m_entity_lookup.end();
+  }
+
+  bool contains(EntityHandle handle) const {
+    return handle.is_valid() && handle.index < m_slots.size() &&
+           m_slots[handle.index].alive &&
+           m_slots[handle.index].generation == handle.generation;
+  }
+
+  // Resolves a persistent id to its slot handle. This is the only hashed
+  // lookup on the entity path; hold on to the handle in per-frame loops.
+  EntityHandle handle(EntityID entity_id) const {
+    auto it = m_entity_lookup.find(entity_id);
+    return it != m_entity_lookup.end() ? it->second : EntityHandle{0u, 0u};
+  }
+
+  EntityID id(EntityHandle handle) const {
+    ASTRA_ENSURE(!contains(handle), "entity handle is stale");
+    return m_slots[handle.index].id;
   }
 
   template <typename T>
   bool has(EntityID entity_id) const {
-    auto it = m_entity_records.find(entity_id);
-    return it != m_entity_records.end() &&
-           it->second.signature.test(component_type_id<T>());
+    return has<T>(handle(entity_id));
+  }
+
+  template <typename T>
+  bool has(EntityHandle handle) const {
+    const auto *record = find_record(handle);
+    return record != nullptr &&
+           m_archetypes[record->archetype_index].signature.test(
+               component_type_id<T>()
+           );
   }
 
   template <typename T>
   T *get(EntityID entity_id) {
-    auto *record = find_record(entity_id);
-    if (record == nullptr || !record->signature.test(component_type_id<T>())) {
+    return get<T>(handle(entity_id));
+  }
+
+  template <typename T>
+  const T *get(EntityID entity_id) const {
+    return get<T>(handle(entity_id));
+  }
+
+  template <typename T>
+  T *get(EntityHandle handle) {
+    auto *record = find_record(handle);
+    if (record == nullptr) {
       return nullptr;
     }
 
@@ -273,9 +540,9 @@ public:
   }
 
   template <typename T>
-  const T *get(EntityID entity_id) const {
-    const auto *record = find_record(entity_id);
-    if (record == nullptr || !record->signature.test(component_type_id<T>())) {
+  const T *get(EntityHandle handle) const {
+    const auto *record = find_record(handle);
+    if (record == nullptr) {
       return nullptr;
     }
 
@@ -290,156 +557,566 @@ public:
 
   template <typename T, typename... Args>
   T &emplace(EntityID entity_id, Args &&...args) {
+    return emplace<T>(require_handle(entity_id), std::forward<Args>(args)...);
+  }
+
+  template <typename T, typename... Args>
+  T &emplace(EntityHandle handle, Args &&...args) {
     T component = detail::make_component<T>(std::forward<Args>(args)...);
 
-    if (auto *existing = get<T>(entity_id); existing != nullptr) {
+    if (auto *existing = get<T>(handle); existing != nullptr) {
       *existing = std::move(component);
+      mark_changed<T>(handle);
       touch();
       return *existing;
     }
 
-    auto &record = require_record(entity_id);
-    Signature new_signature = record.signature;
-    new_signature.set(component_type_id<T>());
+    const size_t target = archetype_with(
+        require_record(handle).archetype_index, component_type_id<T>()
+    );
 
-    migrate_entity(entity_id, new_signature, [&](detail::ArchetypeStorage &arch) {
-      auto &column = ensure_column<T>(arch);
-      column.data.push_back(std::move(component));
+    migrate_entity(handle, target, [&](detail::ArchetypeStorage &arch) {
+      ensure_column<T>(arch).push(std::move(component), m_change_tick);
     });
 
     touch();
-    return *get<T>(entity_id);
+    return *get<T>(handle);
+  }
+
+  // Adds or overwrites several components with a single archetype move.
+  template <typename... Ts>
+  void emplace_bundle(EntityID entity_id, Ts &&...components) {
+    emplace_bundle(require_handle(entity_id), std::forward<Ts>(components)...);
+  }
+
+  template <typename... Ts>
+  void emplace_bundle(EntityHandle handle, Ts &&...components) {
+    static_assert(sizeof...(Ts) > 0u, "emplace_bundle needs at least one component");
+
+    const size_t source = require_record(handle).archetype_index;
+    size_t target = source;
+    ((target = archetype_with(target, component_type_id<Ts>())), ...);
+
+    // Components the entity already has are overwritten in place and then
+    // travel with the rest of the row; new ones are appended to the target.
+    const auto had = [&](ComponentTypeID type_id) {
+      return m_archetypes[source].signature.test(type_id);
+    };
+    (assign_if_present<std::decay_t<Ts>>(handle, had(component_type_id<Ts>()), std::forward<Ts>(components)), ...);
+
+    if (target != source) {
+      migrate_entity(handle, target, [&](detail::ArchetypeStorage &arch) {
+        (append_if_absent<std::decay_t<Ts>>(arch, had(component_type_id<Ts>()), std::forward<Ts>(components)), ...);
+      });
+    }
+
+    touch();
   }
 
   template <typename T>
   void erase(EntityID entity_id) {
-    auto *record = find_record(entity_id);
-    if (record == nullptr || !record->signature.test(component_type_id<T>())) {
+    erase<T>(handle(entity_id));
+  }
+
+  template <typename T>
+  void erase(EntityHandle handle) {
+    auto *record = find_record(handle);
+    if (record == nullptr ||
+        !m_archetypes[record->archetype_index].signature.test(
+            component_type_id<T>()
+        )) {
       return;
     }
 
-    Signature new_signature = record->signature;
-    new_signature.reset(component_type_id<T>());
-    migrate_entity(entity_id, new_signature, [](detail::ArchetypeStorage &) {});
+    const size_t target =
+        archetype_without(record->archetype_index, component_type_id<T>());
+    record_removal(component_type_id<T>(), m_slots[handle.index].id);
+    migrate_entity(handle, target, [](detail::ArchetypeStorage &) {});
     touch();
   }
 
   template <typename... Ts, typename Fn>
   void each(Fn &&fn) {
-    Signature required;
-    (required.set(component_type_id<Ts>()), ...);
-
-    for (auto &archetype : m_archetypes) {
-      if (!archetype.signature.contains(required) ||
-          archetype.entity_ids.empty()) {
-        continue;
-      }
-
-      for (size_t row = 0; row < archetype.entity_ids.size(); ++row) {
-        if constexpr (sizeof...(Ts) == 0u) {
-          fn(archetype.entity_ids[row]);
-        } else {
-          fn(archetype.entity_ids[row],
-             *static_cast<Ts *>(archetype.columns.at(component_type_id<Ts>())
-                                    ->raw_at(row))...);
-        }
-      }
-    }
+    each_in<Ts...>(query_cache<Ts...>(), fn);
   }
 
   template <typename... Ts, typename Fn>
   void each(Fn &&fn) const {
-    Signature required;
-    (required.set(component_type_id<Ts>()), ...);
+    each_in<Ts...>(query_cache<Ts...>(), fn);
+  }
 
-    for (const auto &archetype : m_archetypes) {
-      if (!archetype.signature.contains(required) ||
-          archetype.entity_ids.empty()) {
-        continue;
+  template <typename... Ts>
+  size_t count() const {
+    return count_in(query_cache<Ts...>());
+  }
+
+  template <typename... Ts>
+  Query<Ts...> query() {
+    return Query<Ts...>(*this);
+  }
+
+  // Splits matching rows into chunks of at most `grain` rows and runs them
+  // through the installed ParallelDispatch. Declare read-only components as
+  // `const T`; overlapping writes with another running parallel query throw.
+  // Writable components are change-stamped per chunk, as in each().
+  // Structural changes must go through a CommandBuffer.
+  template <typename... Ts, typename Fn>
+  void par_each(Fn &&fn, size_t grain = 256u) {
+    ASTRA_ENSURE(grain == 0u, "par_each grain must be greater than zero");
+
+    const auto &cache = query_cache<Ts...>();
+    std::vector<detail::QueryChunk> chunks;
+    for (uint32_t archetype_index : cache.archetypes) {
+      const size_t rows = m_archetypes[archetype_index].entity_ids.size();
+      for (size_t begin = 0u; begin < rows; begin += grain) {
+        chunks.push_back(detail::QueryChunk{
+            .archetype_index = archetype_index,
+            .begin = begin,
+            .end = std::min(begin + grain, rows),
+        });
       }
+    }
+
+    if (chunks.empty()) {
+      return;
+    }
 
-      for (size_t row = 0; row < archetype.entity_ids.size(); ++row) {
-        if constexpr (sizeof...(Ts) == 0u) {
-          fn(archetype.entity_ids[row]);
-        } else {
-          fn(archetype.entity_ids[row],
-             *static_cast<const Ts *>(
-                 archetype.columns.at(component_type_id<Ts>())
-                     ->raw_at(row)
-             )...);
+    const ComponentAccess access = component_access<Ts...>();
+    begin_parallel_access(access);
+
+    struct Context {
+      World *world;
+      const std::vector<detail::QueryChunk> *chunks;
+      Fn *fn;
+    } context{this, &chunks, &fn};
+
+    auto task = [](void *raw_context, size_t index) {
+      auto *ctx = static_cast<Context *>(raw_context);
+      const auto &chunk = (*ctx->chunks)[index];
+      auto &archetype = ctx->world->m_archetypes[chunk.archetype_index];
+      ctx->world->visit_rows(archetype, chunk.begin, chunk.end, *ctx->fn,
+                             written_columns<Ts...>(archetype),
+                             archetype.template column_data<Ts>()...);
+    };
+
+    try {
+      if (auto dispatch = parallel_dispatch();
+          dispatch != nullptr && chunks.size() > 1u) {
+        dispatch(chunks.size(), &context, task);
+      } else {
+        for (size_t index = 0u; index < chunks.size(); ++index) {
+          task(&context, index);
         }
       }
+    } catch (...) {
+      end_parallel_access(access);
+      throw;
     }
-  }
 
-  template <typename... Ts>
-  size_t count() const {
-    size_t total = 0u;
-    each<Ts...>([&](auto &&...) { total++; });
-    return total;
+    end_parallel_access(access);
   }
 
-  size_t size() const { return m_entity_records.size(); }
-  bool empty() const { return m_entity_records.empty(); }
+  size_t size() const { return m_entity_lookup.size(); }
+  bool empty() const { return m_entity_lookup.empty(); }
   uint64_t revision() const { return m_revision; }
 
   std::string_view name(EntityID entity_id) const {
-    return require_name(entity_id);
+    return name(require_handle(entity_id));
+  }
+
+  std::string_view name(EntityHandle handle) const {
+    require_slot(handle);
+    return m_entity_names[handle.index];
   }
 
   void set_name(EntityID entity_id, std::string name) {
-    require_record(entity_id);
-    m_entity_names[entity_id] = std::move(name);
+    set_name(require_handle(entity_id), std::move(name));
+  }
+
+  void set_name(EntityHandle handle, std::string name) {
+    require_slot(handle);
+    m_entity_names[handle.index] = std::move(name);
     touch();
   }
 
   bool active(EntityID entity_id) const {
-    return require_record(entity_id).active;
+    return require_record(require_handle(entity_id)).active;
+  }
+
+  bool active(EntityHandle handle) const {
+    return require_record(handle).active;
   }
 
   void set_active(EntityID entity_id, bool active) {
-    require_record(entity_id).active = active;
+    set_active(require_handle(entity_id), active);
+  }
+
+  void set_active(EntityHandle handle, bool active) {
+    require_record(handle).active = active;
     touch();
   }
 
   CommandBuffer commands() { return CommandBuffer(this); }
   void touch() { ++m_revision; }
 
+  // Change detection. emplace, emplace_bundle and patch stamp the current
+  // tick on the written column. each, par_each and Query::each stamp the
+  // components they hand out by non-const reference; callbacks that return
+  // bool limit that to the rows they report as written. Writes through raw
+  // get<T>() pointers must call mark_changed. Readers remember the tick returned by
+  // advance_change_tick and compare against it on their next run.
+  uint32_t change_tick() const { return m_change_tick; }
+  uint32_t advance_change_tick() { return m_change_tick++; }
+
+  template <typename T>
+  void mark_changed(EntityHandle handle) {
+    if (auto *column = find_column(handle, component_type_id<T>());
+        column != nullptr) {
+      column->changed_ticks[m_slots[handle.index].record.row] = m_change_tick;
+      column->last_changed_tick = m_change_tick;
+    }
+  }
+
+  template <typename T>
+  void mark_changed(EntityID entity_id) {
+    mark_changed<T>(handle(entity_id));
+  }
+
+  template <typename T, typename Fn>
+  bool patch(EntityHandle handle, Fn &&fn) {
+    auto *component = get<T>(handle);
+    if (component == nullptr) {
+      return false;
+    }
+
+    fn(*component);
+    mark_changed<T>(handle);
+    touch();
+    return true;
+  }
+
+  template <typename T, typename Fn>
+  bool patch(EntityID entity_id, Fn &&fn) {
+    return patch<T>(handle(entity_id), std::forward<Fn>(fn));
+  }
+
+  template <typename T>
+  bool changed_since(EntityHandle handle, uint32_t tick) const {
+    const auto *column = find_column(handle, component_type_id<T>());
+    return column != nullptr &&
+           column->changed_ticks[m_slots[handle.index].record.row] > tick;
+  }
+
+  // Whether any T was written after `tick`, judged from each column's newest
+  // stamp without visiting rows. May overstate, like the stamps themselves.
+  template <typename T>
+  bool any_changed_since(uint32_t tick) const {
+    for (uint32_t archetype_index : query_cache<T>().archetypes) {
+      const auto &columns = m_archetypes[archetype_index].columns;
+      if (columns.at(component_type_id<T>())->last_changed_tick > tick) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <typename T>
+  bool added_since(EntityHandle handle, uint32_t tick) const {
+    const auto *column = find_column(handle, component_type_id<T>());
+    return column != nullptr &&
+           column->added_ticks[m_slots[handle.index].record.row] > tick;
+  }
+
+  // Removal events are only recorded for component types that opted in, so
+  // worlds nobody drains do not grow unbounded.
+  template <typename T>
+  void track_removals() {
+    m_removed.try_emplace(component_type_id<T>());
+  }
+
+  template <typename T>
+  std::vector<EntityID> drain_removed() {
+    std::vector<EntityID> drained;
+    if (auto it = m_removed.find(component_type_id<T>());
+        it != m_removed.end()) {
+      drained.swap(it->second);
+    }
+    return drained;
+  }
+
 private:
-  EntityRecord *find_record(EntityID entity_id) {
-    auto it = m_entity_records.find(entity_id);
-    return it != m_entity_records.end() ? &it->second : nullptr;
+  template <typename... Ts>
+  detail::QueryCache &query_cache() const {
+    const size_t query_id =
+        detail::query_type_id<std::remove_cvref_t<Ts>...>();
+    if (query_id >= m_query_caches.size()) {
+      m_query_caches.resize(query_id + 1u);
+    }
+
+    auto &cache = m_query_caches[query_id];
+    if (!cache.initialized) {
+      (cache.required.set(component_type_id<Ts>()), ...);
+      cache.initialized = true;
+    }
+
+    refresh_query(cache);
+    return cache;
+  }
+
+  void refresh_query(detail::QueryCache &cache) const {
+    for (; cache.seen_archetypes < m_archetypes.size();
+         ++cache.seen_archetypes) {
+      if (m_archetypes[cache.seen_archetypes].signature.contains(
+              cache.required
+          )) {
+        cache.archetypes.push_back(
+            static_cast<uint32_t>(cache.seen_archetypes)
+        );
+      }
+    }
+  }
+
+  // Column pointers are resolved once per archetype, so structural changes
+  // (spawn, destroy, emplace, erase) must be deferred through a CommandBuffer
+  // while iterating.
+  template <typename... Ts, typename Fn>
+  void each_in(const detail::QueryCache &cache, Fn &fn) {
+    for (uint32_t archetype_index : cache.archetypes) {
+      auto &archetype = m_archetypes[archetype_index];
+      const size_t rows = archetype.entity_ids.size();
+      if (rows == 0u) {
+        continue;
+      }
+
+      visit_rows(archetype, 0u, rows, fn, written_columns<Ts...>(archetype),
+                 archetype.template column_data<Ts>()...);
+    }
+  }
+
+  template <typename... Ts, typename Fn>
+  void each_in(const detail::QueryCache &cache, Fn &fn) const {
+    for (uint32_t archetype_index : cache.archetypes) {
+      const auto &archetype = m_archetypes[archetype_index];
+      const size_t rows = archetype.entity_ids.size();
+      if (rows == 0u) {
+        continue;
+      }
+
+      each_rows(archetype.entity_ids.data(), rows, fn,
+                archetype.template column_data<Ts>()...);
+    }
+  }
+
+  template <typename Fn, typename... Ts>
+  static void each_rows(const EntityID *entity_ids, size_t rows, Fn &fn, Ts *...columns) {
+    for (size_t row = 0; row < rows; ++row) {
+      fn(entity_ids[row], columns[row]...);
+    }
+  }
+
+  // Calls fn for one row. Callbacks may take the row's EntityHandle instead
+  // of its EntityID, which saves callers a lookup when they index dense
+  // per-slot tables.
+  template <typename Fn, typename... Ts>
+  decltype(auto) invoke_row(const detail::ArchetypeStorage &archetype, size_t row, Fn &fn, Ts *...columns) const {
+    if constexpr (std::is_invocable_v<Fn &, EntityHandle, Ts &...>) {
+      const uint32_t slot = archetype.entity_slots[row];
+      return fn(EntityHandle{slot, m_slots[slot].generation}, columns[row]...);
+    } else {
+      return fn(archetype.entity_ids[row], columns[row]...);
+    }
+  }
+
+  // Runs fn over rows [begin, end) and stamps the columns it may write. A
+  // callback returning bool reports whether it wrote the row and only those
+  // rows are stamped; otherwise the whole range is, with one fill per column.
+  // Ranges never overlap across par_each chunks, so workers stamp disjoint
+  // rows.
+  template <typename Fn, typename... Ts>
+  void visit_rows(const detail::ArchetypeStorage &archetype, size_t begin, size_t end, Fn &fn,
+                  const std::array<detail::ColumnBase *, sizeof...(Ts)> &written, Ts *...columns) const {
+    using Result = decltype(invoke_row(archetype, begin, fn, columns...));
+    if constexpr (std::is_same_v<Result, bool>) {
+      for (size_t row = begin; row < end; ++row) {
+        if (invoke_row(archetype, row, fn, columns...)) {
+          stamp_rows(written, row, row + 1u);
+        }
+      }
+    } else {
+      for (size_t row = begin; row < end; ++row) {
+        invoke_row(archetype, row, fn, columns...);
+      }
+      stamp_rows(written, begin, end);
+    }
+  }
+
+  // Columns a query may write; nullptr for the ones it declared const.
+  template <typename... Ts>
+  static std::array<detail::ColumnBase *, sizeof...(Ts)> written_columns(detail::ArchetypeStorage &archetype) {
+    return {written_column<Ts>(archetype)...};
+  }
+
+  template <typename T>
+  static detail::ColumnBase *written_column(detail::ArchetypeStorage &archetype) {
+    if constexpr (std::is_const_v<std::remove_reference_t<T>>) {
+      return nullptr;
+    } else {
+      return archetype.columns.at(component_type_id<T>()).get();
+    }
+  }
+
+  template <size_t N>
+  void stamp_rows(const std::array<detail::ColumnBase *, N> &written, size_t begin, size_t end) const {
+    for (detail::ColumnBase *column : written) {
+      if (column != nullptr) {
+        std::fill(column->changed_ticks.begin() + begin,
+                  column->changed_ticks.begin() + end, m_change_tick);
+        column->last_changed_tick = m_change_tick;
+      }
+    }
+  }
+
+  void begin_parallel_access(const ComponentAccess &access) {
+    std::lock_guard lock(m_parallel_access->mutex);
+    for (const auto &active : m_parallel_access->active) {
+      ASTRA_ENSURE(active.conflicts_with(access), "par_each component access conflicts with a running parallel query");
+    }
+    m_parallel_access->active.push_back(access);
+  }
+
+  void end_parallel_access(const ComponentAccess &access) {
+    std::lock_guard lock(m_parallel_access->mutex);
+    auto &active = m_parallel_access->active;
+    auto it = std::find_if(active.begin(), active.end(), [&](const ComponentAccess &entry) {
+      return entry.reads == access.reads && entry.writes == access.writes;
+    });
+    if (it != active.end()) {
+      active.erase(it);
+    }
+  }
+
+  template <typename... Ts, typename Fn>
+  void each_filtered_in(const detail::QueryCache &cache, const std::vector<detail::QueryFilter> &filters, uint32_t since, Fn &fn) {
+    std::vector<const uint32_t *> ticks(filters.size());
+    const auto passes = [&](size_t row) {
+      for (const uint32_t *filter_ticks : ticks) {
+        if (filter_ticks[row] <= since) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    for (uint32_t archetype_index : cache.archetypes) {
+      auto &archetype = m_archetypes[archetype_index];
+      const size_t rows = archetype.entity_ids.size();
+      if (rows == 0u) {
+        continue;
+      }
+
+      // Archetypes with no filtered column written since `since` are skipped
+      // without touching their rows.
+      bool stale = false;
+      for (size_t index = 0u; index < filters.size(); ++index) {
+        const auto &column = *archetype.columns.at(filters[index].type_id);
+        const bool added = filters[index].kind == detail::QueryFilter::Kind::Added;
+        ticks[index] = added ? column.added_ticks.data() : column.changed_ticks.data();
+        stale = stale || (added ? column.last_added_tick : column.last_changed_tick) <= since;
+      }
+      if (stale) {
+        continue;
+      }
+
+      visit_rows_if(archetype, rows, fn, passes, written_columns<Ts...>(archetype),
+                    archetype.template column_data<Ts>()...);
+    }
   }
 
-  const EntityRecord *find_record(EntityID entity_id) const {
-    auto it = m_entity_records.find(entity_id);
-    return it != m_entity_records.end() ? &it->second : nullptr;
+  template <typename Fn, typename Pred, typename... Ts>
+  void visit_rows_if(const detail::ArchetypeStorage &archetype, size_t rows, Fn &fn, const Pred &pred,
+                     const std::array<detail::ColumnBase *, sizeof...(Ts)> &written, Ts *...columns) const {
+    for (size_t row = 0; row < rows; ++row) {
+      if (pred(row)) {
+        visit_rows(archetype, row, row + 1u, fn, written, columns...);
+      }
+    }
   }
 
-  EntityRecord &require_record(EntityID entity_id) {
-    auto *record = find_record(entity_id);
-    ASTRA_ENSURE(record == nullptr, "entity not found");
-    return *record;
+  detail::ColumnBase *find_column(EntityHandle handle, ComponentTypeID type_id) {
+    auto *record = find_record(handle);
+    if (record == nullptr) {
+      return nullptr;
+    }
+
+    auto &columns = m_archetypes[record->archetype_index].columns;
+    auto it = columns.find(type_id);
+    return it != columns.end() ? it->second.get() : nullptr;
+  }
+
+  const detail::ColumnBase *find_column(EntityHandle handle, ComponentTypeID type_id) const {
+    const auto *record = find_record(handle);
+    if (record == nullptr) {
+      return nullptr;
+    }
+
+    const auto &columns = m_archetypes[record->archetype_index].columns;
+    auto it = columns.find(type_id);
+    return it != columns.end() ? it->second.get() : nullptr;
+  }
+
+  void record_removal(ComponentTypeID type_id, EntityID entity_id) {
+    if (auto it = m_removed.find(type_id); it != m_removed.end()) {
+      it->second.push_back(entity_id);
+    }
+  }
+
+  size_t count_in(const detail::QueryCache &cache) const {
+    size_t total = 0u;
+    for (uint32_t archetype_index : cache.archetypes) {
+      total += m_archetypes[archetype_index].entity_ids.size();
+    }
+    return total;
   }
 
-  const EntityRecord &require_record(EntityID entity_id) const {
-    auto *record = find_record(entity_id);
-    ASTRA_ENSURE(record == nullptr, "entity not found");
-    return *record;
+  EntityRecord *find_record(EntityHandle handle) {
+    return contains(handle) ? &m_slots[handle.index].record : nullptr;
   }
 
-  std::string_view require_name(EntityID entity_id) const {
-    auto it = m_entity_names.find(entity_id);
-    ASTRA_ENSURE(it == m_entity_names.end(), "entity name not found");
+  const EntityRecord *find_record(EntityHandle handle) const {
+    return contains(handle) ? &m_slots[handle.index].record : nullptr;
+  }
+
+  EntityHandle require_handle(EntityID entity_id) const {
+    auto it = m_entity_lookup.find(entity_id);
+    ASTRA_ENSURE(it == m_entity_lookup.end(), "entity not found");
     return it->second;
   }
 
+  EntitySlot &require_slot(EntityHandle handle) {
+    ASTRA_ENSURE(!contains(handle), "entity not found");
+    return m_slots[handle.index];
+  }
+
+  const EntitySlot &require_slot(EntityHandle handle) const {
+    ASTRA_ENSURE(!contains(handle), "entity not found");
+    return m_slots[handle.index];
+  }
+
+  EntityRecord &require_record(EntityHandle handle) {
+    return require_slot(handle).record;
+  }
+
+  const EntityRecord &require_record(EntityHandle handle) const {
+    return require_slot(handle).record;
+  }
+
   template <typename T>
   detail::Column<T> &ensure_column(detail::ArchetypeStorage &archetype) {
-    auto [it, inserted] =
-        archetype.columns.emplace(component_type_id<T>(), nullptr);
-    if (inserted) {
-      it->second = create_scope<detail::Column<T>>();
+    auto it = archetype.columns.find(component_type_id<T>());
+    if (it == archetype.columns.end()) {
+      it = archetype.columns
+               .emplace(component_type_id<T>(), create_scope<detail::Column<T>>())
+               .first;
     }
 
     return static_cast<detail::Column<T> &>(*it->second);
@@ -447,43 +1124,99 @@ private:
 
   detail::ColumnBase &
   ensure_compatible_column(detail::ArchetypeStorage &archetype, ComponentTypeID type_id, const detail::ColumnBase &source_column) {
-    auto [it, inserted] = archetype.columns.emplace(type_id, nullptr);
-    if (inserted) {
-      it->second = source_column.clone_empty();
+    auto it = archetype.columns.find(type_id);
+    if (it == archetype.columns.end()) {
+      it = archetype.columns.emplace(type_id, source_column.clone_empty()).first;
     }
 
     return *it->second;
   }
 
-  void migrate_entity(EntityID entity_id, const Signature &new_signature, const std::function<void(detail::ArchetypeStorage &)> &append_new_components) {
-    EntityRecord previous = require_record(entity_id);
-    ASTRA_ENSURE(previous.signature == new_signature, "migrate_entity called without a signature change");
+  template <typename T, typename U>
+  void assign_if_present(EntityHandle handle, bool present, U &&component) {
+    if (present) {
+      *get<T>(handle) = std::forward<U>(component);
+      mark_changed<T>(handle);
+    }
+  }
+
+  template <typename T, typename U>
+  void append_if_absent(detail::ArchetypeStorage &archetype, bool present, U &&component) {
+    if (!present) {
+      ensure_column<T>(archetype).push(std::forward<U>(component), m_change_tick);
+    }
+  }
+
+  size_t archetype_with(size_t from, ComponentTypeID type_id) {
+    if (m_archetypes[from].signature.test(type_id)) {
+      return from;
+    }
+
+    if (auto it = m_archetypes[from].add_edges.find(type_id);
+        it != m_archetypes[from].add_edges.end()) {
+      return it->second;
+    }
+
+    Signature signature = m_archetypes[from].signature;
+    signature.set(type_id);
+    const size_t to = ensure_archetype(signature);
+    link_archetypes(from, to, type_id);
+    return to;
+  }
+
+  size_t archetype_without(size_t from, ComponentTypeID type_id) {
+    if (!m_archetypes[from].signature.test(type_id)) {
+      return from;
+    }
+
+    if (auto it = m_archetypes[from].remove_edges.find(type_id);
+        it != m_archetypes[from].remove_edges.end()) {
+      return it->second;
+    }
+
+    Signature signature = m_archetypes[from].signature;
+    signature.reset(type_id);
+    const size_t to = ensure_archetype(signature);
+    link_archetypes(to, from, type_id);
+    return to;
+  }
+
+  void link_archetypes(size_t without, size_t with, ComponentTypeID type_id) {
+    m_archetypes[without].add_edges[type_id] = static_cast<uint32_t>(with);
+    m_archetypes[with].remove_edges[type_id] = static_cast<uint32_t>(without);
+  }
+
+  // Moves the entity's row into `new_archetype_index`, transferring shared
+  // columns by move. The callback appends the components the source lacks.
+  template <typename Fn>
+  void migrate_entity(EntityHandle handle, size_t new_archetype_index, Fn &&append_new_components) {
+    const EntityRecord previous = require_record(handle);
+    ASTRA_ENSURE(previous.archetype_index == new_archetype_index, "migrate_entity called without a signature change");
 
-    const size_t new_archetype_index = ensure_archetype(new_signature);
     detail::ArchetypeStorage &new_archetype = m_archetypes[new_archetype_index];
+    detail::ArchetypeStorage &old_archetype = m_archetypes[previous.archetype_index];
     const size_t new_row = new_archetype.entity_ids.size();
 
-    const auto &old_archetype = m_archetypes[previous.archetype_index];
-    for (const auto &[type_id, old_column] : old_archetype.columns) {
-      if (!new_signature.test(type_id)) {
+    for (auto &[type_id, old_column] : old_archetype.columns) {
+      if (!new_archetype.signature.test(type_id)) {
         continue;
       }
 
       auto &new_column =
           ensure_compatible_column(new_archetype, type_id, *old_column);
-      new_column.append_from(*old_column, previous.row);
+      new_column.move_append_from(*old_column, previous.row);
     }
 
     append_new_components(new_archetype);
 
-    new_archetype.entity_ids.push_back(entity_id);
+    new_archetype.entity_ids.push_back(m_slots[handle.index].id);
+    new_archetype.entity_slots.push_back(handle.index);
 
-    auto &record = require_record(entity_id);
-    record.signature = new_signature;
+    auto &record = require_record(handle);
     record.archetype_index = new_archetype_index;
     record.row = new_row;
 
-    swap_remove(previous.archetype_index, previous.row, entity_id);
+    swap_remove(previous.archetype_index, previous.row);
   }
 
   size_t ensure_archetype(const Signature &signature) {
@@ -506,53 +1239,159 @@ private:
     return entity_id;
   }
 
+  EntityHandle allocate_slot() {
+    uint32_t slot_idx;
+
+    if (!m_freelist.empty()) {
+      slot_idx = m_freelist.back();
+      m_freelist.pop_back();
+    } else {
+      slot_idx = static_cast<uint32_t>(m_slots.size());
+      m_slots.emplace_back();
+      m_entity_names.emplace_back();
+    }
+
+    m_slots[slot_idx].alive = true;
+    return EntityHandle{slot_idx, m_slots[slot_idx].generation};
+  }
+
+  void release_slot(EntityHandle handle) {
+    auto &slot = m_slots[handle.index];
+    slot.alive = false;
+    m_entity_names[handle.index].clear();
+    slot.record = EntityRecord{};
+    // Generation 0 marks an invalid handle, so skip it on wrap-around.
+    if (++slot.generation == 0u) {
+      slot.generation = 1u;
+    }
+    m_freelist.push_back(handle.index);
+  }
+
   EntityRef spawn_with_id(EntityID entity_id, std::string name, bool active) {
     ASTRA_ENSURE(contains(entity_id), "entity already exists");
 
     const size_t archetype_index = ensure_archetype(Signature{});
     auto &archetype = m_archetypes[archetype_index];
     const size_t row = archetype.entity_ids.size();
-    archetype.entity_ids.push_back(entity_id);
 
-    m_entity_records.emplace(entity_id, EntityRecord{
-                                            .signature = Signature{},
-                                            .archetype_index = archetype_index,
-                                            .row = row,
-                                            .active = active,
-                                        });
-    m_entity_names.emplace(entity_id, std::move(name));
+    const EntityHandle handle = allocate_slot();
+    archetype.entity_ids.push_back(entity_id);
+    archetype.entity_slots.push_back(handle.index);
+
+    auto &slot = m_slots[handle.index];
+    slot.id = entity_id;
+    m_entity_names[handle.index] = std::move(name);
+    slot.record = EntityRecord{
+        .archetype_index = archetype_index,
+        .row = row,
+        .active = active,
+    };
+    m_entity_lookup[entity_id] = handle;
     touch();
 
-    return EntityRef(this, entity_id);
+    return EntityRef(this, entity_id, handle);
   }
 
-  void swap_remove(size_t archetype_index, size_t row, EntityID) {
+  void swap_remove(size_t archetype_index, size_t row) {
     auto &archetype = m_archetypes[archetype_index];
     ASTRA_ENSURE(row >= archetype.entity_ids.size(), "archetype row is out of bounds");
 
     const size_t last_row = archetype.entity_ids.size() - 1u;
-    const EntityID moved_entity = archetype.entity_ids[last_row];
 
     for (auto &[_, column] : archetype.columns) {
       column->swap_remove(row);
     }
 
     if (row != last_row) {
-      archetype.entity_ids[row] = moved_entity;
-      require_record(moved_entity).row = row;
+      const uint32_t moved_slot = archetype.entity_slots[last_row];
+      archetype.entity_ids[row] = archetype.entity_ids[last_row];
+      archetype.entity_slots[row] = moved_slot;
+      m_slots[moved_slot].record.row = row;
     }
 
     archetype.entity_ids.pop_back();
+    archetype.entity_slots.pop_back();
   }
 
   std::vector<detail::ArchetypeStorage> m_archetypes;
   std::unordered_map<Signature, size_t, SignatureHash> m_archetype_lookup;
-  std::unordered_map<EntityID, EntityRecord> m_entity_records;
-  std::unordered_map<EntityID, std::string> m_entity_names;
+  std::vector<EntitySlot> m_slots;
+  // Names live beside the slots so string_views survive slot growth.
+  std::deque<std::string> m_entity_names;
+  std::vector<uint32_t> m_freelist;
+  FlatHashMap<uint64_t, EntityHandle> m_entity_lookup;
+  mutable std::vector<detail::QueryCache> m_query_caches;
+  std::unordered_map<ComponentTypeID, std::vector<EntityID>> m_removed;
+  uint32_t m_change_tick = 1u;
+  Scope<detail::ParallelAccessTracker> m_parallel_access =
+      create_scope<detail::ParallelAccessTracker>();
   uint64_t m_revision = 0u;
 
   friend class EntityRef;
   friend class CommandBuffer;
+  friend struct detail::SpawnCommand;
+  template <typename... Ts>
+  friend class Query;
+};
+
+// Persistent query that owns its archetype cache, for systems that iterate the
+// same component set every frame.
+template <typename... Ts>
+class Query {
+public:
+  explicit Query(World &world) : m_world(&world) {
+    (m_cache.required.set(component_type_id<Ts>()), ...);
+    m_cache.initialized = true;
+  }
+
+  // Restricts each() to rows whose T was written (changed) or inserted
+  // (added) since this query's previous each().
+  template <typename T>
+  Query &changed() {
+    return add_filter(component_type_id<T>(), detail::QueryFilter::Kind::Changed);
+  }
+
+  template <typename T>
+  Query &added() {
+    return add_filter(component_type_id<T>(), detail::QueryFilter::Kind::Added);
+  }
+
+  template <typename Fn>
+  void each(Fn &&fn) {
+    m_world->refresh_query(m_cache);
+    if (m_filters.empty()) {
+      m_world->template each_in<Ts...>(m_cache, fn);
+    } else {
+      m_world->template each_filtered_in<Ts...>(m_cache, m_filters, m_last_seen_tick, fn);
+    }
+    m_last_seen_tick = m_world->advance_change_tick();
+  }
+
+  size_t count() {
+    m_world->refresh_query(m_cache);
+    return m_world->count_in(m_cache);
+  }
+
+  size_t archetype_count() {
+    m_world->refresh_query(m_cache);
+    return m_cache.archetypes.size();
+  }
+
+private:
+  Query &add_filter(ComponentTypeID type_id, detail::QueryFilter::Kind kind) {
+    m_filters.push_back(detail::QueryFilter{.type_id = type_id, .kind = kind});
+    if (!m_cache.required.test(type_id)) {
+      m_cache.required.set(type_id);
+      m_cache.archetypes.clear();
+      m_cache.seen_archetypes = 0u;
+    }
+    return *this;
+  }
+
+  World *m_world = nullptr;
+  detail::QueryCache m_cache;
+  std::vector<detail::QueryFilter> m_filters;
+  uint32_t m_last_seen_tick = 0u;
 };
 
 inline World::World() {
@@ -565,26 +1404,31 @@ inline EntityRef World::spawn(std::string name, bool active) {
 }
 
 inline EntityRef World::ensure(EntityID entity_id, std::string name, bool active) {
-  if (contains(entity_id)) {
-    set_name(entity_id, std::move(name));
-    set_active(entity_id, active);
-    return EntityRef(this, entity_id);
+  if (const EntityHandle existing = handle(entity_id); existing.is_valid()) {
+    set_name(existing, std::move(name));
+    set_active(existing, active);
+    return EntityRef(this, entity_id, existing);
   }
 
   return spawn_with_id(entity_id, std::move(name), active);
 }
 
 inline void World::destroy(EntityID entity_id) {
-  auto it = m_entity_records.find(entity_id);
-  if (it == m_entity_records.end()) {
+  const EntityHandle handle = this->handle(entity_id);
+  if (!handle.is_valid()) {
     return;
   }
 
-  const EntityRecord record = it->second;
-  swap_remove(record.archetype_index, record.row, entity_id);
+  const EntityRecord &record = m_slots[handle.index].record;
+  if (!m_removed.empty()) {
+    for (const auto &[type_id, _] : m_archetypes[record.archetype_index].columns) {
+      record_removal(type_id, entity_id);
+    }
+  }
+  swap_remove(record.archetype_index, record.row);
 
-  m_entity_records.erase(entity_id);
-  m_entity_names.erase(entity_id);
+  m_entity_lookup.erase(entity_id);
+  release_slot(handle);
   touch();
 }
 
@@ -593,6 +1437,18 @@ inline EntityID EntityRef::id() const {
   return *m_entity_id;
 }
 
+inline EntityHandle EntityRef::handle() const {
+  if (m_world == nullptr || m_entity_id == std::nullopt) {
+    return EntityHandle{0u, 0u};
+  }
+
+  if (!m_world->contains(m_handle)) {
+    m_handle = m_world->handle(*m_entity_id);
+  }
+
+  return m_handle;
+}
+
 inline std::string_view EntityRef::name() const {
   ASTRA_ENSURE(m_world == nullptr, "entity ref is detached");
   return m_world->name(id());
@@ -605,7 +1461,8 @@ inline void EntityRef::set_name(std::string name) {
 
 inline bool EntityRef::active() const {
   ASTRA_ENSURE(m_world == nullptr, "entity ref is detached");
-  return exists() ? m_world->active(id()) : false;
+  const EntityHandle entity_handle = handle();
+  return entity_handle.is_valid() ? m_world->active(entity_handle) : false;
 }
 
 inline void EntityRef::set_active(bool active) {
@@ -613,25 +1470,30 @@ inline void EntityRef::set_active(bool active) {
   m_world->set_active(id(), active);
 }
 
-inline bool EntityRef::exists() const {
-  return m_world != nullptr && m_entity_id != std::nullopt &&
-         m_world->contains(*m_entity_id);
-}
+inline bool EntityRef::exists() const { return handle().is_valid(); }
 
 template <typename T>
 inline bool EntityRef::has() const {
-  return exists() && m_world->has<T>(id());
+  const EntityHandle entity_handle = handle();
+  return entity_handle.is_valid() && m_world->has<T>(entity_handle);
 }
 
 template <typename T>
 inline T *EntityRef::get() {
-  return exists() ? m_world->get<T>(id()) : nullptr;
+  const EntityHandle entity_handle = handle();
+  return entity_handle.is_valid() ? m_world->get<T>(entity_handle) : nullptr;
 }
 
 template <typename T, typename... Args>
 inline T &EntityRef::emplace(Args &&...args) {
   ASTRA_ENSURE(!exists(), "cannot emplace on an invalid entity");
-  return m_world->emplace<T>(id(), std::forward<Args>(args)...);
+  return m_world->emplace<T>(handle(), std::forward<Args>(args)...);
+}
+
+template <typename... Ts>
+inline void EntityRef::emplace_bundle(Ts &&...components) {
+  ASTRA_ENSURE(!exists(), "cannot emplace on an invalid entity");
+  m_world->emplace_bundle(handle(), std::forward<Ts>(components)...);
 }
 
 template <typename T>
@@ -640,72 +1502,236 @@ inline void EntityRef::erase() {
     return;
   }
 
-  m_world->erase<T>(id());
+  m_world->erase<T>(handle());
 }
 
-inline EntityRef CommandBuffer::spawn(std::string name, bool active) {
-  ASTRA_ENSURE(m_world == nullptr, "command buffer is detached");
+namespace detail {
+
+template <typename Command>
+inline void apply_command(CommandHeader *command, World &world) {
+  static_cast<Command *>(command)->run(world);
+}
+
+template <typename Command>
+inline void destroy_command(CommandHeader *command) {
+  static_cast<Command *>(command)->~Command();
+}
+
+struct SpawnCommand : CommandHeader {
+  EntityID entity_id;
+  std::string_view name;
+  bool active;
+
+  SpawnCommand(EntityID entity_id, std::string_view name, bool active)
+      : entity_id(entity_id), name(name), active(active) {}
 
-  EntityID entity_id = m_world->allocate_entity_id();
-  while (std::find(m_reserved_ids.begin(), m_reserved_ids.end(), entity_id) !=
-         m_reserved_ids.end()) {
-    entity_id = m_world->allocate_entity_id();
+  void run(World &world) {
+    world.spawn_with_id(entity_id, std::string(name), active);
   }
+};
 
-  m_reserved_ids.push_back(entity_id);
-  m_commands.push_back(
-      [entity_id, name = std::move(name), active](World &world) mutable {
-        world.spawn_with_id(entity_id, std::move(name), active);
-      }
-  );
+struct DestroyCommand : CommandHeader {
+  EntityID entity_id;
+
+  explicit DestroyCommand(EntityID entity_id) : entity_id(entity_id) {}
+
+  void run(World &world) { world.destroy(entity_id); }
+};
+
+template <typename T>
+struct EmplaceCommand : CommandHeader {
+  EntityID entity_id;
+  T component;
+
+  EmplaceCommand(EntityID entity_id, T &&component)
+      : entity_id(entity_id), component(std::move(component)) {}
+
+  void run(World &world) {
+    world.emplace<T>(entity_id, std::move(component));
+  }
+};
+
+template <typename T>
+struct EraseCommand : CommandHeader {
+  EntityID entity_id;
+
+  explicit EraseCommand(EntityID entity_id) : entity_id(entity_id) {}
+
+  void run(World &world) { world.erase<T>(entity_id); }
+};
+
+struct SetNameCommand : CommandHeader {
+  EntityID entity_id;
+  std::string_view name;
+
+  SetNameCommand(EntityID entity_id, std::string_view name)
+      : entity_id(entity_id), name(name) {}
 
+  void run(World &world) { world.set_name(entity_id, std::string(name)); }
+};
+
+struct SetActiveCommand : CommandHeader {
+  EntityID entity_id;
+  bool active;
+
+  SetActiveCommand(EntityID entity_id, bool active)
+      : entity_id(entity_id), active(active) {}
+
+  void run(World &world) { world.set_active(entity_id, active); }
+};
+
+} // namespace detail
+
+// Each buffer draws spawn ids from its own splitmix64 sequence, seeded once on
+// the constructing thread. The sequence never repeats within a buffer, so
+// recording does not touch the shared Guid generator or keep a reserved list.
+inline CommandBuffer::CommandBuffer(World *world)
+    : m_world(world), m_spawn_state(static_cast<uint64_t>(Guid())) {}
+
+inline CommandBuffer::~CommandBuffer() { destroy_from(m_head); }
+
+inline CommandBuffer::CommandBuffer(CommandBuffer &&other) noexcept
+    : m_world(other.m_world), m_arena(std::move(other.m_arena)),
+      m_head(other.m_head), m_tail(other.m_tail), m_count(other.m_count),
+      m_spawn_state(other.m_spawn_state) {
+  other.m_head = nullptr;
+  other.m_tail = nullptr;
+  other.m_count = 0u;
+}
+
+inline CommandBuffer &CommandBuffer::operator=(CommandBuffer &&other) noexcept {
+  if (this != &other) {
+    destroy_from(m_head);
+    m_world = other.m_world;
+    m_arena = std::move(other.m_arena);
+    m_head = other.m_head;
+    m_tail = other.m_tail;
+    m_count = other.m_count;
+    m_spawn_state = other.m_spawn_state;
+    other.m_head = nullptr;
+    other.m_tail = nullptr;
+    other.m_count = 0u;
+  }
+  return *this;
+}
+
+template <typename Command, typename... Args>
+inline Command *CommandBuffer::record(Args &&...args) {
+  if (m_arena.capacity() == 0u) {
+    m_arena.reserve(k_arena_bytes);
+  }
+
+  Command *command =
+      m_arena.allocate_object<Command>(std::forward<Args>(args)...);
+  command->apply = &detail::apply_command<Command>;
+  if constexpr (!std::is_trivially_destructible_v<Command>) {
+    command->destroy = &detail::destroy_command<Command>;
+  }
+
+  if (m_tail != nullptr) {
+    m_tail->next = command;
+  } else {
+    m_head = command;
+  }
+  m_tail = command;
+  ++m_count;
+  return command;
+}
+
+inline std::string_view CommandBuffer::copy_string(std::string_view value) {
+  if (value.empty()) {
+    return {};
+  }
+
+  if (m_arena.capacity() == 0u) {
+    m_arena.reserve(k_arena_bytes);
+  }
+
+  char *chars = static_cast<char *>(m_arena.allocate(value.size(), 1u));
+  std::memcpy(chars, value.data(), value.size());
+  return std::string_view(chars, value.size());
+}
+
+inline EntityID CommandBuffer::next_spawn_id() {
+  for (;;) {
+    uint64_t value = (m_spawn_state += 0x9E3779B97F4A7C15ull);
+    value = (value ^ (value >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27u)) * 0x94D049BB133111EBull;
+    value ^= value >> 31u;
+
+    const EntityID entity_id(value);
+    if (value != 0u && !m_world->contains(entity_id)) {
+      return entity_id;
+    }
+  }
+}
+
+inline void CommandBuffer::destroy_from(detail::CommandHeader *command) {
+  while (command != nullptr) {
+    detail::CommandHeader *next = command->next;
+    if (command->destroy != nullptr) {
+      command->destroy(command);
+    }
+    command = next;
+  }
+}
+
+inline EntityRef CommandBuffer::spawn(std::string_view name, bool active) {
+  ASTRA_ENSURE(m_world == nullptr, "command buffer is detached");
+
+  const EntityID entity_id = next_spawn_id();
+  record<detail::SpawnCommand>(entity_id, copy_string(name), active);
   return EntityRef(m_world, entity_id);
 }
 
 inline void CommandBuffer::destroy(EntityID entity_id) {
-  m_commands.push_back([entity_id](World &world) { world.destroy(entity_id); });
+  record<detail::DestroyCommand>(entity_id);
 }
 
 template <typename T, typename... Args>
 inline void CommandBuffer::emplace(EntityID entity_id, Args &&...args) {
-  T component = detail::make_component<T>(std::forward<Args>(args)...);
-  m_commands.push_back(
-      [entity_id, component = std::move(component)](World &world) mutable {
-        world.emplace<T>(entity_id, std::move(component));
-      }
+  record<detail::EmplaceCommand<T>>(
+      entity_id, detail::make_component<T>(std::forward<Args>(args)...)
   );
 }
 
 template <typename T>
 inline void CommandBuffer::erase(EntityID entity_id) {
-  m_commands.push_back(
-      [entity_id](World &world) { world.erase<T>(entity_id); }
-  );
+  record<detail::EraseCommand<T>>(entity_id);
 }
 
-inline void CommandBuffer::set_name(EntityID entity_id, std::string name) {
-  m_commands.push_back(
-      [entity_id, name = std::move(name)](World &world) mutable {
-        world.set_name(entity_id, std::move(name));
-      }
-  );
+inline void CommandBuffer::set_name(EntityID entity_id, std::string_view name) {
+  record<detail::SetNameCommand>(entity_id, copy_string(name));
 }
 
 inline void CommandBuffer::set_active(EntityID entity_id, bool active) {
-  m_commands.push_back([entity_id, active](World &world) {
-    world.set_active(entity_id, active);
-  });
+  record<detail::SetActiveCommand>(entity_id, active);
 }
 
 inline void CommandBuffer::apply(World &world) {
   ASTRA_ENSURE(m_world != nullptr && m_world != &world, "command buffer cannot be applied to a different world");
 
-  for (auto &command : m_commands) {
-    command(world);
+  detail::CommandHeader *command = m_head;
+  m_head = nullptr;
+  m_tail = nullptr;
+  m_count = 0u;
+
+  try {
+    while (command != nullptr) {
+      detail::CommandHeader *next = command->next;
+      command->apply(command, world);
+      if (command->destroy != nullptr) {
+        command->destroy(command);
+      }
+      command = next;
+    }
+  } catch (...) {
+    destroy_from(command);
+    m_arena.reset();
+    throw;
   }
 
-  m_commands.clear();
-  m_reserved_ids.clear();
+  m_arena.reset();
 }
 
 inline void CommandBuffer::apply() {
@@ -713,4 +1739,31 @@ inline void CommandBuffer::apply() {
   apply(*m_world);
 }
 
+inline void CommandBuffer::clear() {
+  destroy_from(m_head);
+  m_head = nullptr;
+  m_tail = nullptr;
+  m_count = 0u;
+  m_arena.reset();
+}
+
+inline CommandStreams::CommandStreams(World &world, size_t stream_count)
+    : m_world(&world) {
+  m_streams.reserve(stream_count);
+  for (size_t index = 0u; index < stream_count; ++index) {
+    m_streams.emplace_back(m_world);
+  }
+}
+
+inline CommandBuffer &CommandStreams::stream(size_t index) {
+  ASTRA_ENSURE(index >= m_streams.size(), "command stream index out of range");
+  return m_streams[index];
+}
+
+inline void CommandStreams::apply() {
+  for (auto &stream : m_streams) {
+    stream.apply(*m_world);
+  }
+}
+
 } // namespace astralix::ecs
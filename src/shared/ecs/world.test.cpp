@@ -1,6 +1,7 @@
 #include "world.hpp"
 #include "exceptions/base-exception.hpp"
 #include <gtest/gtest.h>
+#include <memory>
 
 namespace astralix::ecs {
 namespace {
@@ -91,6 +92,343 @@ TEST(WorldTest, EnsureReusesExistingEntityIdAndUpdatesMetadata) {
   EXPECT_EQ(world.size(), 1u);
 }
 
+TEST(WorldTest, HandlesResolveToSlotsAndGoStaleOnDestroy) {
+  World world;
+  auto entity = world.spawn("handled");
+  entity.emplace<Position>(Position{.x = 11});
+
+  const EntityHandle handle = world.handle(entity.id());
+  ASSERT_TRUE(handle.is_valid());
+  EXPECT_EQ(world.id(handle), entity.id());
+  ASSERT_NE(world.get<Position>(handle), nullptr);
+  EXPECT_EQ(world.get<Position>(handle)->x, 11);
+
+  world.destroy(entity.id());
+
+  EXPECT_FALSE(world.contains(handle));
+  EXPECT_EQ(world.get<Position>(handle), nullptr);
+  EXPECT_FALSE(world.handle(entity.id()).is_valid());
+}
+
+TEST(WorldTest, DestroyedSlotsAreRecycledWithNewGeneration) {
+  World world;
+  auto first = world.spawn("first");
+  const EntityHandle first_handle = first.handle();
+  world.destroy(first.id());
+
+  auto second = world.spawn("second");
+  const EntityHandle second_handle = second.handle();
+
+  EXPECT_EQ(second_handle.index, first_handle.index);
+  EXPECT_NE(second_handle.generation, first_handle.generation);
+  EXPECT_FALSE(world.contains(first_handle));
+  EXPECT_EQ(world.name(second_handle), "second");
+  EXPECT_EQ(world.size(), 1u);
+}
+
+TEST(WorldTest, SwapRemoveKeepsMovedEntityRowsAddressable) {
+  World world;
+  auto a = world.spawn("a");
+  auto b = world.spawn("b");
+  auto c = world.spawn("c");
+  a.emplace<Position>(Position{.x = 1});
+  b.emplace<Position>(Position{.x = 2});
+  c.emplace<Position>(Position{.x = 3});
+
+  world.destroy(a.id());
+
+  ASSERT_NE(b.get<Position>(), nullptr);
+  ASSERT_NE(c.get<Position>(), nullptr);
+  EXPECT_EQ(b.get<Position>()->x, 2);
+  EXPECT_EQ(c.get<Position>()->x, 3);
+  EXPECT_EQ(world.count<Position>(), 2u);
+}
+
+TEST(WorldTest, EmplaceBundleMovesEntityInOneStep) {
+  World world;
+  auto entity = world.spawn("bundle");
+  entity.emplace<Position>(Position{.x = 1});
+
+  entity.emplace_bundle(Position{.x = 10}, Velocity{.x = 20});
+
+  ASSERT_NE(entity.get<Position>(), nullptr);
+  ASSERT_NE(entity.get<Velocity>(), nullptr);
+  EXPECT_EQ(entity.get<Position>()->x, 10);
+  EXPECT_EQ(entity.get<Velocity>()->x, 20);
+  EXPECT_EQ((world.count<Position, Velocity>()), 1u);
+  EXPECT_EQ(world.count<Position>(), 1u);
+}
+
+TEST(WorldTest, MigrationMovesComponentsInsteadOfCopying) {
+  struct MoveOnly {
+    std::unique_ptr<int> value;
+  };
+
+  World world;
+  auto entity = world.spawn("move-only");
+  entity.emplace<MoveOnly>(MoveOnly{.value = std::make_unique<int>(7)});
+  entity.emplace<Position>(Position{.x = 1});
+  entity.erase<Position>();
+
+  ASSERT_NE(entity.get<MoveOnly>(), nullptr);
+  ASSERT_NE(entity.get<MoveOnly>()->value, nullptr);
+  EXPECT_EQ(*entity.get<MoveOnly>()->value, 7);
+}
+
+TEST(QueryTest, PicksUpArchetypesCreatedAfterConstruction) {
+  World world;
+  auto query = world.query<Position>();
+
+  auto a = world.spawn("a");
+  a.emplace<Position>(Position{.x = 1});
+  EXPECT_EQ(query.count(), 1u);
+  EXPECT_EQ(query.archetype_count(), 1u);
+
+  auto b = world.spawn("b");
+  b.emplace<Position>(Position{.x = 2});
+  b.emplace<Velocity>(Velocity{.x = 4});
+  EXPECT_EQ(query.archetype_count(), 2u);
+
+  int sum = 0;
+  query.each([&](EntityID, Position &position) { sum += position.x; });
+  EXPECT_EQ(sum, 3);
+}
+
+TEST(QueryTest, EachWritesThroughResolvedColumns) {
+  World world;
+  for (int i = 0; i < 8; ++i) {
+    auto entity = world.spawn("moving");
+    entity.emplace<Position>(Position{.x = i});
+    entity.emplace<Velocity>(Velocity{.x = 1});
+  }
+
+  world.each<Position, Velocity>(
+      [](EntityID, Position &position, const Velocity &velocity) {
+        position.x += velocity.x;
+      });
+
+  int sum = 0;
+  const World &view = world;
+  view.each<Position>([&](EntityID, const Position &position) {
+    sum += position.x;
+  });
+
+  EXPECT_EQ(sum, 28 + 8);
+  EXPECT_EQ((view.count<Position, Velocity>()), 8u);
+}
+
+TEST(ChangeTrackingTest, ChangedFilterOnlyVisitsWrittenRows) {
+  World world;
+  auto moving = world.spawn("moving");
+  auto still = world.spawn("still");
+  moving.emplace<Position>(Position{.x = 1});
+  still.emplace<Position>(Position{.x = 2});
+
+  auto query = world.query<Position>();
+  query.changed<Position>();
+
+  int visited = 0;
+  query.each([&](EntityID, Position &) { visited++; });
+  EXPECT_EQ(visited, 2);
+
+  visited = 0;
+  query.each([&](EntityID, Position &) { visited++; });
+  EXPECT_EQ(visited, 0);
+
+  world.patch<Position>(moving.handle(), [](Position &position) {
+    position.x = 10;
+  });
+
+  std::vector<EntityID> changed;
+  query.each([&](EntityID entity_id, Position &) {
+    changed.push_back(entity_id);
+  });
+  ASSERT_EQ(changed.size(), 1u);
+  EXPECT_EQ((uint64_t)changed.front(), (uint64_t)moving.id());
+}
+
+TEST(ChangeTrackingTest, ChangedFilterPassesEntityHandles) {
+  World world;
+  auto plain = world.spawn("plain");
+  auto moving = world.spawn("moving");
+  plain.emplace<Position>(Position{.x = 1});
+  moving.emplace<Position>(Position{.x = 2});
+  moving.emplace<Velocity>(Velocity{.x = 1});
+
+  auto query = world.query<const Position>();
+  query.changed<Position>();
+  query.each([](EntityHandle, const Position &) {});
+
+  // Only the {Position, Velocity} archetype has a newer write; the other is
+  // skipped on its column tick, and the callback gets the row's live handle.
+  world.mark_changed<Position>(moving.handle());
+  std::vector<EntityHandle> changed;
+  query.each([&](EntityHandle handle, const Position &) {
+    changed.push_back(handle);
+  });
+  ASSERT_EQ(changed.size(), 1u);
+  EXPECT_EQ(changed.front(), moving.handle());
+
+  changed.clear();
+  query.each([&](EntityHandle handle, const Position &) {
+    changed.push_back(handle);
+  });
+  EXPECT_TRUE(changed.empty());
+}
+
+TEST(ChangeTrackingTest, AddedFilterSurvivesMigration) {
+  World world;
+  auto query = world.query<Position>();
+  query.added<Position>();
+
+  auto first = world.spawn("first");
+  first.emplace<Position>(Position{.x = 1});
+  int visited = 0;
+  query.each([&](EntityID, Position &) { visited++; });
+  EXPECT_EQ(visited, 1);
+
+  first.emplace<Velocity>(Velocity{.x = 1});
+  auto second = world.spawn("second");
+  second.emplace<Position>(Position{.x = 2});
+
+  std::vector<EntityID> added;
+  query.each([&](EntityID entity_id, Position &) {
+    added.push_back(entity_id);
+  });
+  ASSERT_EQ(added.size(), 1u);
+  EXPECT_EQ((uint64_t)added.front(), (uint64_t)second.id());
+}
+
+TEST(ChangeTrackingTest, DrainsRemovedComponentsForTrackedTypes) {
+  World world;
+  world.track_removals<Position>();
+
+  auto erased = world.spawn("erased");
+  auto destroyed = world.spawn("destroyed");
+  erased.emplace<Position>(Position{.x = 1});
+  destroyed.emplace<Position>(Position{.x = 2});
+  destroyed.emplace<Velocity>(Velocity{.x = 3});
+
+  erased.erase<Position>();
+  world.destroy(destroyed.id());
+
+  auto removed = world.drain_removed<Position>();
+  ASSERT_EQ(removed.size(), 2u);
+  EXPECT_EQ((uint64_t)removed[0], (uint64_t)erased.id());
+  EXPECT_EQ((uint64_t)removed[1], (uint64_t)destroyed.id());
+  EXPECT_TRUE(world.drain_removed<Position>().empty());
+  EXPECT_TRUE(world.drain_removed<Velocity>().empty());
+}
+
+TEST(ChangeTrackingTest, IterationStampsOnlyWritableComponents) {
+  World world;
+  std::vector<EntityHandle> handles;
+  for (int i = 0; i < 10; ++i) {
+    auto entity = world.spawn("iterated");
+    entity.emplace<Position>(Position{.x = i});
+    entity.emplace<Velocity>(Velocity{.x = 1});
+    handles.push_back(entity.handle());
+  }
+
+  uint32_t since = world.advance_change_tick();
+  world.each<Position, const Velocity>(
+      [](EntityID, Position &position, const Velocity &velocity) {
+        position.x += velocity.x;
+      });
+  for (EntityHandle handle : handles) {
+    EXPECT_TRUE(world.changed_since<Position>(handle, since));
+    EXPECT_FALSE(world.changed_since<Velocity>(handle, since));
+  }
+
+  since = world.advance_change_tick();
+  world.par_each<Velocity>([](EntityID, Velocity &) {}, 3u);
+  for (EntityHandle handle : handles) {
+    EXPECT_FALSE(world.changed_since<Position>(handle, since));
+    EXPECT_TRUE(world.changed_since<Velocity>(handle, since));
+  }
+
+  since = world.advance_change_tick();
+  world.par_each<Position>([](EntityID, Position &position) {
+    if (position.x % 2 != 0) {
+      return false;
+    }
+    position.x = 0;
+    return true;
+  }, 3u);
+  for (size_t index = 0u; index < handles.size(); ++index) {
+    EXPECT_EQ(world.changed_since<Position>(handles[index], since), index % 2u == 1u);
+  }
+}
+
+TEST(ChangeTrackingTest, AnyChangedSinceSeesInPlaceWritesAcrossArchetypes) {
+  World world;
+  auto lone_entity = world.spawn("lone");
+  lone_entity.emplace<Position>();
+  const EntityHandle lone = lone_entity.handle();
+  auto moving = world.spawn("moving");
+  moving.emplace<Position>();
+  moving.emplace<Velocity>();
+
+  uint32_t since = world.advance_change_tick();
+  EXPECT_FALSE(world.any_changed_since<Position>(since));
+  EXPECT_FALSE(world.any_changed_since<Velocity>(since));
+
+  // Written in place: the revision stays put, the column stamp moves.
+  const uint64_t revision = world.revision();
+  world.get<Position>(lone)->x = 4;
+  world.mark_changed<Position>(lone);
+  EXPECT_EQ(world.revision(), revision);
+  EXPECT_TRUE(world.any_changed_since<Position>(since));
+  EXPECT_FALSE(world.any_changed_since<Velocity>(since));
+
+  since = world.advance_change_tick();
+  EXPECT_FALSE(world.any_changed_since<Position>(since));
+  world.mark_changed<Velocity>(moving.handle());
+  EXPECT_TRUE(world.any_changed_since<Velocity>(since));
+}
+
+TEST(ParallelQueryTest, VisitsEveryRowAcrossChunks) {
+  World world;
+  for (int i = 0; i < 100; ++i) {
+    auto entity = world.spawn("chunked");
+    entity.emplace<Position>(Position{.x = i});
+    if (i % 2 == 0) {
+      entity.emplace<Velocity>(Velocity{.x = 1});
+    }
+  }
+
+  world.par_each<Position>([](EntityID, Position &position) {
+    position.x *= 2;
+  }, 7u);
+
+  int sum = 0;
+  world.each<Position>([&](EntityID, const Position &position) {
+    sum += position.x;
+  });
+  EXPECT_EQ(sum, 2 * 4950);
+}
+
+TEST(ParallelQueryTest, RejectsConflictingNestedAccess) {
+  World world;
+  auto entity = world.spawn("conflict");
+  entity.emplace<Position>(Position{.x = 1});
+  entity.emplace<Velocity>(Velocity{.x = 1});
+
+  EXPECT_NO_THROW(world.par_each<const Position>([&](EntityID, const Position &) {
+    world.par_each<const Position, Velocity>(
+        [](EntityID, const Position &, Velocity &) {});
+  }));
+
+  EXPECT_THROW(world.par_each<Position>([&](EntityID, Position &) {
+    world.par_each<const Position>([](EntityID, const Position &) {});
+  }), BaseException);
+
+  EXPECT_FALSE(component_access<Position>().conflicts_with(
+      component_access<const Velocity>()));
+  EXPECT_TRUE(component_access<const Position>().conflicts_with(
+      component_access<Position>()));
+}
+
 TEST(CommandBufferTest, AppliesDeferredOperationsInOrder) {
   World world;
   auto commands = world.commands();
@@ -106,5 +444,57 @@ TEST(CommandBufferTest, AppliesDeferredOperationsInOrder) {
   EXPECT_FALSE(entity.active());
 }
 
+TEST(CommandBufferTest, SpawnsUniqueIdsWithinOneBuffer) {
+  World world;
+  auto commands = world.commands();
+  std::vector<EntityID> ids;
+  for (int index = 0; index < 512; ++index) {
+    ids.push_back(commands.spawn("spawned").id());
+  }
+  EXPECT_EQ(commands.size(), 512u);
+  commands.apply();
+
+  EXPECT_EQ(world.size(), 512u);
+  EXPECT_TRUE(commands.empty());
+  for (EntityID entity_id : ids) {
+    EXPECT_TRUE(world.contains(entity_id));
+  }
+}
+
+TEST(CommandBufferTest, StreamsApplyInIndexOrder) {
+  World world;
+  auto target = world.spawn("target");
+
+  CommandStreams streams(world, 3u);
+  streams.stream(2).emplace<Position>(target.id(), Position{.x = 2});
+  streams.stream(0).emplace<Position>(target.id(), Position{.x = 0});
+  streams.stream(1).set_name(target.id(), "renamed");
+  streams.stream(1).emplace<Position>(target.id(), Position{.x = 1});
+  streams.apply();
+
+  ASSERT_NE(target.get<Position>(), nullptr);
+  EXPECT_EQ(target.get<Position>()->x, 2);
+  EXPECT_EQ(target.name(), "renamed");
+}
+
+TEST(CommandBufferTest, ReleasesUnappliedPayloads) {
+  World world;
+  auto entity = world.spawn("owner");
+  auto shared = std::make_shared<int>(7);
+
+  {
+    auto commands = world.commands();
+    commands.emplace<std::shared_ptr<int>>(entity.id(), shared);
+    EXPECT_EQ(shared.use_count(), 2);
+  }
+  EXPECT_EQ(shared.use_count(), 1);
+
+  auto commands = world.commands();
+  commands.emplace<std::unique_ptr<int>>(entity.id(), std::make_unique<int>(9));
+  commands.apply();
+  ASSERT_NE(entity.get<std::unique_ptr<int>>(), nullptr);
+  EXPECT_EQ(**entity.get<std::unique_ptr<int>>(), 9);
+}
+
 } // namespace
 } // namespace astralix::ecs
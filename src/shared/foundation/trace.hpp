@@ -27,6 +27,7 @@ using AstraVkTraceContext = void *;
 #define ASTRA_PROFILE_CHILD(name) ZoneScopedN(name) // For explicit child spans
 #define ASTRA_PROFILE_BEGIN(name) TracyCZoneN(__astra_zone, name, true)
 #define ASTRA_PROFILE_END() TracyCZoneEnd(__astra_zone)
+#define ASTRA_PROFILE_PLOT(name, value) TracyPlot(name, value)
 #define ASTRA_FRAME_MARK FrameMark
 #define ASTRA_VK_TRACE_CONTEXT_CREATE(var, physdev, device, queue, cmdbuf)     \
   do {                                                                          \
@@ -61,6 +62,7 @@ using AstraVkTraceContext = void *;
 #define ASTRA_PROFILE_CHILD(name)
 #define ASTRA_PROFILE_BEGIN(name)
 #define ASTRA_PROFILE_END()
+#define ASTRA_PROFILE_PLOT(name, value)
 #define ASTRA_FRAME_MARK
 #define ASTRA_VK_TRACE_CONTEXT_CREATE(var, physdev, device, queue, cmdbuf)     \
   do {                                                                          \
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "miniaudio.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace astralix::testing {
+
+inline std::filesystem::path audio_test_dir() {
+  const auto directory =
+      std::filesystem::temp_directory_path() / "astralix-audio-tests";
+  std::filesystem::create_directories(directory);
+  return directory;
+}
+
+// Writes interleaved f32 `samples` to a WAV file under the test directory.
+// Decoding it at the same channel count and sample rate returns the samples
+// bit for bit, so tests can check exactly which frames came back.
+inline std::string write_test_wav(const std::string &name,
+                                  const std::vector<float> &samples,
+                                  uint32_t channels = 1u,
+                                  uint32_t sample_rate = 48000u) {
+  const std::string path = (audio_test_dir() / name).string();
+
+  ma_encoder_config config = ma_encoder_config_init(
+      ma_encoding_format_wav, ma_format_f32, channels, sample_rate);
+  ma_encoder encoder;
+  if (ma_encoder_init_file(path.c_str(), &config, &encoder) != MA_SUCCESS) {
+    return {};
+  }
+
+  ma_uint64 written = 0;
+  ma_encoder_write_pcm_frames(&encoder, samples.data(),
+                              samples.size() / channels, &written);
+  ma_encoder_uninit(&encoder);
+  return path;
+}
+
+// Mono ramp whose frame `i` holds `i`, so a frame's value is its index.
+inline std::vector<float> ramp_samples(uint32_t frame_count) {
+  std::vector<float> samples(frame_count);
+  for (uint32_t frame = 0u; frame < frame_count; ++frame) {
+    samples[frame] = static_cast<float>(frame);
+  }
+  return samples;
+}
+
+} // namespace astralix::testing
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Benchmarks live beside the tests of the code they measure, as DISABLED_
+// tests of a `*Benchmark` suite so the regular run skips them. Run them with
+//   astralix_tests --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+namespace astralix::testing {
+
+template <typename Fn> double elapsed_ms(Fn &&fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start
+  )
+      .count();
+}
+
+// Fastest of `runs` calls, which filters out scheduling noise.
+template <typename Fn> double best_ms(int runs, Fn &&fn) {
+  double best = elapsed_ms(fn);
+  for (int run = 1; run < runs; ++run) {
+    best = std::min(best, elapsed_ms(fn));
+  }
+  return best;
+}
+
+// Workers for a benchmark JobSystem: one per core besides the caller's.
+inline uint32_t benchmark_worker_count() {
+  return std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+}
+
+// Attaches a timing to the running test's XML report, in microseconds.
+inline void record_ms(const std::string &key, double ms) {
+  ::testing::Test::RecordProperty(key + "_us", static_cast<int>(ms * 1000.0));
+}
+
+} // namespace astralix::testing
@@ -0,0 +1,24 @@
+#include "graph/clip-resolution.hpp"
+
+namespace astralix::audio {
+
+// Tests load their clips into the backend's cache up front. There is no
+// resource manager to look descriptors up in, so resolution stops at the
+// cache and every voice plays from it.
+
+const DecodedClip *resolve_clip(AudioBackend &backend, const std::string &clip_id) {
+  const auto *clip = backend.clip_cache().find(clip_id);
+  return clip != nullptr && clip->valid() ? clip : nullptr;
+}
+
+Scope<VoiceHandle> create_clip_voice(AudioBackend &backend,
+                                     const std::string &clip_id, bool spatial) {
+  const auto *clip = resolve_clip(backend, clip_id);
+  if (clip == nullptr) {
+    return nullptr;
+  }
+
+  return backend.create_voice(*clip, spatial);
+}
+
+} // namespace astralix::audio